@@ -51,12 +51,31 @@
 // Section: Included Files
 // *****************************************************************************
 // *****************************************************************************
+#include <stdlib.h>
 #include <string.h>
 #include "app.h"
 #include "definitions.h"
 #include "app_ble.h"
 #include "ble_trsps/ble_trsps.h"
 #include "app_timer/app_timer.h"
+#include "app_nvm/app_nvm.h"
+#include "app_crypto/app_crypto.h"
+#include "app_cal/app_cal.h"
+#include "app_log/app_log.h"
+#include "app_rec/app_rec.h"
+#include "app_lat/app_lat.h"
+#include "app_queue/app_queue.h"
+#include "app_session.h"
+#include "app_conn_policy.h"
+#include "app_link.h"
+#include "app_l2cap.h"
+#include "app_adv.h"
+#include "app_adv_enc.h"
+#include "app_group.h"
+#include "app_auth.h"
+#include "app_smp_key.h"
+#include "ble_util/byte_stream.h"
+#include "ble_util/mw_entropy.h"
 #include <ctype.h>
 
 
@@ -123,15 +142,20 @@ APP_DATA appData;
 
 void APP_Initialize ( void )
 {
+    // Before anything may record an event
+    APP_REC_Init();
+
     /* Place the App state machine in its initial state. */
     appData.state = APP_STATE_INIT;
-    appData.appQueue = xQueueCreate( 64, sizeof(APP_Msg_T) );
+    // Messages are time stamped from the first one queued
+    APP_LAT_Init();
+    APP_QUEUE_Init();
     /* TODO: Initialize your application's state machine and other
      * parameters.
      */
 }
 #define UART_DATA_MAX   25
-uint16_t conn_hdl;// connection handle info captured @BLE_GAP_EVT_CONNECTED event
+#define APP_SERVO_CH                0U
 uint16_t ret;
 uint8_t uart_data;
 uint8_t uartBuf[UART_DATA_MAX];
@@ -145,15 +169,16 @@ void uart_cb(SERCOM_USART_EVENT event, uintptr_t context)
     // Read 1 byte data from UART
     SERCOM0_USART_Read(&uart_data, 1);
     appMsg.msgId = APP_MSG_UART_CB;
-    OSAL_QUEUE_Send(&appData.appQueue, &appMsg, 0);     
+    (void)APP_QUEUE_SendISR(&appMsg);
   }
 }
 void APP_SendUartData()
 {    
-    // Send the uartBuf to connected device through Transparent service
+    // Send the uartBuf to every subscribed device through Transparent service and L2CAP channel
     if(uartBufNum == 0)
         return;
-    BLE_TRSPS_SendData(conn_hdl, uartBufNum, uartBuf);
+    BLE_TRSPS_BroadcastData(uartBufNum, uartBuf, NULL);
+    APP_L2CAP_BroadcastData(uartBufNum, uartBuf);
     memset(uartBuf, 0 , sizeof(uartBuf));
     uartBufNum = 0;
 }
@@ -168,6 +193,195 @@ void APP_UartCBHandler()
     else
         APP_TIMER_SetTimer(APP_TIMER_SEND_UART,APP_TIMER_500MS, false);   
 }
+uint32_t servoDuty;         // Setpoint being output, before the trim
+uint32_t servoTarget;       // Setpoint last commanded
+static uint16_t servoConnHandle;    // Link of the last setpoint
+static void APP_ServoOutput(uint32_t duty)
+{
+    uint32_t neutral = APP_CAL_GetChannel(APP_SERVO_CH)->point[APP_CAL_POINT_NEUTRAL];
+
+    servoDuty = duty;
+    TCC0_PWM24bitDutySet(TCC0_CHANNEL1, APP_CAL_GetOutputDuty(APP_SERVO_CH, duty));
+    APP_LAT_Mark(APP_LAT_POINT_PWM);
+    // Keep flash writes from suspending the RF while the motor is being driven
+    APP_IDLE_HoldPdsCommit(APP_IDLE_PDS_MOTOR_HOLD_MS);
+    APP_ADV_SetServoStatus(((servoTarget == neutral) && (duty == neutral)) ? APP_ADV_SERVO_STOPPED :
+        ((servoTarget < neutral) ? APP_ADV_SERVO_FORWARD : APP_ADV_SERVO_REVERSE), duty, servoTarget);
+}
+static void APP_ServoRamp(void)
+{
+    uint32_t step = APP_CAL_GetChannel(APP_SERVO_CH)->rampStep;
+    uint32_t duty = servoTarget;
+
+    // Move by at most the calibrated ramp step per servo frame
+    if (step != 0U)
+    {
+        if (servoTarget > (servoDuty + step))
+        {
+            duty = servoDuty + step;
+        }
+        else if ((servoTarget + step) < servoDuty)
+        {
+            duty = servoDuty - step;
+        }
+    }
+    APP_ServoOutput(duty);
+    // The motor is still being driven, keep the link of the command in low-latency mode
+    APP_CONN_POLICY_Activity(servoConnHandle);
+    if (duty == servoTarget)
+    {
+        APP_TIMER_StopTimer(APP_TIMER_SERVO_RAMP);
+    }
+}
+static void APP_ServoSetDuty(uint32_t duty)
+{
+    if (duty != servoTarget)
+    {
+        APP_REC_Record(APP_REC_TYPE_SETPOINT, APP_SERVO_CH, duty);
+    }
+    servoTarget = duty;
+    // Only a session setpoint is resumed at boot, never one of the group
+    if ((CONFIG_APP_SERVO_RESUME != 0) && (servoConnHandle != APP_MSG_CONN_HANDLE_GROUP))
+    {
+        APP_CAL_SetLastDuty(APP_SERVO_CH, duty);
+    }
+    APP_ServoRamp();
+    if ((servoDuty != servoTarget) && !APP_TIMER_IsTimerExisted(APP_TIMER_SERVO_RAMP))
+    {
+        APP_TIMER_SetTimer(APP_TIMER_SERVO_RAMP, APP_CAL_RAMP_PERIOD_MS, true);
+    }
+}
+static void APP_ServoCalCommand(uint16_t connHandle, const char *p_cmd)
+{
+    const char *p_value = strchr(p_cmd, ' ');
+    char *p_end;
+    long value = 0;
+    uint16_t result = APP_RES_INVALID_PARA;
+
+    // "<name> <value>", the whole value must be a number
+    if (p_value != NULL)
+    {
+        value = strtol(p_value + 1, &p_end, 0);
+        if ((p_end == (p_value + 1)) || (*p_end != '\0'))
+        {
+            p_value = NULL;
+        }
+    }
+
+    if (p_value == NULL)
+    {
+        // Invalid command
+    }
+    else if (APP_SESSION_AcquireControl(connHandle) != APP_RES_SUCCESS)
+    {
+        result = APP_RES_BAD_STATE;
+    }
+    else if (strncmp(p_cmd, "start ", 6) == 0)
+    {
+        result = APP_CAL_SetPoint(APP_SERVO_CH, APP_CAL_POINT_FORWARD, (uint32_t)value);
+    }
+    else if (strncmp(p_cmd, "stop ", 5) == 0)
+    {
+        result = APP_CAL_SetPoint(APP_SERVO_CH, APP_CAL_POINT_NEUTRAL, (uint32_t)value);
+    }
+    else if (strncmp(p_cmd, "reverse ", 8) == 0)
+    {
+        result = APP_CAL_SetPoint(APP_SERVO_CH, APP_CAL_POINT_REVERSE, (uint32_t)value);
+    }
+    else if (strncmp(p_cmd, "trim ", 5) == 0)
+    {
+        result = APP_CAL_SetTrim(APP_SERVO_CH, (int32_t)value);
+    }
+    else if (strncmp(p_cmd, "ramp ", 5) == 0)
+    {
+        result = APP_CAL_SetRampStep(APP_SERVO_CH, (uint32_t)value);
+    }
+
+    if (result == APP_RES_SUCCESS)
+    {
+        // Apply the new calibration to the current setpoint
+        APP_LAT_Mark(APP_LAT_POINT_PARSE);
+        APP_ServoOutput(servoDuty);
+    }
+    else if (result == APP_RES_BAD_STATE)
+    {
+        const char msg[] = "busy: servo is controlled by another device\n";
+
+        BLE_TRSPS_SendData(connHandle, sizeof(msg) - 1, (uint8_t *)msg);
+    }
+    else
+    {
+        const char msg[] = "cal: invalid command\n";
+
+        BLE_TRSPS_SendData(connHandle, sizeof(msg) - 1, (uint8_t *)msg);
+    }
+}
+void APP_ServoCommand(uint16_t connHandle, uint32_t duty)
+{
+    APP_Msg_T appMsg;
+
+    // Only the session owning the servo control may change the motor state
+    if (APP_SESSION_AcquireControl(connHandle) == APP_RES_SUCCESS)
+    {
+        // Only the newest setpoint waiting for the channel is applied, the message carries the timing of its command
+        appMsg.msgId = APP_MSG_SERVO_SETPOINT;
+        U16_TO_BUF_LE(&appMsg.msgData[APP_MSG_CONN_HANDLE_OFFSET], connHandle);
+        appMsg.msgData[APP_MSG_SETPOINT_CH_OFFSET] = APP_SERVO_CH;
+        U32_TO_BUF_LE(&appMsg.msgData[APP_MSG_SETPOINT_DUTY_OFFSET], duty);
+        APP_LAT_Defer(&appMsg.msgData[APP_MSG_SETPOINT_LAT_OFFSET]);
+        (void)APP_QUEUE_SendLatest(&appMsg, APP_SERVO_CH);
+        APP_CONN_POLICY_Activity(connHandle);
+    }
+    else
+    {
+        const char msg[] = "busy: servo is controlled by another device\n";
+
+        BLE_TRSPS_SendData(connHandle, sizeof(msg) - 1, (uint8_t *)msg);
+    }
+}
+static void APP_GroupSetpoint(uint32_t duty)
+{
+    APP_Msg_T appMsg;
+
+    // A session controlling the servo has precedence over the group
+    if (APP_SESSION_IsControlled())
+    {
+        return;
+    }
+
+    // Coalesced with the setpoints of the sessions, the newest one is applied
+    appMsg.msgId = APP_MSG_SERVO_SETPOINT;
+    U16_TO_BUF_LE(&appMsg.msgData[APP_MSG_CONN_HANDLE_OFFSET], APP_MSG_CONN_HANDLE_GROUP);
+    appMsg.msgData[APP_MSG_SETPOINT_CH_OFFSET] = APP_SERVO_CH;
+    U32_TO_BUF_LE(&appMsg.msgData[APP_MSG_SETPOINT_DUTY_OFFSET], duty);
+    memset(&appMsg.msgData[APP_MSG_SETPOINT_LAT_OFFSET], 0, APP_LAT_CMD_LEN);
+    (void)APP_QUEUE_SendLatest(&appMsg, APP_SERVO_CH);
+}
+static void APP_AuthCommand(uint16_t connHandle)
+{
+    uint8_t salt[APP_AUTH_SALT_LEN];
+    char msg[6 + (APP_AUTH_SALT_LEN * 2) + 2];
+    uint8_t i;
+
+    // Reply "auth <salt>", the central derives the same session key from it
+    if (APP_AUTH_Start(connHandle, salt) == APP_RES_SUCCESS)
+    {
+        memcpy(msg, "auth ", 5);
+        for (i = 0; i < APP_AUTH_SALT_LEN; i++)
+        {
+            msg[5 + (i * 2)] = "0123456789abcdef"[salt[i] >> 4];
+            msg[6 + (i * 2)] = "0123456789abcdef"[salt[i] & 0x0F];
+        }
+        msg[5 + (APP_AUTH_SALT_LEN * 2)] = '\n';
+        BLE_TRSPS_SendData(connHandle, 6 + (APP_AUTH_SALT_LEN * 2), (uint8_t *)msg);
+    }
+    else
+    {
+        const char err[] = "auth: unavailable\n";
+
+        BLE_TRSPS_SendData(connHandle, sizeof(err) - 1, (uint8_t *)err);
+    }
+}
 
 
 /******************************************************************************
@@ -182,6 +396,7 @@ void APP_Tasks ( void )
 {
     APP_Msg_T    appMsg[1];
     APP_Msg_T   *p_appMsg;
+    uint32_t     waitMs;
     p_appMsg=appMsg;
 
     /* Check the application's current state. */
@@ -191,6 +406,7 @@ void APP_Tasks ( void )
         case APP_STATE_INIT:
         {
             bool appInitialized = true;
+            APP_LOG_Init();
             //appData.appQueue = xQueueCreate( 10, sizeof(APP_Msg_T) );
             // Enable UART Read
             SERCOM0_USART_ReadNotificationEnable(true, true);
@@ -198,18 +414,39 @@ void APP_Tasks ( void )
             SERCOM0_USART_ReadThresholdSet(1);
             // Register the UART RX callback function
             SERCOM0_USART_ReadCallbackRegister(uart_cb, (uintptr_t)NULL);
+            APP_SESSION_Init();
+            APP_CONN_POLICY_Init();
+            APP_LINK_Init();
+            APP_GROUP_Init(APP_GroupSetpoint, APP_SERVO_CH);
+            APP_NVM_Init();
+            APP_CRYPTO_Init();
+            (void)MW_ENTROPY_Init();
+            APP_AUTH_Init();
+            APP_SMP_KEY_Init();
+            // Calibration and last setpoint, needed before the PWM starts
+            APP_CAL_Init();
             APP_BleStackInit();
+            APP_L2CAP_Init();
             // Start Advertisement
-            BLE_GAP_SetAdvEnable(0x01, 0x00);
+            APP_ADV_Init();
+            APP_ADV_SetFaults(APP_ADV_FAULT_PWM_OFF);
+            APP_ADV_Start();
+            // Follow the setpoints of the group controller
+            APP_GROUP_Start(CONFIG_APP_GROUP_ID, CONFIG_APP_GROUP_CHANNEL);
             // Reset the uart buffer
             memset(uartBuf, 0, sizeof(uartBuf));
             uartBufNum = 0;            
-            SERCOM0_USART_Write((uint8_t *)"WBZ653 SERVO MOTOR\r\n",20);
-            SERCOM0_USART_Write((uint8_t *)"Advertising\r\n",13);
+            APP_LOG(APP_LOG_ID_BOOT);
+            APP_LOG(APP_LOG_ID_ADVERTISING);
             if (appInitialized)
             {
+                // Come up stopped, the motor turns only when an operator commands it. The first frame has
+                // no pulse until the duty is latched
+                servoTarget = (CONFIG_APP_SERVO_RESUME != 0) ? APP_CAL_GetChannel(APP_SERVO_CH)->lastDuty :
+                    APP_CAL_GetChannel(APP_SERVO_CH)->point[APP_CAL_POINT_NEUTRAL];
+                APP_ServoOutput(servoTarget);
                 TCC0_PWMStart();
-                TCC0_PWM24bitDutySet(TCC0_CHANNEL1,96000);
+                APP_ADV_SetFaults(0);
                 appData.state = APP_STATE_SERVICE_TASKS;
             }
             break;
@@ -217,8 +454,12 @@ void APP_Tasks ( void )
 
         case APP_STATE_SERVICE_TASKS:
         {
-            if (OSAL_QUEUE_Receive(&appData.appQueue, &appMsg, OSAL_WAIT_FOREVER))
+            // A pass takes the messages waiting, at most APP_QUEUE_BULK_BUDGET of them from the bulk lane
+            APP_QUEUE_StartPass();
+            waitMs = OSAL_WAIT_FOREVER;
+            while (APP_QUEUE_Receive(p_appMsg, waitMs))
             {
+                waitMs = 0U;
 
                 if(p_appMsg->msgId==APP_MSG_BLE_STACK_EVT)
                 {
@@ -230,10 +471,63 @@ void APP_Tasks ( void )
                     // Pass BLE UART Data transmission target BLE UART Device handling
                     APP_UartCBHandler();
                 }
+                else if(p_appMsg->msgId==APP_MSG_NVM_CB)
+                {
+                    APP_NVM_Complete();
+                }
+                else if(p_appMsg->msgId==APP_MSG_SMP_KEY_GEN)
+                {
+                    APP_SMP_KEY_Generate();
+                }
+                else if(p_appMsg->msgId==APP_MSG_SERVO_SETPOINT)
+                {
+                    const uint8_t *p_duty = &p_appMsg->msgData[APP_MSG_SETPOINT_DUTY_OFFSET];
+                    const uint8_t *p_connHandle = &p_appMsg->msgData[APP_MSG_CONN_HANDLE_OFFSET];
+                    uint32_t duty;
+
+                    STREAM_LE_TO_U32(&duty, &p_duty);
+                    STREAM_LE_TO_U16(&servoConnHandle, &p_connHandle);
+                    // The command of the setpoint ends at the first write of the ramp, not at the later ones
+                    APP_LAT_Resume(&p_appMsg->msgData[APP_MSG_SETPOINT_LAT_OFFSET], p_appMsg->msgStamp);
+                    APP_ServoSetDuty(duty);
+                    APP_LAT_End();
+                }
                 else if(p_appMsg->msgId== APP_TIMER_SEND_UART_MSG)
                 {
                     APP_SendUartData();
                 }
+                else if(p_appMsg->msgId== APP_TIMER_CONN_POLICY_MSG)
+                {
+                    APP_CONN_POLICY_Tick();
+                }
+                else if(p_appMsg->msgId== APP_TIMER_LINK_STATUS_MSG)
+                {
+                    APP_LINK_Tick();
+                }
+                else if(p_appMsg->msgId== APP_TIMER_L2CAP_DRAIN_MSG)
+                {
+                    APP_L2CAP_Drain();
+                }
+                else if(p_appMsg->msgId== APP_TIMER_ADV_STATUS_MSG)
+                {
+                    APP_ADV_Tick();
+                }
+                else if(p_appMsg->msgId== APP_TIMER_GROUP_APPLY_MSG)
+                {
+                    APP_GROUP_Tick();
+                }
+                else if(p_appMsg->msgId== APP_TIMER_SERVO_RAMP_MSG)
+                {
+                    APP_ServoRamp();
+                }
+                else if(p_appMsg->msgId== APP_TIMER_CAL_SAVE_MSG)
+                {
+                    APP_CAL_Tick();
+                }
+                else if(p_appMsg->msgId== APP_TIMER_ADV_ROTATE_MSG)
+                {
+                    APP_ADV_ENC_Tick();
+                }
                 else if(p_appMsg->msgId== APP_MSG_BLE_SEND_EVT)
                 {
                     const char msg[] =
@@ -241,52 +535,129 @@ void APP_Tasks ( void )
                     "        Use the commands below to control the servo motor:\n"
                     "        start   - rotate clockwise\n"
                     "        stop    - stop the motor\n"
-                    "        reverse - rotate counter-clockwise\n";
-
-                    BLE_TRSPS_SendData(conn_hdl, sizeof(msg) - 1, (uint8_t *)msg);
+                    "        reverse - rotate counter-clockwise\n"
+                    "        release - hand over control to another device\n"
+                    "        cal <start|stop|reverse|trim|ramp> <value> - calibrate\n"
+                    "        auth    - start an authenticated session\n"
+                    "        lat     - command latency, p50/p99/max per stage\n";
+                    uint16_t connHandle;
+
+                    // Reply only to the session that asked for help
+                    BUF_LE_TO_U16(&connHandle, &p_appMsg->msgData[APP_MSG_CONN_HANDLE_OFFSET]);
+                    BLE_TRSPS_SendData(connHandle, sizeof(msg) - 1, (uint8_t *)msg);
                 }
                 else if(p_appMsg->msgId==APP_MSG_BLE_DATA_EVT)
                 {
+                    uint16_t connHandle;
+                    uint8_t *p_data = &p_appMsg->msgData[APP_MSG_BLE_DATA_OFFSET];
+                    bool isAuth = false;
+
                     // Ensure string termination
                     char rxBuffer[32];  // adjust size if you expect longer data
                     memset(rxBuffer, 0, sizeof(rxBuffer));
 
+                    BUF_LE_TO_U16(&connHandle, &p_appMsg->msgData[APP_MSG_CONN_HANDLE_OFFSET]);
+                    uint16_t len = p_appMsg->msgData[APP_MSG_BLE_DATA_LEN_OFFSET];
+                    uint32_t rxStamp;
+                    const uint8_t *p_stamp = &p_appMsg->msgData[APP_MSG_BLE_DATA_STAMP_OFFSET];
+
+                    // Time the command from its reception to the PWM
+                    STREAM_LE_TO_U32(&rxStamp, &p_stamp);
+                    APP_LAT_Begin(rxStamp);
+
+                    // Authenticated frames are decrypted in place, the command follows the frame header
+                    if (APP_AUTH_IsFrame(len, p_data))
+                    {
+                        if (APP_AUTH_VerifyFrame(connHandle, &p_data, &len) == APP_RES_SUCCESS)
+                        {
+                            isAuth = true;
+                        }
+                        else
+                        {
+                            const char msg[] = "auth: rejected\n";
+
+                            BLE_TRSPS_SendData(connHandle, sizeof(msg) - 1, (uint8_t *)msg);
+                            len = 0;
+                        }
+                    }
+
                     // Copy message data safely (BLE data is not null-terminated)
-                    uint16_t len = sizeof(p_appMsg->msgData);
                     if (len >= sizeof(rxBuffer)) len = sizeof(rxBuffer) - 1;
-                    memcpy(rxBuffer, p_appMsg->msgData, len);
+                    memcpy(rxBuffer, p_data, len);
                     rxBuffer[len] = '\0'; // null-terminate for string comparison
                     
-                    SERCOM0_USART_Write((uint8_t*)rxBuffer,len);
-                    SERCOM0_USART_Write((uint8_t*)"\r\n", 2);
+                    APP_LOG_Write(APP_LOG_ID_BLE_CMD, len, rxBuffer);
 
                     // Convert to lowercase if you want case-insensitive match
                     for (uint8_t i = 0; rxBuffer[i]; i++)
                         rxBuffer[i] = tolower((unsigned char)rxBuffer[i]);
 
+                    // The flight recorder keeps the first characters of the command
+                    if (len > 0U)
+                    {
+                        uint32_t cmdChars;
+
+                        memcpy(&cmdChars, rxBuffer, sizeof(cmdChars));
+                        APP_REC_Record(APP_REC_TYPE_COMMAND, connHandle, cmdChars);
+                    }
+
                     // Compare and take action
                     if (strcmp(rxBuffer, "help") == 0)
                     {
                         APP_Msg_T appMsg;
                         appMsg.msgId = APP_MSG_BLE_SEND_EVT;
+                        U16_TO_BUF_LE(&appMsg.msgData[APP_MSG_CONN_HANDLE_OFFSET], connHandle);
                         // Send to application queue
-                        OSAL_QUEUE_Send(&appData.appQueue, &appMsg, 0);
+                        (void)APP_QUEUE_Send(&appMsg, 0);
+                    }
+                    else if (strcmp(rxBuffer, "auth") == 0)
+                    {
+                        APP_AuthCommand(connHandle);
+                    }
+                    else if (strcmp(rxBuffer, "release") == 0)
+                    {
+                        APP_SESSION_ReleaseControl(connHandle);
+                    }
+                    else if (strcmp(rxBuffer, "lat") == 0)
+                    {
+                        APP_LAT_Report(connHandle);
+                    }
+                    else if ((CONFIG_APP_AUTH_REQUIRED != 0) && (!isAuth) && (rxBuffer[0] != '\0'))
+                    {
+                        const char msg[] = "auth: required\n";
+
+                        BLE_TRSPS_SendData(connHandle, sizeof(msg) - 1, (uint8_t *)msg);
                     }
                     else if (strcmp(rxBuffer, "start") == 0)
                     {
-                        TCC0_PWM24bitDutySet(TCC0_CHANNEL1, 64000);   // Full reverse anticlockwise
+                        APP_ServoCommand(connHandle, APP_CAL_GetChannel(APP_SERVO_CH)->point[APP_CAL_POINT_FORWARD]);    // Full reverse anticlockwise
                     }
                     else if (strcmp(rxBuffer, "stop") == 0)
                     {
-                        TCC0_PWM24bitDutySet(TCC0_CHANNEL1, 96000);   // Neutral
+                        APP_ServoCommand(connHandle, APP_CAL_GetChannel(APP_SERVO_CH)->point[APP_CAL_POINT_NEUTRAL]);    // Neutral
                     }
                     else if (strcmp(rxBuffer, "reverse") == 0)
                     {
-                        TCC0_PWM24bitDutySet(TCC0_CHANNEL1, 128000);  // Full forward clockwise                        
+                        APP_ServoCommand(connHandle, APP_CAL_GetChannel(APP_SERVO_CH)->point[APP_CAL_POINT_REVERSE]);   // Full forward clockwise
+                    }
+                    else if (strncmp(rxBuffer, "cal ", 4) == 0)
+                    {
+                        APP_ServoCalCommand(connHandle, &rxBuffer[4]);
                     }
-                                        
+
+                    // Commands not applied to the PWM are not timed, setpoints are timed by their own message
+                    APP_LAT_End();
+                }
+
+                // Keep the crypto clock on only while frames are queued back to back
+                if (APP_QUEUE_IsEmpty())
+                {
+                    APP_AUTH_EndBurst();
                 }
             }
+
+            // The engine interrupt only wakes the task, the crypto jobs complete here
+            APP_CRYPTO_Poll();
             break;
         }
 
@@ -103,16 +103,47 @@ typedef enum APP_MsgId_T
     APP_MSG_ZB_STACK_EVT,
     APP_MSG_ZB_STACK_CB,
     APP_MSG_UART_CB,
-    APP_TIMER_SEND_UART_MSG,            
+    APP_MSG_NVM_CB,
+    APP_MSG_SMP_KEY_GEN,
+    APP_MSG_SERVO_SETPOINT,
+    APP_TIMER_SEND_UART_MSG,
+    APP_TIMER_CONN_POLICY_MSG,
+    APP_TIMER_LINK_STATUS_MSG,
+    APP_TIMER_L2CAP_DRAIN_MSG,
+    APP_TIMER_ADV_STATUS_MSG,
+    APP_TIMER_GROUP_APPLY_MSG,
+    APP_TIMER_SERVO_RAMP_MSG,
+    APP_TIMER_CAL_SAVE_MSG,
+    APP_TIMER_ADV_ROTATE_MSG,
     APP_MSG_STACK_END
 } APP_MsgId_T;
 
 typedef struct APP_Msg_T
 {
     uint8_t msgId;
+    uint32_t msgStamp;      // Cycle counter when queued, set by APP_QUEUE_Send
     uint8_t msgData[256];
 } APP_Msg_T;
 
+/* Layout of msgData for APP_MSG_BLE_DATA_EVT and APP_MSG_BLE_SEND_EVT. Both
+   carry the connection handle of the session, little endian.
+   APP_MSG_BLE_DATA_EVT is followed by the data length, the cycle counter when
+   the data was received and the data. */
+#define APP_MSG_CONN_HANDLE_OFFSET      (0U)
+#define APP_MSG_BLE_DATA_LEN_OFFSET     (2U)
+#define APP_MSG_BLE_DATA_STAMP_OFFSET   (3U)
+#define APP_MSG_BLE_DATA_OFFSET         (7U)
+#define APP_MSG_BLE_DATA_MAX_LEN        (256U - APP_MSG_BLE_DATA_OFFSET)
+
+/* Layout of msgData for APP_MSG_SERVO_SETPOINT, after the connection handle of
+   the session: the servo channel, the duty, little endian, and the stamps of the
+   command, APP_LAT_CMD_LEN bytes. A setpoint of the group listener carries
+   APP_MSG_CONN_HANDLE_GROUP. */
+#define APP_MSG_CONN_HANDLE_GROUP       (0xFFFFU)
+#define APP_MSG_SETPOINT_CH_OFFSET      (2U)
+#define APP_MSG_SETPOINT_DUTY_OFFSET    (3U)
+#define APP_MSG_SETPOINT_LAT_OFFSET     (7U)
+
 // *****************************************************************************
 /* Application Data
 
@@ -132,7 +163,6 @@ typedef struct
     APP_STATES state;
 
     /* TODO: Define any additional data used by the application. */
-    OSAL_QUEUE_HANDLE_TYPE appQueue;
 
 } APP_DATA;
 
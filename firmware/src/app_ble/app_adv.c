@@ -0,0 +1,481 @@
+/*******************************************************************************
+* Copyright (C) 2025 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  Application Advertising Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    app_adv.c
+
+  Summary:
+    This file contains the advertising sets of the application.
+
+  Description:
+    This file schedules the connectable advertising set and publishes the servo
+    status record in the periodic advertising of the status set.
+ *******************************************************************************/
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include <string.h>
+#include "configuration.h"
+#include "osal/osal_freertos_extend.h"
+#include "ble_gap.h"
+#include "gap_defs.h"
+#include "ble_dm/ble_dm.h"
+#include "ble_util/byte_stream.h"
+#include "app_timer/app_timer.h"
+#include "app_adv_enc.h"
+#include "app_adv.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Macros
+// *****************************************************************************
+// *****************************************************************************
+#define APP_ADV_AD_HEADER_LEN                   (4U)        // Length, AD type and company identifier.
+#define APP_ADV_PERI_DATA_LEN                   (APP_ADV_AD_HEADER_LEN + APP_ADV_STATUS_LEN)
+#define APP_ADV_TICK_TO_MS(tick)                ((uint32_t)(tick) * portTICK_PERIOD_MS)
+
+#if defined(CONFIG_APP_ADV_ENC_KEY_PLACEHOLDER) && (CONFIG_APP_ADV_ENC_ENABLE != 0)
+#error "CONFIG_APP_ADV_ENC_ENABLE needs the session key, define CONFIG_APP_ADV_ENC_KEY and CONFIG_APP_ADV_ENC_IV in the build"
+#endif
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+typedef struct APP_ADV_Status_T
+{
+    bool            isChanged;          // The record changed since it was last published.
+    bool            isHolding;          // The rate limit timer is running.
+    uint8_t         state;
+    uint8_t         faults;
+    uint16_t        seq;
+    uint32_t        position;
+    uint32_t        target;
+} APP_ADV_Status_T;
+
+typedef struct APP_ADV_Schedule_T
+{
+    APP_ADV_Phase_T             phase;
+    bool                        isMeasuring;        // A disconnection waits for the next connection.
+    TickType_t                  disconnectTick;
+    APP_ADV_ReconnectStats_T    stats;
+} APP_ADV_Schedule_T;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Global Variables
+// *****************************************************************************
+// *****************************************************************************
+static APP_ADV_Status_T         s_status;
+static APP_ADV_Schedule_T       s_schedule;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Functions
+// *****************************************************************************
+// *****************************************************************************
+static uint16_t app_adv_Publish(void)
+{
+    BLE_GAP_PeriAdvDataParams_T params;
+    uint8_t data[APP_ADV_PERI_DATA_LEN];
+    uint8_t *p_record;
+    uint16_t result;
+
+    data[0] = APP_ADV_PERI_DATA_LEN - 1U;
+    data[1] = 0xFF;     // Manufacturer Specific Data
+    U16_TO_BUF_LE(&data[2], APP_ADV_COMPANY_ID);
+
+    p_record = &data[APP_ADV_AD_HEADER_LEN];
+    p_record[APP_ADV_STATUS_OFFSET_VERSION] = APP_ADV_STATUS_VERSION;
+    U16_TO_BUF_LE(&p_record[APP_ADV_STATUS_OFFSET_SEQ], s_status.seq);
+    p_record[APP_ADV_STATUS_OFFSET_STATE] = s_status.state;
+    U32_TO_BUF_LE(&p_record[APP_ADV_STATUS_OFFSET_POSITION], s_status.position);
+    U32_TO_BUF_LE(&p_record[APP_ADV_STATUS_OFFSET_TARGET], s_status.target);
+    p_record[APP_ADV_STATUS_OFFSET_FAULTS] = s_status.faults;
+
+    if (CONFIG_APP_ADV_ENC_ENABLE != 0)
+    {
+        // Sent once encrypted, then rotated with fresh randomizers
+        result = APP_ADV_ENC_SetData(APP_ADV_PERI_DATA_LEN, data);
+    }
+    else
+    {
+        params.advHandle = APP_ADV_HANDLE_STATUS;
+        params.operation = BLE_GAP_PERIODIC_ADV_DATA_OP_COMPLETE;
+        params.advLen = APP_ADV_PERI_DATA_LEN;
+        params.p_advData = data;
+
+        result = BLE_GAP_SetPeriAdvData(&params);
+    }
+    if (result == MBA_RES_SUCCESS)
+    {
+        s_status.isChanged = false;
+    }
+
+    return result;
+}
+
+static void app_adv_Changed(void)
+{
+    s_status.isChanged = true;
+
+    // Publish at once unless a record went out less than APP_ADV_STATUS_MIN_INTERVAL_MS ago
+    if (!s_status.isHolding)
+    {
+        APP_ADV_Tick();
+    }
+}
+
+static uint8_t app_adv_SetBondedPeers(void)
+{
+    BLE_GAP_ExtAdvEnableParams_T statusEnable;
+    uint8_t devId[BLE_DM_MAX_FILTER_ACCEPT_LIST_NUM];
+    uint8_t privacyMode[BLE_DM_MAX_FILTER_ACCEPT_LIST_NUM];
+    uint8_t devCnt;
+    uint8_t i;
+
+    /* the controller list holds fewer devices than the bond store, the most recently used peers get the places */
+    BLE_DM_GetRecentPairedDeviceList((BLE_DM_MAX_FILTER_ACCEPT_LIST_NUM < BLE_DM_MAX_RESOLVING_LIST_NUM)
+        ? BLE_DM_MAX_FILTER_ACCEPT_LIST_NUM : BLE_DM_MAX_RESOLVING_LIST_NUM, devId, &devCnt);
+
+    for (i = 0; i < devCnt; i++)
+    {
+        // Device privacy mode also accepts a peer advertising its identity address
+        privacyMode[i] = BLE_GAP_PRIVACY_MODE_DEVICE;
+    }
+
+    if (devCnt == 0U)
+    {
+        return 0;
+    }
+
+    // The resolving list cannot be changed while a set advertises, the status set pauses meanwhile
+    statusEnable.advHandle = APP_ADV_HANDLE_STATUS;
+    statusEnable.duration = 0;
+    statusEnable.maxExtAdvEvts = 0;
+    (void)BLE_GAP_SetExtAdvEnable(false, 1, &statusEnable);
+
+    /* The filter accept list holds identity addresses, a peer using a resolvable private address only
+       matches them once the controller resolves it with the IRK of the resolving list. Without both lists
+       the bonded peers could not connect, so the phase then accepts every central. */
+    if ((BLE_DM_SetResolvingList(devCnt, devId, privacyMode) != MBA_RES_SUCCESS)
+        || (BLE_DM_SetFilterAcceptList(devCnt, devId) != MBA_RES_SUCCESS))
+    {
+        devCnt = 0;
+    }
+
+    (void)BLE_GAP_SetExtAdvEnable(true, 1, &statusEnable);
+
+    return devCnt;
+}
+
+static uint16_t app_adv_EnterPhase(APP_ADV_Phase_T phase)
+{
+    BLE_GAP_ExtAdvParams_T advParams;
+    BLE_GAP_ExtAdvEnableParams_T enableParams;
+    int8_t selectedTxPower;
+    uint16_t result;
+
+    enableParams.advHandle = APP_ADV_HANDLE_CONN;
+    enableParams.duration = 0;
+    enableParams.maxExtAdvEvts = 0;
+
+    // The parameters and the filter accept list cannot be changed while the set is enabled
+    (void)BLE_GAP_SetExtAdvEnable(false, 1, &enableParams);
+
+    if ((phase == APP_ADV_PHASE_RECONNECT) && (app_adv_SetBondedPeers() == 0U))
+    {
+        phase = APP_ADV_PHASE_FAST;
+    }
+
+    (void)memset(&advParams, 0, sizeof(BLE_GAP_ExtAdvParams_T));
+    advParams.advHandle = APP_ADV_HANDLE_CONN;
+    advParams.evtProperies = CONFIG_BLE_GAP_EXT_ADV_EVT_PROP;
+    advParams.priChannelMap = CONFIG_BLE_GAP_ADV_CHANNEL_MAP;
+    advParams.txPower = CONFIG_BLE_GAP_ADV_TX_PWR;
+    advParams.priPhy = BLE_GAP_PHY_TYPE_LE_1M;
+    advParams.secPhy = BLE_GAP_PHY_TYPE_LE_1M;
+
+    switch (phase)
+    {
+        case APP_ADV_PHASE_RECONNECT:
+        {
+            advParams.priIntervalMin = APP_ADV_RECONNECT_INTERVAL;
+            advParams.priIntervalMax = APP_ADV_RECONNECT_INTERVAL;
+            advParams.filterPolicy = BLE_GAP_ADV_FILTER_CONNECT;   // Other centrals still discover the device
+            enableParams.duration = APP_ADV_RECONNECT_DURATION;
+        }
+        break;
+
+        case APP_ADV_PHASE_FAST:
+        {
+            advParams.priIntervalMin = CONFIG_BLE_GAP_ADV_INTERVAL_MIN;
+            advParams.priIntervalMax = CONFIG_BLE_GAP_ADV_INTERVAL_MAX;
+            advParams.filterPolicy = CONFIG_BLE_GAP_ADV_FILT_POLICY;
+            enableParams.duration = APP_ADV_FAST_DURATION;
+        }
+        break;
+
+        default:
+        {
+            advParams.priIntervalMin = APP_ADV_SLOW_INTERVAL;
+            advParams.priIntervalMax = APP_ADV_SLOW_INTERVAL;
+            advParams.filterPolicy = CONFIG_BLE_GAP_ADV_FILT_POLICY;
+        }
+        break;
+    }
+
+    result = BLE_GAP_SetExtAdvParams(&advParams, &selectedTxPower);
+    if (result != MBA_RES_SUCCESS)
+    {
+        return result;
+    }
+
+    s_schedule.phase = phase;
+    s_schedule.stats.phase = (uint8_t)phase;
+
+    return BLE_GAP_SetExtAdvEnable(true, 1, &enableParams);
+}
+
+static void app_adv_Connected(void)
+{
+    APP_ADV_ReconnectStats_T *p_stats = &s_schedule.stats;
+    uint32_t latencyMs;
+
+    if (!s_schedule.isMeasuring)
+    {
+        return;
+    }
+
+    s_schedule.isMeasuring = false;
+    latencyMs = APP_ADV_TICK_TO_MS(xTaskGetTickCount() - s_schedule.disconnectTick);
+
+    if ((p_stats->reconnectCnt == 0U) || (latencyMs < p_stats->latencyMinMs))
+    {
+        p_stats->latencyMinMs = latencyMs;
+    }
+    if (latencyMs > p_stats->latencyMaxMs)
+    {
+        p_stats->latencyMaxMs = latencyMs;
+    }
+    if (s_schedule.phase == APP_ADV_PHASE_RECONNECT)
+    {
+        p_stats->burstCnt++;
+    }
+
+    p_stats->latencyMs = latencyMs;
+    p_stats->reconnectCnt++;
+}
+
+uint16_t APP_ADV_Init(void)
+{
+    BLE_GAP_ExtAdvParams_T advParams;
+    BLE_GAP_ExtAdvDataParams_T advData;
+    BLE_GAP_PeriAdvParams_T periParams;
+    BLE_GAP_ExtAdvEnableParams_T enableParams;
+    int8_t selectedTxPower;
+    uint16_t result;
+
+    (void)memset(&s_status, 0, sizeof(s_status));
+    (void)memset(&s_schedule, 0, sizeof(s_schedule));
+
+    (void)memset(&advParams, 0, sizeof(BLE_GAP_ExtAdvParams_T));
+    advParams.advHandle = APP_ADV_HANDLE_STATUS;
+    advParams.evtProperies = 0;         // Non-connectable and non-scannable, as required by periodic advertising
+    advParams.priIntervalMin = APP_ADV_STATUS_PRI_INTERVAL;
+    advParams.priIntervalMax = APP_ADV_STATUS_PRI_INTERVAL;
+    advParams.priChannelMap = CONFIG_BLE_GAP_ADV_CHANNEL_MAP;
+    advParams.filterPolicy = BLE_GAP_ADV_FILTER_DEFAULT;
+    advParams.txPower = CONFIG_BLE_GAP_ADV_TX_PWR;
+    advParams.priPhy = BLE_GAP_PHY_TYPE_LE_1M;
+    advParams.secPhy = BLE_GAP_PHY_TYPE_LE_1M;
+    advParams.sid = APP_ADV_STATUS_SID;
+    result = BLE_GAP_SetExtAdvParams(&advParams, &selectedTxPower);
+    if (result != MBA_RES_SUCCESS)
+    {
+        return result;
+    }
+
+    advData.advHandle = APP_ADV_HANDLE_STATUS;
+    advData.operation = BLE_GAP_EXT_ADV_DATA_OP_COMPLETE;
+    advData.fragPreference = BLE_GAP_EXT_ADV_DATA_FRAG_MIN;
+    advData.advLen = 0;
+    advData.p_advData = NULL;
+    result = BLE_GAP_SetExtAdvData(&advData);
+    if (result != MBA_RES_SUCCESS)
+    {
+        return result;
+    }
+
+    periParams.advHandle = APP_ADV_HANDLE_STATUS;
+    periParams.intervalMin = APP_ADV_STATUS_PERI_INTERVAL;
+    periParams.intervalMax = APP_ADV_STATUS_PERI_INTERVAL;
+    periParams.properties = 0;
+    result = BLE_GAP_SetPeriAdvParams(&periParams);
+    if (result != MBA_RES_SUCCESS)
+    {
+        return result;
+    }
+
+    if (CONFIG_APP_ADV_ENC_ENABLE != 0)
+    {
+        static const uint8_t encKey[APP_ADV_ENC_KEY_LEN] = CONFIG_APP_ADV_ENC_KEY;
+        static const uint8_t encIv[APP_ADV_ENC_IV_LEN] = CONFIG_APP_ADV_ENC_IV;
+
+        APP_ADV_ENC_Init(APP_ADV_HANDLE_STATUS, encKey, encIv);
+    }
+
+    result = app_adv_Publish();
+    if (result != MBA_RES_SUCCESS)
+    {
+        return result;
+    }
+
+    result = BLE_GAP_SetPeriAdvEnable(true, APP_ADV_HANDLE_STATUS);
+    if (result != MBA_RES_SUCCESS)
+    {
+        return result;
+    }
+
+    enableParams.advHandle = APP_ADV_HANDLE_STATUS;
+    enableParams.duration = 0;
+    enableParams.maxExtAdvEvts = 0;
+
+    return BLE_GAP_SetExtAdvEnable(true, 1, &enableParams);
+}
+
+uint16_t APP_ADV_Start(void)
+{
+    return app_adv_EnterPhase(APP_ADV_PHASE_FAST);
+}
+
+uint16_t APP_ADV_Reconnect(void)
+{
+    s_schedule.isMeasuring = true;
+    s_schedule.disconnectTick = xTaskGetTickCount();
+
+    return app_adv_EnterPhase(APP_ADV_PHASE_RECONNECT);
+}
+
+void APP_ADV_GapEvtHandler(BLE_GAP_Event_T *p_event)
+{
+    switch (p_event->eventId)
+    {
+        case BLE_GAP_EVT_CONNECTED:
+        {
+            if (p_event->eventField.evtConnect.status == GAP_STATUS_SUCCESS)
+            {
+                app_adv_Connected();
+            }
+        }
+        break;
+
+        case BLE_GAP_EVT_ADV_SET_TERMINATED:
+        {
+            // A connection also terminates the set, only the end of the phase duration moves the schedule on
+            if ((p_event->eventField.evtAdvSetTerminated.advHandle != APP_ADV_HANDLE_CONN)
+                || (p_event->eventField.evtAdvSetTerminated.status == GAP_STATUS_SUCCESS))
+            {
+                break;
+            }
+
+            if (s_schedule.phase == APP_ADV_PHASE_RECONNECT)
+            {
+                (void)app_adv_EnterPhase(APP_ADV_PHASE_FAST);
+            }
+            else if (s_schedule.phase == APP_ADV_PHASE_FAST)
+            {
+                (void)app_adv_EnterPhase(APP_ADV_PHASE_SLOW);
+            }
+        }
+        break;
+
+        default:
+            break;
+    }
+}
+
+void APP_ADV_GetReconnectStats(APP_ADV_ReconnectStats_T *p_stats)
+{
+    *p_stats = s_schedule.stats;
+}
+
+void APP_ADV_SetServoStatus(uint8_t state, uint32_t position, uint32_t target)
+{
+    if ((state == s_status.state) && (position == s_status.position) && (target == s_status.target))
+    {
+        return;
+    }
+
+    s_status.state = state;
+    s_status.position = position;
+    s_status.target = target;
+    app_adv_Changed();
+}
+
+void APP_ADV_SetFaults(uint8_t faults)
+{
+    if (faults == s_status.faults)
+    {
+        return;
+    }
+
+    s_status.faults = faults;
+    app_adv_Changed();
+}
+
+void APP_ADV_Tick(void)
+{
+    s_status.isHolding = false;
+
+    if (!s_status.isChanged)
+    {
+        return;
+    }
+
+    s_status.seq++;
+    if (app_adv_Publish() != MBA_RES_SUCCESS)
+    {
+        // Keep the record pending and retry after the rate limit period
+        s_status.seq--;
+    }
+
+    if (APP_TIMER_SetTimer(APP_TIMER_ADV_STATUS, APP_ADV_STATUS_MIN_INTERVAL_MS, false) == APP_RES_SUCCESS)
+    {
+        s_status.isHolding = true;
+    }
+}
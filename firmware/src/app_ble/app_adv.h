@@ -0,0 +1,333 @@
+/*******************************************************************************
+* Copyright (C) 2025 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  MPLAB Harmony Application Header File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    app_adv.h
+
+  Summary:
+    This header file provides prototypes and definitions for the advertising
+    sets of the application.
+
+  Description:
+    Two extended advertising sets are used. APP_ADV_HANDLE_CONN carries the
+    connectable advertising with legacy PDUs, so existing centrals keep finding
+    the device. Its interval follows a schedule: after a disconnection, a short
+    high duty burst accepts connections from the bonded peers only, so the
+    controller reconnects quickly. The set then advertises to everyone at the
+    configured interval, and finally backs off to a slow interval to save
+    power. The time from a disconnection to the next connection is measured.
+    APP_ADV_HANDLE_STATUS is non-connectable and carries a periodic
+    advertising train with the servo status record, so a scanner can monitor
+    many servos without connecting. The record is republished only when the
+    status changes, at most once per APP_ADV_STATUS_MIN_INTERVAL_MS. With
+    CONFIG_APP_ADV_ENC_ENABLE, the record is sent as Encrypted Advertising
+    Data, see app_adv_enc.h. The session key and IV are then given by the
+    build, the placeholder key in the sources is refused.
+*******************************************************************************/
+
+#ifndef APP_ADV_H
+#define APP_ADV_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ble_gap.h"
+#include "mba_error_defs.h"
+#include "app_error_defs.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+extern "C" {
+
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Macros
+// *****************************************************************************
+// *****************************************************************************
+#define APP_ADV_HANDLE_CONN                     (0x00U)     /* Connectable advertising set. */
+#define APP_ADV_HANDLE_STATUS                   (0x01U)     /* Status advertising set. */
+#define APP_ADV_STATUS_SID                      (0x01U)     /* Advertising SID of the status set. */
+
+#define APP_ADV_RECONNECT_INTERVAL              (32U)       /* Interval of the reconnection burst: 20 ms, the minimum for legacy PDUs. (Unit: 0.625 ms) */
+#define APP_ADV_RECONNECT_DURATION              (300U)      /* Length of the reconnection burst: 3 s. (Unit: 10 ms) */
+#define APP_ADV_FAST_DURATION                   (3000U)     /* Time advertising at the configured interval: 30 s. (Unit: 10 ms) */
+#define APP_ADV_SLOW_INTERVAL                   (1636U)     /* Interval once backed off: 1022.5 ms. (Unit: 0.625 ms) */
+
+#define APP_ADV_STATUS_PRI_INTERVAL             (1600U)     /* Primary advertising interval of the status set: 1 s. (Unit: 0.625 ms) */
+#define APP_ADV_STATUS_PERI_INTERVAL            (400U)      /* Periodic advertising interval: 500 ms. (Unit: 1.25 ms) */
+#define APP_ADV_STATUS_MIN_INTERVAL_MS          (500U)      /* Minimum time between two published records. */
+
+#define APP_ADV_COMPANY_ID                      (0x00CDU)   /* Microchip Technology Inc. */
+
+/* Servo status record, carried as manufacturer specific data. All fields are little endian. */
+#define APP_ADV_STATUS_VERSION                  (0x01U)
+#define APP_ADV_STATUS_OFFSET_VERSION           (0U)        /* Record format version. (1 byte) */
+#define APP_ADV_STATUS_OFFSET_SEQ               (1U)        /* Incremented on every published change. (2 bytes) */
+#define APP_ADV_STATUS_OFFSET_STATE             (3U)        /* See APP_ADV_ServoState_T. (1 byte) */
+#define APP_ADV_STATUS_OFFSET_POSITION          (4U)        /* PWM duty applied to the servo, in TCC0 counts. (4 bytes) */
+#define APP_ADV_STATUS_OFFSET_TARGET            (8U)        /* PWM duty last commanded, in TCC0 counts. (4 bytes) */
+#define APP_ADV_STATUS_OFFSET_FAULTS            (12U)       /* See APP_ADV_FAULT. (1 byte) */
+#define APP_ADV_STATUS_LEN                      (13U)
+
+/* Fault flags of the status record. */
+#define APP_ADV_FAULT_PWM_OFF                   (1U << 0U)  /* The servo PWM output is not running. */
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+/* Motion state of the servo. */
+typedef enum APP_ADV_ServoState_T
+{
+    APP_ADV_SERVO_STOPPED,
+    APP_ADV_SERVO_FORWARD,
+    APP_ADV_SERVO_REVERSE
+} APP_ADV_ServoState_T;
+
+/* Phase of the connectable advertising schedule. */
+typedef enum APP_ADV_Phase_T
+{
+    APP_ADV_PHASE_RECONNECT,            /* High duty, bonded peers only. */
+    APP_ADV_PHASE_FAST,                 /* Configured interval, any central. */
+    APP_ADV_PHASE_SLOW                  /* Slow interval, any central. */
+} APP_ADV_Phase_T;
+
+/* Disconnection to reconnection latency. */
+typedef struct APP_ADV_ReconnectStats_T
+{
+    uint16_t    reconnectCnt;           /* Number of reconnections measured. */
+    uint16_t    burstCnt;               /* Number of reconnections during the reconnection burst. */
+    uint32_t    latencyMs;              /* Latency of the last reconnection, in ms. */
+    uint32_t    latencyMinMs;           /* Shortest latency, in ms. */
+    uint32_t    latencyMaxMs;           /* Longest latency, in ms. */
+    uint8_t     phase;                  /* Current phase. See APP_ADV_Phase_T. */
+} APP_ADV_ReconnectStats_T;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Function Prototypes
+// *****************************************************************************
+// *****************************************************************************
+
+/*******************************************************************************
+  Function:
+    uint16_t APP_ADV_Init(void)
+
+  Summary:
+     Configure the status advertising set and start its periodic advertising.
+
+  Description:
+
+  Precondition:
+    The connectable advertising set shall be configured.
+
+  Parameters:
+    None.
+
+  Returns:
+    APP_RES_SUCCESS - The status advertising is started.
+    Other           - The status advertising could not be started.
+
+*/
+uint16_t APP_ADV_Init(void);
+
+/*******************************************************************************
+  Function:
+    uint16_t APP_ADV_Start(void)
+
+  Summary:
+     Start the connectable advertising schedule at the fast phase.
+
+  Description:
+
+  Precondition:
+
+  Parameters:
+    None.
+
+  Returns:
+    See BLE_GAP_SetExtAdvEnable.
+
+*/
+uint16_t APP_ADV_Start(void);
+
+/*******************************************************************************
+  Function:
+    uint16_t APP_ADV_Reconnect(void)
+
+  Summary:
+     Start the connectable advertising schedule after a disconnection.
+
+  Description:
+    The schedule starts with the reconnection burst if any peer is bonded,
+    and the reconnection latency is measured from now. The bonded peers are
+    programmed in the resolving list and the filter accept list, so a peer
+    using a resolvable private address is accepted. When more peers are
+    bonded than the lists hold, the most recently encrypted ones are taken.
+    If the lists cannot be programmed, the schedule starts with the
+    advertising to everyone.
+
+  Precondition:
+
+  Parameters:
+    None.
+
+  Returns:
+    See BLE_GAP_SetExtAdvEnable.
+
+*/
+uint16_t APP_ADV_Reconnect(void);
+
+/*******************************************************************************
+  Function:
+    void APP_ADV_GapEvtHandler(BLE_GAP_Event_T *p_event)
+
+  Summary:
+     Move to the next phase of the schedule and measure the reconnections.
+
+  Description:
+
+  Precondition:
+
+  Parameters:
+    p_event - Pointer to the GAP event.
+
+  Returns:
+    None.
+
+*/
+void APP_ADV_GapEvtHandler(BLE_GAP_Event_T *p_event);
+
+/*******************************************************************************
+  Function:
+    void APP_ADV_GetReconnectStats(APP_ADV_ReconnectStats_T *p_stats)
+
+  Summary:
+     Get the reconnection latency statistics.
+
+  Description:
+
+  Precondition:
+
+  Parameters:
+    p_stats - Pointer to store the statistics.
+
+  Returns:
+    None.
+
+*/
+void APP_ADV_GetReconnectStats(APP_ADV_ReconnectStats_T *p_stats);
+
+/*******************************************************************************
+  Function:
+    void APP_ADV_SetServoStatus(uint8_t state, uint32_t position, uint32_t target)
+
+  Summary:
+     Update the motion fields of the status record.
+
+  Description:
+    The record is published if any field changed.
+
+  Precondition:
+
+  Parameters:
+    state    - Motion state. See APP_ADV_ServoState_T.
+    position - PWM duty applied to the servo.
+    target   - PWM duty last commanded.
+
+  Returns:
+    None.
+
+*/
+void APP_ADV_SetServoStatus(uint8_t state, uint32_t position, uint32_t target);
+
+/*******************************************************************************
+  Function:
+    void APP_ADV_SetFaults(uint8_t faults)
+
+  Summary:
+     Update the fault flags of the status record.
+
+  Description:
+    The record is published if the flags changed.
+
+  Precondition:
+
+  Parameters:
+    faults - Fault flags. See APP_ADV_FAULT.
+
+  Returns:
+    None.
+
+*/
+void APP_ADV_SetFaults(uint8_t faults);
+
+/*******************************************************************************
+  Function:
+    void APP_ADV_Tick(void)
+
+  Summary:
+     Publish the changes held back by the rate limit.
+
+  Description:
+    This function is called on APP_TIMER_ADV_STATUS_MSG.
+
+  Precondition:
+
+  Parameters:
+    None.
+
+  Returns:
+    None.
+
+*/
+void APP_ADV_Tick(void);
+
+//DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+//DOM-IGNORE-END
+
+#endif /* APP_ADV_H */
+
+
+/*******************************************************************************
+ End of File
+ */
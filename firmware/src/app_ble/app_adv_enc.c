@@ -0,0 +1,329 @@
+/*******************************************************************************
+* Copyright (C) 2025 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  Application Encrypted Advertising Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    app_adv_enc.c
+
+  Summary:
+    This file contains the encrypted advertising data rotation of the
+    application.
+
+  Description:
+    This file keeps a few payloads of the advertising data encrypted ahead.
+    The payloads are encrypted by crypto jobs, in the Encrypted Data AD type
+    format of MW_MISC_EncryptAdvData, and the rotation timer only swaps them
+    in.
+ *******************************************************************************/
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include <string.h>
+#include "ble_gap.h"
+#include "mba_error_defs.h"
+#include "ble_util/mw_entropy.h"
+#include "ble_util/byte_stream.h"
+#include "app_crypto/app_crypto.h"
+#include "app_timer/app_timer.h"
+#include "app_error_defs.h"
+#include "app_adv_enc.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Macros
+// *****************************************************************************
+// *****************************************************************************
+#define APP_ADV_ENC_AD_TYPE                     (0x31U)     /* Encrypted Data. */
+#define APP_ADV_ENC_AAD                         (0xEAU)
+#define APP_ADV_ENC_RANDOMIZER_LEN              (5U)
+#define APP_ADV_ENC_MIC_LEN                     (4U)
+#define APP_ADV_ENC_NONCE_LEN                   (APP_ADV_ENC_RANDOMIZER_LEN + APP_ADV_ENC_IV_LEN)
+#define APP_ADV_ENC_HEADER_LEN                  (2U + APP_ADV_ENC_RANDOMIZER_LEN)
+#define APP_ADV_ENC_SLOT_NONE                   (0xFFU)
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+typedef enum APP_ADV_ENC_SlotState_T
+{
+    APP_ADV_ENC_SLOT_FREE,
+    APP_ADV_ENC_SLOT_BUSY,              // The payload is being encrypted.
+    APP_ADV_ENC_SLOT_READY,             // The payload waits for its turn.
+    APP_ADV_ENC_SLOT_ON_AIR             // The payload was handed to the controller last.
+} APP_ADV_ENC_SlotState_T;
+
+typedef struct APP_ADV_ENC_Slot_T
+{
+    uint8_t         state;
+    uint8_t         gen;                // Generation of the data the payload is encrypted from.
+    uint8_t         len;
+    uint8_t         nonce[APP_ADV_ENC_NONCE_LEN];
+    uint8_t         payload[APP_ADV_ENC_OVERHEAD + APP_ADV_ENC_DATA_MAX];
+} APP_ADV_ENC_Slot_T;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Global Variables
+// *****************************************************************************
+// *****************************************************************************
+static const uint8_t            s_aad = APP_ADV_ENC_AAD;
+static APP_ADV_ENC_Slot_T       s_slot[APP_ADV_ENC_SLOT_NUM];
+static uint8_t                  s_key[APP_ADV_ENC_KEY_LEN];
+static uint8_t                  s_iv[APP_ADV_ENC_IV_LEN];
+static uint8_t                  s_data[APP_ADV_ENC_DATA_MAX];
+static uint8_t                  s_dataLen;
+static uint8_t                  s_gen;
+static uint8_t                  s_onAir;            // Slot handed to the controller last.
+static bool                     s_isStale;          // The payload on air is not from the current data.
+static uint8_t                  s_advHandle;
+static APP_ADV_ENC_Stats_T      s_stats;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Functions
+// *****************************************************************************
+// *****************************************************************************
+static void app_adv_enc_Rotate(void);
+static void app_adv_enc_Fill(void);
+
+static void app_adv_enc_Encrypted(uint16_t result, uintptr_t context)
+{
+    APP_ADV_ENC_Slot_T *p_slot = &s_slot[context];
+
+    if (result != APP_RES_SUCCESS)
+    {
+        // Retried on the next rotation
+        s_stats.failCnt++;
+        p_slot->state = APP_ADV_ENC_SLOT_FREE;
+        return;
+    }
+
+    if (p_slot->gen != s_gen)
+    {
+        s_stats.discardCnt++;
+        p_slot->state = APP_ADV_ENC_SLOT_FREE;
+        app_adv_enc_Fill();
+        return;
+    }
+
+    s_stats.encryptCnt++;
+    p_slot->state = APP_ADV_ENC_SLOT_READY;
+
+    if (s_isStale)
+    {
+        app_adv_enc_Rotate();
+    }
+}
+
+static void app_adv_enc_Fill(void)
+{
+    APP_CRYPTO_Job_T job;
+    APP_ADV_ENC_Slot_T *p_slot;
+    uint8_t i;
+
+    if (s_dataLen == 0U)
+    {
+        return;
+    }
+
+    (void)memset(&job, 0, sizeof(job));
+    job.op = APP_CRYPTO_OP_CCM_ENC;
+    job.p_key = s_key;
+    job.nonceLen = APP_ADV_ENC_NONCE_LEN;
+    job.tagLen = APP_ADV_ENC_MIC_LEN;
+    job.p_aad = &s_aad;
+    job.aadLen = sizeof(s_aad);
+    job.p_in = s_data;
+    job.length = s_dataLen;
+    job.cb = app_adv_enc_Encrypted;
+
+    for (i = 0; i < APP_ADV_ENC_SLOT_NUM; i++)
+    {
+        p_slot = &s_slot[i];
+        if (p_slot->state != APP_ADV_ENC_SLOT_FREE)
+        {
+            continue;
+        }
+
+        // A fresh randomizer for each payload, it is also the start of the nonce
+        if (MW_ENTROPY_Get(&p_slot->payload[2], APP_ADV_ENC_RANDOMIZER_LEN) != MBA_RES_SUCCESS)
+        {
+            s_stats.failCnt++;
+            return;
+        }
+
+        p_slot->gen = s_gen;
+        p_slot->len = s_dataLen + APP_ADV_ENC_OVERHEAD;
+        p_slot->payload[0] = p_slot->len - 1U;
+        p_slot->payload[1] = APP_ADV_ENC_AD_TYPE;
+        (void)memcpy(p_slot->nonce, &p_slot->payload[2], APP_ADV_ENC_RANDOMIZER_LEN);
+        (void)memcpy(&p_slot->nonce[APP_ADV_ENC_RANDOMIZER_LEN], s_iv, APP_ADV_ENC_IV_LEN);
+
+        job.p_nonce = p_slot->nonce;
+        job.p_out = &p_slot->payload[APP_ADV_ENC_HEADER_LEN];
+        job.p_tag = &p_slot->payload[APP_ADV_ENC_HEADER_LEN + s_dataLen];
+        job.context = i;
+
+        p_slot->state = APP_ADV_ENC_SLOT_BUSY;
+        if (APP_CRYPTO_Submit(&job) != APP_RES_SUCCESS)
+        {
+            p_slot->state = APP_ADV_ENC_SLOT_FREE;
+            return;
+        }
+    }
+}
+
+static void app_adv_enc_Rotate(void)
+{
+    BLE_GAP_PeriAdvDataParams_T params;
+    APP_ADV_ENC_Slot_T *p_slot = NULL;
+    uint8_t index = 0;
+    uint8_t i;
+
+    // Take the slots in turn, starting after the one on air
+    for (i = 1; i <= APP_ADV_ENC_SLOT_NUM; i++)
+    {
+        index = (uint8_t)((s_onAir + i) % APP_ADV_ENC_SLOT_NUM);
+        if (s_slot[index].state == APP_ADV_ENC_SLOT_READY)
+        {
+            p_slot = &s_slot[index];
+            break;
+        }
+    }
+
+    if (p_slot == NULL)
+    {
+        s_stats.missCnt++;
+        app_adv_enc_Fill();
+        return;
+    }
+
+    params.advHandle = s_advHandle;
+    params.operation = BLE_GAP_PERIODIC_ADV_DATA_OP_COMPLETE;
+    params.advLen = p_slot->len;
+    params.p_advData = p_slot->payload;
+    if (BLE_GAP_SetPeriAdvData(&params) != MBA_RES_SUCCESS)
+    {
+        return;
+    }
+
+    if ((s_onAir < APP_ADV_ENC_SLOT_NUM) && (s_slot[s_onAir].state == APP_ADV_ENC_SLOT_ON_AIR))
+    {
+        s_slot[s_onAir].state = APP_ADV_ENC_SLOT_FREE;
+    }
+    p_slot->state = APP_ADV_ENC_SLOT_ON_AIR;
+    s_onAir = index;
+    s_isStale = false;
+    s_stats.rotateCnt++;
+
+    // Replace the payload which went off air
+    app_adv_enc_Fill();
+}
+
+void APP_ADV_ENC_Init(uint8_t advHandle, const uint8_t *p_key, const uint8_t *p_iv)
+{
+    (void)memset(s_slot, 0, sizeof(s_slot));
+    (void)memset(&s_stats, 0, sizeof(s_stats));
+    // The key material is given least significant octet first, as MW_MISC_EncryptAdvData takes it
+    BUF_TO_VARIABLE(s_key, p_key, APP_ADV_ENC_KEY_LEN);
+    (void)memcpy(s_iv, p_iv, APP_ADV_ENC_IV_LEN);
+    s_advHandle = advHandle;
+    s_dataLen = 0;
+    s_gen = 0;
+    s_onAir = APP_ADV_ENC_SLOT_NONE;
+    s_isStale = false;
+
+    (void)APP_TIMER_SetTimer(APP_TIMER_ADV_ROTATE, APP_ADV_ENC_ROTATE_MS, true);
+}
+
+uint16_t APP_ADV_ENC_SetData(uint8_t len, const uint8_t *p_data)
+{
+    uint8_t i;
+
+    if ((len == 0U) || (len > APP_ADV_ENC_DATA_MAX))
+    {
+        return APP_RES_INVALID_PARA;
+    }
+
+    if ((len == s_dataLen) && (memcmp(p_data, s_data, len) == 0))
+    {
+        return APP_RES_SUCCESS;
+    }
+
+    // Jobs still running for the previous data are discarded when they complete
+    (void)memcpy(s_data, p_data, len);
+    s_dataLen = len;
+    s_gen++;
+    s_isStale = true;
+
+    for (i = 0; i < APP_ADV_ENC_SLOT_NUM; i++)
+    {
+        if (s_slot[i].state == APP_ADV_ENC_SLOT_READY)
+        {
+            s_slot[i].state = APP_ADV_ENC_SLOT_FREE;
+        }
+    }
+
+    app_adv_enc_Fill();
+
+    return APP_RES_SUCCESS;
+}
+
+void APP_ADV_ENC_Tick(void)
+{
+    app_adv_enc_Rotate();
+}
+
+void APP_ADV_ENC_GetStats(APP_ADV_ENC_Stats_T *p_stats)
+{
+    uint8_t i;
+
+    *p_stats = s_stats;
+    p_stats->readyNum = 0;
+    for (i = 0; i < APP_ADV_ENC_SLOT_NUM; i++)
+    {
+        if (s_slot[i].state == APP_ADV_ENC_SLOT_READY)
+        {
+            p_stats->readyNum++;
+        }
+    }
+}
+
+
+/*******************************************************************************
+ End of File
+ */
@@ -0,0 +1,201 @@
+/*******************************************************************************
+* Copyright (C) 2025 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  MPLAB Harmony Application Header File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    app_adv_enc.h
+
+  Summary:
+    This header file provides prototypes and definitions for the encrypted
+    advertising data rotation of the application.
+
+  Description:
+    The advertising data of a periodic train is sent as Encrypted Advertising
+    Data. Each payload carries a new random randomizer, so that the same data
+    cannot be tracked from one payload to the next. APP_ADV_ENC_SLOT_NUM
+    payloads of the current data are encrypted ahead on the crypto engine,
+    and every APP_ADV_ENC_ROTATE_MS the next one is handed to the controller.
+    No encryption is done on the rotation path. When the data changes, the
+    first payload of the new data goes out as soon as it is encrypted.
+*******************************************************************************/
+
+#ifndef APP_ADV_ENC_H
+#define APP_ADV_ENC_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+extern "C" {
+
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Macros
+// *****************************************************************************
+// *****************************************************************************
+#define APP_ADV_ENC_SLOT_NUM                    (4U)        /* Payloads encrypted ahead, including the one on air. */
+#define APP_ADV_ENC_ROTATE_MS                   (5000U)     /* Time between two payloads of the same data. */
+#define APP_ADV_ENC_DATA_MAX                    (32U)       /* Largest advertising data to encrypt. */
+#define APP_ADV_ENC_KEY_LEN                     (16U)       /* Session key of the Encrypted Data Key Material. */
+#define APP_ADV_ENC_IV_LEN                      (8U)        /* IV of the Encrypted Data Key Material. */
+#define APP_ADV_ENC_OVERHEAD                    (11U)       /* AD header, randomizer and MIC. */
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+typedef struct APP_ADV_ENC_Stats_T
+{
+    uint32_t    encryptCnt;             /* Payloads encrypted. */
+    uint32_t    discardCnt;             /* Payloads encrypted for data changed meanwhile. */
+    uint32_t    rotateCnt;              /* Payloads handed to the controller. */
+    uint32_t    missCnt;                /* Rotations with no payload ready. */
+    uint32_t    failCnt;                /* Payloads which could not be encrypted. */
+    uint8_t     readyNum;               /* Payloads ready now, the one on air excluded. */
+} APP_ADV_ENC_Stats_T;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Function Prototypes
+// *****************************************************************************
+// *****************************************************************************
+
+/*******************************************************************************
+  Function:
+    void APP_ADV_ENC_Init(uint8_t advHandle, const uint8_t *p_key, const uint8_t *p_iv)
+
+  Summary:
+     Start the rotation of the encrypted periodic advertising data of a set.
+
+  Description:
+     Nothing is sent until APP_ADV_ENC_SetData is called.
+
+  Precondition:
+    The periodic advertising of the set shall be configured.
+
+  Parameters:
+    advHandle - Advertising set handle.
+    p_key     - Pointer to the APP_ADV_ENC_KEY_LEN bytes session key, least
+                significant octet first, as MW_MISC_EncryptAdvData takes it.
+    p_iv      - Pointer to the APP_ADV_ENC_IV_LEN bytes IV.
+
+  Returns:
+    None.
+
+*/
+void APP_ADV_ENC_Init(uint8_t advHandle, const uint8_t *p_key, const uint8_t *p_iv);
+
+/*******************************************************************************
+  Function:
+    uint16_t APP_ADV_ENC_SetData(uint8_t len, const uint8_t *p_data)
+
+  Summary:
+     Set the advertising data to encrypt.
+
+  Description:
+     The payloads of the previous data are dropped. The new data is sent once
+     its first payload is encrypted.
+
+  Precondition:
+
+  Parameters:
+    len    - Length of the advertising data, at most APP_ADV_ENC_DATA_MAX.
+    p_data - Pointer to the advertising data, in AD structures.
+
+  Returns:
+    APP_RES_SUCCESS      - The data is taken.
+    APP_RES_INVALID_PARA - The data is too long.
+
+*/
+uint16_t APP_ADV_ENC_SetData(uint8_t len, const uint8_t *p_data);
+
+/*******************************************************************************
+  Function:
+    void APP_ADV_ENC_Tick(void)
+
+  Summary:
+     Hand the next encrypted payload to the controller.
+
+  Description:
+     Called on the APP_TIMER_ADV_ROTATE_MSG message.
+
+  Precondition:
+
+  Parameters:
+    None.
+
+  Returns:
+    None.
+
+*/
+void APP_ADV_ENC_Tick(void);
+
+/*******************************************************************************
+  Function:
+    void APP_ADV_ENC_GetStats(APP_ADV_ENC_Stats_T *p_stats)
+
+  Summary:
+     Get the rotation statistics.
+
+  Description:
+
+  Precondition:
+
+  Parameters:
+    p_stats - Pointer to where the statistics are stored.
+
+  Returns:
+    None.
+
+*/
+void APP_ADV_ENC_GetStats(APP_ADV_ENC_Stats_T *p_stats);
+
+//DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+//DOM-IGNORE-END
+
+#endif /* APP_ADV_ENC_H */
+
+
+/*******************************************************************************
+ End of File
+ */
@@ -0,0 +1,313 @@
+/*******************************************************************************
+* Copyright (C) 2025 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  Application Authentication Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    app_auth.c
+
+  Summary:
+    This file contains the authenticated command frames of the application.
+
+  Description:
+    This file derives a session key per connection from the pre-shared key and
+    a random salt, and verifies the AES-CCM frames carrying the commands. The
+    CCM key of a session is loaded into its context once, when the first frame
+    is verified, and is reused for the following frames.
+ *******************************************************************************/
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include <string.h>
+#include "definitions.h"
+#include "osal/osal_freertos_extend.h"
+#include "ble_util/mw_conn.h"
+#include "ble_util/mw_aes.h"
+#include "ble_util/mw_entropy.h"
+#include "ble_util/byte_stream.h"
+#include "app_error_defs.h"
+#include "app_auth.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Macros
+// *****************************************************************************
+// *****************************************************************************
+#define APP_AUTH_NONCE_LEN                      (13U)       /* Salt, counter and direction. */
+#define APP_AUTH_DIR_RX                         (0x00U)     /* Direction of the frames from the central. */
+#define APP_AUTH_KDF_LABEL                      "SRVOAUTH"  /* Completes the salt to an AES block for the key derivation. */
+
+#if defined(CONFIG_APP_AUTH_PSK_PLACEHOLDER)
+#if (CONFIG_APP_AUTH_REQUIRED != 0)
+#error "CONFIG_APP_AUTH_REQUIRED needs the plant key, define CONFIG_APP_AUTH_PSK in the build"
+#endif
+#define APP_AUTH_IS_PSK_SET                     (false)     /* The placeholder key is public, a session with it would prove nothing. */
+#else
+#define APP_AUTH_IS_PSK_SET                     (true)
+#endif
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+typedef struct APP_AUTH_Session_T
+{
+    bool            inUse;              // Session is started.
+    bool            isKeyLoaded;        // The session key is loaded into ctx.
+    uint16_t        connHandle;         // Connection handle of the session.
+    uint32_t        rxCounter;          // Counter of the last accepted frame.
+    uint8_t         salt[APP_AUTH_SALT_LEN];
+    uint8_t         key[APP_AUTH_KEY_LEN];
+    MW_AES_Ctx_T    ctx;                // CCM context, keeps the key reference between frames.
+} APP_AUTH_Session_T;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Global Variables
+// *****************************************************************************
+// *****************************************************************************
+static APP_AUTH_Session_T       s_session[MW_CONN_MAX_NBR];
+static bool                     s_isClkHeld;
+static APP_AUTH_Stats_T         s_stats;
+static uint8_t                  s_psk[APP_AUTH_KEY_LEN] = CONFIG_APP_AUTH_PSK;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Functions
+// *****************************************************************************
+// *****************************************************************************
+static APP_AUTH_Session_T *app_auth_GetSession(uint16_t connHandle)
+{
+    uint8_t index;
+
+    index = MW_CONN_GetIndex(connHandle);
+    if ((index >= MW_CONN_MAX_NBR) || (!s_session[index].inUse) || (s_session[index].connHandle != connHandle))
+    {
+        return NULL;
+    }
+
+    return &s_session[index];
+}
+
+static void app_auth_Wipe(APP_AUTH_Session_T *p_session)
+{
+    volatile uint8_t *p_byte = (volatile uint8_t *)p_session;
+    uint16_t i;
+
+    // A volatile access keeps the key from being left in RAM by an optimized memset.
+    for (i = 0; i < sizeof(APP_AUTH_Session_T); i++)
+    {
+        p_byte[i] = 0U;
+    }
+}
+
+static uint16_t app_auth_DeriveKey(APP_AUTH_Session_T *p_session)
+{
+    MW_AES_Ctx_T ctx;
+    uint8_t block[APP_AUTH_KEY_LEN];
+    uint16_t result;
+
+    // K = AES-128(PSK, salt || label)
+    memcpy(block, p_session->salt, APP_AUTH_SALT_LEN);
+    memcpy(&block[APP_AUTH_SALT_LEN], APP_AUTH_KDF_LABEL, APP_AUTH_KEY_LEN - APP_AUTH_SALT_LEN);
+
+    result = MW_AES_EcbEncryptInit(&ctx, s_psk);
+    if (result == APP_RES_SUCCESS)
+    {
+        result = MW_AES_AesEcbEncrypt(&ctx, APP_AUTH_KEY_LEN, p_session->key, block);
+    }
+
+    memset(&ctx, 0, sizeof(ctx));
+
+    return result;
+}
+
+void APP_AUTH_Init(void)
+{
+    memset(s_session, 0, sizeof(s_session));
+    memset(&s_stats, 0, sizeof(s_stats));
+    s_isClkHeld = false;
+
+    // The cycle counter times the frame verification.
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+uint16_t APP_AUTH_Start(uint16_t connHandle, uint8_t *p_salt)
+{
+    APP_AUTH_Session_T *p_session;
+    uint8_t index;
+
+    if (!APP_AUTH_IS_PSK_SET)
+    {
+        return APP_RES_BAD_STATE;
+    }
+
+    index = MW_CONN_GetIndex(connHandle);
+    if (index >= MW_CONN_MAX_NBR)
+    {
+        return APP_RES_INVALID_PARA;
+    }
+
+    p_session = &s_session[index];
+    app_auth_Wipe(p_session);
+
+    if ((MW_ENTROPY_Get(p_session->salt, APP_AUTH_SALT_LEN) != APP_RES_SUCCESS)
+        || (app_auth_DeriveKey(p_session) != APP_RES_SUCCESS))
+    {
+        app_auth_Wipe(p_session);
+        return APP_RES_FAIL;
+    }
+
+    p_session->connHandle = connHandle;
+    p_session->inUse = true;
+    memcpy(p_salt, p_session->salt, APP_AUTH_SALT_LEN);
+
+    return APP_RES_SUCCESS;
+}
+
+void APP_AUTH_Stop(uint16_t connHandle)
+{
+    APP_AUTH_Session_T *p_session;
+
+    p_session = app_auth_GetSession(connHandle);
+    if (p_session != NULL)
+    {
+        app_auth_Wipe(p_session);
+    }
+}
+
+bool APP_AUTH_IsFrame(uint16_t len, const uint8_t *p_data)
+{
+    return ((len > 0U) && (p_data[0] == APP_AUTH_FRAME_MAGIC));
+}
+
+uint16_t APP_AUTH_VerifyFrame(uint16_t connHandle, uint8_t **pp_data, uint16_t *p_len)
+{
+    APP_AUTH_Session_T *p_session;
+    uint8_t nonce[APP_AUTH_NONCE_LEN];
+    uint8_t *p_frame = *pp_data;
+    uint8_t *p_cipher;
+    uint8_t *p_buf;
+    uint16_t cipherLen;
+    uint32_t counter;
+    uint32_t startCycles;
+    uint32_t cycles;
+    uint16_t result;
+
+    if (*p_len <= APP_AUTH_FRAME_OVERHEAD)
+    {
+        s_stats.failCnt++;
+        return APP_RES_INVALID_PARA;
+    }
+
+    p_session = app_auth_GetSession(connHandle);
+    if (p_session == NULL)
+    {
+        s_stats.failCnt++;
+        return APP_RES_BAD_STATE;
+    }
+
+    p_buf = &p_frame[1];
+    STREAM_LE_TO_U32(&counter, &p_buf);
+    if (counter <= p_session->rxCounter)
+    {
+        s_stats.replayCnt++;
+        return APP_RES_FAIL;
+    }
+
+    startCycles = DWT->CYCCNT;
+
+    if (!s_isClkHeld)
+    {
+        MW_AES_HoldClock(true);
+        s_isClkHeld = true;
+    }
+
+    memcpy(nonce, p_session->salt, APP_AUTH_SALT_LEN);
+    U32_TO_BUF_LE(&nonce[APP_AUTH_SALT_LEN], counter);
+    nonce[APP_AUTH_NONCE_LEN - 1U] = APP_AUTH_DIR_RX;
+
+    p_cipher = p_buf;
+    cipherLen = *p_len - APP_AUTH_FRAME_OVERHEAD;
+
+    result = MW_AES_CcmDecryptInit(&p_session->ctx, p_session->isKeyLoaded ? NULL : p_session->key,
+        nonce, APP_AUTH_NONCE_LEN, APP_AUTH_TAG_LEN, p_frame, APP_AUTH_HEADER_LEN, cipherLen);
+    if (result == APP_RES_SUCCESS)
+    {
+        p_session->isKeyLoaded = true;
+        result = MW_AES_AesCcmDecrypt(&p_session->ctx, cipherLen, p_cipher, p_cipher + cipherLen, p_cipher);
+    }
+
+    cycles = DWT->CYCCNT - startCycles;
+    s_stats.verifyCyclesLast = cycles;
+    if (cycles > s_stats.verifyCyclesMax)
+    {
+        s_stats.verifyCyclesMax = cycles;
+    }
+
+    if (result != APP_RES_SUCCESS)
+    {
+        s_stats.failCnt++;
+        return APP_RES_FAIL;
+    }
+
+    p_session->rxCounter = counter;
+    s_stats.verifyCnt++;
+
+    *pp_data = p_cipher;
+    *p_len = cipherLen;
+
+    return APP_RES_SUCCESS;
+}
+
+void APP_AUTH_EndBurst(void)
+{
+    if (s_isClkHeld)
+    {
+        s_isClkHeld = false;
+        MW_AES_HoldClock(false);
+    }
+}
+
+void APP_AUTH_GetStats(APP_AUTH_Stats_T *p_stats)
+{
+    *p_stats = s_stats;
+}
+
+
+/*******************************************************************************
+ End of File
+ */
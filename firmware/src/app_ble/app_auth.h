@@ -0,0 +1,268 @@
+/*******************************************************************************
+* Copyright (C) 2025 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  MPLAB Harmony Application Header File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    app_auth.h
+
+  Summary:
+    This header file provides prototypes and definitions for the authenticated
+    command frames of the application.
+
+  Description:
+    A central starts an authenticated session with the "auth" command. The
+    device replies with a random session salt, and both sides derive the
+    session key from the pre-shared key and the salt. Each command is then
+    sent as a frame protected by AES-CCM:
+
+        magic (1) | counter (4, little endian) | encrypted command | tag (8)
+
+    The header is authenticated as well. The counter of a session must
+    increase from frame to frame, so that a recorded frame cannot be replayed.
+    Frames are verified and decrypted in place, in the received message.
+*******************************************************************************/
+
+#ifndef APP_AUTH_H
+#define APP_AUTH_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+extern "C" {
+
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Macros
+// *****************************************************************************
+// *****************************************************************************
+#define APP_AUTH_FRAME_MAGIC                    (0xA5U)     /* First byte of an authenticated frame. Commands are text, so they never start with it. */
+#define APP_AUTH_HEADER_LEN                     (5U)        /* Magic and counter. */
+#define APP_AUTH_TAG_LEN                        (8U)
+#define APP_AUTH_FRAME_OVERHEAD                 (APP_AUTH_HEADER_LEN + APP_AUTH_TAG_LEN)
+#define APP_AUTH_SALT_LEN                       (8U)
+#define APP_AUTH_KEY_LEN                        (16U)
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+typedef struct APP_AUTH_Stats_T
+{
+    uint32_t        verifyCnt;          /* Frames verified successfully. */
+    uint32_t        failCnt;            /* Frames with a wrong tag or without a session. */
+    uint32_t        replayCnt;          /* Frames with a counter not above the last one. */
+    uint32_t        verifyCyclesLast;   /* CPU cycles spent verifying the last frame. */
+    uint32_t        verifyCyclesMax;    /* Most CPU cycles spent verifying a frame. */
+} APP_AUTH_Stats_T;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Function Prototypes
+// *****************************************************************************
+// *****************************************************************************
+
+/*******************************************************************************
+  Function:
+    void APP_AUTH_Init(void)
+
+  Summary:
+     Initialize the authenticated sessions.
+
+  Description:
+
+  Precondition:
+
+  Parameters:
+    None.
+
+  Returns:
+    None.
+
+*/
+void APP_AUTH_Init(void);
+
+/*******************************************************************************
+  Function:
+    uint16_t APP_AUTH_Start(uint16_t connHandle, uint8_t *p_salt)
+
+  Summary:
+     Start a new authenticated session on a connection.
+
+  Description:
+     A new random salt is drawn and the session key is derived from it. The
+     counter of the session restarts, frames of a previous session of the
+     connection are no longer accepted.
+
+  Precondition:
+
+  Parameters:
+    connHandle - Connection handle.
+    p_salt     - Pointer to where the APP_AUTH_SALT_LEN bytes of salt are stored.
+
+  Returns:
+    APP_RES_SUCCESS      - The session is started.
+    APP_RES_INVALID_PARA - The connection does not exist.
+    APP_RES_FAIL         - No random number is available.
+    APP_RES_BAD_STATE    - The build holds the placeholder pre-shared key.
+
+*/
+uint16_t APP_AUTH_Start(uint16_t connHandle, uint8_t *p_salt);
+
+/*******************************************************************************
+  Function:
+    void APP_AUTH_Stop(uint16_t connHandle)
+
+  Summary:
+     Stop the authenticated session of a connection and wipe its key.
+
+  Description:
+
+  Precondition:
+
+  Parameters:
+    connHandle - Connection handle.
+
+  Returns:
+    None.
+
+*/
+void APP_AUTH_Stop(uint16_t connHandle);
+
+/*******************************************************************************
+  Function:
+    bool APP_AUTH_IsFrame(uint16_t len, const uint8_t *p_data)
+
+  Summary:
+     Check if received data is an authenticated frame.
+
+  Description:
+
+  Precondition:
+
+  Parameters:
+    len    - Length of the data.
+    p_data - Pointer to the data.
+
+  Returns:
+    true if the data is an authenticated frame, false if it is a plain command.
+
+*/
+bool APP_AUTH_IsFrame(uint16_t len, const uint8_t *p_data);
+
+/*******************************************************************************
+  Function:
+    uint16_t APP_AUTH_VerifyFrame(uint16_t connHandle, uint8_t **pp_data, uint16_t *p_len)
+
+  Summary:
+     Verify and decrypt an authenticated frame in place.
+
+  Description:
+     The crypto clock is kept on until APP_AUTH_EndBurst is called, so that
+     back to back frames do not turn it on and off for each one.
+
+  Precondition:
+
+  Parameters:
+    connHandle - Connection handle the frame was received on.
+    pp_data    - Pointer to the frame. Updated to point to the command on success.
+    p_len      - Pointer to the length of the frame. Updated to the length of the command on success.
+
+  Returns:
+    APP_RES_SUCCESS      - The frame is authentic.
+    APP_RES_INVALID_PARA - The frame is too short.
+    APP_RES_BAD_STATE    - No session is started on the connection.
+    APP_RES_FAIL         - The frame is replayed or its tag is wrong. The frame content is undefined.
+
+*/
+uint16_t APP_AUTH_VerifyFrame(uint16_t connHandle, uint8_t **pp_data, uint16_t *p_len);
+
+/*******************************************************************************
+  Function:
+    void APP_AUTH_EndBurst(void)
+
+  Summary:
+     Turn the crypto clock off once no more frame is waiting.
+
+  Description:
+
+  Precondition:
+
+  Parameters:
+    None.
+
+  Returns:
+    None.
+
+*/
+void APP_AUTH_EndBurst(void);
+
+/*******************************************************************************
+  Function:
+    void APP_AUTH_GetStats(APP_AUTH_Stats_T *p_stats)
+
+  Summary:
+     Get the frame verification statistics.
+
+  Description:
+
+  Precondition:
+
+  Parameters:
+    p_stats - Pointer to where the statistics are stored.
+
+  Returns:
+    None.
+
+*/
+void APP_AUTH_GetStats(APP_AUTH_Stats_T *p_stats);
+
+//DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+//DOM-IGNORE-END
+
+#endif /* APP_AUTH_H */
+
+
+/*******************************************************************************
+ End of File
+ */
@@ -47,6 +47,11 @@
 
 
 #include "app_trsps_handler.h"
+#include "ble_lss/ble_lss.h"
+#include "app_adv.h"
+#include "app_group.h"
+#include "app_rec/app_rec.h"
+#include "app_queue/app_queue.h"
 
 
 
@@ -94,6 +99,7 @@ static void APP_BleStackCb(STACK_Event_T *p_stack)
     stackEvent.p_event=OSAL_Malloc(p_stack->evtLen);
     if(stackEvent.p_event==NULL)
     {
+        APP_REC_Record(APP_REC_TYPE_HEAP_FAIL, p_stack->evtLen, xPortGetFreeHeapSize());
         return;
     }
     (void)memcpy(stackEvent.p_event, p_stack->p_event, p_stack->evtLen);
@@ -123,11 +129,14 @@ static void APP_BleStackCb(STACK_Event_T *p_stack)
     ((STACK_Event_T *)appMsg.msgData)->p_event=stackEvent.p_event;
 
     p_appMsg = &appMsg;
-    OSAL_QUEUE_Send(&appData.appQueue, p_appMsg, 0);
+    (void)APP_QUEUE_Send(p_appMsg, 0);
 }
 
 void APP_BleStackEvtHandler(STACK_Event_T *p_stackEvt)
 {
+    //Assign connection slot before the event is dispatched
+    MW_CONN_BleEventHandler(p_stackEvt);
+
     switch(p_stackEvt->groupId)
     {
         case STACK_GRP_BLE_GAP:
@@ -167,15 +176,8 @@ void APP_BleStackEvtHandler(STACK_Event_T *p_stackEvt)
     /* Transparent Profile */
     BLE_TRSPS_BleEventHandler(p_stackEvt);
 
-
-
-
-
-
-
-
-
-
+    //Release connection slot after all modules have processed the event
+    MW_CONN_BleEventPostHandler(p_stackEvt);
 
     OSAL_Free(p_stackEvt->p_event);
 }
@@ -189,11 +191,11 @@ static void APP_BleConfigBasic(void)
 {
     int8_t                          connTxPower;
     int8_t                          advTxPower;
-    BLE_GAP_AdvParams_T             advParam;
+    BLE_GAP_ExtAdvParams_T          advParam;
     uint8_t advData[]=CONFIG_BLE_GAP_ADV_DATA;
-    BLE_GAP_AdvDataParams_T         appAdvData;
+    BLE_GAP_ExtAdvDataParams_T      appAdvData;
     uint8_t scanRspData[]=CONFIG_BLE_GAP_SCAN_RSP_DATA;
-    BLE_GAP_AdvDataParams_T         appScanRspData;
+    BLE_GAP_ExtAdvDataParams_T      appScanRspData;
     BLE_GAP_Addr_T devAddr;
     devAddr.addrType = BLE_GAP_ADDR_TYPE_PUBLIC;
     devAddr.addr[0] = 0xA1;
@@ -209,23 +211,34 @@ static void APP_BleConfigBasic(void)
     // Configure advertising parameters
     BLE_GAP_SetAdvTxPowerLevel(CONFIG_BLE_GAP_ADV_TX_PWR,&advTxPower);      /* Advertising TX Power */
 
-    (void)memset(&advParam, 0, sizeof(BLE_GAP_AdvParams_T));
-    advParam.intervalMin = CONFIG_BLE_GAP_ADV_INTERVAL_MIN;     /* Advertising Interval Min */
-    advParam.intervalMax = CONFIG_BLE_GAP_ADV_INTERVAL_MAX;     /* Advertising Interval Max */
-    advParam.type = CONFIG_BLE_GAP_ADV_TYPE;        /* Advertising Type */
-    advParam.advChannelMap = CONFIG_BLE_GAP_ADV_CHANNEL_MAP;        /* Advertising Channel Map */
+    // The connectable set keeps legacy PDUs so that every central still finds the device
+    (void)memset(&advParam, 0, sizeof(BLE_GAP_ExtAdvParams_T));
+    advParam.advHandle = APP_ADV_HANDLE_CONN;
+    advParam.evtProperies = CONFIG_BLE_GAP_EXT_ADV_EVT_PROP;     /* Advertising Event Properties */
+    advParam.priIntervalMin = CONFIG_BLE_GAP_ADV_INTERVAL_MIN;     /* Advertising Interval Min */
+    advParam.priIntervalMax = CONFIG_BLE_GAP_ADV_INTERVAL_MAX;     /* Advertising Interval Max */
+    advParam.priChannelMap = CONFIG_BLE_GAP_ADV_CHANNEL_MAP;        /* Advertising Channel Map */
     advParam.filterPolicy = CONFIG_BLE_GAP_ADV_FILT_POLICY;     /* Advertising Filter Policy */
-    BLE_GAP_SetAdvParams(&advParam);
+    advParam.txPower = CONFIG_BLE_GAP_ADV_TX_PWR;      /* Advertising TX Power */
+    advParam.priPhy = BLE_GAP_PHY_TYPE_LE_1M;
+    advParam.secPhy = BLE_GAP_PHY_TYPE_LE_1M;
+    BLE_GAP_SetExtAdvParams(&advParam, &advTxPower);
 
     // Configure advertising data
+    appAdvData.advHandle = APP_ADV_HANDLE_CONN;
+    appAdvData.operation = BLE_GAP_EXT_ADV_DATA_OP_COMPLETE;
+    appAdvData.fragPreference = BLE_GAP_EXT_ADV_DATA_FRAG_MIN;
     appAdvData.advLen = CONFIG_BLE_GAP_ADV_DATA_ORIG_LEN;
-    (void)memcpy(appAdvData.advData, advData, appAdvData.advLen);     /* Advertising Data */
-    BLE_GAP_SetAdvData(&appAdvData);
+    appAdvData.p_advData = advData;     /* Advertising Data */
+    BLE_GAP_SetExtAdvData(&appAdvData);
 
     //Configure advertising scan response data
+    appScanRspData.advHandle = APP_ADV_HANDLE_CONN;
+    appScanRspData.operation = BLE_GAP_EXT_ADV_DATA_OP_COMPLETE;
+    appScanRspData.fragPreference = BLE_GAP_EXT_ADV_DATA_FRAG_MIN;
     appScanRspData.advLen = CONFIG_BLE_GAP_SCAN_RSP_DATA_ORIG_LEN;
-    (void)memcpy(appScanRspData.advData, scanRspData, appScanRspData.advLen);     /* Scan Response Data */
-    BLE_GAP_SetScanRspData(&appScanRspData);
+    appScanRspData.p_advData = scanRspData;     /* Scan Response Data */
+    BLE_GAP_SetExtScanRspData(&appScanRspData);
 
     BLE_GAP_SetConnTxPowerLevel(CONFIG_BLE_GAP_CONN_TX_PWR, &connTxPower);      /* Connection TX Power */
 }
@@ -283,6 +296,12 @@ void APP_BleStackInitBasic(void)
     BLE_GAP_Init();
 
     BLE_GAP_AdvInit();  /* Advertising */
+    BLE_GAP_ExtAdvInit();   /* Extended Advertising */
+    BLE_GAP_PeriodicAdvInit();  /* Periodic Advertising */
+
+    BLE_GAP_ScanInit(); /* Scanning */
+    BLE_GAP_ExtScanInit(APP_GROUP_SCAN_DATA_LEN, 0);    /* Extended Scanning */
+    BLE_GAP_SyncInit(); /* Periodic Advertising Sync */
 
     BLE_GAP_ConnPeripheralInit();   /* Peripheral */
 }
@@ -304,6 +323,7 @@ void APP_BleStackInitAdvance(void)
 
     /* GAP/SMP shall be initialized before L2CAP */
     BLE_L2CAP_Init();
+    BLE_L2CAP_CbInit();
 
     /* GAP/SMP/L2CAP shall be initialized before GATTS */
     GATTS_Init(gattsInitParam);
@@ -313,6 +333,8 @@ void APP_BleStackInitAdvance(void)
 
 
     //Initialize BLE middleware
+    MW_CONN_Init();
+
     BLE_DM_Init();
     BLE_DM_EventRegister(APP_DmEvtHandler);
 
@@ -322,6 +344,7 @@ void APP_BleStackInitAdvance(void)
 
 
     //Initialize BLE services
+    BLE_LSS_Add();
 
     //Initialize BLE profiles
     /* Transparent Profile */
@@ -60,6 +60,7 @@
 #include "ble_smp.h"
 #include "gatt.h"
 #include "ble_gcm/ble_dd.h"
+#include "ble_util/mw_conn.h"
 
 
 // DOM-IGNORE-BEGIN
@@ -49,6 +49,16 @@
 #include "app_ble_handler.h"
 #include "peripheral/sercom/usart/plib_sercom0_usart.h"
 #include "app.h"
+#include "app_session.h"
+#include "app_conn_policy.h"
+#include "app_link.h"
+#include "app_l2cap.h"
+#include "app_adv.h"
+#include "app_group.h"
+#include "app_auth.h"
+#include "app_smp_key.h"
+#include "app_log/app_log.h"
+#include "app_rec/app_rec.h"
 
 
 // *****************************************************************************
@@ -56,7 +66,6 @@
 // Section: Global Variables
 // *****************************************************************************
 // *****************************************************************************
-extern uint16_t conn_hdl;
 
 
 // *****************************************************************************
@@ -71,22 +80,52 @@ void APP_BleGapEvtHandler(BLE_GAP_Event_T *p_event)
         case BLE_GAP_EVT_CONNECTED:
         {
             /* TODO: implement your application code.*/
-            SERCOM0_USART_Write((uint8_t *)"Connected\r\n",11);
-            conn_hdl = p_event->eventField.evtConnect.connHandle;
+            if (p_event->eventField.evtConnect.status != GAP_STATUS_SUCCESS)
+            {
+                APP_ADV_Start();
+                break;
+            }
+
+            if (APP_SESSION_Open(p_event->eventField.evtConnect.connHandle) != APP_RES_SUCCESS)
+            {
+                BLE_GAP_Disconnect(p_event->eventField.evtConnect.connHandle, GAP_DISC_REASON_LOW_RESOURCES);
+                break;
+            }
+
+            APP_LOG_1(APP_LOG_ID_CONNECTED, p_event->eventField.evtConnect.connHandle);
+            APP_REC_Record(APP_REC_TYPE_CONNECTED, p_event->eventField.evtConnect.connHandle, 0);
+            APP_CONN_POLICY_GapEvtHandler(p_event);
+            APP_LINK_GapEvtHandler(p_event);
+            APP_ADV_GapEvtHandler(p_event);
+            APP_SMP_KEY_GapEvtHandler(p_event);
+
+            // Advertising stops on connection, keep accepting centrals until the configured limit
+            if (APP_SESSION_GetNum() < APP_SESSION_MAX_NBR)
+            {
+                APP_ADV_Start();
+            }
         }
         break;
 
         case BLE_GAP_EVT_DISCONNECTED:
         {
             /* TODO: implement your application code.*/
-            SERCOM0_USART_Write((uint8_t *)"Disconnected\r\n",14);
-            BLE_GAP_SetAdvEnable(0x01, 0);
+            APP_LOG_2(APP_LOG_ID_DISCONNECTED, p_event->eventField.evtDisconnect.connHandle, p_event->eventField.evtDisconnect.reason);
+            APP_REC_Record(APP_REC_TYPE_DISCONNECTED, p_event->eventField.evtDisconnect.connHandle, p_event->eventField.evtDisconnect.reason);
+            APP_SESSION_Close(p_event->eventField.evtDisconnect.connHandle);
+            APP_AUTH_Stop(p_event->eventField.evtDisconnect.connHandle);
+            APP_CONN_POLICY_GapEvtHandler(p_event);
+            APP_LINK_GapEvtHandler(p_event);
+            APP_L2CAP_GapEvtHandler(p_event);
+            APP_SMP_KEY_GapEvtHandler(p_event);
+            APP_ADV_Reconnect();
         }
         break;
 
         case BLE_GAP_EVT_CONN_PARAM_UPDATE:
         {
-            /* TODO: implement your application code.*/
+            APP_CONN_POLICY_GapEvtHandler(p_event);
+            APP_LINK_GapEvtHandler(p_event);
         }
         break;
 
@@ -116,7 +155,7 @@ void APP_BleGapEvtHandler(BLE_GAP_Event_T *p_event)
 
         case BLE_GAP_EVT_EXT_ADV_REPORT:
         {
-            /* TODO: implement your application code.*/
+            APP_GROUP_GapEvtHandler(p_event);
         }
         break;
 
@@ -146,7 +185,7 @@ void APP_BleGapEvtHandler(BLE_GAP_Event_T *p_event)
 
         case BLE_GAP_EVT_PHY_UPDATE:
         {
-            /* TODO: implement your application code.*/
+            APP_LINK_GapEvtHandler(p_event);
         }
         break;
 
@@ -164,25 +203,25 @@ void APP_BleGapEvtHandler(BLE_GAP_Event_T *p_event)
 
         case BLE_GAP_EVT_PERI_ADV_SYNC_EST:
         {
-            /* TODO: implement your application code.*/
+            APP_GROUP_GapEvtHandler(p_event);
         }
         break;
 
         case BLE_GAP_EVT_PERI_ADV_REPORT:
         {
-            /* TODO: implement your application code.*/
+            APP_GROUP_GapEvtHandler(p_event);
         }
         break;
 
         case BLE_GAP_EVT_PERI_ADV_SYNC_LOST:
         {
-            /* TODO: implement your application code.*/
+            APP_GROUP_GapEvtHandler(p_event);
         }
         break;
 
         case BLE_GAP_EVT_ADV_SET_TERMINATED:
         {
-            /* TODO: implement your application code.*/
+            APP_ADV_GapEvtHandler(p_event);
         }
         break;
 
@@ -207,7 +246,20 @@ void APP_BleGapEvtHandler(BLE_GAP_Event_T *p_event)
 
         case BLE_GAP_EVT_PATH_LOSS_THRESHOLD:
         {
-            /* TODO: implement your application code.*/
+            APP_LINK_GapEvtHandler(p_event);
+        }
+        break;
+
+        case BLE_GAP_EVT_FEATURE_EXCHANGE_COMPL:
+        {
+            APP_CONN_POLICY_GapEvtHandler(p_event);
+            APP_LINK_GapEvtHandler(p_event);
+        }
+        break;
+
+        case BLE_GAP_EVT_SUBRATE_CHANGE:
+        {
+            APP_CONN_POLICY_GapEvtHandler(p_event);
         }
         break;
 
@@ -234,7 +286,7 @@ void APP_BleL2capEvtHandler(BLE_L2CAP_Event_T *p_event)
 
         case BLE_L2CAP_EVT_CB_CONN_IND:
         {
-            /* TODO: implement your application code.*/
+            APP_L2CAP_EvtHandler(p_event);
         }
         break;
 
@@ -246,19 +298,19 @@ void APP_BleL2capEvtHandler(BLE_L2CAP_Event_T *p_event)
 
         case BLE_L2CAP_EVT_CB_SDU_IND:
         {
-            /* TODO: implement your application code.*/
+            APP_L2CAP_EvtHandler(p_event);
         }
         break;
 
         case BLE_L2CAP_EVT_CB_ADD_CREDITS_IND:
         {
-            /* TODO: implement your application code.*/
+            APP_L2CAP_EvtHandler(p_event);
         }
         break;
 
         case BLE_L2CAP_EVT_CB_DISC_IND:
         {
-            /* TODO: implement your application code.*/
+            APP_L2CAP_EvtHandler(p_event);
         }
         break;
 
@@ -333,13 +385,13 @@ void APP_GattEvtHandler(GATT_Event_T *p_event)
 
         case GATTS_EVT_READ:
         {
-            /* TODO: implement your application code.*/
+            APP_LINK_GattEvtHandler(p_event);
         }
         break;
 
         case GATTS_EVT_WRITE:
         {
-            /* TODO: implement your application code.*/
+            APP_LINK_GattEvtHandler(p_event);
         }
         break;
 
@@ -357,7 +409,7 @@ void APP_GattEvtHandler(GATT_Event_T *p_event)
 
         case ATT_EVT_UPDATE_MTU:
         {
-            /* TODO: implement your application code.*/
+            APP_LINK_GattEvtHandler(p_event);
         }
         break;
 
@@ -457,7 +509,7 @@ void APP_BleSmpEvtHandler(BLE_SMP_Event_T *p_event)
 
         case BLE_SMP_EVT_INPUT_SC_OOB_DATA_REQUEST:
         {
-            /* TODO: implement your application code.*/
+            APP_SMP_KEY_SmpEvtHandler(p_event);
         }
         break;
 
@@ -469,7 +521,7 @@ void APP_BleSmpEvtHandler(BLE_SMP_Event_T *p_event)
 
         case BLE_SMP_EVT_GEN_SC_OOB_DATA_DONE:
         {
-            /* TODO: implement your application code.*/
+            APP_SMP_KEY_SmpEvtHandler(p_event);
         }
         break;
 
@@ -496,19 +548,19 @@ void APP_DmEvtHandler(BLE_DM_Event_T *p_event)
 
         case BLE_DM_EVT_SECURITY_START:
         {
-            /* TODO: implement your application code.*/
+            APP_SMP_KEY_DmEvtHandler(p_event);
         }
         break;
 
         case BLE_DM_EVT_SECURITY_SUCCESS:
         {
-            /* TODO: implement your application code.*/
+            APP_SMP_KEY_DmEvtHandler(p_event);
         }
         break;
 
         case BLE_DM_EVT_SECURITY_FAIL:
         {
-            /* TODO: implement your application code.*/
+            APP_SMP_KEY_DmEvtHandler(p_event);
         }
         break;
 
@@ -532,7 +584,7 @@ void APP_DmEvtHandler(BLE_DM_Event_T *p_event)
 
         case BLE_DM_EVT_CONN_UPDATE_FAIL:
         {
-            /* TODO: implement your application code.*/
+            APP_CONN_POLICY_UpdateFailed(p_event->connHandle);
         }
         break;
 
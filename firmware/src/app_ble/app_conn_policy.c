@@ -0,0 +1,530 @@
+/*******************************************************************************
+* Copyright (C) 2025 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  Application Connection Policy Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    app_conn_policy.c
+
+  Summary:
+    This file contains the connection parameter policy of the application.
+
+  Description:
+    This file switches each link between low-latency and low-power connection
+    parameters through BLE_DM_ConnectionParameterUpdate, or between subrate
+    factors through BLE_GAP_SubrateRequest when the peer supports subrating,
+    and accounts the time spent in each mode.
+ *******************************************************************************/
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include <string.h>
+#include "osal/osal_freertos_extend.h"
+#include "ble_dm/ble_dm.h"
+#include "ble_util/mw_conn.h"
+#include "app_timer/app_timer.h"
+#include "app_conn_policy.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Macros
+// *****************************************************************************
+// *****************************************************************************
+#define APP_CONN_POLICY_REQ_TIMEOUT_MS          (30000U)    // Time after which an unanswered request is considered lost.
+
+#define APP_CONN_POLICY_TICK_TO_MS(tick)        ((uint32_t)(tick) * portTICK_PERIOD_MS)
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+typedef struct APP_CONN_POLICY_Link_T
+{
+    bool                        inUse;              // Link is tracked.
+    bool                        isActive;           // A servo command has been received within the idle timeout.
+    bool                        isPending;          // A parameter update request is in progress.
+    bool                        isSubrateCapable;   // Subrating is supported locally and the peer has not reported it unsupported.
+    bool                        isSubratePending;   // A subrate request is in progress.
+    bool                        isActivityWaiting;  // A servo command arrived while a request was in progress.
+    uint8_t                     requestMode;        // Mode of the request in progress.
+    uint16_t                    connHandle;         // Connection handle of the link.
+    uint32_t                    holdoffMs;          // Current hold-off time between requests.
+    TickType_t                  activityTick;       // Tick of the last servo command.
+    TickType_t                  requestTick;        // Tick of the last request.
+    TickType_t                  modeTick;           // Tick of the last mode time accounting.
+    TickType_t                  subrateTick;        // Tick of the last subrate request.
+    APP_CONN_POLICY_Stats_T     stats;              // Statistics of the link.
+} APP_CONN_POLICY_Link_T;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Global Variables
+// *****************************************************************************
+// *****************************************************************************
+static APP_CONN_POLICY_Link_T   s_link[MW_CONN_MAX_NBR];
+static uint8_t                  s_linkNum;
+static bool                     s_isDefaultSubrateSet;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Functions
+// *****************************************************************************
+// *****************************************************************************
+static void app_conn_policy_Evaluate(APP_CONN_POLICY_Link_T *p_link, TickType_t now);
+
+static APP_CONN_POLICY_Link_T *app_conn_policy_GetLink(uint16_t connHandle)
+{
+    uint8_t index;
+
+    index = MW_CONN_GetIndex(connHandle);
+    if ((index >= MW_CONN_MAX_NBR) || (!s_link[index].inUse) || (s_link[index].connHandle != connHandle))
+    {
+        return NULL;
+    }
+
+    return &s_link[index];
+}
+
+static uint8_t app_conn_policy_ModeOfInterval(uint16_t interval)
+{
+    return (interval <= APP_CONN_POLICY_FAST_INTERVAL_MAX) ? APP_CONN_POLICY_MODE_FAST : APP_CONN_POLICY_MODE_IDLE;
+}
+
+static void app_conn_policy_AccountTime(APP_CONN_POLICY_Link_T *p_link, TickType_t now)
+{
+    p_link->stats.modeTimeMs[p_link->stats.mode] += APP_CONN_POLICY_TICK_TO_MS(now - p_link->modeTick);
+    p_link->modeTick = now;
+}
+
+static void app_conn_policy_EvaluateSubrate(APP_CONN_POLICY_Link_T *p_link, TickType_t now)
+{
+    BLE_GAP_SubrateParams_T params;
+
+    if (p_link->isSubratePending)
+    {
+        if (APP_CONN_POLICY_TICK_TO_MS(now - p_link->subrateTick) < APP_CONN_POLICY_REQ_TIMEOUT_MS)
+        {
+            return;
+        }
+        p_link->isSubratePending = false;
+    }
+
+    if (p_link->isActive == (p_link->stats.subrateFactor <= 1U))
+    {
+        p_link->isActivityWaiting = false;
+        return;
+    }
+
+    if (p_link->isActive)
+    {
+        params.subrateMin = 1;
+        params.subrateMax = 1;
+        params.continuationNum = 0;
+    }
+    else
+    {
+        params.subrateMin = APP_CONN_POLICY_SUBRATE_IDLE_MIN;
+        params.subrateMax = APP_CONN_POLICY_SUBRATE_IDLE_MAX;
+        params.continuationNum = APP_CONN_POLICY_SUBRATE_CONT_NUM;
+    }
+    params.maxLatency = APP_CONN_POLICY_FAST_LATENCY;
+    params.supervisionTimeout = APP_CONN_POLICY_FAST_TIMEOUT;
+
+    // A request refused by the stack, e.g. during another procedure, is made again at the next tick
+    if (BLE_GAP_SubrateRequest(p_link->connHandle, &params) == MBA_RES_SUCCESS)
+    {
+        p_link->isActivityWaiting = false;
+        p_link->isSubratePending = true;
+        p_link->subrateTick = now;
+    }
+}
+
+static bool app_conn_policy_IsUnsupported(uint8_t status)
+{
+    return ((status == GAP_STATUS_UNSUPPORTED_REMOTE_FEATURE) || (status == GAP_STATUS_UNSUPPORTED_FEATURE)
+        || (status == GAP_STATUS_UNSUPPORTED_LMP_PARAMETERS));
+}
+
+static void app_conn_policy_RequestDone(APP_CONN_POLICY_Link_T *p_link)
+{
+    // The low-latency request of a servo command that arrived meanwhile is made right away
+    if (p_link->isActivityWaiting)
+    {
+        app_conn_policy_Evaluate(p_link, xTaskGetTickCount());
+    }
+}
+
+static void app_conn_policy_SubrateChanged(BLE_GAP_EvtSubrateChange_T *p_subrate)
+{
+    APP_CONN_POLICY_Link_T *p_link;
+    uint32_t latencyMs;
+
+    p_link = app_conn_policy_GetLink(p_subrate->connHandle);
+    if (p_link == NULL)
+    {
+        return;
+    }
+
+    if (p_subrate->status != GAP_STATUS_SUCCESS)
+    {
+        if (p_link->isSubratePending)
+        {
+            p_link->isSubratePending = false;
+
+            // Fall back to the connection parameters of the idle mode, other failures are retried at the next tick
+            if (app_conn_policy_IsUnsupported(p_subrate->status))
+            {
+                p_link->isSubrateCapable = false;
+            }
+            app_conn_policy_RequestDone(p_link);
+        }
+        return;
+    }
+
+    if (p_link->isSubratePending)
+    {
+        p_link->isSubratePending = false;
+        latencyMs = APP_CONN_POLICY_TICK_TO_MS(xTaskGetTickCount() - p_link->subrateTick);
+        p_link->stats.subrateLatencyMs = latencyMs;
+        if (latencyMs > p_link->stats.subrateLatencyMaxMs)
+        {
+            p_link->stats.subrateLatencyMaxMs = latencyMs;
+        }
+    }
+
+    if (p_subrate->subrateFactor != p_link->stats.subrateFactor)
+    {
+        p_link->stats.subrateChangeCnt++;
+        p_link->stats.subrateFactor = p_subrate->subrateFactor;
+    }
+
+    app_conn_policy_RequestDone(p_link);
+}
+
+static bool app_conn_policy_SetDefaultSubrate(void)
+{
+    BLE_GAP_SubrateParams_T params;
+
+    if (s_isDefaultSubrateSet)
+    {
+        return true;
+    }
+
+    // Also bound the subrating requested by the central. The default applies to every link.
+    params.subrateMin = 1;
+    params.subrateMax = APP_CONN_POLICY_SUBRATE_IDLE_MAX;
+    params.maxLatency = APP_CONN_POLICY_FAST_LATENCY;
+    params.continuationNum = APP_CONN_POLICY_SUBRATE_CONT_NUM;
+    params.supervisionTimeout = APP_CONN_POLICY_FAST_TIMEOUT;
+    s_isDefaultSubrateSet = (BLE_GAP_SetDefaultSubrate(&params) == MBA_RES_SUCCESS);
+
+    return s_isDefaultSubrateSet;
+}
+
+static void app_conn_policy_FeatureExchanged(uint16_t connHandle)
+{
+    APP_CONN_POLICY_Link_T *p_link;
+
+    p_link = app_conn_policy_GetLink(connHandle);
+    if (p_link == NULL)
+    {
+        return;
+    }
+
+    // The stack does not report the features of the peer. A peer without subrating fails the first
+    // request as an unsupported remote feature, and the link then uses the idle connection parameters.
+    p_link->isSubrateCapable = app_conn_policy_SetDefaultSubrate();
+}
+
+static void app_conn_policy_Evaluate(APP_CONN_POLICY_Link_T *p_link, TickType_t now)
+{
+    BLE_DM_ConnParamUpdate_T params;
+    uint8_t mode;
+
+    if (p_link->isPending)
+    {
+        if (APP_CONN_POLICY_TICK_TO_MS(now - p_link->requestTick) < APP_CONN_POLICY_REQ_TIMEOUT_MS)
+        {
+            return;
+        }
+        p_link->isPending = false;
+    }
+
+    if ((p_link->isActive) && (APP_CONN_POLICY_TICK_TO_MS(now - p_link->activityTick) >= APP_CONN_POLICY_IDLE_TIMEOUT_MS))
+    {
+        p_link->isActive = false;
+    }
+
+    if (p_link->isSubrateCapable)
+    {
+        // Subrating saves the power of the idle mode without giving up the low-latency interval
+        if (p_link->stats.mode == APP_CONN_POLICY_MODE_FAST)
+        {
+            app_conn_policy_EvaluateSubrate(p_link, now);
+            return;
+        }
+        mode = APP_CONN_POLICY_MODE_FAST;
+    }
+    else
+    {
+        mode = p_link->isActive ? APP_CONN_POLICY_MODE_FAST : APP_CONN_POLICY_MODE_IDLE;
+    }
+
+    if (mode == p_link->stats.mode)
+    {
+        p_link->isActivityWaiting = false;
+        return;
+    }
+
+    // A servo command waiting for an accepted request is not held off, only rejections are
+    if ((!((mode == APP_CONN_POLICY_MODE_FAST) && (p_link->isActivityWaiting)))
+        && (APP_CONN_POLICY_TICK_TO_MS(now - p_link->requestTick) < p_link->holdoffMs))
+    {
+        return;
+    }
+
+    if (mode == APP_CONN_POLICY_MODE_FAST)
+    {
+        params.intervalMin = APP_CONN_POLICY_FAST_INTERVAL_MIN;
+        params.intervalMax = APP_CONN_POLICY_FAST_INTERVAL_MAX;
+        params.latency = APP_CONN_POLICY_FAST_LATENCY;
+        params.timeout = APP_CONN_POLICY_FAST_TIMEOUT;
+    }
+    else
+    {
+        params.intervalMin = APP_CONN_POLICY_IDLE_INTERVAL_MIN;
+        params.intervalMax = APP_CONN_POLICY_IDLE_INTERVAL_MAX;
+        params.latency = APP_CONN_POLICY_IDLE_LATENCY;
+        params.timeout = APP_CONN_POLICY_IDLE_TIMEOUT;
+    }
+
+    p_link->requestTick = now;
+
+    if (BLE_DM_ConnectionParameterUpdate(p_link->connHandle, &params) == MBA_RES_SUCCESS)
+    {
+        p_link->isActivityWaiting = false;
+        p_link->isPending = true;
+        p_link->requestMode = mode;
+        p_link->stats.requestCnt++;
+    }
+}
+
+static void app_conn_policy_Open(uint16_t connHandle, uint16_t interval)
+{
+    APP_CONN_POLICY_Link_T *p_link;
+    uint8_t index;
+
+    index = MW_CONN_GetIndex(connHandle);
+    if (index >= MW_CONN_MAX_NBR)
+    {
+        return;
+    }
+
+    p_link = &s_link[index];
+    if (!p_link->inUse)
+    {
+        s_linkNum++;
+    }
+
+    (void)memset(p_link, 0, sizeof(APP_CONN_POLICY_Link_T));
+    p_link->inUse = true;
+    p_link->connHandle = connHandle;
+    p_link->holdoffMs = APP_CONN_POLICY_HOLDOFF_MIN_MS;
+    p_link->requestTick = xTaskGetTickCount();          // Let the central settle before the first request
+    p_link->modeTick = p_link->requestTick;
+    p_link->stats.mode = app_conn_policy_ModeOfInterval(interval);
+    p_link->stats.subrateFactor = 1;
+
+    if (s_linkNum == 1U)
+    {
+        APP_TIMER_SetTimer(APP_TIMER_CONN_POLICY, APP_CONN_POLICY_TICK_MS, true);
+    }
+}
+
+static void app_conn_policy_Close(uint16_t connHandle)
+{
+    APP_CONN_POLICY_Link_T *p_link;
+
+    p_link = app_conn_policy_GetLink(connHandle);
+    if (p_link == NULL)
+    {
+        return;
+    }
+
+    p_link->inUse = false;
+    s_linkNum--;
+
+    if (s_linkNum == 0U)
+    {
+        APP_TIMER_StopTimer(APP_TIMER_CONN_POLICY);
+    }
+}
+
+void APP_CONN_POLICY_Init(void)
+{
+    (void)memset(s_link, 0, sizeof(s_link));
+    s_linkNum = 0;
+    s_isDefaultSubrateSet = false;
+}
+
+void APP_CONN_POLICY_Activity(uint16_t connHandle)
+{
+    APP_CONN_POLICY_Link_T *p_link;
+
+    p_link = app_conn_policy_GetLink(connHandle);
+    if (p_link == NULL)
+    {
+        return;
+    }
+
+    p_link->isActive = true;
+    p_link->activityTick = xTaskGetTickCount();
+
+    if ((p_link->stats.mode != APP_CONN_POLICY_MODE_FAST) || (p_link->stats.subrateFactor > 1U))
+    {
+        p_link->isActivityWaiting = true;
+        app_conn_policy_Evaluate(p_link, p_link->activityTick);
+    }
+}
+
+void APP_CONN_POLICY_Tick(void)
+{
+    TickType_t now;
+    uint8_t i;
+
+    now = xTaskGetTickCount();
+
+    for (i = 0; i < MW_CONN_MAX_NBR; i++)
+    {
+        if (s_link[i].inUse)
+        {
+            app_conn_policy_AccountTime(&s_link[i], now);
+            app_conn_policy_Evaluate(&s_link[i], now);
+        }
+    }
+}
+
+void APP_CONN_POLICY_GapEvtHandler(BLE_GAP_Event_T *p_event)
+{
+    switch (p_event->eventId)
+    {
+        case BLE_GAP_EVT_CONNECTED:
+        {
+            if (p_event->eventField.evtConnect.status == GAP_STATUS_SUCCESS)
+            {
+                app_conn_policy_Open(p_event->eventField.evtConnect.connHandle, p_event->eventField.evtConnect.interval);
+            }
+        }
+        break;
+
+        case BLE_GAP_EVT_DISCONNECTED:
+        {
+            app_conn_policy_Close(p_event->eventField.evtDisconnect.connHandle);
+        }
+        break;
+
+        case BLE_GAP_EVT_CONN_PARAM_UPDATE:
+        {
+            APP_CONN_POLICY_Link_T *p_link;
+
+            p_link = app_conn_policy_GetLink(p_event->eventField.evtConnParamUpdate.connHandle);
+            if ((p_link != NULL) && (p_event->eventField.evtConnParamUpdate.status == GAP_STATUS_SUCCESS))
+            {
+                app_conn_policy_AccountTime(p_link, xTaskGetTickCount());
+                p_link->stats.mode = app_conn_policy_ModeOfInterval(p_event->eventField.evtConnParamUpdate.connParam.intervalMax);
+
+                // A central answering with parameters of the other mode is treated as a rejection
+                if ((p_link->isPending) && (p_link->stats.mode != p_link->requestMode))
+                {
+                    APP_CONN_POLICY_UpdateFailed(p_link->connHandle);
+                }
+                else
+                {
+                    p_link->isPending = false;
+                    p_link->holdoffMs = APP_CONN_POLICY_HOLDOFF_MIN_MS;
+                    app_conn_policy_RequestDone(p_link);
+                }
+            }
+        }
+        break;
+
+        case BLE_GAP_EVT_FEATURE_EXCHANGE_COMPL:
+        {
+            app_conn_policy_FeatureExchanged(p_event->eventField.evtFeatureExchangeCompl.connHandle);
+        }
+        break;
+
+        case BLE_GAP_EVT_SUBRATE_CHANGE:
+        {
+            app_conn_policy_SubrateChanged(&p_event->eventField.evtSubrateChange);
+        }
+        break;
+
+        default:
+        break;
+    }
+}
+
+void APP_CONN_POLICY_UpdateFailed(uint16_t connHandle)
+{
+    APP_CONN_POLICY_Link_T *p_link;
+
+    p_link = app_conn_policy_GetLink(connHandle);
+    if (p_link == NULL)
+    {
+        return;
+    }
+
+    p_link->isPending = false;
+    p_link->isActivityWaiting = false;
+    p_link->stats.rejectCnt++;
+    p_link->holdoffMs = (p_link->holdoffMs >= (APP_CONN_POLICY_HOLDOFF_MAX_MS / 2U)) ? APP_CONN_POLICY_HOLDOFF_MAX_MS : (p_link->holdoffMs * 2U);
+}
+
+uint16_t APP_CONN_POLICY_GetStats(uint16_t connHandle, APP_CONN_POLICY_Stats_T *p_stats)
+{
+    APP_CONN_POLICY_Link_T *p_link;
+
+    p_link = app_conn_policy_GetLink(connHandle);
+    if ((p_link == NULL) || (p_stats == NULL))
+    {
+        return APP_RES_INVALID_PARA;
+    }
+
+    app_conn_policy_AccountTime(p_link, xTaskGetTickCount());
+    (void)memcpy(p_stats, &p_link->stats, sizeof(APP_CONN_POLICY_Stats_T));
+
+    return APP_RES_SUCCESS;
+}
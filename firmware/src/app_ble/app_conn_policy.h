@@ -0,0 +1,278 @@
+/*******************************************************************************
+* Copyright (C) 2025 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  MPLAB Harmony Application Header File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    app_conn_policy.h
+
+  Summary:
+    This header file provides prototypes and definitions for the connection
+    parameter policy of the application.
+
+  Description:
+    The policy requests a short connection interval while servo commands are
+    arriving on a link, and falls back to a long interval with peripheral
+    latency once the link has been idle for APP_CONN_POLICY_IDLE_TIMEOUT_MS.
+    Requests to the same link are spaced by a hold-off time which doubles on
+    every rejection, so a central refusing the parameters cannot cause an
+    update storm. The time spent in each mode is accounted per link.
+
+    When the peer supports connection subrating, an idle link keeps the
+    low-latency parameters and skips connection events through a subrate factor
+    of up to APP_CONN_POLICY_SUBRATE_IDLE_MAX instead. The first servo command
+    drops the factor back to 1 within a few underlying connection events, much
+    faster than a connection parameter update. The stack does not report the
+    features of the peer, so subrating is tried first; a peer answering that it
+    is unsupported gets the idle parameters, other failures are retried.
+*******************************************************************************/
+
+#ifndef APP_CONN_POLICY_H
+#define APP_CONN_POLICY_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "mba_error_defs.h"
+#include "app_error_defs.h"
+#include "ble_gap.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+extern "C" {
+
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Macros
+// *****************************************************************************
+// *****************************************************************************
+/* Low-latency mode: 7.5 ms to 15 ms interval, no peripheral latency, 2 s supervision timeout. */
+#define APP_CONN_POLICY_FAST_INTERVAL_MIN       (6U)
+#define APP_CONN_POLICY_FAST_INTERVAL_MAX       (12U)
+#define APP_CONN_POLICY_FAST_LATENCY            (0U)
+#define APP_CONN_POLICY_FAST_TIMEOUT            (200U)
+
+/* Low-power mode: 100 ms to 150 ms interval, 4 skipped events, 6 s supervision timeout. */
+#define APP_CONN_POLICY_IDLE_INTERVAL_MIN       (80U)
+#define APP_CONN_POLICY_IDLE_INTERVAL_MAX       (120U)
+#define APP_CONN_POLICY_IDLE_LATENCY            (4U)
+#define APP_CONN_POLICY_IDLE_TIMEOUT            (600U)
+
+/* Subrating of an idle link on low-latency parameters: up to 240 ms between wakeups at a 7.5 ms interval. */
+#define APP_CONN_POLICY_SUBRATE_IDLE_MIN        (16U)
+#define APP_CONN_POLICY_SUBRATE_IDLE_MAX        (32U)
+#define APP_CONN_POLICY_SUBRATE_CONT_NUM        (2U)        /* Underlying events kept after a data packet, so a command burst is not subrated. */
+
+#define APP_CONN_POLICY_IDLE_TIMEOUT_MS         (5000U)     /* Time without commands before the link falls back to low-power mode. */
+#define APP_CONN_POLICY_HOLDOFF_MIN_MS          (2000U)     /* Minimum time between two requests on the same link. */
+#define APP_CONN_POLICY_HOLDOFF_MAX_MS          (30000U)    /* Maximum hold-off time after repeated rejections. */
+#define APP_CONN_POLICY_TICK_MS                 (500U)      /* Period of the policy evaluation. */
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+/* Connection parameter mode. */
+typedef enum APP_CONN_POLICY_Mode_T
+{
+    APP_CONN_POLICY_MODE_FAST,
+    APP_CONN_POLICY_MODE_IDLE,
+    APP_CONN_POLICY_MODE_NUM
+} APP_CONN_POLICY_Mode_T;
+
+/* Statistics of a link. */
+typedef struct APP_CONN_POLICY_Stats_T
+{
+    uint32_t    modeTimeMs[APP_CONN_POLICY_MODE_NUM];   /* Time spent in each mode, in ms. */
+    uint16_t    requestCnt;                             /* Number of parameter update requests sent. */
+    uint16_t    rejectCnt;                              /* Number of parameter update requests rejected. */
+    uint16_t    subrateChangeCnt;                       /* Number of subrate factor changes. */
+    uint16_t    subrateFactor;                          /* Current subrate factor. */
+    uint32_t    subrateLatencyMs;                       /* Time taken by the last requested subrate change, in ms. */
+    uint32_t    subrateLatencyMaxMs;                    /* Longest time taken by a requested subrate change, in ms. */
+    uint8_t     mode;                                   /* Current mode. See APP_CONN_POLICY_Mode_T. */
+} APP_CONN_POLICY_Stats_T;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Function Prototypes
+// *****************************************************************************
+// *****************************************************************************
+
+/*******************************************************************************
+  Function:
+    void APP_CONN_POLICY_Init(void)
+
+  Summary:
+     Initialize the connection parameter policy.
+
+  Description:
+
+  Precondition:
+
+  Parameters:
+    None.
+
+  Returns:
+    None.
+
+*/
+void APP_CONN_POLICY_Init(void);
+
+/*******************************************************************************
+  Function:
+    void APP_CONN_POLICY_Activity(uint16_t connHandle)
+
+  Summary:
+     Report a servo command received on a link.
+
+  Description:
+    The link is switched to low-latency mode if it is not already in it, and
+    its subrate factor is dropped to 1. When a request is in progress on the
+    link, the low-latency request is made as soon as it completes. The steps
+    of a servo ramp are reported as activity too.
+
+  Precondition:
+
+  Parameters:
+    connHandle - Connection handle of the link.
+
+  Returns:
+    None.
+
+*/
+void APP_CONN_POLICY_Activity(uint16_t connHandle);
+
+/*******************************************************************************
+  Function:
+    void APP_CONN_POLICY_Tick(void)
+
+  Summary:
+     Evaluate the policy of every link.
+
+  Description:
+    This function shall be called every APP_CONN_POLICY_TICK_MS while a link
+    is open. The periodic timer is managed by the policy itself.
+
+  Precondition:
+
+  Parameters:
+    None.
+
+  Returns:
+    None.
+
+*/
+void APP_CONN_POLICY_Tick(void);
+
+/*******************************************************************************
+  Function:
+    void APP_CONN_POLICY_GapEvtHandler(BLE_GAP_Event_T *p_event)
+
+  Summary:
+     Track connection, disconnection, connection parameter update, feature
+     exchange and subrate change events.
+
+  Description:
+
+  Precondition:
+
+  Parameters:
+    p_event - Pointer to the GAP event.
+
+  Returns:
+    None.
+
+*/
+void APP_CONN_POLICY_GapEvtHandler(BLE_GAP_Event_T *p_event);
+
+/*******************************************************************************
+  Function:
+    void APP_CONN_POLICY_UpdateFailed(uint16_t connHandle)
+
+  Summary:
+     Report a rejected connection parameter update request.
+
+  Description:
+    The hold-off time of the link is doubled up to
+    APP_CONN_POLICY_HOLDOFF_MAX_MS.
+
+  Precondition:
+
+  Parameters:
+    connHandle - Connection handle of the link.
+
+  Returns:
+    None.
+
+*/
+void APP_CONN_POLICY_UpdateFailed(uint16_t connHandle);
+
+/*******************************************************************************
+  Function:
+    uint16_t APP_CONN_POLICY_GetStats(uint16_t connHandle, APP_CONN_POLICY_Stats_T *p_stats)
+
+  Summary:
+     Get the statistics of a link.
+
+  Description:
+
+  Precondition:
+
+  Parameters:
+    connHandle - Connection handle of the link.
+    p_stats    - Pointer to store the statistics.
+
+  Returns:
+    APP_RES_SUCCESS if the statistics are retrieved. APP_RES_INVALID_PARA if
+    the link is not tracked.
+
+*/
+uint16_t APP_CONN_POLICY_GetStats(uint16_t connHandle, APP_CONN_POLICY_Stats_T *p_stats);
+
+//DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+//DOM-IGNORE-END
+
+#endif /* APP_CONN_POLICY_H */
+
+
+/*******************************************************************************
+ End of File
+ */
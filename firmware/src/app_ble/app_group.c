@@ -0,0 +1,436 @@
+/*******************************************************************************
+* Copyright (C) 2025 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  Application Group Listener Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    app_group.c
+
+  Summary:
+    This file contains the group setpoint listener of the application.
+
+  Description:
+    This file synchronizes to the periodic advertising train of the group
+    controller and applies the setpoint of this servo at the time carried in
+    each frame.
+ *******************************************************************************/
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include <string.h>
+#include "configuration.h"
+#include "gap_defs.h"
+#include "ble_util/byte_stream.h"
+#include "app_timer/app_timer.h"
+#include "app_cal/app_cal.h"
+#include "app_group.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Macros
+// *****************************************************************************
+// *****************************************************************************
+#define APP_GROUP_AD_TYPE_MANUFACTURER          (0xFFU)
+#define APP_GROUP_AD_HEADER_LEN                 (3U)        // AD type and company identifier, the length excluded.
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+typedef enum APP_GROUP_State_T
+{
+    APP_GROUP_STATE_IDLE,               // The listener is stopped.
+    APP_GROUP_STATE_SCANNING,           // Looking for the announce of the group controller.
+    APP_GROUP_STATE_SYNCING,            // The sync to the periodic advertising train is pending.
+    APP_GROUP_STATE_SYNCED              // Receiving the setpoint frames.
+} APP_GROUP_State_T;
+
+typedef struct APP_GROUP_Listener_T
+{
+    APP_GROUP_ApplyCb_T applyCb;
+    uint8_t             servoCh;
+    APP_GROUP_State_T   state;
+    uint16_t            groupId;
+    uint8_t             channel;
+    uint16_t            syncHandle;
+    bool                isSeqValid;     // lastSeq holds the sequence number of a received frame.
+    uint8_t             lastSeq;
+    bool                isPending;      // A setpoint waits for its apply time.
+    uint32_t            pendingDuty;
+} APP_GROUP_Listener_T;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Global Variables
+// *****************************************************************************
+// *****************************************************************************
+static APP_GROUP_Listener_T     s_listener;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Functions
+// *****************************************************************************
+// *****************************************************************************
+static const uint8_t *app_group_FindRecord(const uint8_t *p_data, uint8_t len, uint8_t type,
+    uint16_t groupId, uint8_t *p_recordLen)
+{
+    uint16_t offset = 0;
+    uint16_t companyId;
+    uint16_t recordGroupId;
+    uint8_t adLen;
+    const uint8_t *p_record;
+
+    while ((offset + 1U) < len)
+    {
+        adLen = p_data[offset];
+        if ((adLen == 0U) || ((offset + 1U + adLen) > len))
+        {
+            break;
+        }
+
+        if ((p_data[offset + 1U] == APP_GROUP_AD_TYPE_MANUFACTURER)
+            && (adLen >= (APP_GROUP_AD_HEADER_LEN + APP_GROUP_ANNOUNCE_LEN)))
+        {
+            BUF_LE_TO_U16(&companyId, &p_data[offset + 2U]);
+            p_record = &p_data[offset + 1U + APP_GROUP_AD_HEADER_LEN];
+            BUF_LE_TO_U16(&recordGroupId, &p_record[APP_GROUP_RECORD_OFFSET_GROUP_ID]);
+
+            if ((companyId == APP_GROUP_COMPANY_ID) && (p_record[APP_GROUP_RECORD_OFFSET_TYPE] == type)
+                && (recordGroupId == groupId))
+            {
+                *p_recordLen = adLen - APP_GROUP_AD_HEADER_LEN;
+                return p_record;
+            }
+        }
+
+        offset += 1U + adLen;
+    }
+
+    return NULL;
+}
+
+static uint16_t app_group_SetScanEnable(bool enable)
+{
+    BLE_GAP_ExtScanningEnable_T scanEnable;
+
+    scanEnable.enable = enable;
+    scanEnable.filterDuplicates = BLE_GAP_SCAN_FD_DISABLE;  // A failed sync is retried on a later announce
+    scanEnable.duration = 0;
+    scanEnable.period = 0;
+
+    return BLE_GAP_SetExtScanningEnable(BLE_GAP_SCAN_MODE_OBSERVER, &scanEnable);
+}
+
+static void app_group_Stop(void)
+{
+    switch (s_listener.state)
+    {
+        case APP_GROUP_STATE_SYNCED:
+        {
+            (void)BLE_GAP_TerminateSync(s_listener.syncHandle);
+        }
+        break;
+
+        case APP_GROUP_STATE_SYNCING:
+        {
+            (void)BLE_GAP_CreateSyncCancel();
+            (void)app_group_SetScanEnable(false);
+        }
+        break;
+
+        case APP_GROUP_STATE_SCANNING:
+        {
+            (void)app_group_SetScanEnable(false);
+        }
+        break;
+
+        default:
+            break;
+    }
+
+    s_listener.state = APP_GROUP_STATE_IDLE;
+}
+
+// Checks that a duty lies between the forward and reverse points of the calibration
+static bool app_group_IsInRange(uint32_t duty)
+{
+    const APP_CAL_Channel_T *p_cal = APP_CAL_GetChannel(s_listener.servoCh);
+    uint32_t forward;
+    uint32_t reverse;
+
+    if (p_cal == NULL)
+    {
+        return false;
+    }
+
+    forward = p_cal->point[APP_CAL_POINT_FORWARD];
+    reverse = p_cal->point[APP_CAL_POINT_REVERSE];
+
+    return (forward < reverse) ? ((duty >= forward) && (duty <= reverse)) : ((duty >= reverse) && (duty <= forward));
+}
+
+static void app_group_Schedule(const APP_GROUP_Setpoint_T *p_setpoint)
+{
+    // A newer frame supersedes a setpoint still waiting for its apply time
+    s_listener.isPending = false;
+    (void)APP_TIMER_StopTimer(APP_TIMER_GROUP_APPLY);
+
+    if (p_setpoint->delay > 0U)
+    {
+        s_listener.pendingDuty = p_setpoint->duty;
+        if (APP_TIMER_SetTimer(APP_TIMER_GROUP_APPLY, p_setpoint->delay, false) == APP_RES_SUCCESS)
+        {
+            s_listener.isPending = true;
+            return;
+        }
+    }
+
+    // Applying late is better than not following the group at all
+    s_listener.applyCb(p_setpoint->duty);
+}
+
+static void app_group_ExtAdvReport(BLE_GAP_EvtExtAdvReport_T *p_report)
+{
+    BLE_GAP_CreateSync_T createSync;
+    uint8_t recordLen;
+
+    if ((s_listener.state != APP_GROUP_STATE_SCANNING) || (p_report->periodAdvInterval == 0U)
+        || (p_report->dataStatus != BLE_GAP_EXT_ADV_RPT_DATA_COMPLETE))
+    {
+        return;
+    }
+
+    if (app_group_FindRecord(p_report->advData, p_report->length, APP_GROUP_RECORD_TYPE_ANNOUNCE,
+        s_listener.groupId, &recordLen) == NULL)
+    {
+        return;
+    }
+
+    createSync.options = 0;
+    createSync.advSid = p_report->sid;
+    createSync.advAddr = p_report->addr;
+    createSync.skip = 0;
+    createSync.syncTimeout = APP_GROUP_SYNC_TIMEOUT;
+
+    if (BLE_GAP_CreateSync(&createSync) == MBA_RES_SUCCESS)
+    {
+        s_listener.state = APP_GROUP_STATE_SYNCING;
+    }
+}
+
+static void app_group_PeriAdvReport(BLE_GAP_EvtPeriAdvReport_T *p_report)
+{
+    APP_GROUP_Setpoint_T setpoint;
+
+    if ((s_listener.state != APP_GROUP_STATE_SYNCED) || (p_report->syncHandle != s_listener.syncHandle)
+        || (p_report->dataStatus != BLE_GAP_DATA_STATUS_COMPLETE))
+    {
+        return;
+    }
+
+    if (APP_GROUP_ParseFrame(p_report->advData, p_report->dataLength, s_listener.groupId,
+        s_listener.channel, &setpoint) != APP_RES_SUCCESS)
+    {
+        return;
+    }
+
+    // Repetitions of a frame already scheduled are ignored
+    if (s_listener.isSeqValid && (setpoint.seq == s_listener.lastSeq))
+    {
+        return;
+    }
+
+    // Any advertiser can send a frame, the servo is never driven out of its calibrated range
+    if (!app_group_IsInRange(setpoint.duty))
+    {
+        return;
+    }
+
+    s_listener.isSeqValid = true;
+    s_listener.lastSeq = setpoint.seq;
+    app_group_Schedule(&setpoint);
+}
+
+void APP_GROUP_Init(APP_GROUP_ApplyCb_T applyCb, uint8_t servoCh)
+{
+    (void)memset(&s_listener, 0, sizeof(s_listener));
+    s_listener.applyCb = applyCb;
+    s_listener.servoCh = servoCh;
+}
+
+uint16_t APP_GROUP_Start(uint16_t groupId, uint8_t channel)
+{
+    BLE_GAP_ExtScanningPhy_T scanPhy;
+    uint16_t result;
+
+    app_group_Stop();
+
+    s_listener.groupId = groupId;
+    s_listener.channel = channel;
+    s_listener.isSeqValid = false;
+
+    if (groupId == APP_GROUP_ID_NONE)
+    {
+        return APP_RES_SUCCESS;
+    }
+
+    (void)memset(&scanPhy, 0, sizeof(BLE_GAP_ExtScanningPhy_T));
+    scanPhy.le1mPhy.enable = true;
+    scanPhy.le1mPhy.type = BLE_GAP_SCAN_TYPE_PASSIVE_SCAN;
+    scanPhy.le1mPhy.interval = APP_GROUP_SCAN_INTERVAL;
+    scanPhy.le1mPhy.window = APP_GROUP_SCAN_WINDOW;
+    scanPhy.le1mPhy.disChannel = 0;
+    result = BLE_GAP_SetExtScanningParams(BLE_GAP_SCAN_FP_ACCEPT_ALL, &scanPhy);
+    if (result != MBA_RES_SUCCESS)
+    {
+        return result;
+    }
+
+    result = app_group_SetScanEnable(true);
+    if (result == MBA_RES_SUCCESS)
+    {
+        s_listener.state = APP_GROUP_STATE_SCANNING;
+    }
+
+    return result;
+}
+
+uint16_t APP_GROUP_ParseFrame(const uint8_t *p_data, uint8_t len, uint16_t groupId,
+    uint8_t channel, APP_GROUP_Setpoint_T *p_setpoint)
+{
+    const uint8_t *p_frame;
+    uint8_t frameLen;
+    uint8_t firstCh;
+    uint8_t chNum;
+    const uint8_t *p_buf;
+
+    p_frame = app_group_FindRecord(p_data, len, APP_GROUP_RECORD_TYPE_SETPOINT, groupId, &frameLen);
+    if ((p_frame == NULL) || (frameLen < APP_GROUP_FRAME_HEADER_LEN))
+    {
+        return APP_RES_INVALID_PARA;
+    }
+
+    firstCh = p_frame[APP_GROUP_FRAME_OFFSET_FIRST_CH];
+    chNum = p_frame[APP_GROUP_FRAME_OFFSET_CH_NUM];
+    if (((uint16_t)APP_GROUP_FRAME_HEADER_LEN + ((uint16_t)chNum * APP_GROUP_SETPOINT_LEN)) > frameLen)
+    {
+        return APP_RES_INVALID_PARA;
+    }
+
+    if ((channel < firstCh) || (((uint16_t)channel - firstCh) >= chNum))
+    {
+        return APP_RES_FAIL;
+    }
+
+    p_setpoint->seq = p_frame[APP_GROUP_FRAME_OFFSET_SEQ];
+    BUF_LE_TO_U16(&p_setpoint->delay, &p_frame[APP_GROUP_FRAME_OFFSET_DELAY]);
+    p_buf = &p_frame[APP_GROUP_FRAME_OFFSET_SETPOINT + ((uint16_t)(channel - firstCh) * APP_GROUP_SETPOINT_LEN)];
+    STREAM_LE_TO_U32(&p_setpoint->duty, &p_buf);
+
+    return APP_RES_SUCCESS;
+}
+
+void APP_GROUP_GapEvtHandler(BLE_GAP_Event_T *p_event)
+{
+    switch (p_event->eventId)
+    {
+        case BLE_GAP_EVT_EXT_ADV_REPORT:
+        {
+            app_group_ExtAdvReport(&p_event->eventField.evtExtAdvReport);
+        }
+        break;
+
+        case BLE_GAP_EVT_PERI_ADV_SYNC_EST:
+        {
+            if (s_listener.state != APP_GROUP_STATE_SYNCING)
+            {
+                break;
+            }
+
+            if (p_event->eventField.evtPeriAdvSyncEst.status == GAP_STATUS_SUCCESS)
+            {
+                s_listener.syncHandle = p_event->eventField.evtPeriAdvSyncEst.syncHandle;
+                s_listener.isSeqValid = false;
+                s_listener.state = APP_GROUP_STATE_SYNCED;
+
+                // The train is followed without scanning
+                (void)app_group_SetScanEnable(false);
+            }
+            else
+            {
+                s_listener.state = APP_GROUP_STATE_SCANNING;
+            }
+        }
+        break;
+
+        case BLE_GAP_EVT_PERI_ADV_REPORT:
+        {
+            app_group_PeriAdvReport(&p_event->eventField.evtPeriAdvReport);
+        }
+        break;
+
+        case BLE_GAP_EVT_PERI_ADV_SYNC_LOST:
+        {
+            if ((s_listener.state == APP_GROUP_STATE_SYNCED)
+                && (p_event->eventField.evtPeriAdvSyncLost.syncHandle == s_listener.syncHandle))
+            {
+                // Look for the controller again. A scheduled setpoint is still applied.
+                if (app_group_SetScanEnable(true) == MBA_RES_SUCCESS)
+                {
+                    s_listener.state = APP_GROUP_STATE_SCANNING;
+                }
+                else
+                {
+                    s_listener.state = APP_GROUP_STATE_IDLE;
+                }
+            }
+        }
+        break;
+
+        default:
+            break;
+    }
+}
+
+void APP_GROUP_Tick(void)
+{
+    if (!s_listener.isPending)
+    {
+        return;
+    }
+
+    s_listener.isPending = false;
+    s_listener.applyCb(s_listener.pendingDuty);
+}
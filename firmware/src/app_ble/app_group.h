@@ -0,0 +1,259 @@
+/*******************************************************************************
+* Copyright (C) 2025 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  MPLAB Harmony Application Header File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    app_group.h
+
+  Summary:
+    This header file provides prototypes and definitions for the group
+    setpoint listener of the application.
+
+  Description:
+    A group controller moves many servos together by broadcasting one frame
+    in its periodic advertising train instead of connecting to each servo in
+    turn. The listener scans for the extended advertising announcing the
+    configured group, synchronizes to its periodic advertising train and
+    extracts the setpoint of its own channel from every new frame. The frames
+    are not authenticated, so a setpoint outside of the calibrated range of
+    the servo, between its forward and reverse duties, is ignored. The
+    setpoint is applied once the delay carried in the frame has elapsed, so
+    all servos of the group move at the same time regardless of group size.
+*******************************************************************************/
+
+#ifndef APP_GROUP_H
+#define APP_GROUP_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ble_gap.h"
+#include "mba_error_defs.h"
+#include "app_error_defs.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+extern "C" {
+
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Macros
+// *****************************************************************************
+// *****************************************************************************
+#define APP_GROUP_ID_NONE                       (0x0000U)   /* The listener is disabled. */
+
+#define APP_GROUP_SCAN_INTERVAL                 (160U)      /* Extended scan interval: 100 ms. (Unit: 0.625 ms) */
+#define APP_GROUP_SCAN_WINDOW                   (80U)       /* Extended scan window: 50 ms. (Unit: 0.625 ms) */
+#define APP_GROUP_SCAN_DATA_LEN                 (0x00FFU)   /* Largest PDU payload received by the scanner. */
+#define APP_GROUP_SYNC_TIMEOUT                  (200U)      /* Periodic advertising sync timeout: 2 s. (Unit: 10 ms) */
+
+#define APP_GROUP_COMPANY_ID                    (0x00CDU)   /* Microchip Technology Inc. */
+
+/* Group records, carried as manufacturer specific data. All fields are little endian. */
+#define APP_GROUP_RECORD_OFFSET_TYPE            (0U)        /* See APP_GROUP_RECORD_TYPE. (1 byte) */
+#define APP_GROUP_RECORD_OFFSET_GROUP_ID        (1U)        /* Group the record is addressed to. (2 bytes) */
+
+/* Record types. */
+#define APP_GROUP_RECORD_TYPE_ANNOUNCE          (0x10U)     /* Extended advertising data of the controller. */
+#define APP_GROUP_RECORD_TYPE_SETPOINT          (0x11U)     /* Periodic advertising data of the controller. */
+
+/* The announce record holds the type and the group ID only. */
+#define APP_GROUP_ANNOUNCE_LEN                  (3U)
+
+/* Setpoint frame. The controller repeats a frame in the following periodic events
+   with the same sequence number and shall decrease the delay by the periodic
+   advertising interval in each repetition, so a listener which missed the first
+   event still applies the setpoint at the same time. */
+#define APP_GROUP_FRAME_OFFSET_SEQ              (3U)        /* Incremented on every new frame. (1 byte) */
+#define APP_GROUP_FRAME_OFFSET_DELAY            (4U)        /* Time from the periodic event carrying the frame to the apply time, in ms. (2 bytes) */
+#define APP_GROUP_FRAME_OFFSET_FIRST_CH         (6U)        /* Channel of the first setpoint. (1 byte) */
+#define APP_GROUP_FRAME_OFFSET_CH_NUM           (7U)        /* Number of setpoints. (1 byte) */
+#define APP_GROUP_FRAME_OFFSET_SETPOINT         (8U)        /* PWM duty of each channel, in TCC0 counts. (4 bytes each) */
+#define APP_GROUP_FRAME_HEADER_LEN              (APP_GROUP_FRAME_OFFSET_SETPOINT)
+#define APP_GROUP_SETPOINT_LEN                  (4U)
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+/* Setpoint extracted from a frame. */
+typedef struct APP_GROUP_Setpoint_T
+{
+    uint8_t         seq;                /* Sequence number of the frame. */
+    uint16_t        delay;              /* Time left until the setpoint is applied, in ms. */
+    uint32_t        duty;               /* PWM duty of the channel, in TCC0 counts. */
+} APP_GROUP_Setpoint_T;
+
+/* Function applying a setpoint to the servo. */
+typedef void (*APP_GROUP_ApplyCb_T)(uint32_t duty);
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Function Prototypes
+// *****************************************************************************
+// *****************************************************************************
+
+/*******************************************************************************
+  Function:
+    void APP_GROUP_Init(APP_GROUP_ApplyCb_T applyCb, uint8_t servoCh)
+
+  Summary:
+     Initialize the group setpoint listener.
+
+  Description:
+
+  Precondition:
+
+  Parameters:
+    applyCb - Function applying a setpoint to the servo.
+    servoCh - Calibration channel of the servo, giving the range of the setpoints.
+
+  Returns:
+    None.
+
+*/
+void APP_GROUP_Init(APP_GROUP_ApplyCb_T applyCb, uint8_t servoCh);
+
+/*******************************************************************************
+  Function:
+    uint16_t APP_GROUP_Start(uint16_t groupId, uint8_t channel)
+
+  Summary:
+     Start listening to the setpoints of a group.
+
+  Description:
+    Extended scanning runs until the periodic advertising train of the group
+    controller is synchronized, and again whenever the sync is lost.
+
+  Precondition:
+    The BLE stack shall be initialized.
+
+  Parameters:
+    groupId - Group to listen to. APP_GROUP_ID_NONE stops the listener.
+    channel - Channel of this servo within the group.
+
+  Returns:
+    APP_RES_SUCCESS - The listener is started.
+    Other           - The scanning could not be started.
+
+*/
+uint16_t APP_GROUP_Start(uint16_t groupId, uint8_t channel);
+
+/*******************************************************************************
+  Function:
+    uint16_t APP_GROUP_ParseFrame(const uint8_t *p_data, uint8_t len, uint16_t groupId,
+        uint8_t channel, APP_GROUP_Setpoint_T *p_setpoint)
+
+  Summary:
+     Extract the setpoint of a channel from periodic advertising data.
+
+  Description:
+    The data is scanned for the setpoint frame of the group. The function has
+    no side effect.
+
+  Precondition:
+
+  Parameters:
+    p_data     - Periodic advertising data.
+    len        - Length of the data.
+    groupId    - Group of this servo.
+    channel    - Channel of this servo within the group.
+    p_setpoint - Setpoint of the channel.
+
+  Returns:
+    APP_RES_SUCCESS      - The frame carries a setpoint for the channel.
+    APP_RES_FAIL         - The frame does not carry a setpoint for the channel.
+    APP_RES_INVALID_PARA - The data holds no valid frame of the group.
+
+*/
+uint16_t APP_GROUP_ParseFrame(const uint8_t *p_data, uint8_t len, uint16_t groupId,
+    uint8_t channel, APP_GROUP_Setpoint_T *p_setpoint);
+
+/*******************************************************************************
+  Function:
+    void APP_GROUP_GapEvtHandler(BLE_GAP_Event_T *p_event)
+
+  Summary:
+     Find the group controller, keep the sync and schedule its setpoints.
+
+  Description:
+
+  Precondition:
+
+  Parameters:
+    p_event - Pointer to the GAP event.
+
+  Returns:
+    None.
+
+*/
+void APP_GROUP_GapEvtHandler(BLE_GAP_Event_T *p_event);
+
+/*******************************************************************************
+  Function:
+    void APP_GROUP_Tick(void)
+
+  Summary:
+     Apply the scheduled setpoint.
+
+  Description:
+    This function is called on APP_TIMER_GROUP_APPLY_MSG.
+
+  Precondition:
+
+  Parameters:
+    None.
+
+  Returns:
+    None.
+
+*/
+void APP_GROUP_Tick(void);
+
+//DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+//DOM-IGNORE-END
+
+#endif /* APP_GROUP_H */
+
+
+/*******************************************************************************
+ End of File
+ */
@@ -0,0 +1,425 @@
+/*******************************************************************************
+* Copyright (C) 2025 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  Application L2CAP Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    app_l2cap.c
+
+  Summary:
+    This file contains the L2CAP credit-based channel transport of the
+    application.
+
+  Description:
+    This file tracks one credit-based channel per connection, bridges the
+    received SDUs to the UART and returns credits from the room left in the
+    receive FIFO.
+ *******************************************************************************/
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include <string.h>
+#include "osal/osal_freertos_extend.h"
+#include "ble_util/mw_conn.h"
+#include "peripheral/sercom/usart/plib_sercom0_usart.h"
+#include "app_timer/app_timer.h"
+#include "app_l2cap.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Macros
+// *****************************************************************************
+// *****************************************************************************
+#define APP_L2CAP_SDU_LEN_FIELD_SIZE            (2U)        // SDU length field of the first K-frame.
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+typedef struct APP_L2CAP_Chan_T
+{
+    bool                inUse;              // Channel is open.
+    uint8_t             leL2capId;          // L2CAP instance of the channel.
+    uint16_t            connHandle;         // Connection handle of the link.
+    uint16_t            remoteMtu;          // Largest SDU accepted by the peer.
+    uint16_t            remoteMps;          // Largest K-frame payload accepted by the peer.
+    uint16_t            txCredits;          // Credits granted by the peer.
+    uint16_t            rxCredits;          // Credits granted to the peer and not used yet.
+    APP_L2CAP_Stats_T   stats;              // Statistics of the channel.
+} APP_L2CAP_Chan_T;
+
+typedef struct APP_L2CAP_Fifo_T
+{
+    uint16_t            head;               // Next byte to write to the UART.
+    uint16_t            count;              // Number of bytes in the FIFO.
+    uint8_t             buf[APP_L2CAP_RX_FIFO_SIZE];
+} APP_L2CAP_Fifo_T;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Global Variables
+// *****************************************************************************
+// *****************************************************************************
+static APP_L2CAP_Chan_T         s_chan[MW_CONN_MAX_NBR];
+static APP_L2CAP_Fifo_T         s_rxFifo;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Functions
+// *****************************************************************************
+// *****************************************************************************
+static APP_L2CAP_Chan_T *app_l2cap_GetChanByHandle(uint16_t connHandle)
+{
+    uint8_t index;
+
+    index = MW_CONN_GetIndex(connHandle);
+    if ((index >= MW_CONN_MAX_NBR) || (!s_chan[index].inUse) || (s_chan[index].connHandle != connHandle))
+    {
+        return NULL;
+    }
+
+    return &s_chan[index];
+}
+
+static APP_L2CAP_Chan_T *app_l2cap_GetChanById(uint8_t leL2capId)
+{
+    uint8_t i;
+
+    for (i = 0; i < MW_CONN_MAX_NBR; i++)
+    {
+        if ((s_chan[i].inUse) && (s_chan[i].leL2capId == leL2capId))
+        {
+            return &s_chan[i];
+        }
+    }
+
+    return NULL;
+}
+
+static uint32_t app_l2cap_FifoFree(void)
+{
+    uint32_t reserved = 0;
+    uint8_t i;
+
+    // Room promised to the credits already granted is not available for new credits
+    for (i = 0; i < MW_CONN_MAX_NBR; i++)
+    {
+        if (s_chan[i].inUse)
+        {
+            reserved += (uint32_t)s_chan[i].rxCredits * APP_L2CAP_MPS;
+        }
+    }
+
+    reserved += s_rxFifo.count;
+
+    return (reserved >= APP_L2CAP_RX_FIFO_SIZE) ? 0U : (APP_L2CAP_RX_FIFO_SIZE - reserved);
+}
+
+static bool app_l2cap_FifoPut(uint16_t len, uint8_t *p_data)
+{
+    uint16_t tail;
+    uint16_t chunk;
+
+    if (len > (APP_L2CAP_RX_FIFO_SIZE - s_rxFifo.count))
+    {
+        return false;
+    }
+
+    tail = (uint16_t)((s_rxFifo.head + s_rxFifo.count) % APP_L2CAP_RX_FIFO_SIZE);
+    chunk = ((APP_L2CAP_RX_FIFO_SIZE - tail) < len) ? (uint16_t)(APP_L2CAP_RX_FIFO_SIZE - tail) : len;
+
+    (void)memcpy(&s_rxFifo.buf[tail], p_data, chunk);
+    (void)memcpy(&s_rxFifo.buf[0], &p_data[chunk], len - chunk);
+    s_rxFifo.count += len;
+
+    return true;
+}
+
+static void app_l2cap_ReturnCredits(void)
+{
+    APP_L2CAP_Chan_T *p_chan;
+    uint32_t affordable;
+    uint16_t credits;
+    uint8_t i;
+
+    for (i = 0; i < MW_CONN_MAX_NBR; i++)
+    {
+        p_chan = &s_chan[i];
+        if ((!p_chan->inUse) || (p_chan->rxCredits >= APP_L2CAP_MAX_CREDITS))
+        {
+            continue;
+        }
+
+        affordable = app_l2cap_FifoFree() / APP_L2CAP_MPS;
+        credits = APP_L2CAP_MAX_CREDITS - p_chan->rxCredits;
+        if (credits > affordable)
+        {
+            credits = (uint16_t)affordable;
+        }
+
+        // Batch the returns to save signaling PDUs, unless the peer cannot send at all
+        if ((credits == 0U) || ((credits < APP_L2CAP_CREDIT_BATCH) && (p_chan->rxCredits != 0U)))
+        {
+            continue;
+        }
+
+        if (BLE_L2CAP_CbAddCredits(p_chan->leL2capId, credits) == MBA_RES_SUCCESS)
+        {
+            p_chan->rxCredits += credits;
+        }
+    }
+}
+
+static void app_l2cap_Open(BLE_L2CAP_EvtCbConnInd_T *p_connInd)
+{
+    APP_L2CAP_Chan_T *p_chan;
+    uint8_t index;
+
+    index = MW_CONN_GetIndex(p_connInd->connHandle);
+    if ((p_connInd->spsm != APP_L2CAP_SPSM) || (index >= MW_CONN_MAX_NBR) || (s_chan[index].inUse))
+    {
+        // Only one bridge channel per link
+        (void)BLE_L2CAP_CbDiscReq(p_connInd->leL2capId);
+        return;
+    }
+
+    // The stack granted the initial credits when it accepted the channel, the FIFO must have room for them
+    if (app_l2cap_FifoFree() < ((uint32_t)APP_L2CAP_INIT_CREDITS * APP_L2CAP_MPS))
+    {
+        (void)BLE_L2CAP_CbDiscReq(p_connInd->leL2capId);
+        return;
+    }
+
+    p_chan = &s_chan[index];
+    (void)memset(p_chan, 0, sizeof(APP_L2CAP_Chan_T));
+    p_chan->inUse = true;
+    p_chan->leL2capId = p_connInd->leL2capId;
+    p_chan->connHandle = p_connInd->connHandle;
+    p_chan->remoteMtu = p_connInd->remoteMtu;
+    p_chan->remoteMps = p_connInd->remoteMps;
+    p_chan->txCredits = p_connInd->initialCredits;
+    p_chan->rxCredits = APP_L2CAP_INIT_CREDITS;
+}
+
+static void app_l2cap_ReceiveSdu(BLE_L2CAP_EvtCbSduInd_T *p_sduInd)
+{
+    APP_L2CAP_Chan_T *p_chan;
+
+    p_chan = app_l2cap_GetChanById(p_sduInd->leL2capId);
+    if (p_chan == NULL)
+    {
+        return;
+    }
+
+    p_chan->rxCredits = (p_sduInd->frames >= p_chan->rxCredits) ? 0U : (uint16_t)(p_chan->rxCredits - p_sduInd->frames);
+    if (p_chan->rxCredits == 0U)
+    {
+        p_chan->stats.rxStallCnt++;
+    }
+
+    if (app_l2cap_FifoPut(p_sduInd->length, p_sduInd->payload))
+    {
+        p_chan->stats.rxSduCnt++;
+        p_chan->stats.rxByteCnt += p_sduInd->length;
+    }
+    else
+    {
+        p_chan->stats.rxDropCnt++;
+    }
+
+    APP_L2CAP_Drain();
+}
+
+uint16_t APP_L2CAP_Init(void)
+{
+    (void)memset(s_chan, 0, sizeof(s_chan));
+    (void)memset(&s_rxFifo, 0, sizeof(s_rxFifo));
+
+    if (BLE_L2CAP_CbRegisterSpsm(APP_L2CAP_SPSM, APP_L2CAP_MTU, APP_L2CAP_MPS, APP_L2CAP_INIT_CREDITS, BLE_L2CAP_PERMISSION_NONE) != MBA_RES_SUCCESS)
+    {
+        return APP_RES_FAIL;
+    }
+
+    return APP_RES_SUCCESS;
+}
+
+void APP_L2CAP_EvtHandler(BLE_L2CAP_Event_T *p_event)
+{
+    switch (p_event->eventId)
+    {
+        case BLE_L2CAP_EVT_CB_CONN_IND:
+        {
+            app_l2cap_Open(&p_event->eventField.evtCbConnInd);
+        }
+        break;
+
+        case BLE_L2CAP_EVT_CB_SDU_IND:
+        {
+            app_l2cap_ReceiveSdu(&p_event->eventField.evtCbSduInd);
+        }
+        break;
+
+        case BLE_L2CAP_EVT_CB_ADD_CREDITS_IND:
+        {
+            APP_L2CAP_Chan_T *p_chan;
+
+            p_chan = app_l2cap_GetChanById(p_event->eventField.evtCbAddCreditsInd.leL2capId);
+            if (p_chan != NULL)
+            {
+                p_chan->txCredits += p_event->eventField.evtCbAddCreditsInd.credits;
+            }
+        }
+        break;
+
+        case BLE_L2CAP_EVT_CB_DISC_IND:
+        {
+            APP_L2CAP_Chan_T *p_chan;
+
+            p_chan = app_l2cap_GetChanById(p_event->eventField.evtCbDiscInd.leL2capId);
+            if (p_chan != NULL)
+            {
+                p_chan->inUse = false;
+            }
+        }
+        break;
+
+        default:
+        break;
+    }
+}
+
+void APP_L2CAP_GapEvtHandler(BLE_GAP_Event_T *p_event)
+{
+    if (p_event->eventId == BLE_GAP_EVT_DISCONNECTED)
+    {
+        APP_L2CAP_Chan_T *p_chan;
+
+        p_chan = app_l2cap_GetChanByHandle(p_event->eventField.evtDisconnect.connHandle);
+        if (p_chan != NULL)
+        {
+            p_chan->inUse = false;
+        }
+    }
+}
+
+uint16_t APP_L2CAP_SendData(uint16_t connHandle, uint16_t len, uint8_t *p_data)
+{
+    APP_L2CAP_Chan_T *p_chan;
+    uint16_t frames;
+    uint16_t result;
+
+    p_chan = app_l2cap_GetChanByHandle(connHandle);
+    if ((p_chan == NULL) || (len == 0U) || (len > p_chan->remoteMtu) || (p_chan->remoteMps == 0U))
+    {
+        return APP_RES_INVALID_PARA;
+    }
+
+    frames = (uint16_t)((len + APP_L2CAP_SDU_LEN_FIELD_SIZE + p_chan->remoteMps - 1U) / p_chan->remoteMps);
+    if (frames > p_chan->txCredits)
+    {
+        p_chan->stats.txStallCnt++;
+        return APP_RES_NO_RESOURCE;
+    }
+
+    result = BLE_L2CAP_CbSendSdu(p_chan->leL2capId, len, p_data);
+    if (result != MBA_RES_SUCCESS)
+    {
+        return (result == MBA_RES_INVALID_PARA) ? APP_RES_INVALID_PARA : APP_RES_NO_RESOURCE;
+    }
+
+    p_chan->txCredits -= frames;
+    p_chan->stats.txSduCnt++;
+    p_chan->stats.txByteCnt += len;
+
+    return APP_RES_SUCCESS;
+}
+
+uint8_t APP_L2CAP_BroadcastData(uint16_t len, uint8_t *p_data)
+{
+    uint8_t sentNum = 0;
+    uint8_t i;
+
+    for (i = 0; i < MW_CONN_MAX_NBR; i++)
+    {
+        if ((s_chan[i].inUse) && (APP_L2CAP_SendData(s_chan[i].connHandle, len, p_data) == APP_RES_SUCCESS))
+        {
+            sentNum++;
+        }
+    }
+
+    return sentNum;
+}
+
+void APP_L2CAP_Drain(void)
+{
+    uint16_t chunk;
+    size_t written;
+
+    while (s_rxFifo.count > 0U)
+    {
+        chunk = ((APP_L2CAP_RX_FIFO_SIZE - s_rxFifo.head) < s_rxFifo.count) ? (uint16_t)(APP_L2CAP_RX_FIFO_SIZE - s_rxFifo.head) : s_rxFifo.count;
+        written = SERCOM0_USART_Write(&s_rxFifo.buf[s_rxFifo.head], chunk);
+        if (written == 0U)
+        {
+            break;
+        }
+
+        s_rxFifo.head = (uint16_t)((s_rxFifo.head + written) % APP_L2CAP_RX_FIFO_SIZE);
+        s_rxFifo.count -= (uint16_t)written;
+    }
+
+    app_l2cap_ReturnCredits();
+
+    // Poll until the UART has taken everything
+    if (s_rxFifo.count > 0U)
+    {
+        APP_TIMER_SetTimer(APP_TIMER_L2CAP_DRAIN, APP_TIMER_10MS, false);
+    }
+}
+
+uint16_t APP_L2CAP_GetStats(uint16_t connHandle, APP_L2CAP_Stats_T *p_stats)
+{
+    APP_L2CAP_Chan_T *p_chan;
+
+    p_chan = app_l2cap_GetChanByHandle(connHandle);
+    if ((p_chan == NULL) || (p_stats == NULL))
+    {
+        return APP_RES_INVALID_PARA;
+    }
+
+    (void)memcpy(p_stats, &p_chan->stats, sizeof(APP_L2CAP_Stats_T));
+
+    return APP_RES_SUCCESS;
+}
@@ -0,0 +1,272 @@
+/*******************************************************************************
+* Copyright (C) 2025 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  MPLAB Harmony Application Header File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    app_l2cap.h
+
+  Summary:
+    This header file provides prototypes and definitions for the L2CAP
+    credit-based channel transport of the application.
+
+  Description:
+    A central may open one L2CAP credit-based channel per connection on
+    APP_L2CAP_SPSM as an alternative to the Transparent service. SDUs of up to
+    APP_L2CAP_MTU bytes are carried in a single send, the segmentation into
+    K-frames being handled by the stack. Received SDUs are bridged to the UART
+    through a receive FIFO, and credits are returned to the peer only while the
+    FIFO has room for the frames they allow, so a slow UART throttles the peer
+    instead of dropping data. A channel is refused when the FIFO has no room
+    for its initial credits.
+*******************************************************************************/
+
+#ifndef APP_L2CAP_H
+#define APP_L2CAP_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "mba_error_defs.h"
+#include "app_error_defs.h"
+#include "ble_gap.h"
+#include "ble_l2cap.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+extern "C" {
+
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Macros
+// *****************************************************************************
+// *****************************************************************************
+#define APP_L2CAP_SPSM                          (0x0080U)                   /* SPSM of the bridge channel. */
+#define APP_L2CAP_MTU                           (BLE_L2CAP_MAX_SDU_SIZE)    /* Largest SDU accepted from the peer. */
+#define APP_L2CAP_MPS                           (247U)                      /* K-frame payload filling one LE data PDU of 251 bytes. */
+#define APP_L2CAP_INIT_CREDITS                  (2U)                        /* Credits granted when a channel is opened. */
+#define APP_L2CAP_MAX_CREDITS                   (4U)                        /* Credits the peer may hold at once on one channel. */
+#define APP_L2CAP_CREDIT_BATCH                  (2U)                        /* Minimum credits returned at once unless the peer is stalled. */
+#define APP_L2CAP_RX_FIFO_SIZE                  (2048U)                     /* Size of the receive FIFO towards the UART. Covers the initial credits of CONFIG_APP_MAX_CONN_NBR channels. */
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+/* Statistics of a channel. */
+typedef struct APP_L2CAP_Stats_T
+{
+    uint32_t    txSduCnt;           /* Number of SDUs sent. */
+    uint32_t    txByteCnt;          /* Number of SDU bytes sent. */
+    uint32_t    rxSduCnt;           /* Number of SDUs received. */
+    uint32_t    rxByteCnt;          /* Number of SDU bytes received. */
+    uint32_t    txStallCnt;         /* Number of sends rejected because the peer granted too few credits. */
+    uint32_t    rxStallCnt;         /* Number of times the peer ran out of credits granted by the local device. */
+    uint32_t    rxDropCnt;          /* Number of SDUs dropped because the receive FIFO was full. */
+} APP_L2CAP_Stats_T;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Function Prototypes
+// *****************************************************************************
+// *****************************************************************************
+
+/*******************************************************************************
+  Function:
+    uint16_t APP_L2CAP_Init(void)
+
+  Summary:
+     Initialize the transport and register APP_L2CAP_SPSM.
+
+  Description:
+
+  Precondition:
+    BLE_L2CAP_CbInit shall be called before this function.
+
+  Parameters:
+    None.
+
+  Returns:
+    APP_RES_SUCCESS - The SPSM is registered.
+    APP_RES_FAIL    - The SPSM could not be registered.
+
+*/
+uint16_t APP_L2CAP_Init(void);
+
+/*******************************************************************************
+  Function:
+    void APP_L2CAP_EvtHandler(BLE_L2CAP_Event_T *p_event)
+
+  Summary:
+     Handle the credit-based channel events of the L2CAP layer.
+
+  Description:
+
+  Precondition:
+
+  Parameters:
+    p_event - Pointer to the L2CAP event.
+
+  Returns:
+    None.
+
+*/
+void APP_L2CAP_EvtHandler(BLE_L2CAP_Event_T *p_event);
+
+/*******************************************************************************
+  Function:
+    void APP_L2CAP_GapEvtHandler(BLE_GAP_Event_T *p_event)
+
+  Summary:
+     Release the channel of a disconnected link.
+
+  Description:
+
+  Precondition:
+
+  Parameters:
+    p_event - Pointer to the GAP event.
+
+  Returns:
+    None.
+
+*/
+void APP_L2CAP_GapEvtHandler(BLE_GAP_Event_T *p_event);
+
+/*******************************************************************************
+  Function:
+    uint16_t APP_L2CAP_SendData(uint16_t connHandle, uint16_t len, uint8_t *p_data)
+
+  Summary:
+     Send an SDU on the channel of a connection.
+
+  Description:
+    The SDU is sent only when the peer granted enough credits for all of its
+    K-frames, so a rejected SDU can be retried as a whole.
+
+  Precondition:
+
+  Parameters:
+    connHandle - Connection handle of the link.
+    len        - Length of the SDU, up to the MTU of the peer.
+    p_data     - Pointer to the SDU.
+
+  Returns:
+    APP_RES_SUCCESS      - The SDU is queued in the stack.
+    APP_RES_INVALID_PARA - No channel is open on the link or the SDU is too long.
+    APP_RES_NO_RESOURCE  - The peer granted too few credits or the stack is out of buffers.
+
+*/
+uint16_t APP_L2CAP_SendData(uint16_t connHandle, uint16_t len, uint8_t *p_data);
+
+/*******************************************************************************
+  Function:
+    uint8_t APP_L2CAP_BroadcastData(uint16_t len, uint8_t *p_data)
+
+  Summary:
+     Send an SDU on every open channel.
+
+  Description:
+
+  Precondition:
+
+  Parameters:
+    len    - Length of the SDU.
+    p_data - Pointer to the SDU.
+
+  Returns:
+    Number of channels the SDU was sent on.
+
+*/
+uint8_t APP_L2CAP_BroadcastData(uint16_t len, uint8_t *p_data);
+
+/*******************************************************************************
+  Function:
+    void APP_L2CAP_Drain(void)
+
+  Summary:
+     Move the received data from the receive FIFO to the UART.
+
+  Description:
+    This function is called on APP_TIMER_L2CAP_DRAIN_MSG while the receive
+    FIFO is not empty, and returns credits to the peers as room is freed.
+
+  Precondition:
+
+  Parameters:
+    None.
+
+  Returns:
+    None.
+
+*/
+void APP_L2CAP_Drain(void);
+
+/*******************************************************************************
+  Function:
+    uint16_t APP_L2CAP_GetStats(uint16_t connHandle, APP_L2CAP_Stats_T *p_stats)
+
+  Summary:
+     Get the statistics of the channel of a connection.
+
+  Description:
+
+  Precondition:
+
+  Parameters:
+    connHandle - Connection handle of the link.
+    p_stats    - Pointer to where the statistics are stored.
+
+  Returns:
+    APP_RES_SUCCESS      - The statistics are retrieved.
+    APP_RES_INVALID_PARA - No channel is open on the link.
+
+*/
+uint16_t APP_L2CAP_GetStats(uint16_t connHandle, APP_L2CAP_Stats_T *p_stats);
+
+//DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+//DOM-IGNORE-END
+
+#endif /* APP_L2CAP_H */
+
+
+/*******************************************************************************
+ End of File
+ */
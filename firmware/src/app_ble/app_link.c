@@ -0,0 +1,489 @@
+/*******************************************************************************
+* Copyright (C) 2025 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  Application Link Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    app_link.c
+
+  Summary:
+    This file contains the link negotiation and telemetry of the application.
+
+  Description:
+    This file requests the LE 2M PHY and the largest ATT MTU on each new link,
+    falls back to the LE 1M PHY on high path loss, and reports the link status
+    through the Link Status Service.
+ *******************************************************************************/
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include <string.h>
+#include "osal/osal_freertos_extend.h"
+#include "ble_util/mw_conn.h"
+#include "ble_util/byte_stream.h"
+#include "ble_trsps/ble_trsps.h"
+#include "ble_lss/ble_lss.h"
+#include "app_timer/app_timer.h"
+#include "app_link.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Macros
+// *****************************************************************************
+// *****************************************************************************
+#define APP_LINK_TICK_TO_MS(tick)               ((uint32_t)(tick) * portTICK_PERIOD_MS)
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+typedef struct APP_LINK_Link_T
+{
+    bool            inUse;              // Link is tracked.
+    bool            notifyEnabled;      // The peer subscribed to the link status.
+    bool            is2mSupported;      // The peer has not rejected the LE 2M PHY.
+    uint8_t         txPhy;              // Current TX PHY.
+    uint8_t         rxPhy;              // Current RX PHY.
+    uint8_t         requestedPhys;      // PHYs of the update in progress, 0 if none.
+    uint8_t         pathLossZone;       // Last reported path loss zone.
+    uint16_t        connHandle;         // Connection handle of the link.
+    uint16_t        attMtu;             // Negotiated ATT MTU.
+    uint16_t        connInterval;       // Current connection interval.
+    uint32_t        txThroughput;       // Transparent data sent during the last period. (bytes/s)
+    uint32_t        rxThroughput;       // Transparent data received during the last period. (bytes/s)
+    uint32_t        lastTxByteCnt;      // TRSPS byte counters at the last sample.
+    uint32_t        lastRxByteCnt;
+    TickType_t      sampleTick;         // Tick of the last sample.
+} APP_LINK_Link_T;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Global Variables
+// *****************************************************************************
+// *****************************************************************************
+static APP_LINK_Link_T          s_link[MW_CONN_MAX_NBR];
+static uint8_t                  s_linkNum;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Functions
+// *****************************************************************************
+// *****************************************************************************
+static APP_LINK_Link_T *app_link_GetLink(uint16_t connHandle)
+{
+    uint8_t index;
+
+    index = MW_CONN_GetIndex(connHandle);
+    if ((index >= MW_CONN_MAX_NBR) || (!s_link[index].inUse) || (s_link[index].connHandle != connHandle))
+    {
+        return NULL;
+    }
+
+    return &s_link[index];
+}
+
+static void app_link_BuildStatus(APP_LINK_Link_T *p_link, uint8_t *p_value)
+{
+    p_value[BLE_LSS_STATUS_OFFSET_TX_PHY] = p_link->txPhy;
+    p_value[BLE_LSS_STATUS_OFFSET_RX_PHY] = p_link->rxPhy;
+    U16_TO_BUF_LE(&p_value[BLE_LSS_STATUS_OFFSET_ATT_MTU], p_link->attMtu);
+    U16_TO_BUF_LE(&p_value[BLE_LSS_STATUS_OFFSET_CONN_INTERVAL], p_link->connInterval);
+    U32_TO_BUF_LE(&p_value[BLE_LSS_STATUS_OFFSET_TX_THROUGHPUT], p_link->txThroughput);
+    U32_TO_BUF_LE(&p_value[BLE_LSS_STATUS_OFFSET_RX_THROUGHPUT], p_link->rxThroughput);
+    p_value[BLE_LSS_STATUS_OFFSET_PATH_LOSS_ZONE] = p_link->pathLossZone;
+}
+
+static void app_link_NotifyStatus(APP_LINK_Link_T *p_link)
+{
+    GATTS_HandleValueParams_T *p_hvParams;
+
+    if (!p_link->notifyEnabled)
+    {
+        return;
+    }
+
+    p_hvParams = OSAL_Malloc(sizeof(GATTS_HandleValueParams_T));
+    if (p_hvParams == NULL)
+    {
+        return;
+    }
+
+    p_hvParams->charHandle = LSS_HDL_CHARVAL_STATUS;
+    p_hvParams->charLength = BLE_LSS_STATUS_LEN;
+    p_hvParams->sendType = ATT_HANDLE_VALUE_NTF;
+    app_link_BuildStatus(p_link, p_hvParams->charValue);
+
+    // A status dropped for lack of TX buffers is superseded by the next period
+    (void)GATTS_SendHandleValue(p_link->connHandle, p_hvParams);
+
+    OSAL_Free(p_hvParams);
+}
+
+static void app_link_SetPhy(APP_LINK_Link_T *p_link, uint8_t phys)
+{
+    if (BLE_GAP_SetPhy(p_link->connHandle, phys, phys, BLE_GAP_PHY_PREF_NO) == MBA_RES_SUCCESS)
+    {
+        p_link->requestedPhys = phys;
+    }
+}
+
+static void app_link_Open(BLE_GAP_EvtConnect_T *p_connect)
+{
+    BLE_TRSPS_CreditStats_T stats;
+    APP_LINK_Link_T *p_link;
+    uint8_t index;
+
+    index = MW_CONN_GetIndex(p_connect->connHandle);
+    if (index >= MW_CONN_MAX_NBR)
+    {
+        return;
+    }
+
+    p_link = &s_link[index];
+    if (!p_link->inUse)
+    {
+        s_linkNum++;
+    }
+
+    (void)memset(p_link, 0, sizeof(APP_LINK_Link_T));
+    p_link->inUse = true;
+    p_link->is2mSupported = true;
+    p_link->connHandle = p_connect->connHandle;
+    p_link->txPhy = BLE_GAP_PHY_TYPE_LE_1M;
+    p_link->rxPhy = BLE_GAP_PHY_TYPE_LE_1M;
+    p_link->attMtu = BLE_ATT_DEFAULT_MTU_LEN;
+    p_link->connInterval = p_connect->interval;
+    p_link->pathLossZone = BLE_GAP_PATH_LOSS_ZONE_LOW;
+    p_link->sampleTick = xTaskGetTickCount();
+
+    if (BLE_TRSPS_GetCreditStats(p_link->connHandle, &stats) == MBA_RES_SUCCESS)
+    {
+        p_link->lastTxByteCnt = stats.txByteCnt;
+        p_link->lastRxByteCnt = stats.rxByteCnt;
+    }
+
+    app_link_SetPhy(p_link, BLE_GAP_PHY_OPTION_2M);
+    (void)GATTC_ExchangeMTURequest(p_link->connHandle, BLE_ATT_MAX_MTU_LEN);
+
+    if (s_linkNum == 1U)
+    {
+        APP_TIMER_SetTimer(APP_TIMER_LINK_STATUS, APP_LINK_STATUS_PERIOD_MS, true);
+    }
+}
+
+static void app_link_EnablePathLoss(uint16_t connHandle)
+{
+    BLE_GAP_PathLossReportingParams_T pathLoss;
+
+    if (app_link_GetLink(connHandle) == NULL)
+    {
+        return;
+    }
+
+    pathLoss.connHandle = connHandle;
+    pathLoss.highThreshold = APP_LINK_PATH_LOSS_HIGH_THRESHOLD;
+    pathLoss.highHysteresis = APP_LINK_PATH_LOSS_HIGH_HYSTERESIS;
+    pathLoss.lowThreshold = APP_LINK_PATH_LOSS_LOW_THRESHOLD;
+    pathLoss.lowHysteresis = APP_LINK_PATH_LOSS_LOW_HYSTERESIS;
+    pathLoss.minTimeSpent = APP_LINK_PATH_LOSS_MIN_TIME;
+    if (BLE_GAP_SetPathLossReportingParams(&pathLoss) == MBA_RES_SUCCESS)
+    {
+        (void)BLE_GAP_SetPathLossReportingEnable(connHandle, true);
+    }
+}
+
+static void app_link_Close(uint16_t connHandle)
+{
+    APP_LINK_Link_T *p_link;
+
+    p_link = app_link_GetLink(connHandle);
+    if (p_link == NULL)
+    {
+        return;
+    }
+
+    p_link->inUse = false;
+    s_linkNum--;
+
+    if (s_linkNum == 0U)
+    {
+        APP_TIMER_StopTimer(APP_TIMER_LINK_STATUS);
+    }
+}
+
+static void app_link_PathLossHandler(BLE_GAP_EvtPathLossThreshold_T *p_pathLoss)
+{
+    APP_LINK_Link_T *p_link;
+
+    p_link = app_link_GetLink(p_pathLoss->connHandle);
+    if (p_link == NULL)
+    {
+        return;
+    }
+
+    p_link->pathLossZone = p_pathLoss->zoneEntered;
+
+    // The LE 1M PHY has a better sensitivity, so keep the link alive at the cell edge
+    if ((p_pathLoss->zoneEntered == BLE_GAP_PATH_LOSS_ZONE_HIGH) && (p_link->txPhy == BLE_GAP_PHY_TYPE_LE_2M))
+    {
+        app_link_SetPhy(p_link, BLE_GAP_PHY_OPTION_1M);
+    }
+    else if ((p_pathLoss->zoneEntered == BLE_GAP_PATH_LOSS_ZONE_LOW) && (p_link->is2mSupported)
+        && (p_link->txPhy != BLE_GAP_PHY_TYPE_LE_2M))
+    {
+        app_link_SetPhy(p_link, BLE_GAP_PHY_OPTION_2M);
+    }
+
+    app_link_NotifyStatus(p_link);
+}
+
+static void app_link_ReadHandler(GATT_EvtRead_T *p_read)
+{
+    GATTS_SendReadRespParams_T *p_respParams;
+    GATTS_SendErrRespParams_T errParams;
+    APP_LINK_Link_T *p_link;
+
+    if (p_read->attrHandle != LSS_HDL_CHARVAL_STATUS)
+    {
+        return;
+    }
+
+    p_link = app_link_GetLink(p_read->connHandle);
+    if ((p_link == NULL) || (p_read->readType == ATT_READ_BLOB_REQ))
+    {
+        // The status always fits in the default MTU
+        errParams.reqOpcode = p_read->readType;
+        errParams.attrHandle = p_read->attrHandle;
+        errParams.errorCode = (p_link == NULL) ? ATT_ERR_UNLIKELY_ERROR : ATT_ERR_ATTRIBUTE_NOT_LONG;
+        (void)GATTS_SendErrorResponse(p_read->connHandle, &errParams);
+        return;
+    }
+
+    p_respParams = OSAL_Malloc(sizeof(GATTS_SendReadRespParams_T));
+    if (p_respParams == NULL)
+    {
+        return;
+    }
+
+    p_respParams->responseType = ATT_READ_RSP;
+    p_respParams->attrLength = BLE_LSS_STATUS_LEN;
+    app_link_BuildStatus(p_link, p_respParams->attrValue);
+    (void)GATTS_SendReadResponse(p_read->connHandle, p_respParams);
+
+    OSAL_Free(p_respParams);
+}
+
+static void app_link_WriteHandler(GATT_EvtWrite_T *p_write)
+{
+    GATTS_SendWriteRespParams_T *p_respParams;
+    APP_LINK_Link_T *p_link;
+
+    if (p_write->attrHandle != LSS_HDL_CCCD_STATUS)
+    {
+        return;
+    }
+
+    p_link = app_link_GetLink(p_write->connHandle);
+    if ((p_link != NULL) && (p_write->writeDataLength >= 2U))
+    {
+        p_link->notifyEnabled = ((p_write->writeValue[0] & NOTIFICATION) != 0U);
+    }
+
+    if (p_write->writeType == ATT_WRITE_REQ)
+    {
+        p_respParams = OSAL_Malloc(sizeof(GATTS_SendWriteRespParams_T));
+        if (p_respParams == NULL)
+        {
+            return;
+        }
+
+        p_respParams->responseType = ATT_WRITE_RSP;
+        (void)GATTS_SendWriteResponse(p_write->connHandle, p_respParams);
+
+        OSAL_Free(p_respParams);
+    }
+}
+
+void APP_LINK_Init(void)
+{
+    (void)memset(s_link, 0, sizeof(s_link));
+    s_linkNum = 0;
+}
+
+void APP_LINK_GapEvtHandler(BLE_GAP_Event_T *p_event)
+{
+    switch (p_event->eventId)
+    {
+        case BLE_GAP_EVT_CONNECTED:
+        {
+            if (p_event->eventField.evtConnect.status == GAP_STATUS_SUCCESS)
+            {
+                app_link_Open(&p_event->eventField.evtConnect);
+            }
+        }
+        break;
+
+        case BLE_GAP_EVT_DISCONNECTED:
+        {
+            app_link_Close(p_event->eventField.evtDisconnect.connHandle);
+        }
+        break;
+
+        case BLE_GAP_EVT_CONN_PARAM_UPDATE:
+        {
+            APP_LINK_Link_T *p_link;
+
+            p_link = app_link_GetLink(p_event->eventField.evtConnParamUpdate.connHandle);
+            if ((p_link != NULL) && (p_event->eventField.evtConnParamUpdate.status == GAP_STATUS_SUCCESS))
+            {
+                p_link->connInterval = p_event->eventField.evtConnParamUpdate.connParam.intervalMax;
+                app_link_NotifyStatus(p_link);
+            }
+        }
+        break;
+
+        case BLE_GAP_EVT_PHY_UPDATE:
+        {
+            APP_LINK_Link_T *p_link;
+
+            p_link = app_link_GetLink(p_event->eventField.evtPhyUpdate.connHandle);
+            if (p_link != NULL)
+            {
+                if (p_event->eventField.evtPhyUpdate.status == GAP_STATUS_SUCCESS)
+                {
+                    p_link->txPhy = p_event->eventField.evtPhyUpdate.txPhy;
+                    p_link->rxPhy = p_event->eventField.evtPhyUpdate.rxPhy;
+                }
+                else if (p_link->requestedPhys == BLE_GAP_PHY_OPTION_2M)
+                {
+                    // Do not ask again for a PHY the peer does not support
+                    p_link->is2mSupported = false;
+                }
+                p_link->requestedPhys = 0U;
+                app_link_NotifyStatus(p_link);
+            }
+        }
+        break;
+
+        case BLE_GAP_EVT_FEATURE_EXCHANGE_COMPL:
+        {
+            // Path loss reporting relies on the features of the peer
+            app_link_EnablePathLoss(p_event->eventField.evtFeatureExchangeCompl.connHandle);
+        }
+        break;
+
+        case BLE_GAP_EVT_PATH_LOSS_THRESHOLD:
+        {
+            app_link_PathLossHandler(&p_event->eventField.evtPathLossThreshold);
+        }
+        break;
+
+        default:
+        break;
+    }
+}
+
+void APP_LINK_GattEvtHandler(GATT_Event_T *p_event)
+{
+    switch (p_event->eventId)
+    {
+        case ATT_EVT_UPDATE_MTU:
+        {
+            APP_LINK_Link_T *p_link;
+
+            p_link = app_link_GetLink(p_event->eventField.onUpdateMTU.connHandle);
+            if (p_link != NULL)
+            {
+                p_link->attMtu = p_event->eventField.onUpdateMTU.exchangedMTU;
+                app_link_NotifyStatus(p_link);
+            }
+        }
+        break;
+
+        case GATTS_EVT_READ:
+        {
+            app_link_ReadHandler(&p_event->eventField.onRead);
+        }
+        break;
+
+        case GATTS_EVT_WRITE:
+        {
+            app_link_WriteHandler(&p_event->eventField.onWrite);
+        }
+        break;
+
+        default:
+        break;
+    }
+}
+
+uint16_t APP_LINK_GetMtu(uint16_t connHandle)
+{
+    APP_LINK_Link_T *p_link = app_link_GetLink(connHandle);
+
+    return (p_link != NULL) ? p_link->attMtu : BLE_ATT_DEFAULT_MTU_LEN;
+}
+
+void APP_LINK_Tick(void)
+{
+    BLE_TRSPS_CreditStats_T stats;
+    TickType_t now;
+    uint32_t elapsedMs;
+    uint8_t i;
+
+    now = xTaskGetTickCount();
+
+    for (i = 0; i < MW_CONN_MAX_NBR; i++)
+    {
+        if ((!s_link[i].inUse) || (BLE_TRSPS_GetCreditStats(s_link[i].connHandle, &stats) != MBA_RES_SUCCESS))
+        {
+            continue;
+        }
+
+        elapsedMs = APP_LINK_TICK_TO_MS(now - s_link[i].sampleTick);
+        if (elapsedMs == 0U)
+        {
+            continue;
+        }
+
+        s_link[i].txThroughput = (uint32_t)(((uint64_t)(stats.txByteCnt - s_link[i].lastTxByteCnt) * 1000U) / elapsedMs);
+        s_link[i].rxThroughput = (uint32_t)(((uint64_t)(stats.rxByteCnt - s_link[i].lastRxByteCnt) * 1000U) / elapsedMs);
+        s_link[i].lastTxByteCnt = stats.txByteCnt;
+        s_link[i].lastRxByteCnt = stats.rxByteCnt;
+        s_link[i].sampleTick = now;
+
+        app_link_NotifyStatus(&s_link[i]);
+    }
+}
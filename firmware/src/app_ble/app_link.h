@@ -0,0 +1,202 @@
+/*******************************************************************************
+* Copyright (C) 2025 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  MPLAB Harmony Application Header File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    app_link.h
+
+  Summary:
+    This header file provides prototypes and definitions for the link
+    negotiation and telemetry of the application.
+
+  Description:
+    Right after a connection is established, the application requests the
+    LE 2M PHY and the largest ATT MTU. The link falls back to the LE 1M PHY
+    when the path loss enters the high zone, and returns to the LE 2M PHY
+    once it is back in the low zone. The negotiated values and the transparent
+    data throughput of each link are reported through the Link Status Service.
+*******************************************************************************/
+
+#ifndef APP_LINK_H
+#define APP_LINK_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ble_gap.h"
+#include "gatt.h"
+#include "mba_error_defs.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+extern "C" {
+
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Macros
+// *****************************************************************************
+// *****************************************************************************
+#define APP_LINK_STATUS_PERIOD_MS               (1000U)     /* Period of the throughput sampling and of the status notification. */
+
+/* Path loss zones used to fall back to the LE 1M PHY and to return to the LE 2M PHY. (Unit: dB) */
+#define APP_LINK_PATH_LOSS_HIGH_THRESHOLD       (80U)
+#define APP_LINK_PATH_LOSS_HIGH_HYSTERESIS      (5U)
+#define APP_LINK_PATH_LOSS_LOW_THRESHOLD        (60U)
+#define APP_LINK_PATH_LOSS_LOW_HYSTERESIS       (5U)
+#define APP_LINK_PATH_LOSS_MIN_TIME             (16U)       /* Connection events spent beyond a threshold before it is reported. */
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Function Prototypes
+// *****************************************************************************
+// *****************************************************************************
+
+/*******************************************************************************
+  Function:
+    void APP_LINK_Init(void)
+
+  Summary:
+     Initialize the link negotiation and telemetry.
+
+  Description:
+
+  Precondition:
+    The GATT server shall be initialized.
+
+  Parameters:
+    None.
+
+  Returns:
+    None.
+
+*/
+void APP_LINK_Init(void);
+
+/*******************************************************************************
+  Function:
+    void APP_LINK_GapEvtHandler(BLE_GAP_Event_T *p_event)
+
+  Summary:
+     Negotiate the PHY and MTU of new links and track the link parameters.
+
+  Description:
+
+  Precondition:
+
+  Parameters:
+    p_event - Pointer to the GAP event.
+
+  Returns:
+    None.
+
+*/
+void APP_LINK_GapEvtHandler(BLE_GAP_Event_T *p_event);
+
+/*******************************************************************************
+  Function:
+    void APP_LINK_GattEvtHandler(GATT_Event_T *p_event)
+
+  Summary:
+     Track the MTU and serve the Link Status Service.
+
+  Description:
+
+  Precondition:
+
+  Parameters:
+    p_event - Pointer to the GATT event.
+
+  Returns:
+    None.
+
+*/
+void APP_LINK_GattEvtHandler(GATT_Event_T *p_event);
+
+/*******************************************************************************
+  Function:
+    uint16_t APP_LINK_GetMtu(uint16_t connHandle)
+
+  Summary:
+     Get the negotiated ATT MTU of a link.
+
+  Description:
+
+  Precondition:
+
+  Parameters:
+    connHandle - Connection handle of the link.
+
+  Returns:
+    The ATT MTU, BLE_ATT_DEFAULT_MTU_LEN if the link is unknown.
+
+*/
+uint16_t APP_LINK_GetMtu(uint16_t connHandle);
+
+/*******************************************************************************
+  Function:
+    void APP_LINK_Tick(void)
+
+  Summary:
+     Sample the throughput of every link and notify the subscribed links.
+
+  Description:
+    This function shall be called every APP_LINK_STATUS_PERIOD_MS while a link
+    is open. The periodic timer is managed by the module itself.
+
+  Precondition:
+
+  Parameters:
+    None.
+
+  Returns:
+    None.
+
+*/
+void APP_LINK_Tick(void);
+
+//DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+//DOM-IGNORE-END
+
+#endif /* APP_LINK_H */
+
+
+/*******************************************************************************
+ End of File
+ */
@@ -0,0 +1,201 @@
+/*******************************************************************************
+* Copyright (C) 2025 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  Application Session Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    app_session.c
+
+  Summary:
+    This file contains the connection sessions of the application.
+
+  Description:
+    This file keeps one session per connected central and arbitrates the servo
+    control ownership between them. Sessions are indexed by the connection slot
+    of the BLE middleware so that lookups take constant time.
+ *******************************************************************************/
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include <string.h>
+#include "osal/osal_freertos_extend.h"
+#include "app_session.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Macros
+// *****************************************************************************
+// *****************************************************************************
+#define APP_SESSION_OWNER_NONE          MW_CONN_INDEX_INVALID
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+typedef struct APP_SESSION_Session_T
+{
+    bool            inUse;              // Session is open.
+    uint16_t        connHandle;         // Connection handle of the session.
+    TickType_t      lastCmdTick;        // Tick of the last accepted servo command.
+} APP_SESSION_Session_T;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Global Variables
+// *****************************************************************************
+// *****************************************************************************
+static APP_SESSION_Session_T    s_session[MW_CONN_MAX_NBR];
+static uint8_t                  s_sessionNum;
+static uint8_t                  s_ownerIndex;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Functions
+// *****************************************************************************
+// *****************************************************************************
+static APP_SESSION_Session_T *app_session_Get(uint16_t connHandle, uint8_t *p_index)
+{
+    uint8_t index;
+
+    index = MW_CONN_GetIndex(connHandle);
+    if ((index >= MW_CONN_MAX_NBR) || (!s_session[index].inUse) || (s_session[index].connHandle != connHandle))
+    {
+        return NULL;
+    }
+
+    if (p_index != NULL)
+    {
+        *p_index = index;
+    }
+
+    return &s_session[index];
+}
+
+void APP_SESSION_Init(void)
+{
+    (void)memset(s_session, 0, sizeof(s_session));
+    s_sessionNum = 0;
+    s_ownerIndex = APP_SESSION_OWNER_NONE;
+}
+
+uint16_t APP_SESSION_Open(uint16_t connHandle)
+{
+    uint8_t index;
+
+    index = MW_CONN_GetIndex(connHandle);
+    if ((index >= MW_CONN_MAX_NBR) || (s_sessionNum >= APP_SESSION_MAX_NBR))
+    {
+        return APP_RES_NO_RESOURCE;
+    }
+
+    if (!s_session[index].inUse)
+    {
+        s_session[index].inUse = true;
+        s_sessionNum++;
+    }
+    s_session[index].connHandle = connHandle;
+    s_session[index].lastCmdTick = 0;
+
+    return APP_RES_SUCCESS;
+}
+
+void APP_SESSION_Close(uint16_t connHandle)
+{
+    uint8_t index;
+
+    if (app_session_Get(connHandle, &index) == NULL)
+    {
+        return;
+    }
+
+    if (s_ownerIndex == index)
+    {
+        s_ownerIndex = APP_SESSION_OWNER_NONE;
+    }
+
+    s_session[index].inUse = false;
+    s_sessionNum--;
+}
+
+uint8_t APP_SESSION_GetNum(void)
+{
+    return s_sessionNum;
+}
+
+uint16_t APP_SESSION_AcquireControl(uint16_t connHandle)
+{
+    APP_SESSION_Session_T *p_session;
+    TickType_t now;
+    uint8_t index;
+
+    p_session = app_session_Get(connHandle, &index);
+    if (p_session == NULL)
+    {
+        return APP_RES_INVALID_PARA;
+    }
+
+    now = xTaskGetTickCount();
+
+    if ((s_ownerIndex != APP_SESSION_OWNER_NONE) && (s_ownerIndex != index)
+        && (((now - s_session[s_ownerIndex].lastCmdTick) * portTICK_PERIOD_MS) < APP_SESSION_OWNER_TIMEOUT_MS))
+    {
+        return APP_RES_BUSY;
+    }
+
+    s_ownerIndex = index;
+    p_session->lastCmdTick = now;
+
+    return APP_RES_SUCCESS;
+}
+
+uint16_t APP_SESSION_ReleaseControl(uint16_t connHandle)
+{
+    uint8_t index;
+
+    if ((app_session_Get(connHandle, &index) == NULL) || (s_ownerIndex != index))
+    {
+        return APP_RES_BAD_STATE;
+    }
+
+    s_ownerIndex = APP_SESSION_OWNER_NONE;
+
+    return APP_RES_SUCCESS;
+}
+
+bool APP_SESSION_IsControlled(void)
+{
+    return ((s_ownerIndex != APP_SESSION_OWNER_NONE)
+        && (((xTaskGetTickCount() - s_session[s_ownerIndex].lastCmdTick) * portTICK_PERIOD_MS) < APP_SESSION_OWNER_TIMEOUT_MS));
+}
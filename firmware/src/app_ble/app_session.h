@@ -0,0 +1,248 @@
+/*******************************************************************************
+* Copyright (C) 2025 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  MPLAB Harmony Application Header File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    app_session.h
+
+  Summary:
+    This header file provides prototypes and definitions for the connection
+    sessions of the application.
+
+  Description:
+    The application keeps one session per connected central. Any session may
+    receive notifications and query the device, but only the session that owns
+    the servo control may change the motor state. Ownership is taken by the
+    first command, and is released on request, on disconnection, or after the
+    owner has been idle for APP_SESSION_OWNER_TIMEOUT_MS.
+*******************************************************************************/
+
+#ifndef APP_SESSION_H
+#define APP_SESSION_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "configuration.h"
+#include "mba_error_defs.h"
+#include "app_error_defs.h"
+#include "ble_util/mw_conn.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+extern "C" {
+
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Macros
+// *****************************************************************************
+// *****************************************************************************
+#define APP_SESSION_MAX_NBR             CONFIG_APP_MAX_CONN_NBR     /* Maximum number of simultaneous sessions. */
+#define APP_SESSION_OWNER_TIMEOUT_MS    (30000U)                    /* Idle time after which the servo control ownership can be taken over. */
+
+#if (APP_SESSION_MAX_NBR > MW_CONN_MAX_NBR)
+#error "CONFIG_APP_MAX_CONN_NBR exceeds the number of links supported by the BLE stack"
+#endif
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Function Prototypes
+// *****************************************************************************
+// *****************************************************************************
+
+/*******************************************************************************
+  Function:
+    void APP_SESSION_Init(void)
+
+  Summary:
+     Initialize the session table.
+
+  Description:
+
+  Precondition:
+
+  Parameters:
+    None.
+
+  Returns:
+    None.
+
+*/
+void APP_SESSION_Init(void);
+
+/*******************************************************************************
+  Function:
+    uint16_t APP_SESSION_Open(uint16_t connHandle)
+
+  Summary:
+     Open a session for a new connection.
+
+  Description:
+
+  Precondition:
+    The connection slot must have been assigned by MW_CONN_BleEventHandler.
+
+  Parameters:
+    connHandle - Connection handle of the new connection.
+
+  Returns:
+    APP_RES_SUCCESS if the session is opened. APP_RES_NO_RESOURCE if the
+    configured connection limit is reached.
+
+*/
+uint16_t APP_SESSION_Open(uint16_t connHandle);
+
+/*******************************************************************************
+  Function:
+    void APP_SESSION_Close(uint16_t connHandle)
+
+  Summary:
+     Close the session of a terminated connection and release its ownership.
+
+  Description:
+
+  Precondition:
+
+  Parameters:
+    connHandle - Connection handle of the terminated connection.
+
+  Returns:
+    None.
+
+*/
+void APP_SESSION_Close(uint16_t connHandle);
+
+/*******************************************************************************
+  Function:
+    uint8_t APP_SESSION_GetNum(void)
+
+  Summary:
+     Get the number of open sessions.
+
+  Description:
+
+  Precondition:
+
+  Parameters:
+    None.
+
+  Returns:
+    Number of open sessions.
+
+*/
+uint8_t APP_SESSION_GetNum(void);
+
+/*******************************************************************************
+  Function:
+    uint16_t APP_SESSION_AcquireControl(uint16_t connHandle)
+
+  Summary:
+     Take or refresh the servo control ownership for a session.
+
+  Description:
+    The ownership is granted if no session owns the servo control, if the
+    requesting session already owns it, or if the owner has been idle for
+    APP_SESSION_OWNER_TIMEOUT_MS.
+
+  Precondition:
+
+  Parameters:
+    connHandle - Connection handle of the requesting session.
+
+  Returns:
+    APP_RES_SUCCESS if the session owns the servo control. APP_RES_BUSY if
+    another session owns it. APP_RES_INVALID_PARA if no session is open for
+    the connection handle.
+
+*/
+uint16_t APP_SESSION_AcquireControl(uint16_t connHandle);
+
+/*******************************************************************************
+  Function:
+    uint16_t APP_SESSION_ReleaseControl(uint16_t connHandle)
+
+  Summary:
+     Release the servo control ownership held by a session.
+
+  Description:
+
+  Precondition:
+
+  Parameters:
+    connHandle - Connection handle of the requesting session.
+
+  Returns:
+    APP_RES_SUCCESS if the ownership is released. APP_RES_BAD_STATE if the
+    session does not own the servo control.
+
+*/
+uint16_t APP_SESSION_ReleaseControl(uint16_t connHandle);
+
+/*******************************************************************************
+  Function:
+    bool APP_SESSION_IsControlled(void)
+
+  Summary:
+     Check if a session owns the servo control.
+
+  Description:
+    An owner idle for APP_SESSION_OWNER_TIMEOUT_MS no longer counts, as its
+    ownership can be taken over.
+
+  Precondition:
+
+  Parameters:
+    None.
+
+  Returns:
+    true if a session owns the servo control, false otherwise.
+
+*/
+bool APP_SESSION_IsControlled(void);
+
+//DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+//DOM-IGNORE-END
+
+#endif /* APP_SESSION_H */
+
+
+/*******************************************************************************
+ End of File
+ */
@@ -0,0 +1,401 @@
+/*******************************************************************************
+* Copyright (C) 2025 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  Application Pairing Key Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    app_smp_key.c
+
+  Summary:
+    This file contains the precomputation of the pairing key material of the
+    application.
+
+  Description:
+    This file has the LE Secure Connections key pair generated in idle time,
+    so that it is ready when a central starts pairing, and measures the time
+    each pairing takes from connection to bonded.
+ *******************************************************************************/
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include <string.h>
+#include "osal/osal_freertos_extend.h"
+#include "mba_error_defs.h"
+#include "ble_util/mw_conn.h"
+#include "app.h"
+#include "app_idle_task.h"
+#include "app_error_defs.h"
+#include "app_smp_key.h"
+#include "app_queue/app_queue.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Macros
+// *****************************************************************************
+// *****************************************************************************
+#define APP_SMP_KEY_STATE_STALE                 (0U)        /* No key pair ready, generate one at the next idle time. */
+#define APP_SMP_KEY_STATE_REQUESTED             (1U)        /* APP_MSG_SMP_KEY_GEN is queued. */
+#define APP_SMP_KEY_STATE_GENERATING            (2U)        /* Waiting for BLE_SMP_EVT_GEN_SC_OOB_DATA_DONE. */
+#define APP_SMP_KEY_STATE_READY                 (3U)        /* The stack holds a key pair for the next pairing. */
+
+#define APP_SMP_KEY_TICKS_TO_MS(ticks)          ((uint32_t)(ticks) * portTICK_PERIOD_MS)
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+typedef struct APP_SMP_KEY_Conn_T
+{
+    bool            inUse;
+    bool            isPairing;          // Pairing started and not completed yet.
+    uint16_t        connHandle;
+    uint32_t        connTick;           // Tick count at connection.
+    uint32_t        pairTick;           // Tick count at pairing start.
+} APP_SMP_KEY_Conn_T;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Global Variables
+// *****************************************************************************
+// *****************************************************************************
+static volatile uint8_t         s_state;
+static volatile uint8_t         s_pairingNum;       // Connections with a pairing in progress, read by the idle task.
+static uint32_t                 s_retryTick;        // Tick count before which no generation is requested.
+static uint32_t                 s_genTick;          // Tick count at the start of the generation.
+static uint32_t                 s_readyTick;        // Tick count when the key pair got ready.
+static uint8_t                  s_confirm[APP_SMP_KEY_OOB_LEN];
+static uint8_t                  s_rand[APP_SMP_KEY_OOB_LEN];
+static APP_SMP_KEY_Conn_T       s_conn[MW_CONN_MAX_NBR];   // Indexed by the MW_CONN slot.
+static APP_SMP_KEY_Stats_T      s_stats;
+static APP_Msg_T                s_genMsg;           // Kept off the idle task stack.
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Functions
+// *****************************************************************************
+// *****************************************************************************
+static APP_SMP_KEY_Conn_T *app_smp_key_GetConn(uint16_t connHandle)
+{
+    uint8_t index;
+
+    index = MW_CONN_GetIndex(connHandle);
+    if ((index >= MW_CONN_MAX_NBR) || (!s_conn[index].inUse) || (s_conn[index].connHandle != connHandle))
+    {
+        return NULL;
+    }
+
+    return &s_conn[index];
+}
+
+static void app_smp_key_StartPairing(APP_SMP_KEY_Conn_T *p_conn)
+{
+    p_conn->isPairing = true;
+    p_conn->pairTick = xTaskGetTickCount();
+    s_pairingNum++;
+
+    s_stats.pairCnt++;
+    if (s_state == APP_SMP_KEY_STATE_READY)
+    {
+        s_stats.readyCnt++;
+    }
+
+    // The key pair goes to this pairing, a new one is generated once no pairing is in progress
+    s_state = APP_SMP_KEY_STATE_STALE;
+    s_stats.isReady = false;
+}
+
+static void app_smp_key_EndPairing(APP_SMP_KEY_Conn_T *p_conn, bool isBonded)
+{
+    uint32_t now = xTaskGetTickCount();
+
+    if (!p_conn->isPairing)
+    {
+        return;
+    }
+
+    p_conn->isPairing = false;
+    s_pairingNum--;
+
+    if (!isBonded)
+    {
+        s_stats.failCnt++;
+        return;
+    }
+
+    s_stats.bondCnt++;
+    s_stats.pairMsLast = APP_SMP_KEY_TICKS_TO_MS(now - p_conn->pairTick);
+    s_stats.bondMsLast = APP_SMP_KEY_TICKS_TO_MS(now - p_conn->connTick);
+    if (s_stats.pairMsLast > s_stats.pairMsMax)
+    {
+        s_stats.pairMsMax = s_stats.pairMsLast;
+    }
+    if (s_stats.bondMsLast > s_stats.bondMsMax)
+    {
+        s_stats.bondMsMax = s_stats.bondMsLast;
+    }
+}
+
+void APP_SMP_KEY_Init(void)
+{
+    memset(s_conn, 0, sizeof(s_conn));
+    memset(&s_stats, 0, sizeof(s_stats));
+    s_pairingNum = 0;
+    s_retryTick = xTaskGetTickCount();
+    s_state = APP_SMP_KEY_STATE_STALE;
+}
+
+void APP_SMP_KEY_IdleHandler(void)
+{
+    OSAL_CRITSECT_DATA_TYPE critState;
+    uint32_t now;
+    bool isDue = false;
+
+    if (s_pairingNum != 0U)
+    {
+        return;
+    }
+
+    now = xTaskGetTickCount();
+
+    // The application task may change the state at any time, the request is taken atomically
+    critState = OSAL_CRIT_Enter(OSAL_CRIT_TYPE_LOW);
+    if (s_state == APP_SMP_KEY_STATE_STALE)
+    {
+        isDue = ((int32_t)(now - s_retryTick) >= 0);
+    }
+    else if ((s_state == APP_SMP_KEY_STATE_READY) && (!APP_IDLE_IsPdsCommitHeld()))
+    {
+        // A key pair in hand is renewed only while the motor is not being driven, the generation stalls the task
+        isDue = ((now - s_readyTick) >= pdMS_TO_TICKS(APP_SMP_KEY_MAX_AGE_MS));
+    }
+    if (isDue)
+    {
+        s_state = APP_SMP_KEY_STATE_REQUESTED;
+    }
+    OSAL_CRIT_Leave(OSAL_CRIT_TYPE_LOW, critState);
+
+    if (!isDue)
+    {
+        return;
+    }
+
+    s_genMsg.msgId = APP_MSG_SMP_KEY_GEN;
+    if (APP_QUEUE_Send(&s_genMsg, 0) != APP_RES_SUCCESS)
+    {
+        s_state = APP_SMP_KEY_STATE_STALE;
+    }
+}
+
+void APP_SMP_KEY_Generate(void)
+{
+    uint32_t now = xTaskGetTickCount();
+
+    // A pairing may have started since the request
+    if ((s_state != APP_SMP_KEY_STATE_REQUESTED) || (s_pairingNum != 0U))
+    {
+        if (s_state == APP_SMP_KEY_STATE_REQUESTED)
+        {
+            s_state = APP_SMP_KEY_STATE_STALE;
+        }
+        return;
+    }
+
+    s_stats.isReady = false;
+
+    if (BLE_SMP_GenerateScOobData() == MBA_RES_SUCCESS)
+    {
+        s_genTick = now;
+        s_state = APP_SMP_KEY_STATE_GENERATING;
+    }
+    else
+    {
+        s_stats.genFailCnt++;
+        s_retryTick = now + pdMS_TO_TICKS(APP_SMP_KEY_RETRY_MS);
+        s_state = APP_SMP_KEY_STATE_STALE;
+    }
+}
+
+void APP_SMP_KEY_GapEvtHandler(BLE_GAP_Event_T *p_event)
+{
+    APP_SMP_KEY_Conn_T *p_conn;
+    uint8_t index;
+
+    switch (p_event->eventId)
+    {
+        case BLE_GAP_EVT_CONNECTED:
+        {
+            if (p_event->eventField.evtConnect.status != GAP_STATUS_SUCCESS)
+            {
+                break;
+            }
+
+            index = MW_CONN_GetIndex(p_event->eventField.evtConnect.connHandle);
+            if (index >= MW_CONN_MAX_NBR)
+            {
+                break;
+            }
+
+            // The slot of a link dropped with a pairing in progress is reused
+            app_smp_key_EndPairing(&s_conn[index], false);
+            s_conn[index].inUse = true;
+            s_conn[index].connHandle = p_event->eventField.evtConnect.connHandle;
+            s_conn[index].connTick = xTaskGetTickCount();
+        }
+        break;
+
+        case BLE_GAP_EVT_DISCONNECTED:
+        {
+            p_conn = app_smp_key_GetConn(p_event->eventField.evtDisconnect.connHandle);
+            if (p_conn != NULL)
+            {
+                app_smp_key_EndPairing(p_conn, false);
+                p_conn->inUse = false;
+            }
+        }
+        break;
+
+        default:
+        break;
+    }
+}
+
+void APP_SMP_KEY_SmpEvtHandler(BLE_SMP_Event_T *p_event)
+{
+    uint32_t genMs;
+
+    switch (p_event->eventId)
+    {
+        case BLE_SMP_EVT_GEN_SC_OOB_DATA_DONE:
+        {
+            if (s_state != APP_SMP_KEY_STATE_GENERATING)
+            {
+                // A pairing started meanwhile and owns the key pair
+                break;
+            }
+
+            memcpy(s_confirm, p_event->eventField.evtGenScOobDataDone.confirm, APP_SMP_KEY_OOB_LEN);
+            memcpy(s_rand, p_event->eventField.evtGenScOobDataDone.randNum, APP_SMP_KEY_OOB_LEN);
+            s_readyTick = xTaskGetTickCount();
+            s_state = APP_SMP_KEY_STATE_READY;
+
+            genMs = APP_SMP_KEY_TICKS_TO_MS(s_readyTick - s_genTick);
+            s_stats.genCnt++;
+            s_stats.genMsLast = genMs;
+            if (genMs > s_stats.genMsMax)
+            {
+                s_stats.genMsMax = genMs;
+            }
+            s_stats.isReady = true;
+        }
+        break;
+
+        case BLE_SMP_EVT_INPUT_SC_OOB_DATA_REQUEST:
+        {
+            // No OOB data is received from the central, only the local OOB data may have been handed out
+            (void)BLE_SMP_ScOobDataReply(p_event->eventField.evtInputScOobData.connHandle, NULL, NULL);
+        }
+        break;
+
+        default:
+        break;
+    }
+}
+
+void APP_SMP_KEY_DmEvtHandler(BLE_DM_Event_T *p_event)
+{
+    APP_SMP_KEY_Conn_T *p_conn;
+
+    p_conn = app_smp_key_GetConn(p_event->connHandle);
+    if (p_conn == NULL)
+    {
+        return;
+    }
+
+    switch (p_event->eventId)
+    {
+        case BLE_DM_EVT_SECURITY_START:
+        {
+            if ((p_event->eventField.evtSecurityStart.procedure == DM_SECURITY_PROC_PAIRING) && (!p_conn->isPairing))
+            {
+                app_smp_key_StartPairing(p_conn);
+            }
+        }
+        break;
+
+        case BLE_DM_EVT_SECURITY_SUCCESS:
+        {
+            if (p_event->eventField.evtSecuritySuccess.procedure == DM_SECURITY_PROC_PAIRING)
+            {
+                app_smp_key_EndPairing(p_conn, true);
+            }
+        }
+        break;
+
+        case BLE_DM_EVT_SECURITY_FAIL:
+        {
+            if (p_event->eventField.evtSecurityFail.procedure == DM_SECURITY_PROC_PAIRING)
+            {
+                app_smp_key_EndPairing(p_conn, false);
+            }
+        }
+        break;
+
+        default:
+        break;
+    }
+}
+
+uint16_t APP_SMP_KEY_GetOobData(uint8_t *p_confirm, uint8_t *p_rand)
+{
+    if (s_state != APP_SMP_KEY_STATE_READY)
+    {
+        return APP_RES_BAD_STATE;
+    }
+
+    memcpy(p_confirm, s_confirm, APP_SMP_KEY_OOB_LEN);
+    memcpy(p_rand, s_rand, APP_SMP_KEY_OOB_LEN);
+
+    return APP_RES_SUCCESS;
+}
+
+void APP_SMP_KEY_GetStats(APP_SMP_KEY_Stats_T *p_stats)
+{
+    *p_stats = s_stats;
+}
+
+
+/*******************************************************************************
+ End of File
+ */
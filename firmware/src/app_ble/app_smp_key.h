@@ -0,0 +1,290 @@
+/*******************************************************************************
+* Copyright (C) 2025 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  MPLAB Harmony Application Header File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    app_smp_key.h
+
+  Summary:
+    This header file provides prototypes and definitions for the precomputed
+    pairing key material of the application.
+
+  Description:
+    LE Secure Connections pairing needs a P-256 key pair. Generating it when
+    a central starts pairing stalls the device. Instead, the key pair is
+    generated ahead, in idle time, through BLE_SMP_GenerateScOobData: the
+    stack keeps the key pair it computed the OOB data with for the next
+    pairing, so pairing starts on a ready key. A key pair is used for one
+    pairing at most and is renewed after APP_SMP_KEY_MAX_AGE_MS anyway.
+
+    The time from connection to bonding is measured on every pairing.
+*******************************************************************************/
+
+#ifndef APP_SMP_KEY_H
+#define APP_SMP_KEY_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ble_gap.h"
+#include "ble_smp.h"
+#include "ble_dm/ble_dm.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+extern "C" {
+
+#endif
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Macros
+// *****************************************************************************
+// *****************************************************************************
+#define APP_SMP_KEY_MAX_AGE_MS                  (600000U)   /* Age at which an unused key pair is renewed. */
+#define APP_SMP_KEY_RETRY_MS                    (1000U)     /* Wait before generating again when the stack was busy. */
+#define APP_SMP_KEY_OOB_LEN                     (16U)       /* Length of the OOB confirm value and random number. */
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+typedef struct APP_SMP_KEY_Stats_T
+{
+    uint32_t        genCnt;             /* Key pairs generated. */
+    uint32_t        genFailCnt;         /* Generations refused by the stack. */
+    uint32_t        genMsLast;          /* Time taken by the last generation. */
+    uint32_t        genMsMax;           /* Longest generation. */
+    uint32_t        pairCnt;            /* Pairings started. */
+    uint32_t        readyCnt;           /* Pairings started with a key pair ready. */
+    uint32_t        bondCnt;            /* Pairings completed. */
+    uint32_t        failCnt;            /* Pairings failed or disconnected before completion. */
+    uint32_t        pairMsLast;         /* Time from pairing start to bonded, last pairing. */
+    uint32_t        pairMsMax;          /* Time from pairing start to bonded, longest. */
+    uint32_t        bondMsLast;         /* Time from connection to bonded, last pairing. */
+    uint32_t        bondMsMax;          /* Time from connection to bonded, longest. */
+    bool            isReady;            /* A key pair is ready now. */
+} APP_SMP_KEY_Stats_T;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Function Prototypes
+// *****************************************************************************
+// *****************************************************************************
+
+/*******************************************************************************
+  Function:
+    void APP_SMP_KEY_Init(void)
+
+  Summary:
+     Initialize the key precomputation.
+
+  Description:
+     The first key pair is generated at the first idle time.
+
+  Precondition:
+
+  Parameters:
+    None.
+
+  Returns:
+    None.
+
+*/
+void APP_SMP_KEY_Init(void);
+
+/*******************************************************************************
+  Function:
+    void APP_SMP_KEY_IdleHandler(void)
+
+  Summary:
+     Request a new key pair when none is ready.
+
+  Description:
+     Called from the idle task. Nothing is generated while a pairing is in
+     progress, and a ready key pair is not renewed while the PDS commits are
+     held after a motor command. The generation itself is started on the APP_MSG_SMP_KEY_GEN
+     message, in the application task.
+
+  Precondition:
+
+  Parameters:
+    None.
+
+  Returns:
+    None.
+
+*/
+void APP_SMP_KEY_IdleHandler(void);
+
+/*******************************************************************************
+  Function:
+    void APP_SMP_KEY_Generate(void)
+
+  Summary:
+     Start the generation of a key pair.
+
+  Description:
+     Called on the APP_MSG_SMP_KEY_GEN message. The key pair is ready on the
+     BLE_SMP_EVT_GEN_SC_OOB_DATA_DONE event.
+
+  Precondition:
+
+  Parameters:
+    None.
+
+  Returns:
+    None.
+
+*/
+void APP_SMP_KEY_Generate(void);
+
+/*******************************************************************************
+  Function:
+    void APP_SMP_KEY_GapEvtHandler(BLE_GAP_Event_T *p_event)
+
+  Summary:
+     Handle the connection and disconnection events.
+
+  Description:
+
+  Precondition:
+
+  Parameters:
+    p_event - Pointer to the GAP event.
+
+  Returns:
+    None.
+
+*/
+void APP_SMP_KEY_GapEvtHandler(BLE_GAP_Event_T *p_event);
+
+/*******************************************************************************
+  Function:
+    void APP_SMP_KEY_SmpEvtHandler(BLE_SMP_Event_T *p_event)
+
+  Summary:
+     Handle the SMP events of the key generation and of the OOB data request.
+
+  Description:
+
+  Precondition:
+
+  Parameters:
+    p_event - Pointer to the SMP event.
+
+  Returns:
+    None.
+
+*/
+void APP_SMP_KEY_SmpEvtHandler(BLE_SMP_Event_T *p_event);
+
+/*******************************************************************************
+  Function:
+    void APP_SMP_KEY_DmEvtHandler(BLE_DM_Event_T *p_event)
+
+  Summary:
+     Handle the start and the end of the pairing procedures.
+
+  Description:
+
+  Precondition:
+
+  Parameters:
+    p_event - Pointer to the DM event.
+
+  Returns:
+    None.
+
+*/
+void APP_SMP_KEY_DmEvtHandler(BLE_DM_Event_T *p_event);
+
+/*******************************************************************************
+  Function:
+    uint16_t APP_SMP_KEY_GetOobData(uint8_t *p_confirm, uint8_t *p_rand)
+
+  Summary:
+     Get the OOB data of the ready key pair.
+
+  Description:
+     The OOB data can be handed to a central over an out of band channel,
+     for OOB pairing.
+
+  Precondition:
+
+  Parameters:
+    p_confirm - Pointer to where the APP_SMP_KEY_OOB_LEN bytes confirm value is stored.
+    p_rand    - Pointer to where the APP_SMP_KEY_OOB_LEN bytes random number is stored.
+
+  Returns:
+    APP_RES_SUCCESS   - The OOB data is copied.
+    APP_RES_BAD_STATE - No key pair is ready.
+
+*/
+uint16_t APP_SMP_KEY_GetOobData(uint8_t *p_confirm, uint8_t *p_rand);
+
+/*******************************************************************************
+  Function:
+    void APP_SMP_KEY_GetStats(APP_SMP_KEY_Stats_T *p_stats)
+
+  Summary:
+     Get the key generation and time to bonded statistics.
+
+  Description:
+
+  Precondition:
+
+  Parameters:
+    p_stats - Pointer to where the statistics are stored.
+
+  Returns:
+    None.
+
+*/
+void APP_SMP_KEY_GetStats(APP_SMP_KEY_Stats_T *p_stats);
+
+//DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+//DOM-IGNORE-END
+
+#endif /* APP_SMP_KEY_H */
+
+
+/*******************************************************************************
+ End of File
+ */
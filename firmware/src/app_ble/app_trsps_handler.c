@@ -45,8 +45,12 @@
 // *****************************************************************************
 #include "app_trsps_handler.h"
 #include "osal/osal_freertos_extend.h"
+#include "ble_util/byte_stream.h"
 #include "peripheral/sercom/usart/plib_sercom0_usart.h"
 #include "app.h"
+#include "app_rec/app_rec.h"
+#include "app_lat/app_lat.h"
+#include "app_queue/app_queue.h"
 
 // *****************************************************************************
 // *****************************************************************************
@@ -93,6 +97,8 @@ void APP_TrspsEvtHandler(BLE_TRSPS_Event_T *p_event)
         {
             uint16_t data_len;
             uint8_t *ble_data;
+            // The event is sent by the service as the data is received
+            uint32_t rxStamp = APP_LAT_Stamp();
 
             // Get received data length
             BLE_TRSPS_GetDataLength(p_event->eventField.onReceiveData.connHandle, &data_len);
@@ -100,19 +106,27 @@ void APP_TrspsEvtHandler(BLE_TRSPS_Event_T *p_event)
             // Allocate memory for data
             ble_data = OSAL_Malloc(data_len);
             if (ble_data == NULL)
+            {
+                APP_REC_Record(APP_REC_TYPE_HEAP_FAIL, data_len, xPortGetFreeHeapSize());
                 break;
+            }
 
             // Retrieve received data
             BLE_TRSPS_GetData(p_event->eventField.onReceiveData.connHandle, ble_data);
 
-            // Create application message
+            // Create application message tagged with the originating session
             APP_Msg_T appMsg;
             appMsg.msgId = APP_MSG_BLE_DATA_EVT;
             memset(appMsg.msgData, 0, sizeof(appMsg.msgData));
-            memcpy(appMsg.msgData, ble_data, data_len);
+            if (data_len > APP_MSG_BLE_DATA_MAX_LEN)
+                data_len = APP_MSG_BLE_DATA_MAX_LEN;
+            U16_TO_BUF_LE(&appMsg.msgData[APP_MSG_CONN_HANDLE_OFFSET], p_event->eventField.onReceiveData.connHandle);
+            appMsg.msgData[APP_MSG_BLE_DATA_LEN_OFFSET] = (uint8_t)data_len;
+            U32_TO_BUF_LE(&appMsg.msgData[APP_MSG_BLE_DATA_STAMP_OFFSET], rxStamp);
+            memcpy(&appMsg.msgData[APP_MSG_BLE_DATA_OFFSET], ble_data, data_len);
 
             // Send to application queue
-            OSAL_QUEUE_Send(&appData.appQueue, &appMsg, 0);
+            (void)APP_QUEUE_Send(&appMsg, 0);
 
             // Free allocated memory
             OSAL_Free(ble_data);
@@ -121,7 +135,14 @@ void APP_TrspsEvtHandler(BLE_TRSPS_Event_T *p_event)
         
         case BLE_TRSPS_EVT_VENDOR_CMD:
         {
-            /* TODO: implement your application code.*/
+            if ((p_event->eventField.onVendorCmd.length > 0U) && (p_event->eventField.onVendorCmd.p_payLoad[0] == APP_REC_VENDOR_OPCODE))
+            {
+                APP_REC_VendorCmdHandler(p_event->eventField.onVendorCmd.connHandle, p_event->eventField.onVendorCmd.length, p_event->eventField.onVendorCmd.p_payLoad);
+            }
+            else if ((p_event->eventField.onVendorCmd.length > 0U) && (p_event->eventField.onVendorCmd.p_payLoad[0] == APP_LAT_VENDOR_OPCODE))
+            {
+                APP_LAT_VendorCmdHandler(p_event->eventField.onVendorCmd.connHandle, p_event->eventField.onVendorCmd.length, p_event->eventField.onVendorCmd.p_payLoad);
+            }
         }
         break;
 
@@ -133,7 +154,7 @@ void APP_TrspsEvtHandler(BLE_TRSPS_Event_T *p_event)
 
         case BLE_TRSPS_EVT_ERR_NO_MEM:
         {
-            /* TODO: implement your application code.*/
+            APP_REC_Record(APP_REC_TYPE_HEAP_FAIL, 0, xPortGetFreeHeapSize());
         }
         break;
 
@@ -0,0 +1,242 @@
+/*******************************************************************************
+  Application Servo Calibration Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    app_cal.c
+
+  Summary:
+    This file contains the Application Servo Calibration functions for this project.
+
+  Description:
+    This file contains the Application Servo Calibration functions for this project.
+    Changes are gathered in RAM and saved once no other change came for
+    APP_CAL_SAVE_DELAY_MS, so that frequent tuning does not wear the flash.
+ *******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2025 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include <stddef.h>
+#include <string.h>
+#include "app_cal.h"
+#include "app_error_defs.h"
+#include "app_timer/app_timer.h"
+#include "pds.h"
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Macros
+// *****************************************************************************
+// *****************************************************************************
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+typedef enum APP_CAL_PdsItem_T
+{
+    APP_CAL_PDS_ITEM_ID = (PDS_MODULE_APP_OFFSET)       // PDS item of the calibration record.
+} APP_CAL_PdsItem_T;
+
+typedef struct APP_CAL_Record_T
+{
+    uint16_t            version;                    // APP_CAL_VERSION.
+    uint16_t            length;                     // Size of the record.
+    APP_CAL_Channel_T   ch[APP_CAL_CH_NUM];
+    uint16_t            crc;                        // CRC-16/CCITT of the fields above.
+} APP_CAL_Record_T;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Variables
+// *****************************************************************************
+// *****************************************************************************
+static APP_CAL_Record_T s_cal;
+static APP_CAL_Record_T s_calStore;                 // Copy written by PDS in the background.
+
+PDS_DECLARE_FILE(APP_CAL_PDS_ITEM_ID, (uint16_t)sizeof(APP_CAL_Record_T), &s_calStore, FILE_INTEGRITY_CONTROL_MARK);
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Functions
+// *****************************************************************************
+// *****************************************************************************
+static uint16_t app_cal_Crc(const APP_CAL_Record_T *p_record)
+{
+    const uint8_t *p_data = (const uint8_t *)p_record;
+    uint16_t crc = 0xFFFF;
+    uint16_t i;
+    uint8_t bit;
+
+    for (i = 0; i < offsetof(APP_CAL_Record_T, crc); i++)
+    {
+        crc ^= (uint16_t)p_data[i] << 8;
+        for (bit = 0; bit < 8U; bit++)
+        {
+            crc = ((crc & 0x8000U) != 0U) ? (uint16_t)((crc << 1) ^ 0x1021U) : (uint16_t)(crc << 1);
+        }
+    }
+
+    return crc;
+}
+
+static void app_cal_SetDefault(void)
+{
+    uint8_t ch;
+
+    (void)memset(&s_cal, 0, sizeof(s_cal));
+    s_cal.version = APP_CAL_VERSION;
+    s_cal.length = (uint16_t)sizeof(APP_CAL_Record_T);
+
+    for (ch = 0; ch < APP_CAL_CH_NUM; ch++)
+    {
+        s_cal.ch[ch].point[APP_CAL_POINT_FORWARD] = APP_CAL_DUTY_FORWARD;
+        s_cal.ch[ch].point[APP_CAL_POINT_NEUTRAL] = APP_CAL_DUTY_NEUTRAL;
+        s_cal.ch[ch].point[APP_CAL_POINT_REVERSE] = APP_CAL_DUTY_REVERSE;
+        s_cal.ch[ch].lastDuty = APP_CAL_DUTY_NEUTRAL;
+    }
+}
+
+static void app_cal_Changed(void)
+{
+    // Restarted on each change, so a tuning session is written once
+    (void)APP_TIMER_SetTimer(APP_TIMER_CAL_SAVE, APP_CAL_SAVE_DELAY_MS, false);
+}
+
+void APP_CAL_Init(void)
+{
+    if (PDS_IsAbleToRestore((uint16_t)APP_CAL_PDS_ITEM_ID) && PDS_Restore((uint16_t)APP_CAL_PDS_ITEM_ID)
+        && (s_calStore.version == APP_CAL_VERSION) && (s_calStore.length == sizeof(APP_CAL_Record_T))
+        && (s_calStore.crc == app_cal_Crc(&s_calStore)))
+    {
+        s_cal = s_calStore;
+    }
+    else
+    {
+        app_cal_SetDefault();
+    }
+}
+
+const APP_CAL_Channel_T *APP_CAL_GetChannel(uint8_t ch)
+{
+    return (ch < APP_CAL_CH_NUM) ? &s_cal.ch[ch] : NULL;
+}
+
+uint32_t APP_CAL_GetOutputDuty(uint8_t ch, uint32_t duty)
+{
+    int32_t out = (int32_t)duty;
+
+    if (ch < APP_CAL_CH_NUM)
+    {
+        out += s_cal.ch[ch].trim;
+    }
+
+    if (out < 0)
+    {
+        out = 0;
+    }
+    else if (out > (int32_t)APP_CAL_DUTY_MAX)
+    {
+        out = (int32_t)APP_CAL_DUTY_MAX;
+    }
+
+    return (uint32_t)out;
+}
+
+uint16_t APP_CAL_SetPoint(uint8_t ch, uint8_t point, uint32_t duty)
+{
+    if ((ch >= APP_CAL_CH_NUM) || (point >= (uint8_t)APP_CAL_POINT_NUM) || (duty > APP_CAL_DUTY_MAX))
+    {
+        return APP_RES_INVALID_PARA;
+    }
+
+    s_cal.ch[ch].point[point] = duty;
+    app_cal_Changed();
+
+    return APP_RES_SUCCESS;
+}
+
+uint16_t APP_CAL_SetTrim(uint8_t ch, int32_t trim)
+{
+    if ((ch >= APP_CAL_CH_NUM) || (trim > (int32_t)APP_CAL_DUTY_MAX) || (trim < -(int32_t)APP_CAL_DUTY_MAX))
+    {
+        return APP_RES_INVALID_PARA;
+    }
+
+    s_cal.ch[ch].trim = trim;
+    app_cal_Changed();
+
+    return APP_RES_SUCCESS;
+}
+
+uint16_t APP_CAL_SetRampStep(uint8_t ch, uint32_t rampStep)
+{
+    if (ch >= APP_CAL_CH_NUM)
+    {
+        return APP_RES_INVALID_PARA;
+    }
+
+    s_cal.ch[ch].rampStep = rampStep;
+    app_cal_Changed();
+
+    return APP_RES_SUCCESS;
+}
+
+void APP_CAL_SetLastDuty(uint8_t ch, uint32_t duty)
+{
+    if ((ch < APP_CAL_CH_NUM) && (s_cal.ch[ch].lastDuty != duty))
+    {
+        s_cal.ch[ch].lastDuty = duty;
+        app_cal_Changed();
+    }
+}
+
+void APP_CAL_Tick(void)
+{
+    // A store still waiting in the PDS queue writes from s_calStore, do not change it under its feet
+    if (PDS_GetPendingItemsCount() != 0U)
+    {
+        app_cal_Changed();
+        return;
+    }
+
+    s_cal.crc = app_cal_Crc(&s_cal);
+    s_calStore = s_cal;
+    (void)PDS_Store((uint16_t)APP_CAL_PDS_ITEM_ID);
+}
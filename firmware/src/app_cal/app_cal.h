@@ -0,0 +1,168 @@
+/*******************************************************************************
+  Application Servo Calibration Header File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    app_cal.h
+
+  Summary:
+    This file contains the Application Servo Calibration functions for this project.
+
+  Description:
+    This file contains the Application Servo Calibration functions for this project.
+    The calibration and the last setpoint of each servo channel are kept in a
+    versioned, CRC protected PDS record, restored at boot before the PWM starts.
+ *******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2025 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+
+#ifndef APP_CAL_H
+#define APP_CAL_H
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include <stdint.h>
+#include <stdbool.h>
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Macros
+// *****************************************************************************
+// *****************************************************************************
+#define APP_CAL_VERSION                     (1U)        /**< Version of the calibration record. A record of another version is discarded. */
+#define APP_CAL_CH_NUM                      (1U)        /**< Number of servo channels. */
+#define APP_CAL_SAVE_DELAY_MS               (10000U)    /**< Changes are saved once no other change came for this time. */
+#define APP_CAL_RAMP_PERIOD_MS              (20U)       /**< Period of the ramp, one servo frame. */
+
+#define APP_CAL_DUTY_FORWARD                (64000U)    /**< Default forward duty. */
+#define APP_CAL_DUTY_NEUTRAL                (96000U)    /**< Default neutral duty. */
+#define APP_CAL_DUTY_REVERSE                (128000U)   /**< Default reverse duty. */
+#define APP_CAL_DUTY_MAX                    (1280000U)  /**< PWM period, highest duty. */
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+
+/**@brief Command points of a servo channel. */
+typedef enum APP_CAL_Point_T
+{
+    APP_CAL_POINT_FORWARD,
+    APP_CAL_POINT_NEUTRAL,
+    APP_CAL_POINT_REVERSE,
+    APP_CAL_POINT_NUM
+} APP_CAL_Point_T;
+
+/**@brief Calibration and state of a servo channel. Duties are PWM counts before the trim. */
+typedef struct APP_CAL_Channel_T
+{
+    uint32_t    point[APP_CAL_POINT_NUM];       /**< Duty of each command point. See @ref APP_CAL_Point_T. */
+    int32_t     trim;                           /**< Offset added to every duty. */
+    uint32_t    rampStep;                       /**< Largest duty change per APP_CAL_RAMP_PERIOD_MS. 0 for no limit. */
+    uint32_t    lastDuty;                       /**< Last setpoint of a session, applied at boot with CONFIG_APP_SERVO_RESUME. */
+} APP_CAL_Channel_T;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Function Prototypes
+// *****************************************************************************
+// *****************************************************************************
+
+/**@brief The function is used to restore the calibration record, or to load the defaults if no valid record is stored.
+ *        PDS must be initialized.
+ */
+void APP_CAL_Init(void);
+
+/**@brief The function is used to get the calibration of a channel.
+ *@param[in] ch                               Channel index.
+ *
+ * @retval Pointer to the calibration, NULL if the channel does not exist.
+ *
+ */
+const APP_CAL_Channel_T *APP_CAL_GetChannel(uint8_t ch);
+
+/**@brief The function is used to get the PWM duty to output for a setpoint, with the trim applied.
+ *@param[in] ch                               Channel index.
+ *@param[in] duty                             Setpoint.
+ *
+ * @retval The PWM duty, limited to the PWM period.
+ *
+ */
+uint32_t APP_CAL_GetOutputDuty(uint8_t ch, uint32_t duty);
+
+/**@brief The function is used to set the duty of a command point.
+ *@param[in] ch                               Channel index.
+ *@param[in] point                            Command point. See @ref APP_CAL_Point_T.
+ *@param[in] duty                             Duty of the point.
+ *
+ * @retval APP_RES_SUCCESS                    The point is set, and saved later.
+ * @retval APP_RES_INVALID_PARA               The channel or the point does not exist, or the duty exceeds APP_CAL_DUTY_MAX.
+ *
+ */
+uint16_t APP_CAL_SetPoint(uint8_t ch, uint8_t point, uint32_t duty);
+
+/**@brief The function is used to set the trim of a channel.
+ *@param[in] ch                               Channel index.
+ *@param[in] trim                             Offset added to every duty.
+ *
+ * @retval APP_RES_SUCCESS                    The trim is set, and saved later.
+ * @retval APP_RES_INVALID_PARA               The channel does not exist, or the trim exceeds APP_CAL_DUTY_MAX.
+ *
+ */
+uint16_t APP_CAL_SetTrim(uint8_t ch, int32_t trim);
+
+/**@brief The function is used to set the ramp limit of a channel.
+ *@param[in] ch                               Channel index.
+ *@param[in] rampStep                         Largest duty change per APP_CAL_RAMP_PERIOD_MS. 0 for no limit.
+ *
+ * @retval APP_RES_SUCCESS                    The limit is set, and saved later.
+ * @retval APP_RES_INVALID_PARA               The channel does not exist.
+ *
+ */
+uint16_t APP_CAL_SetRampStep(uint8_t ch, uint32_t rampStep);
+
+/**@brief The function is used to record the last setpoint of a channel, saved later.
+ *@param[in] ch                               Channel index.
+ *@param[in] duty                             Setpoint.
+ */
+void APP_CAL_SetLastDuty(uint8_t ch, uint32_t duty);
+
+/**@brief The function is used to handle the APP_TIMER_CAL_SAVE_MSG message, it saves the changed record. */
+void APP_CAL_Tick(void);
+
+
+#endif
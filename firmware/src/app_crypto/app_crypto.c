@@ -0,0 +1,406 @@
+/*******************************************************************************
+  Application Crypto Job Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    app_crypto.c
+
+  Summary:
+    This file contains the Application Crypto Job functions for this project.
+
+  Description:
+    This file contains the Application Crypto Job functions for this project.
+    Jobs are started on the crypto engine from the application task, so the
+    task never waits on the engine. The engine interrupt marks the operation
+    done and wakes the task, which polls the completion on every pass: a full
+    queue delays a completion but cannot lose it. Consecutive ECB jobs using
+    the same key are fed to a single engine operation, one wakeup completes
+    all of them. The MW_AES functions complete the running jobs before they
+    use the engine.
+ *******************************************************************************/
+
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2025 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include <string.h>
+#include "definitions.h"
+#include "driver/security/cryptosym/statuscodes.h"
+#include "driver/security/cryptosym/keyref_api.h"
+#include "driver/security/cryptosym/blkcipher_api.h"
+#include "driver/security/cryptosym/aead_api.h"
+#include "driver/security/cryptosym/interrupts_api.h"
+#include "ble_util/mw_aes.h"
+#include "app_crypto.h"
+#include "app_error_defs.h"
+#include "../app.h"
+#include "app_queue/app_queue.h"
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+typedef enum APP_CRYPTO_State_T
+{
+    APP_CRYPTO_STATE_IDLE,          // No job is running.
+    APP_CRYPTO_STATE_RUNNING,       // The engine processes the jobs at the head of the queue.
+    APP_CRYPTO_STATE_DONE           // The engine interrupted, the application task polls the completion.
+} APP_CRYPTO_State_T;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Variables
+// *****************************************************************************
+// *****************************************************************************
+static APP_CRYPTO_Job_T s_job[APP_CRYPTO_JOB_NUM];
+static uint8_t s_jobHead;
+static uint8_t s_jobNum;
+static uint8_t s_runNum;                                    // Jobs at the head of the queue in the running operation.
+static volatile APP_CRYPTO_State_T s_state;
+static bool s_isHeld;                                       // No job is started until the next APP_CRYPTO_Poll.
+static struct crmkeyref s_keyRef;
+static struct crmblkcipher s_blkCipher;
+static struct crmaead s_aead;
+static APP_CRYPTO_Stats_T s_stats;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Functions
+// *****************************************************************************
+// *****************************************************************************
+void SILEX_0_Handler(void)
+{
+    // The line stays asserted until the driver reads the status, mask it until then
+    NVIC_DisableIRQ(SILEX_0_IRQn);
+
+    if (s_state == APP_CRYPTO_STATE_RUNNING)
+    {
+        s_state = APP_CRYPTO_STATE_DONE;
+        APP_QUEUE_WakeISR();
+    }
+}
+
+static APP_CRYPTO_Job_T *app_crypto_GetJob(uint8_t offset)
+{
+    return &s_job[(s_jobHead + offset) % APP_CRYPTO_JOB_NUM];
+}
+
+static void app_crypto_Finish(uint8_t num, uint16_t result)
+{
+    APP_CRYPTO_Job_T job[APP_CRYPTO_BATCH_MAX];
+    uint8_t i;
+
+    // Dequeue first, the callbacks may submit and start new jobs
+    for (i = 0; i < num; i++)
+    {
+        job[i] = s_job[s_jobHead];
+        s_jobHead = (uint8_t)((s_jobHead + 1U) % APP_CRYPTO_JOB_NUM);
+        s_jobNum--;
+
+        s_stats.jobCnt++;
+        if (result != APP_RES_SUCCESS)
+        {
+            s_stats.failCnt++;
+        }
+    }
+
+    for (i = 0; i < num; i++)
+    {
+        if (job[i].cb != NULL)
+        {
+            job[i].cb(result, job[i].context);
+        }
+    }
+}
+
+static int32_t app_crypto_StartEcb(void)
+{
+    const APP_CRYPTO_Job_T *p_first = app_crypto_GetJob(0);
+    const APP_CRYPTO_Job_T *p_job;
+    int32_t s;
+
+    s = CRM_BLKCIPHER_CREATE_AESECB_ENC(&s_blkCipher, &s_keyRef);
+
+    if (s == CRM_OK)
+    {
+        s = CRM_BLKCIPHER_CRYPT(&s_blkCipher, (const char *)p_first->p_in, p_first->length, (char *)p_first->p_out);
+    }
+
+    if (s != CRM_OK)
+    {
+        return s;
+    }
+
+    s_runNum = 1;
+
+    // Append the following jobs with the same key, until the engine takes no more data
+    while ((s_runNum < APP_CRYPTO_BATCH_MAX) && (s_runNum < s_jobNum))
+    {
+        p_job = app_crypto_GetJob(s_runNum);
+        if ((p_job->op != APP_CRYPTO_OP_ECB_ENC)
+            || ((p_job->p_key != p_first->p_key) && (memcmp(p_job->p_key, p_first->p_key, APP_CRYPTO_KEY_LEN) != 0)))
+        {
+            break;
+        }
+
+        if (CRM_BLKCIPHER_CRYPT(&s_blkCipher, (const char *)p_job->p_in, p_job->length, (char *)p_job->p_out) != CRM_OK)
+        {
+            break;
+        }
+
+        s_runNum++;
+    }
+
+    // The interrupt may come as soon as the operation is started
+    s_state = APP_CRYPTO_STATE_RUNNING;
+
+    return CRM_BLKCIPHER_RUN(&s_blkCipher);
+}
+
+static int32_t app_crypto_StartCcm(void)
+{
+    const APP_CRYPTO_Job_T *p_job = app_crypto_GetJob(0);
+    int32_t s;
+
+    if (p_job->op == APP_CRYPTO_OP_CCM_ENC)
+    {
+        s = CRM_AEAD_CREATE_AESCCM_ENC(&s_aead, &s_keyRef, (const char *)p_job->p_nonce, p_job->nonceLen,
+            p_job->tagLen, p_job->aadLen, p_job->length);
+    }
+    else
+    {
+        s = CRM_AEAD_CREATE_AESCCM_DEC(&s_aead, &s_keyRef, (const char *)p_job->p_nonce, p_job->nonceLen,
+            p_job->tagLen, p_job->aadLen, p_job->length);
+    }
+
+    if ((s == CRM_OK) && (p_job->aadLen > 0U))
+    {
+        s = CRM_AEAD_FEED_AAD(&s_aead, (const char *)p_job->p_aad, p_job->aadLen);
+    }
+
+    if (s == CRM_OK)
+    {
+        s = CRM_AEAD_CRYPT(&s_aead, (const char *)p_job->p_in, p_job->length, (char *)p_job->p_out);
+    }
+
+    if (s != CRM_OK)
+    {
+        return s;
+    }
+
+    s_runNum = 1;
+    s_state = APP_CRYPTO_STATE_RUNNING;
+
+    // Producing or verifying the tag starts the operation
+    if (p_job->op == APP_CRYPTO_OP_CCM_ENC)
+    {
+        return CRM_AEAD_PRODUCE_TAG(&s_aead, (char *)p_job->p_tag);
+    }
+
+    return CRM_AEAD_VERIFY_TAG(&s_aead, (const char *)p_job->p_tag);
+}
+
+static void app_crypto_End(int32_t s)
+{
+    uint8_t num = s_runNum;
+
+    s_runNum = 0;
+    s_state = APP_CRYPTO_STATE_IDLE;
+    MW_AES_HoldClock(false);
+    app_crypto_Finish(num, (s == CRM_OK) ? APP_RES_SUCCESS : APP_RES_FAIL);
+}
+
+static int32_t app_crypto_GetStatus(void)
+{
+    if (app_crypto_GetJob(0)->op == APP_CRYPTO_OP_ECB_ENC)
+    {
+        return CRM_BLKCIPHER_STATUS(&s_blkCipher);
+    }
+
+    return CRM_AEAD_STATUS(&s_aead);
+}
+
+static void app_crypto_Start(void)
+{
+    const APP_CRYPTO_Job_T *p_job;
+    int32_t s;
+
+    while ((s_state == APP_CRYPTO_STATE_IDLE) && (s_jobNum > 0U) && (!s_isHeld))
+    {
+        p_job = app_crypto_GetJob(0);
+
+        // The clock stays on until the engine completes
+        MW_AES_HoldClock(true);
+        NVIC_ClearPendingIRQ(SILEX_0_IRQn);
+        NVIC_EnableIRQ(SILEX_0_IRQn);
+
+        s_keyRef = CRM_KEYREF_LOAD_MATERIAL(APP_CRYPTO_KEY_LEN, (const char *)p_job->p_key);
+
+        if (p_job->op == APP_CRYPTO_OP_ECB_ENC)
+        {
+            s = app_crypto_StartEcb();
+        }
+        else
+        {
+            s = app_crypto_StartCcm();
+        }
+
+        if (s == CRM_OK)
+        {
+            s_stats.runCnt++;
+            return;
+        }
+
+        NVIC_DisableIRQ(SILEX_0_IRQn);
+        if (s_runNum == 0U)
+        {
+            s_runNum = 1;
+        }
+        app_crypto_End(s);
+    }
+}
+
+void APP_CRYPTO_Init(void)
+{
+    s_jobHead = 0;
+    s_jobNum = 0;
+    s_runNum = 0;
+    s_state = APP_CRYPTO_STATE_IDLE;
+    s_isHeld = false;
+    (void)memset(&s_stats, 0, sizeof(s_stats));
+
+    // The handler wakes the task, so the line is kept at the level of the other RTOS aware interrupts
+    NVIC_SetPriority(SILEX_0_IRQn, 7);
+    NVIC_DisableIRQ(SILEX_0_IRQn);
+    MW_AES_RegisterAcquireCb(APP_CRYPTO_Wait);
+
+    MW_AES_HoldClock(true);
+    (void)CRM_INTERRUPTS_ENABLE();
+    MW_AES_HoldClock(false);
+}
+
+uint16_t APP_CRYPTO_Submit(const APP_CRYPTO_Job_T *p_job)
+{
+    if ((p_job->length == 0U) || (p_job->p_key == NULL))
+    {
+        return APP_RES_INVALID_PARA;
+    }
+
+    if (p_job->op == APP_CRYPTO_OP_ECB_ENC)
+    {
+        if ((p_job->length % 16U) != 0U)
+        {
+            return APP_RES_INVALID_PARA;
+        }
+    }
+    else if ((p_job->op > APP_CRYPTO_OP_CCM_DEC) || (p_job->nonceLen < 7U) || (p_job->nonceLen > 13U)
+        || (p_job->tagLen < 4U) || (p_job->tagLen > 16U) || ((p_job->tagLen % 2U) != 0U) || (p_job->p_tag == NULL))
+    {
+        return APP_RES_INVALID_PARA;
+    }
+
+    if (s_jobNum == APP_CRYPTO_JOB_NUM)
+    {
+        return APP_RES_NO_RESOURCE;
+    }
+
+    s_job[(s_jobHead + s_jobNum) % APP_CRYPTO_JOB_NUM] = *p_job;
+    s_jobNum++;
+
+    app_crypto_Start();
+
+    return APP_RES_SUCCESS;
+}
+
+bool APP_CRYPTO_IsActive(void)
+{
+    return (s_state != APP_CRYPTO_STATE_IDLE);
+}
+
+void APP_CRYPTO_Wait(void)
+{
+    int32_t s;
+
+    if (s_state == APP_CRYPTO_STATE_IDLE)
+    {
+        return;
+    }
+
+    // The interrupt is not needed any more, it may already have come
+    NVIC_DisableIRQ(SILEX_0_IRQn);
+    s_state = APP_CRYPTO_STATE_DONE;
+
+    do
+    {
+        s = app_crypto_GetStatus();
+    } while (s == CRM_ERR_HW_PROCESSING);
+
+    // Jobs submitted by the callbacks wait, the caller is about to use the engine
+    s_isHeld = true;
+    app_crypto_End(s);
+
+    APP_QUEUE_Wake();
+}
+
+void APP_CRYPTO_Poll(void)
+{
+    int32_t s;
+
+    s_isHeld = false;
+
+    if (s_state == APP_CRYPTO_STATE_DONE)
+    {
+        s = app_crypto_GetStatus();
+
+        if (s == CRM_ERR_HW_PROCESSING)
+        {
+            // Not the end of the operation yet, wait for the next interrupt
+            s_state = APP_CRYPTO_STATE_RUNNING;
+            NVIC_EnableIRQ(SILEX_0_IRQn);
+            return;
+        }
+
+        app_crypto_End(s);
+    }
+
+    app_crypto_Start();
+}
+
+void APP_CRYPTO_GetStats(APP_CRYPTO_Stats_T *p_stats)
+{
+    *p_stats = s_stats;
+}
@@ -0,0 +1,162 @@
+/*******************************************************************************
+  Application Crypto Job Header File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    app_crypto.h
+
+  Summary:
+    This file contains the Application Crypto Job functions for this project.
+
+  Description:
+    This file contains the Application Crypto Job functions for this project.
+    AES jobs are run on the crypto engine without blocking the caller. The
+    completion of each job is reported through the application queue.
+ *******************************************************************************/
+
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2025 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+
+#ifndef APP_CRYPTO_H
+#define APP_CRYPTO_H
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include <stdint.h>
+#include <stdbool.h>
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Macros
+// *****************************************************************************
+// *****************************************************************************
+#define APP_CRYPTO_JOB_NUM                  (8U)        /**< Maximum number of queued crypto jobs. */
+#define APP_CRYPTO_BATCH_MAX                (4U)        /**< Maximum number of ECB jobs run in one engine operation. */
+#define APP_CRYPTO_KEY_LEN                  (16U)       /**< Size of the AES-128 key. */
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+
+/**@brief Crypto job operations. */
+typedef enum APP_CRYPTO_Op_T
+{
+    APP_CRYPTO_OP_ECB_ENC,                      /**< AES-ECB encryption. Consecutive jobs with the same key are batched. */
+    APP_CRYPTO_OP_CCM_ENC,                      /**< AES-CCM encryption, the tag is written to p_tag. */
+    APP_CRYPTO_OP_CCM_DEC                       /**< AES-CCM decryption, the tag is read from p_tag. */
+} APP_CRYPTO_Op_T;
+
+/**@brief Crypto job completion callback, called in the application task.
+ *@param[in] result                           APP_RES_SUCCESS if the job succeeded, APP_RES_FAIL otherwise. A CCM decryption fails on a wrong tag.
+ *@param[in] context                          Context given with the job.
+ */
+typedef void (*APP_CRYPTO_CompleteCb_T)(uint16_t result, uintptr_t context);
+
+/**@brief Crypto job. The buffers must stay valid until the job completes. */
+typedef struct APP_CRYPTO_Job_T
+{
+    APP_CRYPTO_Op_T         op;                 /**< Operation. See @ref APP_CRYPTO_Op_T. */
+    const uint8_t           *p_key;             /**< APP_CRYPTO_KEY_LEN bytes key. */
+    const uint8_t           *p_nonce;           /**< CCM nonce. */
+    uint8_t                 nonceLen;           /**< Size of the CCM nonce, between 7 and 13 bytes. */
+    uint8_t                 tagLen;             /**< Size of the CCM tag, in {4, 6, 8, 10, 12, 14, 16}. */
+    uint16_t                aadLen;             /**< Size of the CCM additional data, may be 0. */
+    const uint8_t           *p_aad;             /**< CCM additional data. */
+    const uint8_t           *p_in;              /**< Input data. */
+    uint8_t                 *p_out;             /**< Output data, may be p_in. */
+    uint16_t                length;             /**< Size of the data. A multiple of 16 bytes for ECB. */
+    uint8_t                 *p_tag;             /**< CCM tag. */
+    APP_CRYPTO_CompleteCb_T cb;                 /**< Completion callback, may be NULL. */
+    uintptr_t               context;            /**< Context given to the completion callback. */
+} APP_CRYPTO_Job_T;
+
+/**@brief Crypto job statistics. */
+typedef struct APP_CRYPTO_Stats_T
+{
+    uint32_t                jobCnt;             /**< Completed jobs. */
+    uint32_t                runCnt;             /**< Engine operations, a batch of jobs counts once. */
+    uint32_t                failCnt;            /**< Failed jobs. */
+} APP_CRYPTO_Stats_T;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Function Prototypes
+// *****************************************************************************
+// *****************************************************************************
+
+/**@brief The function is used to initialize the crypto jobs. It enables the crypto engine interrupts and
+ *        registers @ref APP_CRYPTO_Wait to be called before each MW_AES call. */
+void APP_CRYPTO_Init(void);
+
+/**@brief The function is used to queue a crypto job. The job is started at once if the engine is free.
+ *@param[in] p_job                            Pointer to the job. The structure is copied.
+ *
+ * @retval APP_RES_SUCCESS                    The job is queued.
+ * @retval APP_RES_INVALID_PARA               The sizes do not fit the operation.
+ * @retval APP_RES_NO_RESOURCE                APP_CRYPTO_JOB_NUM jobs are already queued.
+ *
+ */
+uint16_t APP_CRYPTO_Submit(const APP_CRYPTO_Job_T *p_job);
+
+/**@brief The function is used to check if a crypto job is in progress.
+ *        The engine is reserved until the job completes, an MW_AES call completes it first. See @ref APP_CRYPTO_Wait.
+ *
+ * @retval true                               A crypto job is in progress.
+ * @retval false                              No crypto job is in progress.
+ *
+ */
+bool APP_CRYPTO_IsActive(void);
+
+/**@brief The function is used to complete the running jobs at once, before a blocking MW_AES call in the application task.
+ *        The MW_AES functions call it, the callers do not need to. The callbacks are called, the next jobs start
+ *        at the next @ref APP_CRYPTO_Poll.
+ */
+void APP_CRYPTO_Wait(void);
+
+/**@brief The function is used to complete the running jobs once the engine is done and to start the next ones.
+ *        It is called on every pass of the application task, the engine interrupt only wakes the task.
+ */
+void APP_CRYPTO_Poll(void);
+
+/**@brief The function is used to get the crypto job statistics.
+ *@param[out] p_stats                         Pointer to where the statistics are stored.
+ */
+void APP_CRYPTO_GetStats(APP_CRYPTO_Stats_T *p_stats);
+
+
+#endif
@@ -38,35 +38,166 @@
 // DOM-IGNORE-END
 
 #include "definitions.h"
+#include "app_nvm/app_nvm.h"
+#include "app_log/app_log.h"
+#include "ble_util/mw_entropy.h"
+#include "app_ble/app_smp_key.h"
+
+static volatile uint32_t s_pdsHoldUntil;        // Tick count until which PDS commits are held.
+static bool s_isPdsPending;
+static uint8_t s_pdsPendingCnt;
+static uint32_t s_pdsFirstTick;                 // Tick count when an item became pending with none before.
+static uint32_t s_pdsChangeTick;                // Tick count when the last item was added.
+static APP_IDLE_PdsStats_T s_pdsStats;
+
+void APP_IDLE_HoldPdsCommit(uint32_t ms)
+{
+    uint32_t until = xTaskGetTickCount() + pdMS_TO_TICKS(ms);
+
+    if ((int32_t)(until - s_pdsHoldUntil) > 0)
+    {
+        s_pdsHoldUntil = until;
+    }
+}
+
+bool APP_IDLE_IsPdsCommitHeld(void)
+{
+    return ((int32_t)(s_pdsHoldUntil - xTaskGetTickCount()) > 0);
+}
+
+void APP_IDLE_GetPdsStats(APP_IDLE_PdsStats_T *p_stats)
+{
+    *p_stats = s_pdsStats;
+}
+
+static bool app_idle_PdsCommitDue(uint8_t pending, uint32_t now)
+{
+    if (pending == 0U)
+    {
+        s_isPdsPending = false;
+        s_pdsPendingCnt = 0;
+        return false;
+    }
+
+    if (!s_isPdsPending)
+    {
+        s_isPdsPending = true;
+        s_pdsFirstTick = now;
+        s_pdsChangeTick = now;
+    }
+    else if (pending > s_pdsPendingCnt)
+    {
+        s_pdsChangeTick = now;
+    }
+    s_pdsPendingCnt = pending;
+
+    if ((now - s_pdsFirstTick) >= pdMS_TO_TICKS(APP_IDLE_PDS_MAX_DEFER_MS))
+    {
+        return true;
+    }
+
+    // Let a burst of updates to the same items settle, so that they are written once
+    if ((now - s_pdsChangeTick) < pdMS_TO_TICKS(APP_IDLE_PDS_SETTLE_MS))
+    {
+        return false;
+    }
+
+    return ((int32_t)(s_pdsHoldUntil - now) <= 0);
+}
+
+// Microsecond time stamp from the tick count and the SysTick down counter
+static uint64_t app_idle_GetTimeUs(void)
+{
+    uint32_t tick, val, load;
+
+    do
+    {
+        tick = xTaskGetTickCount();
+        val = SysTick->VAL;
+    } while (tick != xTaskGetTickCount());
+
+    load = SysTick->LOAD + 1U;
+
+    return ((uint64_t)tick * 1000U) + ((uint64_t)(load - val) * 1000U / load);
+}
+
 void app_idle_task( void )
 {
-    uint8_t PDS_Items_Pending = PDS_GetPendingItemsCount();
-    bool RF_Cal_Needed = RF_NeedCal(); // device_support library API
+    uint32_t now;
+    bool PDS_Commit;
+    bool RF_Cal_Needed;
     uint8_t BT_RF_Suspended = 0;
+    uint64_t suspendUs;
+    OSAL_CRITSECT_DATA_TYPE IntState;
+
+    APP_LOG_Drain();
+
+    // The RF stays suspended until the flash job step completes
+    APP_NVM_IdleCheck();
+    if (APP_NVM_IsActive())
+    {
+        return;
+    }
 
-    if (PDS_Items_Pending || RF_Cal_Needed)
+    now = xTaskGetTickCount();
+    PDS_Commit = app_idle_PdsCommitDue(PDS_GetPendingItemsCount(), now);
+    RF_Cal_Needed = RF_NeedCal(); // device_support library API
+
+    if (!PDS_Commit && !RF_Cal_Needed && APP_NVM_IdleHandler())
+    {
+        return;
+    }
+
+    if (!PDS_Commit && !RF_Cal_Needed)
     {
-        OSAL_CRITSECT_DATA_TYPE IntState;
-        IntState = OSAL_CRIT_Enter(OSAL_CRIT_TYPE_HIGH);
-        BT_RF_Suspended = BT_SYS_RfSuspendReq(1);
-        //once BT_RF_Suspended is true, BT internal RF_Suspend_Req_Flag will be set,
-        //and BT is forbidden to prepare RF.
-        OSAL_CRIT_Leave(OSAL_CRIT_TYPE_HIGH, IntState);
+        // Nothing else to do in this slot, top up the random pool and the pairing key
+        (void)MW_ENTROPY_Refill();
+        APP_SMP_KEY_IdleHandler();
+        return;
+    }
+
+    suspendUs = app_idle_GetTimeUs();
+    IntState = OSAL_CRIT_Enter(OSAL_CRIT_TYPE_HIGH);
+    BT_RF_Suspended = BT_SYS_RfSuspendReq(1);
+    //once BT_RF_Suspended is true, BT internal RF_Suspend_Req_Flag will be set,
+    //and BT is forbidden to prepare RF.
+    OSAL_CRIT_Leave(OSAL_CRIT_TYPE_HIGH, IntState);
+
 
+    if (BT_RF_Suspended)
+    {
+        if (PDS_Commit)
+        {
+            // One item per idle slot, the RF is resumed before the next one
+            PDS_StoreItemTaskHandler();
+        }
+        else if ((RF_Cal_Needed) && (BT_RF_Suspended == BT_SYS_RF_SUSPENDED_NO_SLEEP))
+        {
+            RF_Timer_Cal(WSS_ENABLE_BLE);
+        }
+        BT_SYS_RfSuspendReq(0);
 
-        if (BT_RF_Suspended)
+        if (PDS_Commit)
         {
-            if (PDS_Items_Pending)
+            suspendUs = app_idle_GetTimeUs() - suspendUs;
+            s_pdsStats.writeCnt++;
+            s_pdsStats.suspendUsLast = (uint32_t)suspendUs;
+            s_pdsStats.suspendUsTotal += (uint32_t)suspendUs;
+            if (s_pdsStats.suspendUsLast > s_pdsStats.suspendUsMax)
             {
-                PDS_StoreItemTaskHandler();
+                s_pdsStats.suspendUsMax = s_pdsStats.suspendUsLast;
             }
-            else if ((RF_Cal_Needed) && (BT_RF_Suspended == BT_SYS_RF_SUSPENDED_NO_SLEEP))
+            if ((now - s_pdsFirstTick) > s_pdsStats.deferMsMax)
             {
-                   RF_Timer_Cal(WSS_ENABLE_BLE);
+                s_pdsStats.deferMsMax = now - s_pdsFirstTick;
             }
-            BT_SYS_RfSuspendReq(0);
         }
     }
+    else if (PDS_Commit)
+    {
+        // The link layer could not give up the RF, typically a connection event is imminent
+        s_pdsStats.suspendDenyCnt++;
+    }
 }
 
 
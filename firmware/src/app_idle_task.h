@@ -44,6 +44,8 @@
 // Section: Included Files
 // *****************************************************************************
 // *****************************************************************************
+#include <stdint.h>
+#include <stdbool.h>
 
 
 
@@ -55,6 +57,31 @@ extern "C" {
 #endif
 // DOM-IGNORE-END
 
+// *****************************************************************************
+// *****************************************************************************
+// Section: Macros
+// *****************************************************************************
+// *****************************************************************************
+#define APP_IDLE_PDS_SETTLE_MS          (100U)      /**< Wait for no new PDS store during this time before committing, so bursts of updates are written once. */
+#define APP_IDLE_PDS_MOTOR_HOLD_MS      (500U)      /**< Time to hold PDS commits after a motor command. */
+#define APP_IDLE_PDS_MAX_DEFER_MS       (5000U)     /**< Longest time a pending PDS item waits, even while commits are held. */
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+/**@brief PDS commit statistics. */
+typedef struct APP_IDLE_PdsStats_T
+{
+    uint32_t    writeCnt;           /**< Number of PDS items written to flash. */
+    uint32_t    suspendDenyCnt;     /**< Number of commits the BLE stack refused to suspend the RF for. */
+    uint32_t    suspendUsLast;      /**< Duration of the last RF suspension for a PDS write, in microseconds. */
+    uint32_t    suspendUsMax;       /**< Longest RF suspension for a PDS write, in microseconds. */
+    uint32_t    suspendUsTotal;     /**< Total RF suspension for PDS writes, in microseconds. */
+    uint32_t    deferMsMax;         /**< Longest time from the first pending item to its commit, in milliseconds. */
+} APP_IDLE_PdsStats_T;
+
 // *****************************************************************************
 // *****************************************************************************
 // Section: System Functions
@@ -84,6 +111,38 @@ void app_idle_task( void );
 */
 void app_idle_updateRtcCnt(uint32_t cnt);
 
+// *****************************************************************************
+/**
+*@brief  Hold the PDS commits, so that the RF is not suspended while the application is busy.
+*    A commit is never delayed more than APP_IDLE_PDS_MAX_DEFER_MS after the first pending item.
+*
+*@param ms       -      Hold time in milliseconds. A shorter hold than the current one has no effect.
+*
+*@retval None
+*/
+void APP_IDLE_HoldPdsCommit(uint32_t ms);
+
+// *****************************************************************************
+/**
+*@brief  Check if the PDS commits are held, that is if the application was busy lately.
+*
+*@param None
+*
+*@retval true   -       A hold set by APP_IDLE_HoldPdsCommit has not expired.
+*@retval false  -       No hold.
+*/
+bool APP_IDLE_IsPdsCommitHeld(void);
+
+// *****************************************************************************
+/**
+*@brief  Get the PDS commit statistics.
+*
+*@param p_stats  -      Pointer to where the statistics will be stored.
+*
+*@retval None
+*/
+void APP_IDLE_GetPdsStats(APP_IDLE_PdsStats_T *p_stats);
+
 
 //DOM-IGNORE-BEGIN
 #ifdef __cplusplus
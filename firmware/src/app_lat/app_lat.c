@@ -0,0 +1,373 @@
+/*******************************************************************************
+  Application Latency Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    app_lat.c
+
+  Summary:
+    This file contains the Application Latency functions for this project.
+
+  Description:
+    This file contains the Application Latency functions for this project.
+    Commands are received, dequeued and applied by the application task, so
+    one command is measured at a time and no lock is needed. A command is
+    measured only while the message receiving or applying it is handled. A bucket is
+    found with a count of leading zeros, so counting takes a fixed time.
+ *******************************************************************************/
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include <string.h>
+#include "definitions.h"
+#include "ble_trsps/ble_trsps.h"
+#include "ble_util/byte_stream.h"
+#include "app_log/app_log.h"
+#include "app_queue/app_queue.h"
+#include "app_link.h"
+#include "app_lat.h"
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Macros
+// *****************************************************************************
+// *****************************************************************************
+#define APP_LAT_CYCLES_PER_US               (CPU_CLOCK_FREQUENCY / 1000000U)
+#define APP_LAT_SUMMARY_LEN                 (3U + 16U)
+#define APP_LAT_READ_HEADER_LEN             (4U)
+#define APP_LAT_REPORT_LINE_MAX             (192U)
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+typedef struct APP_LAT_Hist_T
+{
+    uint32_t                count;
+    uint32_t                maxCycles;
+    uint32_t                bucket[APP_LAT_BUCKET_NUM];
+} APP_LAT_Hist_T;
+
+typedef struct APP_LAT_Cmd_T
+{
+    bool                    isOpen;
+    bool                    isParsed;
+    uint32_t                rxStamp;
+    uint32_t                dequeueStamp;
+    uint32_t                parseStamp;
+    uint32_t                actuateStamp;
+} APP_LAT_Cmd_T;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Global Variables
+// *****************************************************************************
+// *****************************************************************************
+static APP_LAT_Hist_T           s_hist[APP_LAT_STAGE_NUM];
+static APP_LAT_Cmd_T            s_cmd;
+static const char * const       s_stageName[APP_LAT_STAGE_NUM] = {"queue", "parse", "actuate", "total", "urgent", "normal", "bulk"};
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Functions
+// *****************************************************************************
+// *****************************************************************************
+void APP_LAT_Count(APP_LAT_Stage_T stage, uint32_t cycles)
+{
+    APP_LAT_Hist_T *p_hist = &s_hist[stage];
+    uint32_t bucket = 32U - __CLZ(cycles);
+
+    if (bucket >= APP_LAT_BUCKET_NUM)
+    {
+        bucket = APP_LAT_BUCKET_NUM - 1U;
+    }
+
+    p_hist->bucket[bucket]++;
+    p_hist->count++;
+    if (cycles > p_hist->maxCycles)
+    {
+        p_hist->maxCycles = cycles;
+    }
+}
+
+// Upper bound of the bucket holding the given percentile, at most the longest time seen
+static uint32_t app_lat_GetPercentile(const APP_LAT_Hist_T *p_hist, uint32_t percent)
+{
+    uint32_t rank = ((p_hist->count * percent) + 99U) / 100U;
+    uint32_t sum = 0U;
+    uint32_t bucket;
+    uint32_t bound = p_hist->maxCycles;
+
+    for (bucket = 0U; bucket < APP_LAT_BUCKET_NUM; bucket++)
+    {
+        sum += p_hist->bucket[bucket];
+        if ((sum >= rank) && (sum != 0U))
+        {
+            bound = (bucket < (APP_LAT_BUCKET_NUM - 1U)) ? ((1UL << bucket) - 1U) : UINT32_MAX;
+            break;
+        }
+    }
+
+    return (bound < p_hist->maxCycles) ? bound : p_hist->maxCycles;
+}
+
+static char *app_lat_PutText(char *p_out, const char *p_text)
+{
+    while (*p_text != '\0')
+    {
+        *p_out++ = *p_text++;
+    }
+
+    return p_out;
+}
+
+static char *app_lat_PutNumber(char *p_out, uint32_t value)
+{
+    char digit[10];
+    uint8_t num = 0U;
+
+    do
+    {
+        digit[num++] = (char)('0' + (value % 10U));
+        value /= 10U;
+    } while (value != 0U);
+
+    while (num > 0U)
+    {
+        *p_out++ = digit[--num];
+    }
+
+    return p_out;
+}
+
+void APP_LAT_Init(void)
+{
+    memset(s_hist, 0, sizeof(s_hist));
+    memset(&s_cmd, 0, sizeof(s_cmd));
+
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+uint32_t APP_LAT_Stamp(void)
+{
+    return DWT->CYCCNT;
+}
+
+void APP_LAT_Begin(uint32_t rxStamp)
+{
+    s_cmd.dequeueStamp = DWT->CYCCNT;
+    s_cmd.rxStamp = rxStamp;
+    s_cmd.isOpen = true;
+    s_cmd.isParsed = false;
+}
+
+void APP_LAT_Mark(APP_LAT_Point_T point)
+{
+    uint32_t stamp = DWT->CYCCNT;
+
+    if (!s_cmd.isOpen)
+    {
+        return;
+    }
+
+    if (point == APP_LAT_POINT_PARSE)
+    {
+        s_cmd.parseStamp = stamp;
+        s_cmd.actuateStamp = stamp;
+        s_cmd.isParsed = true;
+        return;
+    }
+
+    // Applied without a parse point, the parse stage takes the whole time
+    if (!s_cmd.isParsed)
+    {
+        s_cmd.parseStamp = stamp;
+        s_cmd.actuateStamp = stamp;
+    }
+
+    APP_LAT_Count(APP_LAT_STAGE_QUEUE, s_cmd.dequeueStamp - s_cmd.rxStamp);
+    APP_LAT_Count(APP_LAT_STAGE_PARSE, s_cmd.parseStamp - s_cmd.dequeueStamp);
+    APP_LAT_Count(APP_LAT_STAGE_ACTUATE, stamp - s_cmd.actuateStamp);
+    APP_LAT_Count(APP_LAT_STAGE_TOTAL, stamp - s_cmd.rxStamp);
+    s_cmd.isOpen = false;
+}
+
+void APP_LAT_Defer(uint8_t *p_buf)
+{
+    memset(p_buf, 0, APP_LAT_CMD_LEN);
+    if (!s_cmd.isOpen)
+    {
+        return;
+    }
+
+    p_buf[0] = 1U;
+    U32_TO_BUF_LE(&p_buf[1], s_cmd.rxStamp);
+    U32_TO_BUF_LE(&p_buf[5], s_cmd.dequeueStamp);
+    s_cmd.isOpen = false;
+}
+
+void APP_LAT_Resume(const uint8_t *p_buf, uint32_t msgStamp)
+{
+    const uint8_t *p_stamp = &p_buf[1];
+
+    // The wait of the setpoint in the urgent lane is not part of the actuate stage
+    s_cmd.actuateStamp = DWT->CYCCNT;
+    s_cmd.isOpen = (p_buf[0] != 0U);
+    if (!s_cmd.isOpen)
+    {
+        return;
+    }
+
+    STREAM_LE_TO_U32(&s_cmd.rxStamp, &p_stamp);
+    STREAM_LE_TO_U32(&s_cmd.dequeueStamp, &p_stamp);
+    s_cmd.parseStamp = msgStamp;
+    s_cmd.isParsed = true;
+}
+
+void APP_LAT_End(void)
+{
+    s_cmd.isOpen = false;
+}
+
+void APP_LAT_GetSummary(APP_LAT_Stage_T stage, APP_LAT_Summary_T *p_summary)
+{
+    const APP_LAT_Hist_T *p_hist = &s_hist[stage];
+
+    p_summary->count = p_hist->count;
+    p_summary->p50Cycles = app_lat_GetPercentile(p_hist, 50U);
+    p_summary->p99Cycles = app_lat_GetPercentile(p_hist, 99U);
+    p_summary->maxCycles = p_hist->maxCycles;
+}
+
+void APP_LAT_Report(uint16_t connHandle)
+{
+    char line[APP_LAT_REPORT_LINE_MAX];
+    char *p_out;
+    APP_LAT_Summary_T summary;
+    APP_QUEUE_Stats_T laneStats;
+    uint32_t arg[4];
+    uint8_t stage;
+
+    // One line per stage: "lat <stage>: n <count>, p50 <us>, p99 <us>, max <us> us",
+    // the lanes of the application queue add ", starved <count>, full <count>" and the urgent
+    // lane the coalesced setpoints ", setpoints applied <count>, dropped <count>"
+    for (stage = 0U; stage < (uint8_t)APP_LAT_STAGE_NUM; stage++)
+    {
+        APP_LAT_GetSummary((APP_LAT_Stage_T)stage, &summary);
+
+        p_out = app_lat_PutText(line, "lat ");
+        p_out = app_lat_PutText(p_out, s_stageName[stage]);
+        p_out = app_lat_PutText(p_out, ": n ");
+        p_out = app_lat_PutNumber(p_out, summary.count);
+        p_out = app_lat_PutText(p_out, ", p50 ");
+        p_out = app_lat_PutNumber(p_out, summary.p50Cycles / APP_LAT_CYCLES_PER_US);
+        p_out = app_lat_PutText(p_out, ", p99 ");
+        p_out = app_lat_PutNumber(p_out, summary.p99Cycles / APP_LAT_CYCLES_PER_US);
+        p_out = app_lat_PutText(p_out, ", max ");
+        p_out = app_lat_PutNumber(p_out, summary.maxCycles / APP_LAT_CYCLES_PER_US);
+        p_out = app_lat_PutText(p_out, " us");
+        if (stage >= (uint8_t)APP_LAT_STAGE_LANE_URGENT)
+        {
+            APP_QUEUE_GetStats((APP_QUEUE_Lane_T)(stage - (uint8_t)APP_LAT_STAGE_LANE_URGENT), &laneStats);
+            p_out = app_lat_PutText(p_out, ", starved ");
+            p_out = app_lat_PutNumber(p_out, laneStats.starveCnt);
+            p_out = app_lat_PutText(p_out, ", full ");
+            p_out = app_lat_PutNumber(p_out, laneStats.fullCnt);
+        }
+        if (stage == (uint8_t)APP_LAT_STAGE_LANE_URGENT)
+        {
+            p_out = app_lat_PutText(p_out, ", setpoints applied ");
+            p_out = app_lat_PutNumber(p_out, laneStats.latestCnt);
+            p_out = app_lat_PutText(p_out, ", dropped ");
+            p_out = app_lat_PutNumber(p_out, laneStats.coalesceCnt);
+        }
+        p_out = app_lat_PutText(p_out, "\n");
+        (void)BLE_TRSPS_SendData(connHandle, (uint16_t)(p_out - line), (uint8_t *)line);
+
+        arg[0] = stage;
+        arg[1] = summary.p50Cycles / APP_LAT_CYCLES_PER_US;
+        arg[2] = summary.p99Cycles / APP_LAT_CYCLES_PER_US;
+        arg[3] = summary.maxCycles / APP_LAT_CYCLES_PER_US;
+        APP_LOG_Write(APP_LOG_ID_LATENCY, sizeof(arg), arg);
+        if (stage >= (uint8_t)APP_LAT_STAGE_LANE_URGENT)
+        {
+            APP_LOG_2(APP_LOG_ID_LANE, laneStats.starveCnt, laneStats.fullCnt);
+        }
+        if (stage == (uint8_t)APP_LAT_STAGE_LANE_URGENT)
+        {
+            APP_LOG_2(APP_LOG_ID_SETPOINTS, laneStats.latestCnt, laneStats.coalesceCnt);
+        }
+    }
+}
+
+void APP_LAT_VendorCmdHandler(uint16_t connHandle, uint16_t length, const uint8_t *p_payload)
+{
+    uint8_t reply[APP_LAT_READ_HEADER_LEN + (APP_LAT_BUCKET_NUM * 4U)];
+    uint8_t replyLen = 2U;
+    uint8_t *p_cursor;
+    uint32_t bucket, num;
+    APP_LAT_Summary_T summary;
+
+    if (length < 2U)
+    {
+        return;
+    }
+
+    reply[0] = p_payload[1];
+    reply[1] = APP_LAT_STATUS_SUCCESS;
+
+    if ((p_payload[1] == APP_LAT_OP_SUMMARY) && (length == 3U) && (p_payload[2] < (uint8_t)APP_LAT_STAGE_NUM))
+    {
+        APP_LAT_GetSummary((APP_LAT_Stage_T)p_payload[2], &summary);
+        reply[2] = p_payload[2];
+        U32_TO_BUF_LE(&reply[3], summary.count);
+        U32_TO_BUF_LE(&reply[7], summary.p50Cycles);
+        U32_TO_BUF_LE(&reply[11], summary.p99Cycles);
+        U32_TO_BUF_LE(&reply[15], summary.maxCycles);
+        replyLen = APP_LAT_SUMMARY_LEN;
+    }
+    else if ((p_payload[1] == APP_LAT_OP_READ) && (length == 4U) && (p_payload[2] < (uint8_t)APP_LAT_STAGE_NUM)
+        && (p_payload[3] < APP_LAT_BUCKET_NUM))
+    {
+        bucket = p_payload[3];
+
+        // As many buckets as fit in a notification
+        num = (APP_LINK_GetMtu(connHandle) - ATT_NOTI_INDI_HEADER_SIZE - 1U - APP_LAT_READ_HEADER_LEN) / 4U;
+        if (num > (APP_LAT_BUCKET_NUM - bucket))
+        {
+            num = APP_LAT_BUCKET_NUM - bucket;
+        }
+
+        reply[2] = p_payload[2];
+        reply[3] = (uint8_t)bucket;
+        p_cursor = &reply[APP_LAT_READ_HEADER_LEN];
+        for (; num > 0U; num--)
+        {
+            U32_TO_BUF_LE(p_cursor, s_hist[p_payload[2]].bucket[bucket]);
+            bucket++;
+            p_cursor += 4U;
+        }
+        replyLen = (uint8_t)(p_cursor - reply);
+    }
+    else if ((p_payload[1] == APP_LAT_OP_CLEAR) && (length == 2U))
+    {
+        memset(s_hist, 0, sizeof(s_hist));
+    }
+    else
+    {
+        reply[1] = APP_LAT_STATUS_INVALID;
+    }
+
+    (void)BLE_TRSPS_SendVendorCommand(connHandle, APP_LAT_VENDOR_OPCODE, replyLen, reply);
+}
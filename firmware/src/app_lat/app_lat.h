@@ -0,0 +1,192 @@
+/*******************************************************************************
+  Application Latency Header File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    app_lat.h
+
+  Summary:
+    This file contains the Application Latency functions for this project.
+
+  Description:
+    This file contains the Application Latency functions for this project.
+    A servo command is time stamped with the core cycle counter when it is
+    received, taken from the application queue, parsed and committed to the
+    PWM. A setpoint is applied from its own message of the urgent lane, which
+    carries the stamps of its command; the wait in the lane is counted with
+    the lane, not with the command. The time spent in each stage is counted in a histogram of power of 2
+    buckets, read by a central with the APP_LAT_VENDOR_OPCODE vendor command
+    of the transparent service or with the "lat" command. The time messages
+    wait in each lane of the application queue is counted the same way.
+ *******************************************************************************/
+
+
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2025 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+
+#ifndef APP_LAT_H
+#define APP_LAT_H
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include <stdint.h>
+#include <stdbool.h>
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Macros
+// *****************************************************************************
+// *****************************************************************************
+#define APP_LAT_BUCKET_NUM                  (32U)       /**< Bucket n counts the times of n significant bits, in cycles, the last one all the longer times. */
+#define APP_LAT_VENDOR_OPCODE               (0xF1U)     /**< Vendor command of the transparent service to read the histograms. */
+#define APP_LAT_CMD_LEN                     (9U)        /**< Stamps of a command carried by the message applying it, all zero if none. */
+
+/**@brief Operations of the vendor command, in the byte after the opcode. Each reply repeats the operation and a status byte. */
+#define APP_LAT_OP_SUMMARY                  (0x00U)     /**< Request: stage (1). Reply: stage (1), count (4), p50 (4), p99 (4) and max (4), in cycles. */
+#define APP_LAT_OP_READ                     (0x01U)     /**< Request: stage (1), first bucket (1). Reply: stage (1), first bucket (1), counts of the buckets (4 each). */
+#define APP_LAT_OP_CLEAR                    (0x02U)     /**< Clear all the histograms. */
+
+#define APP_LAT_STATUS_SUCCESS              (0x00U)
+#define APP_LAT_STATUS_INVALID              (0x01U)     /**< Unknown operation or stage, or wrong length. */
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+
+/**@brief Points of a command where it is time stamped, after the reception. */
+typedef enum APP_LAT_Point_T
+{
+    APP_LAT_POINT_PARSE = 0,                    /**< The command is recognized and about to be applied. */
+    APP_LAT_POINT_PWM                           /**< The duty is written to the PWM. */
+} APP_LAT_Point_T;
+
+/**@brief Measured stages. Values are used on the air. */
+typedef enum APP_LAT_Stage_T
+{
+    APP_LAT_STAGE_QUEUE = 0,                    /**< Reception to dequeue by the application task. */
+    APP_LAT_STAGE_PARSE,                        /**< Dequeue to parse, a setpoint is parsed when its message is queued. */
+    APP_LAT_STAGE_ACTUATE,                      /**< Parse, or dequeue of the setpoint message, to PWM commit. */
+    APP_LAT_STAGE_TOTAL,                        /**< Reception to PWM commit. */
+    APP_LAT_STAGE_LANE_URGENT,                  /**< Time in the urgent lane of the application queue, of any message. */
+    APP_LAT_STAGE_LANE_NORMAL,                  /**< Time in the normal lane. */
+    APP_LAT_STAGE_LANE_BULK,                    /**< Time in the bulk lane. */
+
+    APP_LAT_STAGE_NUM
+} APP_LAT_Stage_T;
+
+/**@brief Summary of a stage. Percentiles are the upper bound of their bucket, at most the maximum. */
+typedef struct APP_LAT_Summary_T
+{
+    uint32_t                count;              /**< Commands measured. */
+    uint32_t                p50Cycles;          /**< Median. */
+    uint32_t                p99Cycles;          /**< 99th percentile. */
+    uint32_t                maxCycles;          /**< Longest. */
+} APP_LAT_Summary_T;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Function Prototypes
+// *****************************************************************************
+// *****************************************************************************
+
+/**@brief The function is used to initialize the latency measurement and start the cycle counter.
+ */
+void APP_LAT_Init(void);
+
+/**@brief The function is used to read the cycle counter when a command is received.
+ *
+ *@return The current value of the cycle counter.
+ */
+uint32_t APP_LAT_Stamp(void);
+
+/**@brief The function is used to start measuring a command taken from the application queue.
+ *@param[in] rxStamp                          Cycle counter when the command was received. See @ref APP_LAT_Stamp.
+ */
+void APP_LAT_Begin(uint32_t rxStamp);
+
+/**@brief The function is used to time stamp the command being measured. Nothing is done if no command is measured.
+ *        The command ends at the PWM commit.
+ *@param[in] point                            Point reached. See @ref APP_LAT_Point_T.
+ */
+void APP_LAT_Mark(APP_LAT_Point_T point);
+
+/**@brief The function is used to hand the command being measured over to the setpoint message that applies it.
+ *        The command is parsed when the message is queued, at its msgStamp. A setpoint replaced in the queue by a
+ *        newer one is never applied, so its command is not counted.
+ *@param[out] p_buf                           APP_LAT_CMD_LEN bytes of the message, all zero if no command is measured.
+ */
+void APP_LAT_Defer(uint8_t *p_buf);
+
+/**@brief The function is used to resume measuring the command of a setpoint message taken from the application
+ *        queue. The command ends at the next PWM write, the one applying the setpoint.
+ *@param[in] p_buf                            APP_LAT_CMD_LEN bytes of the message. See @ref APP_LAT_Defer.
+ *@param[in] msgStamp                         Cycle counter when the message was queued.
+ */
+void APP_LAT_Resume(const uint8_t *p_buf, uint32_t msgStamp);
+
+/**@brief The function is used to end the command being measured. A command not committed to the PWM is not counted,
+ *        and the PWM writes following, of the ramp or of the group, are not counted.
+ */
+void APP_LAT_End(void);
+
+/**@brief The function is used to count a time in the histogram of a stage, measured elsewhere.
+ *@param[in] stage                            Stage. See @ref APP_LAT_Stage_T.
+ *@param[in] cycles                           Time, in cycles.
+ */
+void APP_LAT_Count(APP_LAT_Stage_T stage, uint32_t cycles);
+
+/**@brief The function is used to get the summary of a stage.
+ *@param[in] stage                            Stage. See @ref APP_LAT_Stage_T.
+ *@param[out] p_summary                       Pointer to the summary.
+ */
+void APP_LAT_GetSummary(APP_LAT_Stage_T stage, APP_LAT_Summary_T *p_summary);
+
+/**@brief The function is used to report the summaries, in microseconds, to a central and on the application log.
+ *@param[in] connHandle                       Connection handle of the central.
+ */
+void APP_LAT_Report(uint16_t connHandle);
+
+/**@brief The function is used to handle the APP_LAT_VENDOR_OPCODE vendor command. The reply is sent as a vendor command with the same opcode.
+ *@param[in] connHandle                       Connection handle of the central.
+ *@param[in] length                           Length of the command, the opcode included.
+ *@param[in] p_payload                        Pointer to the command, starting with the opcode.
+ */
+void APP_LAT_VendorCmdHandler(uint16_t connHandle, uint16_t length, const uint8_t *p_payload);
+
+
+#endif
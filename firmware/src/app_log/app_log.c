@@ -0,0 +1,224 @@
+/*******************************************************************************
+  Application Log Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    app_log.c
+
+  Summary:
+    This file contains the Application Log functions for this project.
+
+  Description:
+    This file contains the Application Log functions for this project. A
+    record is claimed in the ring with an exclusive access on the write
+    index, filled, then published through its sequence number, so logging
+    takes no lock and never waits. The idle task sends the published records
+    in order and reports the records dropped on a full ring.
+ *******************************************************************************/
+
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2025 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include <string.h>
+#include "definitions.h"
+#include "app_log.h"
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+typedef struct APP_LOG_Record_T
+{
+    volatile uint32_t       seq;                // Write index + 1 once the record is complete.
+    uint16_t                id;
+    uint8_t                 len;
+    uint8_t                 data[APP_LOG_DATA_MAX];
+} APP_LOG_Record_T;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Global Variables
+// *****************************************************************************
+// *****************************************************************************
+static APP_LOG_Record_T         s_ring[APP_LOG_RECORD_NUM];
+static volatile uint32_t        s_writeIdx;         // Next record to claim.
+static volatile uint32_t        s_readIdx;          // Next record to send, moved by the idle task only.
+static volatile uint32_t        s_dropCnt;
+static uint32_t                 s_dropSent;         // Drops already reported.
+static APP_LOG_Stats_T          s_stats;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Functions
+// *****************************************************************************
+// *****************************************************************************
+static void app_log_AtomicInc(volatile uint32_t *p_value)
+{
+    uint32_t value;
+
+    do
+    {
+        value = __LDREXW(p_value);
+    } while (__STREXW(value + 1U, p_value) != 0U);
+}
+
+static bool app_log_Send(uint16_t id, uint8_t len, const uint8_t *p_data)
+{
+    uint8_t frame[APP_LOG_FRAME_OVERHEAD + APP_LOG_DATA_MAX];
+    uint8_t size = APP_LOG_FRAME_OVERHEAD + len;
+    uint8_t check = 0;
+    uint8_t i;
+    bool isSent = false;
+    OSAL_CRITSECT_DATA_TYPE critState;
+
+    frame[0] = APP_LOG_FRAME_SYNC;
+    frame[1] = (uint8_t)id;
+    frame[2] = (uint8_t)(id >> 8);
+    frame[3] = len;
+    memcpy(&frame[4], p_data, len);
+    for (i = 1; i < (size - 1U); i++)
+    {
+        check ^= frame[i];
+    }
+    frame[size - 1U] = check;
+
+    // The application task writes the UART as well and may preempt the idle task
+    critState = OSAL_CRIT_Enter(OSAL_CRIT_TYPE_LOW);
+    if (SERCOM0_USART_WriteFreeBufferCountGet() >= size)
+    {
+        (void)SERCOM0_USART_Write(frame, size);
+        isSent = true;
+    }
+    OSAL_CRIT_Leave(OSAL_CRIT_TYPE_LOW, critState);
+
+    if (isSent)
+    {
+        s_stats.recordCnt++;
+        s_stats.byteCnt += size;
+    }
+
+    return isSent;
+}
+
+void APP_LOG_Init(void)
+{
+    memset(s_ring, 0, sizeof(s_ring));
+    memset(&s_stats, 0, sizeof(s_stats));
+    s_writeIdx = 0;
+    s_readIdx = 0;
+    s_dropCnt = 0;
+    s_dropSent = 0;
+}
+
+void APP_LOG_Write(APP_LOG_Id_T id, uint16_t len, const void *p_data)
+{
+    APP_LOG_Record_T *p_record;
+    uint32_t idx;
+
+    if (len > APP_LOG_DATA_MAX)
+    {
+        len = APP_LOG_DATA_MAX;
+    }
+
+    // Claim a record, another task or an interrupt may be claiming one at the same time
+    do
+    {
+        idx = __LDREXW(&s_writeIdx);
+        if ((idx - s_readIdx) >= APP_LOG_RECORD_NUM)
+        {
+            __CLREX();
+            app_log_AtomicInc(&s_dropCnt);
+            return;
+        }
+    } while (__STREXW(idx + 1U, &s_writeIdx) != 0U);
+
+    p_record = &s_ring[idx & (APP_LOG_RECORD_NUM - 1U)];
+    p_record->id = (uint16_t)id;
+    p_record->len = (uint8_t)len;
+    if (len > 0U)
+    {
+        memcpy(p_record->data, p_data, len);
+    }
+
+    // The record is complete before it is published
+    __DMB();
+    p_record->seq = idx + 1U;
+}
+
+void APP_LOG_Drain(void)
+{
+    APP_LOG_Record_T *p_record;
+    uint32_t dropCnt = s_dropCnt;
+    uint32_t lost;
+
+    if (dropCnt != s_dropSent)
+    {
+        lost = dropCnt - s_dropSent;
+        if (!app_log_Send(APP_LOG_ID_DROPPED, sizeof(lost), (const uint8_t *)&lost))
+        {
+            return;
+        }
+        s_dropSent = dropCnt;
+    }
+
+    while (true)
+    {
+        p_record = &s_ring[s_readIdx & (APP_LOG_RECORD_NUM - 1U)];
+        if (p_record->seq != (s_readIdx + 1U))
+        {
+            // Empty, or the next record is still being written
+            break;
+        }
+        __DMB();
+
+        if (!app_log_Send(p_record->id, p_record->len, p_record->data))
+        {
+            break;
+        }
+
+        // The record is sent before it may be claimed again
+        __DMB();
+        s_readIdx++;
+    }
+}
+
+void APP_LOG_GetStats(APP_LOG_Stats_T *p_stats)
+{
+    *p_stats = s_stats;
+    p_stats->dropCnt = s_dropCnt;
+}
@@ -0,0 +1,133 @@
+/*******************************************************************************
+  Application Log Header File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    app_log.h
+
+  Summary:
+    This file contains the Application Log functions for this project.
+
+  Description:
+    This file contains the Application Log functions for this project. A log
+    record is a log ID from app_log_ids.h and its binary arguments. Records
+    are queued in a lock-free ring and sent on the UART by the idle task, the
+    text is rebuilt on the host by tools/app_log_decode.py.
+ *******************************************************************************/
+
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2025 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+
+#ifndef APP_LOG_H
+#define APP_LOG_H
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include <stdint.h>
+#include <stdbool.h>
+#include "app_log_ids.h"
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Macros
+// *****************************************************************************
+// *****************************************************************************
+#define APP_LOG_RECORD_NUM                  (32U)       /**< Records queued until sent, a power of 2. */
+#define APP_LOG_DATA_MAX                    (16U)       /**< Maximum size of the arguments of a record. */
+
+/**@brief Log frame on the UART: sync, log ID (little endian), size of the arguments, arguments and the XOR of the bytes from the log ID on. */
+#define APP_LOG_FRAME_SYNC                  (0x1EU)
+#define APP_LOG_FRAME_OVERHEAD              (5U)
+
+/**@brief Log a message without argument. */
+#define APP_LOG(id)                         APP_LOG_Write((id), 0U, NULL)
+
+/**@brief Log a message with one 32-bit argument. */
+#define APP_LOG_1(id, a)                    do { uint32_t arg_[1] = {(uint32_t)(a)}; APP_LOG_Write((id), sizeof(arg_), arg_); } while (0)
+
+/**@brief Log a message with two 32-bit arguments. */
+#define APP_LOG_2(id, a, b)                 do { uint32_t arg_[2] = {(uint32_t)(a), (uint32_t)(b)}; APP_LOG_Write((id), sizeof(arg_), arg_); } while (0)
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+#define APP_LOG_ID_ENUM_(id, text)          id,
+
+/**@brief Log IDs, in the order of APP_LOG_TABLE. */
+typedef enum APP_LOG_Id_T
+{
+    APP_LOG_TABLE(APP_LOG_ID_ENUM_)
+    APP_LOG_ID_NUM
+} APP_LOG_Id_T;
+
+/**@brief Log statistics. */
+typedef struct APP_LOG_Stats_T
+{
+    uint32_t                recordCnt;          /**< Records sent. */
+    uint32_t                dropCnt;            /**< Records dropped on a full ring. */
+    uint32_t                byteCnt;            /**< Bytes sent on the UART. */
+} APP_LOG_Stats_T;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Function Prototypes
+// *****************************************************************************
+// *****************************************************************************
+
+/**@brief The function is used to initialize the log ring. */
+void APP_LOG_Init(void);
+
+/**@brief The function is used to queue a log record. It never blocks and may be called from any task or interrupt.
+ *@param[in] id                               Log ID. See @ref APP_LOG_Id_T.
+ *@param[in] len                              Size of the arguments. The arguments beyond APP_LOG_DATA_MAX are cut.
+ *@param[in] p_data                           Pointer to the arguments, in the order of the message.
+ */
+void APP_LOG_Write(APP_LOG_Id_T id, uint16_t len, const void *p_data);
+
+/**@brief The function is used to send the queued records on the UART. Called from the idle task.
+ *        Only whole frames are written, the rest waits for room in the UART buffer.
+ */
+void APP_LOG_Drain(void);
+
+/**@brief The function is used to get the log statistics.
+ *@param[out] p_stats                         Pointer to where the statistics are stored.
+ */
+void APP_LOG_GetStats(APP_LOG_Stats_T *p_stats);
+
+
+#endif
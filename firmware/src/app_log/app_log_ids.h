@@ -0,0 +1,71 @@
+/*******************************************************************************
+  Application Log Message Table Header File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    app_log_ids.h
+
+  Summary:
+    This file contains the log messages of the application.
+
+  Description:
+    This file contains the log messages of the application. The log ID of a
+    message is its position in APP_LOG_TABLE, only the ID and the arguments
+    are sent. The host decoder (tools/app_log_decode.py) reads this file to
+    rebuild the text, so messages are only appended, never reordered.
+
+    Each %u, %d or %x takes a 32-bit argument. %s takes the rest of the
+    record as text and comes last.
+ *******************************************************************************/
+
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2025 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+
+#ifndef APP_LOG_IDS_H
+#define APP_LOG_IDS_H
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Macros
+// *****************************************************************************
+// *****************************************************************************
+#define APP_LOG_TABLE(X) \
+    X(APP_LOG_ID_DROPPED,               "log: %u records dropped") \
+    X(APP_LOG_ID_BOOT,                  "WBZ653 SERVO MOTOR") \
+    X(APP_LOG_ID_ADVERTISING,           "Advertising") \
+    X(APP_LOG_ID_CONNECTED,             "Connected 0x%x") \
+    X(APP_LOG_ID_DISCONNECTED,          "Disconnected 0x%x reason 0x%x") \
+    X(APP_LOG_ID_BLE_CMD,               "cmd: %s") \
+    X(APP_LOG_ID_LATENCY,               "lat %u: p50 %u p99 %u max %u us") \
+    X(APP_LOG_ID_LANE,                  "lane: starved %u full %u") \
+    X(APP_LOG_ID_SETPOINTS,             "setpoints: applied %u dropped %u")
+
+
+#endif
@@ -0,0 +1,315 @@
+/*******************************************************************************
+  Application Flash Job Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    app_nvm.c
+
+  Summary:
+    This file contains the Application Flash Job functions for this project.
+
+  Description:
+    This file contains the Application Flash Job functions for this project.
+    Each step is started from the idle task with the RF suspended, as PDS
+    does. The NVM interrupt posts the completion to the application task,
+    which verifies the step and chains the next one. The idle task resumes
+    the RF as soon as the step ends and posts the completion again if the
+    interrupt could not.
+ *******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2025 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include <string.h>
+#include "definitions.h"
+#include "app_nvm.h"
+#include "app_error_defs.h"
+#include "../app.h"
+#include "app_queue/app_queue.h"
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+typedef enum APP_NVM_Step_T
+{
+    APP_NVM_STEP_ERASE,
+    APP_NVM_STEP_WRITE
+} APP_NVM_Step_T;
+
+typedef enum APP_NVM_State_T
+{
+    APP_NVM_STATE_IDLE,             // No job.
+    APP_NVM_STATE_READY,            // The next step waits for the idle task.
+    APP_NVM_STATE_RUNNING,          // The step is in progress with the RF suspended.
+    APP_NVM_STATE_DONE              // The step is completed, the application task is notified.
+} APP_NVM_State_T;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Variables
+// *****************************************************************************
+// *****************************************************************************
+static APP_NVM_Job_T s_job[APP_NVM_JOB_NUM];
+static uint8_t s_jobHead;
+static uint8_t s_jobNum;
+static uint32_t s_offset;                                   // Offset of the current step in the first job.
+static APP_NVM_Step_T s_step;
+static volatile APP_NVM_State_T s_state;
+static volatile bool s_isPosted;                            // The completion of the step is queued to the application task.
+static bool s_isRfHeld;                                     // The RF is suspended for the step.
+static NVM_ERROR s_stepError;                               // Error of the step, read as it ends since PDS may use the NVM next.
+static APP_Msg_T s_cbMsg;                                   // Completion posted from the idle task, its stack is small.
+static uint32_t s_rowBuf[NVM_FLASH_ROWSIZE / 4U];           // Source of the row write, also used for the verification.
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Functions
+// *****************************************************************************
+// *****************************************************************************
+static void app_nvm_InterruptCb(uintptr_t context)
+{
+    APP_Msg_T appMsg;
+
+    (void)context;
+
+    // PDS uses the NVM as well, but never while a step is running
+    if (s_state == APP_NVM_STATE_RUNNING)
+    {
+        s_stepError = NVM_ErrorGet();
+        s_state = APP_NVM_STATE_DONE;
+        appMsg.msgId = APP_MSG_NVM_CB;
+        s_isPosted = (APP_QUEUE_SendISR(&appMsg) == APP_RES_SUCCESS);
+    }
+}
+
+static void app_nvm_ResumeRf(void)
+{
+    OSAL_CRITSECT_DATA_TYPE IntState;
+    bool isRfHeld;
+
+    // Both the idle task and the application task may see the end of the step first
+    IntState = OSAL_CRIT_Enter(OSAL_CRIT_TYPE_HIGH);
+    isRfHeld = s_isRfHeld;
+    s_isRfHeld = false;
+    OSAL_CRIT_Leave(OSAL_CRIT_TYPE_HIGH, IntState);
+
+    if (isRfHeld)
+    {
+        (void)BT_SYS_RfSuspendReq(0);
+    }
+}
+
+static void app_nvm_Finish(uint16_t result)
+{
+    APP_NVM_Job_T job = s_job[s_jobHead];
+
+    s_jobHead = (uint8_t)((s_jobHead + 1U) % APP_NVM_JOB_NUM);
+    s_jobNum--;
+    s_offset = 0;
+    s_step = APP_NVM_STEP_ERASE;
+    s_state = (s_jobNum > 0U) ? APP_NVM_STATE_READY : APP_NVM_STATE_IDLE;
+
+    if (job.cb != NULL)
+    {
+        job.cb(result, job.context);
+    }
+}
+
+void APP_NVM_Init(void)
+{
+    s_jobHead = 0;
+    s_jobNum = 0;
+    s_state = APP_NVM_STATE_IDLE;
+    s_isRfHeld = false;
+    NVM_CallbackRegister(app_nvm_InterruptCb, 0);
+}
+
+uint16_t APP_NVM_Submit(const APP_NVM_Job_T *p_job)
+{
+    if (((p_job->address % NVM_FLASH_PAGESIZE) != 0U) || (p_job->length == 0U)
+        || (p_job->address < APP_NVM_REGION_START)
+        || (p_job->length > (APP_NVM_REGION_START + APP_NVM_REGION_SIZE - p_job->address)))
+    {
+        return APP_RES_INVALID_PARA;
+    }
+
+    if (s_jobNum == APP_NVM_JOB_NUM)
+    {
+        return APP_RES_NO_RESOURCE;
+    }
+
+    s_job[(s_jobHead + s_jobNum) % APP_NVM_JOB_NUM] = *p_job;
+    s_jobNum++;
+
+    if (s_state == APP_NVM_STATE_IDLE)
+    {
+        s_offset = 0;
+        s_step = APP_NVM_STEP_ERASE;
+        s_state = APP_NVM_STATE_READY;
+    }
+
+    return APP_RES_SUCCESS;
+}
+
+bool APP_NVM_IsActive(void)
+{
+    return s_isRfHeld;
+}
+
+void APP_NVM_IdleCheck(void)
+{
+    OSAL_CRITSECT_DATA_TYPE IntState;
+
+    if (((s_state != APP_NVM_STATE_RUNNING) && (s_state != APP_NVM_STATE_DONE)) || NVM_IsBusy())
+    {
+        return;
+    }
+
+    // The operation is over, the interrupt is taken as missed if it did not come
+    IntState = OSAL_CRIT_Enter(OSAL_CRIT_TYPE_HIGH);
+    if (s_state == APP_NVM_STATE_RUNNING)
+    {
+        s_stepError = NVM_ErrorGet();
+        s_state = APP_NVM_STATE_DONE;
+        s_isPosted = false;
+    }
+    OSAL_CRIT_Leave(OSAL_CRIT_TYPE_HIGH, IntState);
+
+    app_nvm_ResumeRf();
+
+    if ((s_state == APP_NVM_STATE_DONE) && !s_isPosted)
+    {
+        s_cbMsg.msgId = APP_MSG_NVM_CB;
+        s_isPosted = (APP_QUEUE_Send(&s_cbMsg, 0) == APP_RES_SUCCESS);
+    }
+}
+
+bool APP_NVM_IdleHandler(void)
+{
+    const APP_NVM_Job_T *p_job = &s_job[s_jobHead];
+    uint32_t len;
+    OSAL_CRITSECT_DATA_TYPE IntState;
+    uint8_t BT_RF_Suspended;
+
+    if ((s_state != APP_NVM_STATE_READY) || NVM_IsBusy())
+    {
+        return false;
+    }
+
+    if (s_step == APP_NVM_STEP_WRITE)
+    {
+        len = p_job->length - s_offset;
+        if (len > NVM_FLASH_ROWSIZE)
+        {
+            len = NVM_FLASH_ROWSIZE;
+        }
+        (void)memset(s_rowBuf, 0xFF, sizeof(s_rowBuf));
+        (void)memcpy(s_rowBuf, p_job->p_data + s_offset, len);
+    }
+
+    IntState = OSAL_CRIT_Enter(OSAL_CRIT_TYPE_HIGH);
+    BT_RF_Suspended = BT_SYS_RfSuspendReq(1);
+    OSAL_CRIT_Leave(OSAL_CRIT_TYPE_HIGH, IntState);
+
+    if (BT_RF_Suspended == 0U)
+    {
+        return false;
+    }
+
+    // The interrupt may come as soon as the operation is started
+    s_isRfHeld = true;
+    s_isPosted = false;
+    s_state = APP_NVM_STATE_RUNNING;
+
+    if (s_step == APP_NVM_STEP_ERASE)
+    {
+        (void)NVM_PageErase(p_job->address + s_offset);
+    }
+    else
+    {
+        (void)NVM_RowWrite(s_rowBuf, p_job->address + s_offset);
+    }
+
+    return true;
+}
+
+void APP_NVM_Complete(void)
+{
+    const APP_NVM_Job_T *p_job = &s_job[s_jobHead];
+
+    if (s_state != APP_NVM_STATE_DONE)
+    {
+        return;
+    }
+
+    app_nvm_ResumeRf();
+
+    if (s_stepError != NVM_ERROR_NONE)
+    {
+        app_nvm_Finish(APP_RES_FAIL);
+        return;
+    }
+
+    if (s_step == APP_NVM_STEP_WRITE)
+    {
+        if (memcmp((const void *)(p_job->address + s_offset), s_rowBuf, NVM_FLASH_ROWSIZE) != 0)
+        {
+            app_nvm_Finish(APP_RES_FAIL);
+            return;
+        }
+
+        s_offset += NVM_FLASH_ROWSIZE;
+
+        if (s_offset >= p_job->length)
+        {
+            app_nvm_Finish(APP_RES_SUCCESS);
+            return;
+        }
+
+        if ((s_offset % NVM_FLASH_PAGESIZE) == 0U)
+        {
+            s_step = APP_NVM_STEP_ERASE;
+        }
+    }
+    else
+    {
+        s_step = APP_NVM_STEP_WRITE;
+    }
+
+    s_state = APP_NVM_STATE_READY;
+}
@@ -0,0 +1,140 @@
+/*******************************************************************************
+  Application Flash Job Header File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    app_nvm.h
+
+  Summary:
+    This file contains the Application Flash Job functions for this project.
+
+  Description:
+    This file contains the Application Flash Job functions for this project.
+    Flash jobs are run without blocking the caller: each page is erased, then
+    written row by row and every row is verified, one step at a time.
+ *******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2025 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+
+#ifndef APP_NVM_H
+#define APP_NVM_H
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include <stdint.h>
+#include <stdbool.h>
+#include "peripheral/nvm/plib_nvm.h"
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Macros
+// *****************************************************************************
+// *****************************************************************************
+#define APP_NVM_JOB_NUM                     (4U)        /**< Maximum number of queued flash jobs. */
+#ifndef APP_NVM_REGION_SIZE
+#define APP_NVM_REGION_SIZE                 (0x10000U)  /**< Flash of the jobs, at the end of the flash. The image must end below it, see ROM_LENGTH of the linker script. */
+#endif
+#define APP_NVM_REGION_START                (NVM_FLASH_START_ADDRESS + NVM_FLASH_SIZE - APP_NVM_REGION_SIZE)
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+
+/**@brief Flash job completion callback, called in the application task.
+ *@param[in] result                           APP_RES_SUCCESS if every row was written and verified, APP_RES_FAIL otherwise.
+ *@param[in] context                          Context given with the job.
+ */
+typedef void (*APP_NVM_CompleteCb_T)(uint16_t result, uintptr_t context);
+
+/**@brief Flash job. */
+typedef struct APP_NVM_Job_T
+{
+    uint32_t                address;            /**< Flash address in the region of the jobs, aligned on NVM_FLASH_PAGESIZE. The pages covering the data are erased. */
+    const uint8_t           *p_data;            /**< Data to write. Must stay valid until the job completes. */
+    uint32_t                length;             /**< Length of the data in bytes. The last row is padded with 0xFF. */
+    APP_NVM_CompleteCb_T    cb;                 /**< Completion callback, may be NULL. */
+    uintptr_t               context;            /**< Context given to the completion callback. */
+} APP_NVM_Job_T;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Function Prototypes
+// *****************************************************************************
+// *****************************************************************************
+
+/**@brief The function is used to initialize the flash jobs. It takes the NVM interrupt callback. */
+void APP_NVM_Init(void);
+
+/**@brief The function is used to queue a flash job.
+ *@param[in] p_job                            Pointer to the job. The structure is copied.
+ *
+ * @retval APP_RES_SUCCESS                    The job is queued.
+ * @retval APP_RES_INVALID_PARA               The address is not page aligned, or the data is outside the region of the jobs,
+ *                                            so a job never erases the image or the PDS pages.
+ * @retval APP_RES_NO_RESOURCE                APP_NVM_JOB_NUM jobs are already queued.
+ *
+ */
+uint16_t APP_NVM_Submit(const APP_NVM_Job_T *p_job);
+
+/**@brief The function is used to check if a flash operation holds the RF.
+ *        The RF is suspended until the operation ends, the idle task must not suspend or resume it meanwhile.
+ *
+ * @retval true                               A flash operation is in progress.
+ * @retval false                              No flash operation is in progress.
+ *
+ */
+bool APP_NVM_IsActive(void);
+
+/**@brief The function is used to end the flash operation once the NVM is no longer busy, it is called from the idle task
+ *        before APP_NVM_IsActive. The RF is resumed, and the completion is posted again if the interrupt could not post it.
+ */
+void APP_NVM_IdleCheck(void);
+
+/**@brief The function is used to start the next flash operation, it is called from the idle task.
+ *
+ * @retval true                               A flash operation is started.
+ * @retval false                              No flash operation is started.
+ *
+ */
+bool APP_NVM_IdleHandler(void);
+
+/**@brief The function is used to handle the APP_MSG_NVM_CB message, it verifies the last operation and chains the next one. */
+void APP_NVM_Complete(void);
+
+
+#endif
@@ -0,0 +1,358 @@
+/*******************************************************************************
+  Application Queue Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    app_queue.c
+
+  Summary:
+    This file contains the Application Queue functions for this project.
+
+  Description:
+    This file contains the Application Queue functions for this project.
+    Each lane is a queue, and a counting semaphore given after each message
+    wakes the application task. A message is always queued before its count
+    is given, so the application task finds it; a count given for a message
+    already taken is skipped. A coalesced message only gives a count when its
+    slot was empty.
+ *******************************************************************************/
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include <string.h>
+#include "definitions.h"
+#include "osal/osal_freertos_extend.h"
+#include "app_error_defs.h"
+#include "app_rec/app_rec.h"
+#include "app_lat/app_lat.h"
+#include "app_queue.h"
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Macros
+// *****************************************************************************
+// *****************************************************************************
+#define APP_QUEUE_TOTAL_SIZE                (APP_QUEUE_URGENT_SIZE + APP_QUEUE_NORMAL_SIZE + APP_QUEUE_BULK_SIZE + APP_QUEUE_LATEST_NUM)
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Global Variables
+// *****************************************************************************
+// *****************************************************************************
+static OSAL_QUEUE_HANDLE_TYPE   s_lane[APP_QUEUE_LANE_NUM];
+static OSAL_SEM_HANDLE_TYPE     s_msgSem;
+static uint8_t                  s_skipCnt[APP_QUEUE_LANE_NUM];     // Messages taken from more urgent lanes while waiting.
+static APP_QUEUE_Stats_T        s_stats[APP_QUEUE_LANE_NUM];
+static APP_Msg_T                s_latest[APP_QUEUE_LATEST_NUM];
+static volatile bool            s_isLatestPending[APP_QUEUE_LATEST_NUM];
+static uint8_t                  s_bulkBudget;       // Bulk messages left in this pass.
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Functions
+// *****************************************************************************
+// *****************************************************************************
+static APP_QUEUE_Lane_T app_queue_GetLane(uint8_t msgId)
+{
+    switch (msgId)
+    {
+        // A stop must not wait behind a burst of events
+        case APP_MSG_BLE_DATA_EVT:
+        case APP_MSG_SERVO_SETPOINT:
+        case APP_TIMER_SERVO_RAMP_MSG:
+        case APP_TIMER_GROUP_APPLY_MSG:
+            return APP_QUEUE_LANE_URGENT;
+
+        case APP_MSG_BLE_STACK_LOG:
+        case APP_MSG_UART_CB:
+        case APP_MSG_SMP_KEY_GEN:
+        case APP_TIMER_SEND_UART_MSG:
+        case APP_TIMER_L2CAP_DRAIN_MSG:
+            return APP_QUEUE_LANE_BULK;
+
+        default:
+            return APP_QUEUE_LANE_NORMAL;
+    }
+}
+
+static void app_queue_AtomicInc(volatile uint32_t *p_value)
+{
+    uint32_t value;
+
+    do
+    {
+        value = __LDREXW(p_value);
+    } while (__STREXW(value + 1U, p_value) != 0U);
+}
+
+static void app_queue_Lost(APP_QUEUE_Lane_T lane, uint8_t msgId)
+{
+    app_queue_AtomicInc(&s_stats[lane].fullCnt);
+    APP_REC_Record(APP_REC_TYPE_QUEUE_FULL, msgId, (uint32_t)lane);
+}
+
+static uint8_t app_queue_GetLatestNum(void)
+{
+    uint8_t key;
+    uint8_t num = 0U;
+
+    for (key = 0U; key < APP_QUEUE_LATEST_NUM; key++)
+    {
+        if (s_isLatestPending[key])
+        {
+            num++;
+        }
+    }
+
+    return num;
+}
+
+static bool app_queue_TakeLatest(APP_Msg_T *p_msg)
+{
+    OSAL_CRITSECT_DATA_TYPE critState;
+    uint8_t key;
+    bool isTaken = false;
+
+    critState = OSAL_CRIT_Enter(OSAL_CRIT_TYPE_LOW);
+    for (key = 0U; key < APP_QUEUE_LATEST_NUM; key++)
+    {
+        if (s_isLatestPending[key])
+        {
+            (void)memcpy(p_msg, &s_latest[key], sizeof(APP_Msg_T));
+            s_isLatestPending[key] = false;
+            isTaken = true;
+            break;
+        }
+    }
+    OSAL_CRIT_Leave(OSAL_CRIT_TYPE_LOW, critState);
+
+    return isTaken;
+}
+
+// The most urgent lane with a message, unless a lane waited too long
+static bool app_queue_SelectLane(APP_QUEUE_Lane_T *p_lane)
+{
+    uint8_t depth[APP_QUEUE_LANE_NUM];
+    uint8_t lane;
+    uint8_t selected = APP_QUEUE_LANE_NUM;
+
+    for (lane = 0U; lane < APP_QUEUE_LANE_NUM; lane++)
+    {
+        depth[lane] = OSAL_QUEUE_MessagesWaiting(s_lane[lane]);
+        if (lane == (uint8_t)APP_QUEUE_LANE_URGENT)
+        {
+            depth[lane] += app_queue_GetLatestNum();
+        }
+        if (depth[lane] > s_stats[lane].depthMax)
+        {
+            s_stats[lane].depthMax = depth[lane];
+        }
+        if ((lane == (uint8_t)APP_QUEUE_LANE_BULK) && (s_bulkBudget == 0U))
+        {
+            depth[lane] = 0U;
+        }
+        if ((depth[lane] != 0U) && (s_skipCnt[lane] >= APP_QUEUE_STARVE_LIMIT))
+        {
+            s_stats[lane].starveCnt++;
+            selected = lane;
+            break;
+        }
+    }
+
+    if (selected == APP_QUEUE_LANE_NUM)
+    {
+        for (lane = 0U; lane < APP_QUEUE_LANE_NUM; lane++)
+        {
+            if (depth[lane] != 0U)
+            {
+                selected = lane;
+                break;
+            }
+        }
+    }
+
+    if (selected == APP_QUEUE_LANE_NUM)
+    {
+        return false;
+    }
+
+    for (lane = 0U; lane < APP_QUEUE_LANE_NUM; lane++)
+    {
+        if (lane == selected)
+        {
+            s_skipCnt[lane] = 0U;
+        }
+        else if ((depth[lane] != 0U) && (lane > selected))
+        {
+            s_skipCnt[lane]++;
+        }
+    }
+
+    *p_lane = (APP_QUEUE_Lane_T)selected;
+
+    return true;
+}
+
+void APP_QUEUE_Init(void)
+{
+    (void)OSAL_QUEUE_Create(&s_lane[APP_QUEUE_LANE_URGENT], APP_QUEUE_URGENT_SIZE, sizeof(APP_Msg_T));
+    (void)OSAL_QUEUE_Create(&s_lane[APP_QUEUE_LANE_NORMAL], APP_QUEUE_NORMAL_SIZE, sizeof(APP_Msg_T));
+    (void)OSAL_QUEUE_Create(&s_lane[APP_QUEUE_LANE_BULK], APP_QUEUE_BULK_SIZE, sizeof(APP_Msg_T));
+    (void)OSAL_SEM_Create(&s_msgSem, OSAL_SEM_TYPE_COUNTING, APP_QUEUE_TOTAL_SIZE, 0U);
+
+    memset(s_skipCnt, 0, sizeof(s_skipCnt));
+    memset(s_stats, 0, sizeof(s_stats));
+    memset((void *)s_isLatestPending, 0, sizeof(s_isLatestPending));
+    s_bulkBudget = APP_QUEUE_BULK_BUDGET;
+}
+
+uint16_t APP_QUEUE_Send(APP_Msg_T *p_msg, uint32_t waitMs)
+{
+    APP_QUEUE_Lane_T lane = app_queue_GetLane(p_msg->msgId);
+
+    p_msg->msgStamp = APP_LAT_Stamp();
+    if (OSAL_QUEUE_Send(&s_lane[lane], p_msg, waitMs) != OSAL_RESULT_SUCCESS)
+    {
+        app_queue_Lost(lane, p_msg->msgId);
+        return APP_RES_NO_RESOURCE;
+    }
+
+    (void)OSAL_SEM_Post(&s_msgSem);
+
+    return APP_RES_SUCCESS;
+}
+
+uint16_t APP_QUEUE_SendISR(APP_Msg_T *p_msg)
+{
+    APP_QUEUE_Lane_T lane = app_queue_GetLane(p_msg->msgId);
+
+    p_msg->msgStamp = APP_LAT_Stamp();
+    if (OSAL_QUEUE_SendISR(&s_lane[lane], p_msg) != OSAL_RESULT_SUCCESS)
+    {
+        app_queue_Lost(lane, p_msg->msgId);
+        return APP_RES_NO_RESOURCE;
+    }
+
+    (void)OSAL_SEM_PostISR(&s_msgSem);
+
+    return APP_RES_SUCCESS;
+}
+
+uint16_t APP_QUEUE_SendLatest(APP_Msg_T *p_msg, uint8_t key)
+{
+    OSAL_CRITSECT_DATA_TYPE critState;
+    bool isReplaced;
+
+    if (key >= APP_QUEUE_LATEST_NUM)
+    {
+        return APP_RES_INVALID_PARA;
+    }
+
+    p_msg->msgStamp = APP_LAT_Stamp();
+    critState = OSAL_CRIT_Enter(OSAL_CRIT_TYPE_LOW);
+    isReplaced = s_isLatestPending[key];
+    (void)memcpy(&s_latest[key], p_msg, sizeof(APP_Msg_T));
+    s_isLatestPending[key] = true;
+    OSAL_CRIT_Leave(OSAL_CRIT_TYPE_LOW, critState);
+
+    // The message replaced already gave its count
+    if (isReplaced)
+    {
+        app_queue_AtomicInc(&s_stats[APP_QUEUE_LANE_URGENT].coalesceCnt);
+    }
+    else
+    {
+        (void)OSAL_SEM_Post(&s_msgSem);
+    }
+
+    return APP_RES_SUCCESS;
+}
+
+void APP_QUEUE_Wake(void)
+{
+    // A full count already wakes the task, a failed post loses nothing
+    (void)OSAL_SEM_Post(&s_msgSem);
+}
+
+void APP_QUEUE_WakeISR(void)
+{
+    (void)OSAL_SEM_PostISR(&s_msgSem);
+}
+
+void APP_QUEUE_StartPass(void)
+{
+    s_bulkBudget = APP_QUEUE_BULK_BUDGET;
+}
+
+bool APP_QUEUE_Receive(APP_Msg_T *p_msg, uint32_t waitMs)
+{
+    APP_QUEUE_Lane_T lane;
+
+    if (OSAL_SEM_Pend(&s_msgSem, waitMs) != OSAL_RESULT_SUCCESS)
+    {
+        return false;
+    }
+
+    if (!app_queue_SelectLane(&lane))
+    {
+        // Only bulk messages are left and the budget is spent, the count goes to the next pass
+        if ((s_bulkBudget == 0U) && (OSAL_QUEUE_MessagesWaiting(s_lane[APP_QUEUE_LANE_BULK]) != 0U))
+        {
+            s_stats[APP_QUEUE_LANE_BULK].budgetCnt++;
+            (void)OSAL_SEM_Post(&s_msgSem);
+        }
+        return false;
+    }
+
+    // Coalesced messages come first in the urgent lane, they are the newest commands
+    if ((lane == APP_QUEUE_LANE_URGENT) && app_queue_TakeLatest(p_msg))
+    {
+        s_stats[lane].latestCnt++;
+    }
+    else if (OSAL_QUEUE_Receive(&s_lane[lane], p_msg, 0U) != OSAL_RESULT_SUCCESS)
+    {
+        return false;
+    }
+
+    if (lane == APP_QUEUE_LANE_BULK)
+    {
+        s_bulkBudget--;
+    }
+    s_stats[lane].recvCnt++;
+    APP_LAT_Count((APP_LAT_Stage_T)(APP_LAT_STAGE_LANE_URGENT + (uint8_t)lane), APP_LAT_Stamp() - p_msg->msgStamp);
+
+    return true;
+}
+
+bool APP_QUEUE_IsEmpty(void)
+{
+    uint8_t lane;
+
+    if (app_queue_GetLatestNum() != 0U)
+    {
+        return false;
+    }
+
+    for (lane = 0U; lane < APP_QUEUE_LANE_NUM; lane++)
+    {
+        if (OSAL_QUEUE_MessagesWaiting(s_lane[lane]) != 0U)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void APP_QUEUE_GetStats(APP_QUEUE_Lane_T lane, APP_QUEUE_Stats_T *p_stats)
+{
+    *p_stats = s_stats[lane];
+}
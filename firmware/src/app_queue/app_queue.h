@@ -0,0 +1,184 @@
+/*******************************************************************************
+  Application Queue Header File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    app_queue.h
+
+  Summary:
+    This file contains the Application Queue functions for this project.
+
+  Description:
+    This file contains the Application Queue functions for this project.
+    The messages of the application task are sorted by their ID in lanes of
+    decreasing priority: urgent for the servo control, normal for the stack
+    and driver events and bulk for the bridged data and background work. The
+    application task takes the message of the most urgent lane, and a lane
+    passed over APP_QUEUE_STARVE_LIMIT times in a row is served next.
+    Setpoints are coalesced: only the newest one waiting for a servo channel
+    is kept, in the urgent lane.
+ *******************************************************************************/
+
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2025 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+
+#ifndef APP_QUEUE_H
+#define APP_QUEUE_H
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "../app.h"
+#include "app_cal/app_cal.h"
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Macros
+// *****************************************************************************
+// *****************************************************************************
+#define APP_QUEUE_URGENT_SIZE               (8U)        /**< Messages of the urgent lane. */
+#define APP_QUEUE_NORMAL_SIZE               (40U)       /**< Messages of the normal lane. */
+#define APP_QUEUE_BULK_SIZE                 (16U)       /**< Messages of the bulk lane. */
+#define APP_QUEUE_STARVE_LIMIT              (8U)        /**< Messages taken from more urgent lanes before a waiting lane is served. */
+#define APP_QUEUE_BULK_BUDGET               (4U)        /**< Messages taken from the bulk lane in one pass of the application task. */
+#define APP_QUEUE_LATEST_NUM                (APP_CAL_CH_NUM)    /**< Coalesced messages, one per servo channel. */
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+
+/**@brief Lanes, the most urgent first. */
+typedef enum APP_QUEUE_Lane_T
+{
+    APP_QUEUE_LANE_URGENT = 0,                  /**< Servo commands and setpoints. */
+    APP_QUEUE_LANE_NORMAL,                      /**< Stack, driver and timer events. */
+    APP_QUEUE_LANE_BULK,                        /**< Bridged data and background work. */
+
+    APP_QUEUE_LANE_NUM
+} APP_QUEUE_Lane_T;
+
+/**@brief Counters of a lane. */
+typedef struct APP_QUEUE_Stats_T
+{
+    uint32_t                recvCnt;            /**< Messages taken by the application task. */
+    uint32_t                fullCnt;            /**< Messages lost as the lane was full. */
+    uint32_t                starveCnt;          /**< Times the lane was served after waiting APP_QUEUE_STARVE_LIMIT messages. */
+    uint32_t                latestCnt;          /**< Coalesced messages taken, urgent lane only. */
+    uint32_t                coalesceCnt;        /**< Coalesced messages dropped for a newer one, urgent lane only. */
+    uint32_t                budgetCnt;          /**< Passes ended with messages left after APP_QUEUE_BULK_BUDGET, bulk lane only. */
+    uint8_t                 depthMax;           /**< Most messages seen waiting in the lane. */
+} APP_QUEUE_Stats_T;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Function Prototypes
+// *****************************************************************************
+// *****************************************************************************
+
+/**@brief The function is used to create the lanes. It is called before the scheduler starts.
+ */
+void APP_QUEUE_Init(void);
+
+/**@brief The function is used to send a message to the application task, in the lane of its ID. It must not be called from an interrupt.
+ *        A lost message is counted and recorded.
+ *@param[in] p_msg                            Pointer to the message. Its time stamp is set.
+ *@param[in] waitMs                           Time to wait for room in the lane, in ms.
+ *
+ * @retval APP_RES_SUCCESS                    The message is queued.
+ * @retval APP_RES_NO_RESOURCE                The lane is full.
+ */
+uint16_t APP_QUEUE_Send(APP_Msg_T *p_msg, uint32_t waitMs);
+
+/**@brief The function is used to send a message to the application task from an interrupt.
+ *@param[in] p_msg                            Pointer to the message. Its time stamp is set.
+ *
+ * @retval APP_RES_SUCCESS                    The message is queued.
+ * @retval APP_RES_NO_RESOURCE                The lane is full.
+ */
+uint16_t APP_QUEUE_SendISR(APP_Msg_T *p_msg);
+
+/**@brief The function is used to send a message to the application task in the urgent lane, replacing the message
+ *        of the same key not taken yet. It must not be called from an interrupt.
+ *@param[in] p_msg                            Pointer to the message. Its time stamp is set.
+ *@param[in] key                              Key of the message, lower than APP_QUEUE_LATEST_NUM.
+ *
+ * @retval APP_RES_SUCCESS                    The message is queued.
+ * @retval APP_RES_INVALID_PARA               The key is not valid.
+ */
+uint16_t APP_QUEUE_SendLatest(APP_Msg_T *p_msg, uint8_t key);
+
+/**@brief The function is used to wake the application task without a message, so it polls the pending work.
+ *        Nothing is lost if the task is already due to wake. It must not be called from an interrupt.
+ */
+void APP_QUEUE_Wake(void);
+
+/**@brief The function is used to wake the application task without a message, from an interrupt. See @ref APP_QUEUE_Wake.
+ */
+void APP_QUEUE_WakeISR(void);
+
+/**@brief The function is used by the application task to start a pass: the bulk lane gets APP_QUEUE_BULK_BUDGET messages again.
+ */
+void APP_QUEUE_StartPass(void);
+
+/**@brief The function is used by the application task to take the next message. The time spent in the lane is measured.
+ *        Once the budget of the pass is spent, the bulk lane waits for the next pass.
+ *@param[out] p_msg                           Pointer to the buffer of the message.
+ *@param[in] waitMs                           Time to wait for a message, in ms, or OSAL_WAIT_FOREVER.
+ *
+ * @retval true                               A message is taken.
+ * @retval false                              No message for this pass, the task may have been woken by @ref APP_QUEUE_Wake.
+ */
+bool APP_QUEUE_Receive(APP_Msg_T *p_msg, uint32_t waitMs);
+
+/**@brief The function is used to check if no message waits in any lane.
+ *
+ * @retval true                               All the lanes are empty.
+ * @retval false                              A message waits.
+ */
+bool APP_QUEUE_IsEmpty(void);
+
+/**@brief The function is used to get the counters of a lane.
+ *@param[in] lane                             Lane. See @ref APP_QUEUE_Lane_T.
+ *@param[out] p_stats                         Pointer to the counters.
+ */
+void APP_QUEUE_GetStats(APP_QUEUE_Lane_T lane, APP_QUEUE_Stats_T *p_stats);
+
+
+#endif
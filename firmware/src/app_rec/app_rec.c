@@ -0,0 +1,271 @@
+/*******************************************************************************
+  Application Flight Recorder Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    app_rec.c
+
+  Summary:
+    This file contains the Application Flight Recorder functions for this project.
+
+  Description:
+    This file contains the Application Flight Recorder functions for this
+    project. A record is claimed with an exclusive access on the write index,
+    so recording takes no lock and a fixed time. The sequence number of a
+    record is cleared while it is written, so a record torn by a reset or
+    overwritten during a read is not reported.
+ *******************************************************************************/
+
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2025 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include <string.h>
+#include "definitions.h"
+#include "ble_trsps/ble_trsps.h"
+#include "ble_util/byte_stream.h"
+#include "app_link.h"
+#include "app_rec.h"
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Macros
+// *****************************************************************************
+// *****************************************************************************
+#define APP_REC_MAGIC                       (0x31434552UL)      // "REC1"
+#define APP_REC_CHECK                       ((uint32_t)~APP_REC_MAGIC ^ APP_REC_RECORD_NUM)
+#define APP_REC_INFO_LEN                    (2U + 11U)
+#define APP_REC_READ_HEADER_LEN             (2U + 4U)
+#define APP_REC_READ_MAX                    (16U)               // Most records in a reply.
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+typedef struct APP_REC_Record_T
+{
+    volatile uint32_t       seq;                // Index + 1 once the record is complete, 0 while it is written.
+    uint32_t                tick;               // Time stamp, in ms since the boot.
+    uint8_t                 type;
+    uint8_t                 boot;               // Low byte of the boot count.
+    uint16_t                arg16;
+    uint32_t                arg32;
+} APP_REC_Record_T;
+
+typedef struct APP_REC_Ring_T
+{
+    uint32_t                magic;
+    uint32_t                check;              // With magic, tells that the RAM held the recorder before the reset.
+    volatile uint32_t       writeIdx;           // Index of the next record.
+    volatile uint32_t       firstIdx;           // Records before are cleared.
+    uint16_t                bootCnt;
+    APP_REC_Record_T        record[APP_REC_RECORD_NUM];
+} APP_REC_Ring_T;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Global Variables
+// *****************************************************************************
+// *****************************************************************************
+static APP_REC_Ring_T           s_ring __attribute__((persistent));
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Functions
+// *****************************************************************************
+// *****************************************************************************
+static uint32_t app_rec_GetTick(void)
+{
+    if (__get_IPSR() != 0U)
+    {
+        return (uint32_t)xTaskGetTickCountFromISR();
+    }
+
+    return (uint32_t)xTaskGetTickCount();
+}
+
+static uint32_t app_rec_GetFirst(void)
+{
+    uint32_t writeIdx = s_ring.writeIdx;
+    uint32_t firstIdx = s_ring.firstIdx;
+
+    if ((writeIdx - firstIdx) > APP_REC_RECORD_NUM)
+    {
+        firstIdx = writeIdx - APP_REC_RECORD_NUM;
+    }
+
+    return firstIdx;
+}
+
+// Copy a record in its air format, a record being written or already overwritten is sent as type 0
+static void app_rec_Copy(uint32_t idx, uint8_t *p_buf)
+{
+    APP_REC_Record_T *p_record = &s_ring.record[idx & (APP_REC_RECORD_NUM - 1U)];
+    uint8_t *p_out = p_buf;
+
+    if (p_record->seq == (idx + 1U))
+    {
+        __DMB();
+        U32_TO_BUF_LE(p_out, p_record->tick);
+        p_out[4] = p_record->type;
+        p_out[5] = p_record->boot;
+        U16_TO_BUF_LE(&p_out[6], p_record->arg16);
+        U32_TO_BUF_LE(&p_out[8], p_record->arg32);
+        __DMB();
+
+        if (p_record->seq == (idx + 1U))
+        {
+            return;
+        }
+    }
+
+    (void)memset(p_buf, 0, APP_REC_RECORD_LEN);
+}
+
+void APP_REC_Init(void)
+{
+    uint32_t resetFlags = RCON_REGS->RCON_RCON;
+
+    RCON_REGS->RCON_RCONCLR = resetFlags;
+
+    // The RAM is not retained over a power-on or brown-out reset
+    if (((resetFlags & (RCON_RCON_POR_Msk | RCON_RCON_BOR_Msk | RCON_RCON_PORCORE_Msk | RCON_RCON_PORIO_Msk)) != 0U)
+        || (s_ring.magic != APP_REC_MAGIC) || (s_ring.check != APP_REC_CHECK))
+    {
+        (void)memset(&s_ring, 0, sizeof(s_ring));
+        s_ring.magic = APP_REC_MAGIC;
+        s_ring.check = APP_REC_CHECK;
+    }
+
+    s_ring.bootCnt++;
+    APP_REC_Record(APP_REC_TYPE_RESET, s_ring.bootCnt, resetFlags);
+}
+
+void APP_REC_Record(APP_REC_Type_T type, uint16_t arg16, uint32_t arg32)
+{
+    APP_REC_Record_T *p_record;
+    uint32_t idx;
+
+    // Claim a record, another task or an interrupt may be claiming one at the same time
+    do
+    {
+        idx = __LDREXW(&s_ring.writeIdx);
+    } while (__STREXW(idx + 1U, &s_ring.writeIdx) != 0U);
+
+    p_record = &s_ring.record[idx & (APP_REC_RECORD_NUM - 1U)];
+    p_record->seq = 0U;
+    __DMB();
+    p_record->tick = app_rec_GetTick();
+    p_record->type = (uint8_t)type;
+    p_record->boot = (uint8_t)s_ring.bootCnt;
+    p_record->arg16 = arg16;
+    p_record->arg32 = arg32;
+    __DMB();
+    p_record->seq = idx + 1U;
+}
+
+void APP_REC_VendorCmdHandler(uint16_t connHandle, uint16_t length, const uint8_t *p_payload)
+{
+    uint8_t reply[APP_REC_READ_HEADER_LEN + (APP_REC_READ_MAX * APP_REC_RECORD_LEN)];
+    uint8_t replyLen = 2U;
+    uint8_t *p_cursor;
+    uint32_t idx, first, next, num, maxNum;
+    const uint8_t *p_idx;
+
+    if (length < 2U)
+    {
+        return;
+    }
+
+    reply[0] = p_payload[1];
+    reply[1] = APP_REC_STATUS_SUCCESS;
+
+    if ((p_payload[1] == APP_REC_OP_INFO) && (length == 2U))
+    {
+        U32_TO_BUF_LE(&reply[2], app_rec_GetFirst());
+        U32_TO_BUF_LE(&reply[6], s_ring.writeIdx);
+        U16_TO_BUF_LE(&reply[10], s_ring.bootCnt);
+        reply[12] = APP_REC_RECORD_LEN;
+        replyLen = APP_REC_INFO_LEN;
+    }
+    else if ((p_payload[1] == APP_REC_OP_READ) && (length == 6U))
+    {
+        p_idx = &p_payload[2];
+        STREAM_LE_TO_U32(&idx, &p_idx);
+        first = app_rec_GetFirst();
+        next = s_ring.writeIdx;
+
+        // Older records are gone, resume at the oldest one kept
+        if ((int32_t)(idx - first) < 0)
+        {
+            idx = first;
+        }
+        num = ((int32_t)(next - idx) > 0) ? (next - idx) : 0U;
+
+        // As many records as fit in a notification
+        maxNum = (APP_LINK_GetMtu(connHandle) - ATT_NOTI_INDI_HEADER_SIZE - 1U - APP_REC_READ_HEADER_LEN) / APP_REC_RECORD_LEN;
+        if (maxNum > APP_REC_READ_MAX)
+        {
+            maxNum = APP_REC_READ_MAX;
+        }
+        if (num > maxNum)
+        {
+            num = maxNum;
+        }
+
+        U32_TO_BUF_LE(&reply[2], idx);
+        p_cursor = &reply[APP_REC_READ_HEADER_LEN];
+        for (; num > 0U; num--)
+        {
+            app_rec_Copy(idx, p_cursor);
+            idx++;
+            p_cursor += APP_REC_RECORD_LEN;
+        }
+        replyLen = (uint8_t)(p_cursor - reply);
+    }
+    else if ((p_payload[1] == APP_REC_OP_CLEAR) && (length == 2U))
+    {
+        s_ring.firstIdx = s_ring.writeIdx;
+    }
+    else
+    {
+        reply[1] = APP_REC_STATUS_INVALID;
+    }
+
+    (void)BLE_TRSPS_SendVendorCommand(connHandle, APP_REC_VENDOR_OPCODE, replyLen, reply);
+}
@@ -0,0 +1,127 @@
+/*******************************************************************************
+  Application Flight Recorder Header File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    app_rec.h
+
+  Summary:
+    This file contains the Application Flight Recorder functions for this project.
+
+  Description:
+    This file contains the Application Flight Recorder functions for this
+    project. The last APP_REC_RECORD_NUM events are kept in RAM which is not
+    initialized at startup, so the history survives a warm reset. It is read
+    by a central with the APP_REC_VENDOR_OPCODE vendor command of the
+    transparent service, and decoded by tools/app_rec_decode.py.
+ *******************************************************************************/
+
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2025 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+
+#ifndef APP_REC_H
+#define APP_REC_H
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include <stdint.h>
+#include <stdbool.h>
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Macros
+// *****************************************************************************
+// *****************************************************************************
+#define APP_REC_RECORD_NUM                  (256U)      /**< Events kept, a power of 2. */
+#define APP_REC_VENDOR_OPCODE               (0xF0U)     /**< Vendor command of the transparent service to read the recorder. */
+
+/**@brief Operations of the vendor command, in the byte after the opcode. Each reply repeats the operation and a status byte. */
+#define APP_REC_OP_INFO                     (0x00U)     /**< Reply: first index (4), next index (4), boot count (2), size of a record (1). */
+#define APP_REC_OP_READ                     (0x01U)     /**< Request: index (4). Reply: index of the first record sent (4), records. No record after the last one. */
+#define APP_REC_OP_CLEAR                    (0x02U)     /**< Forget all the events. */
+
+#define APP_REC_STATUS_SUCCESS              (0x00U)
+#define APP_REC_STATUS_INVALID              (0x01U)     /**< Unknown operation or wrong length. */
+
+/**@brief A record on the air: time stamp (4), type (1), boot (1), arg16 (2) and arg32 (4), little endian. */
+#define APP_REC_RECORD_LEN                  (12U)
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+
+/**@brief Recorded events. Values are only appended, the host decoder relies on them. */
+typedef enum APP_REC_Type_T
+{
+    APP_REC_TYPE_RESET = 1,                     /**< arg16: boot count, arg32: RCON reset flags. */
+    APP_REC_TYPE_COMMAND,                       /**< arg16: connection handle, arg32: first four characters of the command. */
+    APP_REC_TYPE_SETPOINT,                      /**< arg16: servo channel, arg32: new duty. */
+    APP_REC_TYPE_CONNECTED,                     /**< arg16: connection handle. */
+    APP_REC_TYPE_DISCONNECTED,                  /**< arg16: connection handle, arg32: reason. */
+    APP_REC_TYPE_QUEUE_FULL,                    /**< arg16: ID of the message lost, arg32: lane of the application queue. */
+    APP_REC_TYPE_HEAP_FAIL                      /**< arg16: size requested, 0 if unknown, arg32: free heap. */
+} APP_REC_Type_T;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Function Prototypes
+// *****************************************************************************
+// *****************************************************************************
+
+/**@brief The function is used to initialize the recorder. It is called before the scheduler starts.
+ *        The events are kept over a warm reset and forgotten after a power-on or brown-out reset. A reset event is recorded.
+ */
+void APP_REC_Init(void);
+
+/**@brief The function is used to record an event. It never blocks and may be called from any task or interrupt.
+ *        The oldest event is overwritten once the recorder is full.
+ *@param[in] type                             Event type. See @ref APP_REC_Type_T.
+ *@param[in] arg16                            First argument of the event.
+ *@param[in] arg32                            Second argument of the event.
+ */
+void APP_REC_Record(APP_REC_Type_T type, uint16_t arg16, uint32_t arg32);
+
+/**@brief The function is used to handle the APP_REC_VENDOR_OPCODE vendor command. The reply is sent as a vendor command with the same opcode.
+ *@param[in] connHandle                       Connection handle of the central.
+ *@param[in] length                           Length of the command, the opcode included.
+ *@param[in] p_payload                        Pointer to the command, starting with the opcode.
+ */
+void APP_REC_VendorCmdHandler(uint16_t connHandle, uint16_t length, const uint8_t *p_payload);
+
+
+#endif
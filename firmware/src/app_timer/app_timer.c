@@ -51,6 +51,7 @@
 #include "app_error_defs.h"
 #include "FreeRTOS.h"
 #include "timers.h"
+#include "app_queue/app_queue.h"
 
 
 // *****************************************************************************
@@ -114,37 +115,52 @@ static void APP_TIMER_OneShotTimerExpiredHandle(TimerHandle_t xTimer)
         }
         break;   
         
-        case APP_TIMER_ID_1:
+        case APP_TIMER_CONN_POLICY:
         {
-           //appMsg.msgId = APP_TIMER_ID_1_MSG;
+            appMsg.msgId = APP_TIMER_CONN_POLICY_MSG;
         }
         break;
-        case APP_TIMER_ID_2:
+        case APP_TIMER_LINK_STATUS:
         {
-           //appMsg.msgId = APP_TIMER_ID_2_MSG;
+            appMsg.msgId = APP_TIMER_LINK_STATUS_MSG;
         }
         break;
-        case APP_TIMER_ID_3:
+        case APP_TIMER_L2CAP_DRAIN:
         {
-           //appMsg.msgId = APP_TIMER_ID_3_MSG;
+            appMsg.msgId = APP_TIMER_L2CAP_DRAIN_MSG;
         }
         break;
-        case APP_TIMER_ID_4:
+        case APP_TIMER_ADV_STATUS:
         {
-           //appMsg.msgId = APP_TIMER_ID_4_MSG;
+            appMsg.msgId = APP_TIMER_ADV_STATUS_MSG;
         }
         break;
-        case APP_TIMER_ID_5:
+        case APP_TIMER_GROUP_APPLY:
         {
-           //appMsg.msgId = APP_TIMER_ID_5_MSG;
+            appMsg.msgId = APP_TIMER_GROUP_APPLY_MSG;
         }
         break;	
+        case APP_TIMER_SERVO_RAMP:
+        {
+            appMsg.msgId = APP_TIMER_SERVO_RAMP_MSG;
+        }
+        break;
+        case APP_TIMER_CAL_SAVE:
+        {
+            appMsg.msgId = APP_TIMER_CAL_SAVE_MSG;
+        }
+        break;
+        case APP_TIMER_ADV_ROTATE:
+        {
+            appMsg.msgId = APP_TIMER_ADV_ROTATE_MSG;
+        }
+        break;
 
         default:
             break;
     }
 
-    OSAL_QUEUE_Send(&appData.appQueue, &appMsg, msgWaitTime);
+    (void)APP_QUEUE_Send(&appMsg, msgWaitTime);
 }
 
 static void APP_TIMER_PeriodicTimerExpiredHandle(TimerHandle_t xTimer)
@@ -162,36 +178,51 @@ static void APP_TIMER_PeriodicTimerExpiredHandle(TimerHandle_t xTimer)
         }
         break;   
         
-        case APP_TIMER_ID_1:
+        case APP_TIMER_CONN_POLICY:
+        {
+            appMsg.msgId = APP_TIMER_CONN_POLICY_MSG;
+        }
+        break;
+        case APP_TIMER_LINK_STATUS:
+        {
+            appMsg.msgId = APP_TIMER_LINK_STATUS_MSG;
+        }
+        break;
+        case APP_TIMER_L2CAP_DRAIN:
+        {
+            appMsg.msgId = APP_TIMER_L2CAP_DRAIN_MSG;
+        }
+        break;
+        case APP_TIMER_ADV_STATUS:
         {
-           //appMsg.msgId = APP_TIMER_ID_1_MSG;
+            appMsg.msgId = APP_TIMER_ADV_STATUS_MSG;
         }
         break;
-        case APP_TIMER_ID_2:
+        case APP_TIMER_GROUP_APPLY:
         {
-           //appMsg.msgId = APP_TIMER_ID_2_MSG;
+            appMsg.msgId = APP_TIMER_GROUP_APPLY_MSG;
         }
         break;
-        case APP_TIMER_ID_3:
+        case APP_TIMER_SERVO_RAMP:
         {
-           //appMsg.msgId = APP_TIMER_ID_3_MSG;
+            appMsg.msgId = APP_TIMER_SERVO_RAMP_MSG;
         }
         break;
-        case APP_TIMER_ID_4:
+        case APP_TIMER_CAL_SAVE:
         {
-           //appMsg.msgId = APP_TIMER_ID_4_MSG;
+            appMsg.msgId = APP_TIMER_CAL_SAVE_MSG;
         }
         break;
-        case APP_TIMER_ID_5:
+        case APP_TIMER_ADV_ROTATE:
         {
-           //appMsg.msgId = APP_TIMER_ID_5_MSG;
+            appMsg.msgId = APP_TIMER_ADV_ROTATE_MSG;
         }
         break;
         default:
             break;
     }
 
-    OSAL_QUEUE_Send(&appData.appQueue, &appMsg, 0);
+    (void)APP_QUEUE_Send(&appMsg, 0);
     //No need to free timer ID due to it's periodic timer
 }
 
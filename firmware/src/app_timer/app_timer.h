@@ -68,11 +68,14 @@
 typedef enum APP_TIMER_TimerId_T
 {
     APP_TIMER_SEND_UART,
-    APP_TIMER_ID_1,
-    APP_TIMER_ID_2,
-    APP_TIMER_ID_3,
-    APP_TIMER_ID_4,
-    APP_TIMER_ID_5,
+    APP_TIMER_CONN_POLICY,
+    APP_TIMER_LINK_STATUS,
+    APP_TIMER_L2CAP_DRAIN,
+    APP_TIMER_ADV_STATUS,
+    APP_TIMER_GROUP_APPLY,
+    APP_TIMER_SERVO_RAMP,
+    APP_TIMER_CAL_SAVE,
+    APP_TIMER_ADV_ROTATE,
     APP_TIMER_TOTAL,
 } APP_TIMER_TimerId_T;
 
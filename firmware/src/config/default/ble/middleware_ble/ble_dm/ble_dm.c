@@ -288,4 +288,17 @@ void BLE_DM_GetPairedDeviceList(uint8_t *p_devId, uint8_t *p_devCnt)
             (*p_devCnt)++;
         }
     }
+}
+
+
+/**
+ * @brief Retrieves the paired device identifiers, most recently used first.
+ * 
+ * @param maxCnt[in]     Size of the p_devId array.
+ * @param p_devId[out]   Pointer to an array to store the device identifiers.
+ * @param p_devCnt[out]  Pointer to store the count of device identifiers.
+ */
+void BLE_DM_GetRecentPairedDeviceList(uint8_t maxCnt, uint8_t *p_devId, uint8_t *p_devCnt)
+{
+    BLE_DM_DdsGetRecentDevices(maxCnt, p_devId, p_devCnt);
 }
\ No newline at end of file
@@ -104,7 +104,7 @@ extern "C" {
  * @brief Defines the maximum number of paired devices that can be stored in flash memory.
  * @{
  */
-#define BLE_DM_MAX_PAIRED_DEVICE_NUM            (8U)                                        /**< Maximum number of paired devices stored in flash. */
+#define BLE_DM_MAX_PAIRED_DEVICE_NUM            (32U)                                       /**< Maximum number of paired devices stored in flash. */
 /** @} */
 
 
@@ -121,7 +121,7 @@ extern "C" {
  * @brief Defines the maximum number of devices that can be included in the filter accept list.
  * @{
  */
-#define BLE_DM_MAX_FILTER_ACCEPT_LIST_NUM       BLE_DM_MAX_PAIRED_DEVICE_NUM                /**< Maximum size of the filter accept list. */
+#define BLE_DM_MAX_FILTER_ACCEPT_LIST_NUM       (8U)                                        /**< Maximum size of the filter accept list. Independent of the number of paired devices. */
 /** @} */
 
 /**
@@ -129,7 +129,7 @@ extern "C" {
  * @brief Defines the maximum number of devices that can be included in the resolving list.
  * @{
  */
-#define BLE_DM_MAX_RESOLVING_LIST_NUM           BLE_DM_MAX_PAIRED_DEVICE_NUM                /**< Maximum size of the resolving list. */
+#define BLE_DM_MAX_RESOLVING_LIST_NUM           (8U)                                        /**< Maximum size of the resolving list. Independent of the number of paired devices. */
 /** @} */
 
 
@@ -442,6 +442,18 @@ uint16_t BLE_DM_DeleteAllPairedDevice(void);
 void BLE_DM_GetPairedDeviceList(uint8_t *p_devId, uint8_t *p_devCnt);
 
 
+/**
+ * @brief Retrieves the device IDs of the paired devices, most recently encrypted link first.
+ * @note  The order is kept across resets.
+ *
+ * @param[in] maxCnt                 Size of the p_devId buffer. Less recent devices beyond it are left out.
+ * @param[out] p_devId               Pointer to the buffer to store the device IDs.
+ * @param[out] p_devCnt              Pointer to the variable to store the count of valid device IDs in p_devId.
+ *
+*/
+void BLE_DM_GetRecentPairedDeviceList(uint8_t maxCnt, uint8_t *p_devId, uint8_t *p_devCnt);
+
+
 /**
  * @brief Requests a change in the connection parameters for a specific connection.
  *
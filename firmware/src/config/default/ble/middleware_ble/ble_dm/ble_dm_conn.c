@@ -47,6 +47,7 @@
 // *****************************************************************************
 // *****************************************************************************
 #include "osal/osal_freertos_extend.h"
+#include "ble_util/mw_conn.h"
 #include "ble_dm.h"
 #include "ble_dm_conn.h"
 #include "ble_dm_info.h"
@@ -110,21 +111,22 @@ static void ble_dm_ConnInitUpdateDb(BLE_DM_ConnUpdateDb_T *p_conn)
 }
 
 /**
- * @brief Retrieves a free connection instance from the connection update database.
+ * @brief Retrieves the free connection instance assigned to a new connection.
+ * 
+ * @param[in] connHandle The handle of the new connection.
  * 
  * @retval Pointer to the free connection instance, or NULL if none are available.
  */
-static BLE_DM_ConnUpdateDb_T *ble_dm_GetFreeConn(void)
+static BLE_DM_ConnUpdateDb_T *ble_dm_GetFreeConn(uint16_t connHandle)
 {
-    uint8_t i;
+    uint8_t index;
 
-    for (i=0; i<BLE_GAP_MAX_LINK_NBR; i++)
+    index = MW_CONN_GetIndex(connHandle);
+
+    if ((index < BLE_GAP_MAX_LINK_NBR) && (sp_dmConnCtrl->updateDb[index].state == BLE_DM_CONN_STATE_IDLE))
     {
-        if (sp_dmConnCtrl->updateDb[i].state == BLE_DM_CONN_STATE_IDLE)
-        {
-            sp_dmConnCtrl->updateDb[i].state = BLE_DM_CONN_STATE_CONNECTED;
-            return &sp_dmConnCtrl->updateDb[i];
-        }
+        sp_dmConnCtrl->updateDb[index].state = BLE_DM_CONN_STATE_CONNECTED;
+        return &sp_dmConnCtrl->updateDb[index];
     }
     return NULL;
 }
@@ -139,14 +141,14 @@ static BLE_DM_ConnUpdateDb_T *ble_dm_GetFreeConn(void)
  */
 static BLE_DM_ConnUpdateDb_T *ble_dm_ConnFindConnByHandle(uint16_t connHandle)
 {
-    uint8_t i;
+    uint8_t index;
 
-    for (i=0; i<BLE_GAP_MAX_LINK_NBR; i++)
+    index = MW_CONN_GetIndex(connHandle);
+
+    if ((index < BLE_GAP_MAX_LINK_NBR) 
+        && (sp_dmConnCtrl->updateDb[index].state == BLE_DM_CONN_STATE_CONNECTED) && (sp_dmConnCtrl->updateDb[index].connHandle == connHandle))
     {
-        if ((sp_dmConnCtrl->updateDb[i].state == BLE_DM_CONN_STATE_CONNECTED) && (sp_dmConnCtrl->updateDb[i].connHandle == connHandle))
-        {
-            return &sp_dmConnCtrl->updateDb[i];
-        }
+        return &sp_dmConnCtrl->updateDb[index];
     }
     return NULL;
 }
@@ -194,7 +196,7 @@ static void ble_dm_ConnProcGapConnected(BLE_GAP_Event_T *p_event)
         BLE_DM_ConnUpdateDb_T *p_conn;
     
         /* Find free connection instance */
-        p_conn = ble_dm_GetFreeConn();
+        p_conn = ble_dm_GetFreeConn(p_event->eventField.evtConnect.connHandle);
 
         if (p_conn != NULL)
         {
@@ -49,6 +49,7 @@
 #include <string.h>
 #include "osal/osal_freertos.h"
 #include "ble_util/mw_aes.h"
+#include "ble_util/mw_assert.h"
 #include "ble_dm_dds.h"
 #include "pds.h"
 
@@ -58,37 +59,53 @@
 // Section: Macros
 // *****************************************************************************
 // *****************************************************************************
+#define BLE_DM_DDS_RECORD_PER_FILE            (8U)                  // Number of bond records packed in a PDS file.
+#define BLE_DM_DDS_FILE_NUM                   ((BLE_DM_MAX_PAIRED_DEVICE_NUM + BLE_DM_DDS_RECORD_PER_FILE - 1U) / BLE_DM_DDS_RECORD_PER_FILE)
+#define BLE_DM_DDS_LEGACY_DEV_NUM             (8U)                  // Number of paired devices stored by the legacy one file per device format.
+
+#define BLE_DM_DDS_RPA_CACHE_NUM              (4U)                  // Number of resolvable private addresses kept with their device ID.
+
+/* Flags of a bond record.*/
+#define BLE_DM_DDS_RECORD_VALID               (1U << 0U)            // The record holds a paired device.
+#define BLE_DM_DDS_RECORD_LOCAL_ADDR          (1U << 1U)            // The local address used for the pairing is known.
+
 /* Enumeration of BLE PDS item IDs.*/
 typedef enum BLE_DM_PdsBleItem_T{
-    PDS_BLE_ITEM_ID_1 = (PDS_MODULE_BT_OFFSET),         // PDS item ID 1.
-    PDS_BLE_ITEM_ID_2,                                  // PDS item ID 2.
-    PDS_BLE_ITEM_ID_3,                                  // PDS item ID 3.
-    PDS_BLE_ITEM_ID_4,                                  // PDS item ID 4.
-    PDS_BLE_ITEM_ID_5,                                  // PDS item ID 5.
-    PDS_BLE_ITEM_ID_6,                                  // PDS item ID 6.
-    PDS_BLE_ITEM_ID_7,                                  // PDS item ID 7.
-    PDS_BLE_ITEM_ID_8,                                  // PDS item ID 8.
-
-
-    PDS_BLE_ITEM_EXT_ID_1,                              // PDS extended item ID 1.
-    PDS_BLE_ITEM_EXT_ID_2,                              // PDS extended item ID 2.
-    PDS_BLE_ITEM_EXT_ID_3,                              // PDS extended item ID 3.
-    PDS_BLE_ITEM_EXT_ID_4,                              // PDS extended item ID 4.
-    PDS_BLE_ITEM_EXT_ID_5,                              // PDS extended item ID 5.
-    PDS_BLE_ITEM_EXT_ID_6,                              // PDS extended item ID 6.
-    PDS_BLE_ITEM_EXT_ID_7,                              // PDS extended item ID 7.
-    PDS_BLE_ITEM_EXT_ID_8                               // PDS extended item ID 8.
+    PDS_BLE_ITEM_ID_1 = (PDS_MODULE_BT_OFFSET),         // Legacy PDS item ID 1.
+    PDS_BLE_ITEM_ID_2,                                  // Legacy PDS item ID 2.
+    PDS_BLE_ITEM_ID_3,                                  // Legacy PDS item ID 3.
+    PDS_BLE_ITEM_ID_4,                                  // Legacy PDS item ID 4.
+    PDS_BLE_ITEM_ID_5,                                  // Legacy PDS item ID 5.
+    PDS_BLE_ITEM_ID_6,                                  // Legacy PDS item ID 6.
+    PDS_BLE_ITEM_ID_7,                                  // Legacy PDS item ID 7.
+    PDS_BLE_ITEM_ID_8,                                  // Legacy PDS item ID 8.
+
+
+    PDS_BLE_ITEM_EXT_ID_1,                              // Legacy PDS extended item ID 1.
+    PDS_BLE_ITEM_EXT_ID_2,                              // Legacy PDS extended item ID 2.
+    PDS_BLE_ITEM_EXT_ID_3,                              // Legacy PDS extended item ID 3.
+    PDS_BLE_ITEM_EXT_ID_4,                              // Legacy PDS extended item ID 4.
+    PDS_BLE_ITEM_EXT_ID_5,                              // Legacy PDS extended item ID 5.
+    PDS_BLE_ITEM_EXT_ID_6,                              // Legacy PDS extended item ID 6.
+    PDS_BLE_ITEM_EXT_ID_7,                              // Legacy PDS extended item ID 7.
+    PDS_BLE_ITEM_EXT_ID_8,                              // Legacy PDS extended item ID 8.
+
+    PDS_BLE_ITEM_BOND_ID_1,                             // PDS bond file ID 1.
+    PDS_BLE_ITEM_BOND_ID_2,                             // PDS bond file ID 2.
+    PDS_BLE_ITEM_BOND_ID_3,                             // PDS bond file ID 3.
+    PDS_BLE_ITEM_BOND_ID_4                              // PDS bond file ID 4.
 }BLE_DM_PdsBleItem_T;
 
-#define BLE_DM_DDS_FILE_MAIN_ITEM_START       PDS_BLE_ITEM_ID_1     // Start ID for main item in DDS.
-#define BLE_DM_DDS_FILE_EXT_ITEM_START        PDS_BLE_ITEM_EXT_ID_1 // Start ID for extended item in DDS.
+#define BLE_DM_DDS_FILE_MAIN_ITEM_START       PDS_BLE_ITEM_ID_1     // Start ID for legacy main item in DDS.
+#define BLE_DM_DDS_FILE_EXT_ITEM_START        PDS_BLE_ITEM_EXT_ID_1 // Start ID for legacy extended item in DDS.
+#define BLE_DM_DDS_FILE_BOND_START            PDS_BLE_ITEM_BOND_ID_1    // Start ID for bond file in DDS.
 
 // *****************************************************************************
 // *****************************************************************************
 // Section: Data Types
 // *****************************************************************************
 // *****************************************************************************
-/* Structure to store main paired device information.*/
+/* Structure to store main paired device information in the legacy format.*/
 typedef struct BLE_DM_MainPairedDevInfo_T
 {
     BLE_GAP_Addr_T                  remoteAddr;                    // Paired device bluetooth address.
@@ -102,7 +119,7 @@ typedef struct BLE_DM_MainPairedDevInfo_T
 }BLE_DM_MainPairedDevInfo_T;
 
 
-/* Structure to store extended paired device information.*/
+/* Structure to store extended paired device information in the legacy format.*/
 typedef struct BLE_DM_ExtPairedDevInfo_T
 {
     BLE_GAP_Addr_T                  localAddr;                     // Local device bluetooth address.
@@ -110,12 +127,49 @@ typedef struct BLE_DM_ExtPairedDevInfo_T
     uint8_t                         reserved[9];                   // Reserved space for future use.
 }BLE_DM_ExtPairedDevInfo_T;
 
+
+/* Structure of a bond record.*/
+typedef struct BLE_DM_DdsRecord_T
+{
+    BLE_GAP_Addr_T                  remoteAddr;                    // Paired device bluetooth address.
+    uint8_t                         remoteIrk[16];                 // Paired device BLE identity resolving key.
+    BLE_GAP_Addr_T                  localAddr;                     // Local device bluetooth address.
+    uint8_t                         localIrk[16];                  // Local device BLE identity resolving key.
+    uint8_t                         rv[8];                         // Paired device BLE rand value
+    uint8_t                         ediv[2];                       // Paired device BLE encrypted diversifier.
+    uint8_t                         ltk[16];                       // Paired device BLE Link key.
+    uint8_t                         lesc:1;                        // Paired device using LE secure connection.
+    uint8_t                         auth:1;                        // Paired device using authenticated pairing method.
+    uint8_t                         encryptKeySize:6;              // Paired device BLE encrpytion key size.
+    uint8_t                         flags;                         // See BLE_DM_DDS_RECORD_VALID.
+    uint32_t                        useSeq;                        // Recency of the paired device, the highest is the most recent.
+}BLE_DM_DdsRecord_T;
+
+
+/* Structure of a PDS file packing several bond records.*/
+typedef struct BLE_DM_DdsFile_T
+{
+    BLE_DM_DdsRecord_T              record[BLE_DM_DDS_RECORD_PER_FILE];
+}BLE_DM_DdsFile_T;
+
+
+/* Structure of a resolved private address.*/
+typedef struct BLE_DM_DdsRpaEntry_T
+{
+    uint8_t                         addr[GAP_MAX_BD_ADDRESS_LEN];  // Resolvable private address.
+    uint8_t                         devId;                         // Device ID, BLE_DM_MAX_PAIRED_DEVICE_NUM if no paired device resolves it.
+}BLE_DM_DdsRpaEntry_T;
+
 // *****************************************************************************
 // *****************************************************************************
 // Section: Local Variables
 // *****************************************************************************
 // *****************************************************************************
 
+/* Each bond file has its own RAM image, so a background store never races with another file.*/
+static BLE_DM_DdsFile_T                 s_bondFile[BLE_DM_DDS_FILE_NUM];
+
+/* Buffers of the legacy format, only used to import the paired devices of an older firmware.*/
 static BLE_DM_MainPairedDevInfo_T       s_mainPairedInfo;
 static BLE_DM_ExtPairedDevInfo_T        s_extPairedInfo;
 
@@ -138,33 +192,54 @@ PDS_DECLARE_FILE(PDS_BLE_ITEM_EXT_ID_6, (uint16_t)sizeof(BLE_DM_ExtPairedDevInfo
 PDS_DECLARE_FILE(PDS_BLE_ITEM_EXT_ID_7, (uint16_t)sizeof(BLE_DM_ExtPairedDevInfo_T), &s_extPairedInfo,FILE_INTEGRITY_CONTROL_MARK);
 PDS_DECLARE_FILE(PDS_BLE_ITEM_EXT_ID_8, (uint16_t)sizeof(BLE_DM_ExtPairedDevInfo_T), &s_extPairedInfo,FILE_INTEGRITY_CONTROL_MARK);
 
+PDS_DECLARE_FILE(PDS_BLE_ITEM_BOND_ID_1, (uint16_t)sizeof(BLE_DM_DdsFile_T), &s_bondFile[0],FILE_INTEGRITY_CONTROL_MARK);
+PDS_DECLARE_FILE(PDS_BLE_ITEM_BOND_ID_2, (uint16_t)sizeof(BLE_DM_DdsFile_T), &s_bondFile[1],FILE_INTEGRITY_CONTROL_MARK);
+PDS_DECLARE_FILE(PDS_BLE_ITEM_BOND_ID_3, (uint16_t)sizeof(BLE_DM_DdsFile_T), &s_bondFile[2],FILE_INTEGRITY_CONTROL_MARK);
+PDS_DECLARE_FILE(PDS_BLE_ITEM_BOND_ID_4, (uint16_t)sizeof(BLE_DM_DdsFile_T), &s_bondFile[3],FILE_INTEGRITY_CONTROL_MARK);
+
 
 static BLE_DM_DdsWriteCompleteCb_T s_dmDdsCb;
 
+static bool                             s_isLoaded;
+static uint8_t                          s_pendingWrite[BLE_DM_DDS_FILE_NUM];    // Records of each file waiting for the write complete callback.
+
+/* Device IDs of the paired devices sorted by identity address.*/
+static uint8_t                          s_addrIndex[BLE_DM_MAX_PAIRED_DEVICE_NUM];
+static uint8_t                          s_addrIndexNum;
+
+static uint8_t                          s_irkKey[BLE_DM_MAX_PAIRED_DEVICE_NUM][16];     // Paired device IRK, in the byte order of the AES key.
+static uint32_t                         s_useSeq;
+static uint8_t                          s_recentDevId;  // Most recently used paired device, its stored recency is already the highest one.
+
+/* Most recently used first. The entries are only valid for s_rpaCacheLocalAddr and the current bond list.*/
+static BLE_DM_DdsRpaEntry_T             s_rpaCache[BLE_DM_DDS_RPA_CACHE_NUM];
+static uint8_t                          s_rpaCacheNum;
+static BLE_GAP_Addr_T                   s_rpaCacheLocalAddr;
+
 // *****************************************************************************
 // *****************************************************************************
 // Section: Functions
 // *****************************************************************************
 // *****************************************************************************
+MW_ASSERT(BLE_DM_DDS_FILE_NUM == 4U);
+MW_ASSERT(sizeof(BLE_DM_DdsFile_T) <= PDS_MAX_FILE_SIZE);
+MW_ASSERT(BLE_DM_MAX_PAIRED_DEVICE_NUM >= BLE_DM_DDS_LEGACY_DEV_NUM);
+
 /**
  * @brief Checks if the given address can be resolved using the provided IRK.
  *
- * @param[in] p_remoteIrk Pointer to the IRK used for resolving the address.
+ * @param[in] p_irkKey Pointer to the IRK used for resolving the address, in the byte order of the AES key.
  * @param[in] p_remoteAddr Pointer to the address to be resolved.
  * 
  * @retval true if the address can be resolved, false otherwise.
  */
-static bool ble_dm_DdsCheckResolveAddress(uint8_t *p_remoteIrk, uint8_t *p_remoteAddr)
+static bool ble_dm_DdsCheckResolveAddress(const uint8_t *p_irkKey, uint8_t *p_remoteAddr)
 {
     uint8_t data[16], temp[16];
     uint8_t i;
     MW_AES_Ctx_T ctx;
 
-    /* convert irk as aes key */
-    for(i=0U; i<16U; i++)
-    {
-        temp[i]=p_remoteIrk[15U-i];
-    }
+    (void)memcpy(temp, p_irkKey, 16);
 
     if (MW_AES_EcbEncryptInit(&ctx, temp) != MBA_RES_SUCCESS)
     {
@@ -194,6 +269,328 @@ static bool ble_dm_DdsCheckResolveAddress(uint8_t *p_remoteIrk, uint8_t *p_remot
     return (memcmp(temp + 13, data, 3) == 0);
 }
 
+/**
+ * @brief Get the bond record of a device ID.
+ *
+ * @param[in] devId             Device ID within the range of 0 to (BLE_DM_MAX_PAIRED_DEVICE_NUM - 1).
+ *
+ * @retval Pointer to the record.
+ */
+static BLE_DM_DdsRecord_T *ble_dm_DdsGetRecord(uint8_t devId)
+{
+    return &s_bondFile[devId / BLE_DM_DDS_RECORD_PER_FILE].record[devId % BLE_DM_DDS_RECORD_PER_FILE];
+}
+
+/**
+ * @brief Find the position of an identity address in the address index.
+ *
+ * @param[in] p_addr            Pointer to the identity address.
+ * @param[out] p_pos            Pointer to the position of the address, or to the position to insert it at.
+ *
+ * @retval true if the address is in the index, false otherwise.
+ */
+static bool ble_dm_DdsIndexFind(const BLE_GAP_Addr_T *p_addr, uint8_t *p_pos)
+{
+    uint8_t low = 0;
+    uint8_t high = s_addrIndexNum;
+    uint8_t mid;
+    int cmp;
+
+    while (low < high)
+    {
+        mid = (uint8_t)((low + high) / 2U);
+        cmp = memcmp(&ble_dm_DdsGetRecord(s_addrIndex[mid])->remoteAddr, p_addr, (uint16_t)sizeof(BLE_GAP_Addr_T));
+
+        if (cmp == 0)
+        {
+            *p_pos = mid;
+            return true;
+        }
+        else if (cmp < 0)
+        {
+            low = mid + 1U;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+
+    *p_pos = low;
+    return false;
+}
+
+/**
+ * @brief Add a paired device to the address index.
+ *
+ * @param[in] devId             Device ID of the paired device.
+ */
+static void ble_dm_DdsIndexAdd(uint8_t devId)
+{
+    uint8_t pos;
+
+    (void)ble_dm_DdsIndexFind(&ble_dm_DdsGetRecord(devId)->remoteAddr, &pos);
+    (void)memmove(&s_addrIndex[pos + 1U], &s_addrIndex[pos], (uint16_t)(s_addrIndexNum - pos));
+    s_addrIndex[pos] = devId;
+    s_addrIndexNum++;
+}
+
+/**
+ * @brief Remove a paired device from the address index.
+ *
+ * @param[in] devId             Device ID of the paired device.
+ */
+static void ble_dm_DdsIndexRemove(uint8_t devId)
+{
+    uint8_t pos;
+
+    for (pos = 0; pos < s_addrIndexNum; pos++)
+    {
+        if (s_addrIndex[pos] == devId)
+        {
+            (void)memmove(&s_addrIndex[pos], &s_addrIndex[pos + 1U], (uint16_t)(s_addrIndexNum - pos - 1U));
+            s_addrIndexNum--;
+            break;
+        }
+    }
+}
+
+/**
+ * @brief Keep the RAM only data of a paired device up to date with its record.
+ *
+ * @param[in] devId             Device ID of the paired device.
+ */
+static void ble_dm_DdsAttach(uint8_t devId)
+{
+    BLE_DM_DdsRecord_T *p_record = ble_dm_DdsGetRecord(devId);
+    uint8_t i;
+
+    /* convert irk as aes key once, instead of on every resolution */
+    for(i=0U; i<16U; i++)
+    {
+        s_irkKey[devId][i]=p_record->remoteIrk[15U-i];
+    }
+
+    if (p_record->useSeq >= s_useSeq)
+    {
+        s_useSeq = p_record->useSeq + 1U;
+        s_recentDevId = devId;
+    }
+
+    ble_dm_DdsIndexAdd(devId);
+}
+
+/**
+ * @brief Import the paired devices stored by an older firmware, one PDS file per device.
+ *
+ * @retval true if any paired device was imported, false otherwise.
+ */
+static bool ble_dm_DdsImportLegacy(void)
+{
+    BLE_DM_DdsRecord_T *p_record;
+    uint8_t devId;
+    bool imported = false;
+
+    for (devId = 0; devId < BLE_DM_DDS_LEGACY_DEV_NUM; devId++)
+    {
+        if (PDS_IsAbleToRestore((uint16_t)BLE_DM_DDS_FILE_MAIN_ITEM_START + devId) == false
+            || PDS_Restore((uint16_t)BLE_DM_DDS_FILE_MAIN_ITEM_START + devId) == false)
+        {
+            continue;
+        }
+
+        p_record = ble_dm_DdsGetRecord(devId);
+        p_record->remoteAddr = s_mainPairedInfo.remoteAddr;
+        (void)memcpy(p_record->remoteIrk, s_mainPairedInfo.remoteIrk, 16);
+        (void)memcpy(p_record->rv, s_mainPairedInfo.rv, 8);
+        (void)memcpy(p_record->ediv, s_mainPairedInfo.ediv, 2);
+        (void)memcpy(p_record->ltk, s_mainPairedInfo.ltk, 16);
+        p_record->lesc = s_mainPairedInfo.lesc;
+        p_record->auth = s_mainPairedInfo.auth;
+        p_record->encryptKeySize = s_mainPairedInfo.encryptKeySize;
+        p_record->flags = BLE_DM_DDS_RECORD_VALID;
+        p_record->useSeq = 0;
+
+        if (PDS_IsAbleToRestore((uint16_t)BLE_DM_DDS_FILE_EXT_ITEM_START + devId)
+            && PDS_Restore((uint16_t)BLE_DM_DDS_FILE_EXT_ITEM_START + devId))
+        {
+            p_record->localAddr = s_extPairedInfo.localAddr;
+            (void)memcpy(p_record->localIrk, s_extPairedInfo.localIrk, 16);
+            p_record->flags |= BLE_DM_DDS_RECORD_LOCAL_ADDR;
+        }
+
+        imported = true;
+    }
+
+    return imported;
+}
+
+/**
+ * @brief Delete the legacy files once the bond files hold the paired devices.
+ */
+static void ble_dm_DdsDeleteLegacy(void)
+{
+    uint8_t devId;
+
+    for (devId = 0; devId < BLE_DM_DDS_LEGACY_DEV_NUM; devId++)
+    {
+        if (PDS_IsAbleToRestore((uint16_t)BLE_DM_DDS_FILE_MAIN_ITEM_START + devId))
+        {
+            (void)PDS_Delete((uint16_t)BLE_DM_DDS_FILE_MAIN_ITEM_START + devId);
+        }
+
+        if (PDS_IsAbleToRestore((uint16_t)BLE_DM_DDS_FILE_EXT_ITEM_START + devId))
+        {
+            (void)PDS_Delete((uint16_t)BLE_DM_DDS_FILE_EXT_ITEM_START + devId);
+        }
+    }
+}
+
+/**
+ * @brief Load the bond files and build the RAM index.
+ */
+static void ble_dm_DdsLoad(void)
+{
+    uint8_t i;
+    uint8_t devId;
+    bool hasBondFile = false;
+
+    (void)memset(s_bondFile, 0, sizeof(s_bondFile));
+    s_addrIndexNum = 0;
+    s_rpaCacheNum = 0;
+    s_useSeq = 1;
+    s_recentDevId = BLE_DM_MAX_PAIRED_DEVICE_NUM;
+
+    for (i = 0; i < BLE_DM_DDS_FILE_NUM; i++)
+    {
+        if (PDS_IsAbleToRestore((uint16_t)BLE_DM_DDS_FILE_BOND_START + i))
+        {
+            if (PDS_Restore((uint16_t)BLE_DM_DDS_FILE_BOND_START + i))
+            {
+                hasBondFile = true;
+            }
+            else
+            {
+                (void)memset(&s_bondFile[i], 0, sizeof(BLE_DM_DdsFile_T));
+            }
+        }
+    }
+
+    if (hasBondFile)
+    {
+        /* The legacy files are only deleted at the next start, once the bond files are known to be written */
+        ble_dm_DdsDeleteLegacy();
+    }
+    else if (ble_dm_DdsImportLegacy())
+    {
+        for (i = 0; i < BLE_DM_DDS_FILE_NUM; i++)
+        {
+            (void)PDS_Store((uint16_t)BLE_DM_DDS_FILE_BOND_START + i);
+        }
+    }
+
+    for (devId = 0; devId < BLE_DM_MAX_PAIRED_DEVICE_NUM; devId++)
+    {
+        if ((ble_dm_DdsGetRecord(devId)->flags & BLE_DM_DDS_RECORD_VALID) != 0U)
+        {
+            ble_dm_DdsAttach(devId);
+        }
+    }
+
+    s_isLoaded = true;
+}
+
+/**
+ * @brief Check the bond files are loaded and a device ID holds a paired device.
+ *
+ * @param[in] devId             Device ID to be checked.
+ *
+ * @retval true if the device ID holds a paired device, false otherwise.
+ */
+static bool ble_dm_DdsIsValid(uint8_t devId)
+{
+    if (!s_isLoaded)
+    {
+        ble_dm_DdsLoad();
+    }
+
+    return (devId < BLE_DM_MAX_PAIRED_DEVICE_NUM) && ((ble_dm_DdsGetRecord(devId)->flags & BLE_DM_DDS_RECORD_VALID) != 0U);
+}
+
+/**
+ * @brief Look up a resolvable private address among the recently resolved ones.
+ *
+ * @param[in] p_addr            Pointer to the resolvable private address.
+ * @param[out] p_devId          Pointer to the device ID of the address.
+ *
+ * @retval true if the address was resolved recently, false otherwise.
+ */
+static bool ble_dm_DdsRpaCacheGet(const uint8_t *p_addr, uint8_t *p_devId)
+{
+    BLE_DM_DdsRpaEntry_T entry;
+    uint8_t i;
+
+    for (i = 0; i < s_rpaCacheNum; i++)
+    {
+        if (memcmp(s_rpaCache[i].addr, p_addr, GAP_MAX_BD_ADDRESS_LEN) == 0)
+        {
+            entry = s_rpaCache[i];
+
+            /* move to the front */
+            (void)memmove(&s_rpaCache[1], &s_rpaCache[0], i * sizeof(BLE_DM_DdsRpaEntry_T));
+            s_rpaCache[0] = entry;
+
+            *p_devId = entry.devId;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Keep a resolved private address, replacing the least recently used one if the cache is full.
+ *
+ * @param[in] p_addr            Pointer to the resolvable private address.
+ * @param[in] devId             Device ID of the address.
+ */
+static void ble_dm_DdsRpaCachePut(const uint8_t *p_addr, uint8_t devId)
+{
+    if (s_rpaCacheNum < BLE_DM_DDS_RPA_CACHE_NUM)
+    {
+        s_rpaCacheNum++;
+    }
+
+    (void)memmove(&s_rpaCache[1], &s_rpaCache[0], (s_rpaCacheNum - 1U) * sizeof(BLE_DM_DdsRpaEntry_T));
+    (void)memcpy(s_rpaCache[0].addr, p_addr, GAP_MAX_BD_ADDRESS_LEN);
+    s_rpaCache[0].devId = devId;
+}
+
+/**
+ * @brief Store the bond file holding a device ID.
+ *
+ * @param[in] devId             Device ID of the changed record.
+ * @param[in] notify            True to call the write complete callback for the device ID.
+ *
+ * @retval MBA_RES_SUCCESS if storing has begun, MBA_RES_FAIL otherwise.
+ */
+static uint16_t ble_dm_DdsStoreRecord(uint8_t devId, bool notify)
+{
+    uint8_t file = devId / BLE_DM_DDS_RECORD_PER_FILE;
+
+    if (!PDS_Store((uint16_t)BLE_DM_DDS_FILE_BOND_START + file))
+    {
+        return MBA_RES_FAIL;
+    }
+
+    if (notify)
+    {
+        s_pendingWrite[file] |= (uint8_t)(1U << (devId % BLE_DM_DDS_RECORD_PER_FILE));
+    }
+
+    return MBA_RES_SUCCESS;
+}
+
 /**
  * @brief Retrieve paired device information.
  * 
@@ -206,37 +603,37 @@ static bool ble_dm_DdsCheckResolveAddress(uint8_t *p_remoteIrk, uint8_t *p_remot
  */
 uint16_t BLE_DM_DdsGetPairedDevice(uint8_t devId, BLE_DM_PairedDevInfo_T * p_pairedDevInfo)
 {
-    if (devId >= BLE_DM_MAX_PAIRED_DEVICE_NUM
-        || PDS_IsAbleToRestore((uint16_t)BLE_DM_DDS_FILE_MAIN_ITEM_START + devId) == false)
+    BLE_DM_DdsRecord_T *p_record;
+
+    if (!ble_dm_DdsIsValid(devId))
     {
         return MBA_RES_INVALID_PARA;
     }
 
-    if (PDS_Restore((uint16_t)BLE_DM_DDS_FILE_MAIN_ITEM_START + devId))
-    {
-        if (PDS_IsAbleToRestore((uint16_t)BLE_DM_DDS_FILE_EXT_ITEM_START + devId) == true)
-        {
-            if (PDS_Restore((uint16_t)BLE_DM_DDS_FILE_EXT_ITEM_START + devId) == false)
-            {
-                return MBA_RES_FAIL;
-            }
-
-            (void)memcpy(&p_pairedDevInfo->localAddr, &s_extPairedInfo.localAddr, offsetof(BLE_DM_ExtPairedDevInfo_T, reserved));
-        }
-        else
-        {
-            (void)memset(&p_pairedDevInfo->localAddr, 0x00, offsetof(BLE_DM_ExtPairedDevInfo_T, reserved));
-        }
+    p_record = ble_dm_DdsGetRecord(devId);
 
-        (void)memcpy(&p_pairedDevInfo->remoteAddr, &s_mainPairedInfo.remoteAddr, offsetof(BLE_DM_PairedDevInfo_T, localAddr));
-        (void)memcpy(p_pairedDevInfo->rv, s_mainPairedInfo.rv, sizeof(BLE_DM_MainPairedDevInfo_T) - offsetof(BLE_DM_MainPairedDevInfo_T, rv));
+    p_pairedDevInfo->remoteAddr = p_record->remoteAddr;
+    (void)memcpy(p_pairedDevInfo->remoteIrk, p_record->remoteIrk, 16);
 
-        return MBA_RES_SUCCESS;
+    if ((p_record->flags & BLE_DM_DDS_RECORD_LOCAL_ADDR) != 0U)
+    {
+        p_pairedDevInfo->localAddr = p_record->localAddr;
+        (void)memcpy(p_pairedDevInfo->localIrk, p_record->localIrk, 16);
     }
     else
     {
-        return MBA_RES_FAIL;
+        (void)memset(&p_pairedDevInfo->localAddr, 0x00, sizeof(BLE_GAP_Addr_T));
+        (void)memset(p_pairedDevInfo->localIrk, 0x00, 16);
     }
+
+    (void)memcpy(p_pairedDevInfo->rv, p_record->rv, 8);
+    (void)memcpy(p_pairedDevInfo->ediv, p_record->ediv, 2);
+    (void)memcpy(p_pairedDevInfo->ltk, p_record->ltk, 16);
+    p_pairedDevInfo->lesc = p_record->lesc;
+    p_pairedDevInfo->auth = p_record->auth;
+    p_pairedDevInfo->encryptKeySize = p_record->encryptKeySize;
+
+    return MBA_RES_SUCCESS;
 }
 
 /**
@@ -251,38 +648,44 @@ uint16_t BLE_DM_DdsGetPairedDevice(uint8_t devId, BLE_DM_PairedDevInfo_T * p_pai
  */
 uint16_t BLE_DM_DdsSetPairedDevice(uint8_t devId, BLE_DM_PairedDevInfo_T *p_pairedDevInfo)
 {
+    BLE_DM_DdsRecord_T *p_record;
+
     if (devId >= BLE_DM_MAX_PAIRED_DEVICE_NUM)
     {
         return MBA_RES_INVALID_PARA;
     }
 
-    (void)memcpy(&s_extPairedInfo.localAddr, &p_pairedDevInfo->localAddr, offsetof(BLE_DM_ExtPairedDevInfo_T, reserved));
-
-    if (PDS_Store((uint16_t)BLE_DM_DDS_FILE_EXT_ITEM_START + devId))
-    {
-        (void)memcpy(&s_mainPairedInfo.remoteAddr, &p_pairedDevInfo->remoteAddr, offsetof(BLE_DM_PairedDevInfo_T, localAddr));
-        (void)memcpy(s_mainPairedInfo.rv, p_pairedDevInfo->rv, sizeof(BLE_DM_MainPairedDevInfo_T) - offsetof(BLE_DM_MainPairedDevInfo_T, rv));
-
-        if (PDS_Store((uint16_t)BLE_DM_DDS_FILE_MAIN_ITEM_START + devId))
-        {
-            return MBA_RES_SUCCESS;
-        }
-        else
-        {
-            return MBA_RES_FAIL;
-        }
-    }
-    else
+    if (ble_dm_DdsIsValid(devId))
     {
-        return MBA_RES_FAIL;
+        ble_dm_DdsIndexRemove(devId);
     }
+
+    p_record = ble_dm_DdsGetRecord(devId);
+
+    p_record->remoteAddr = p_pairedDevInfo->remoteAddr;
+    (void)memcpy(p_record->remoteIrk, p_pairedDevInfo->remoteIrk, 16);
+    p_record->localAddr = p_pairedDevInfo->localAddr;
+    (void)memcpy(p_record->localIrk, p_pairedDevInfo->localIrk, 16);
+    (void)memcpy(p_record->rv, p_pairedDevInfo->rv, 8);
+    (void)memcpy(p_record->ediv, p_pairedDevInfo->ediv, 2);
+    (void)memcpy(p_record->ltk, p_pairedDevInfo->ltk, 16);
+    p_record->lesc = p_pairedDevInfo->lesc;
+    p_record->auth = p_pairedDevInfo->auth;
+    p_record->encryptKeySize = p_pairedDevInfo->encryptKeySize;
+    p_record->flags = BLE_DM_DDS_RECORD_VALID | BLE_DM_DDS_RECORD_LOCAL_ADDR;
+    p_record->useSeq = s_useSeq;
+
+    ble_dm_DdsAttach(devId);
+    s_rpaCacheNum = 0;
+
+    return ble_dm_DdsStoreRecord(devId, true);
 }
 
 
 /**
  * @brief Get the first free device ID.
  * 
- * @retval The first free device ID.
+ * @retval The first free device ID, or BLE_DM_MAX_PAIRED_DEVICE_NUM if every device ID is in use.
  */
 uint8_t BLE_DM_DdsGetFreeDeviceId(void)
 {
@@ -290,7 +693,7 @@ uint8_t BLE_DM_DdsGetFreeDeviceId(void)
 
     for (devId = 0; devId < BLE_DM_MAX_PAIRED_DEVICE_NUM; devId++)
     {
-        if (!PDS_IsAbleToRestore((uint16_t)BLE_DM_DDS_FILE_MAIN_ITEM_START + devId))
+        if (!ble_dm_DdsIsValid(devId))
         {
             break;
         }
@@ -300,6 +703,34 @@ uint8_t BLE_DM_DdsGetFreeDeviceId(void)
 }
 
 
+/**
+ * @brief Delete the least recently used paired device to free its device ID.
+ * 
+ * @retval The freed device ID, or BLE_DM_MAX_PAIRED_DEVICE_NUM on failure.
+ */
+uint8_t BLE_DM_DdsEvictDeviceId(void)
+{
+    uint8_t devId;
+    uint8_t lruDevId = BLE_DM_MAX_PAIRED_DEVICE_NUM;
+
+    for (devId = 0; devId < BLE_DM_MAX_PAIRED_DEVICE_NUM; devId++)
+    {
+        if (ble_dm_DdsIsValid(devId)
+            && ((lruDevId == BLE_DM_MAX_PAIRED_DEVICE_NUM) || (ble_dm_DdsGetRecord(devId)->useSeq < ble_dm_DdsGetRecord(lruDevId)->useSeq)))
+        {
+            lruDevId = devId;
+        }
+    }
+
+    if ((lruDevId == BLE_DM_MAX_PAIRED_DEVICE_NUM) || (BLE_DM_DdsDeletePairedDevice(lruDevId) != MBA_RES_SUCCESS))
+    {
+        return BLE_DM_MAX_PAIRED_DEVICE_NUM;
+    }
+
+    return lruDevId;
+}
+
+
 /**
  * @brief Retrieve the device ID for a given Bluetooth address.
  * 
@@ -310,8 +741,10 @@ uint8_t BLE_DM_DdsGetFreeDeviceId(void)
 uint8_t BLE_DM_DdsGetDeviceId(BLE_GAP_Addr_T *p_bdAddr)
 {
     uint8_t devId;
+    uint8_t pos;
     BLE_GAP_Addr_T addr;
     uint16_t result;
+    BLE_DM_DdsRecord_T *p_record;
 
     /* check if non-resolvable private address? */
     if (p_bdAddr->addrType == BLE_GAP_ADDR_TYPE_RANDOM_NON_RESOLVABLE)
@@ -325,43 +758,54 @@ uint8_t BLE_DM_DdsGetDeviceId(BLE_GAP_Addr_T *p_bdAddr)
     {
         return BLE_DM_MAX_PAIRED_DEVICE_NUM;
     }
-    
-    for (devId = 0; devId < BLE_DM_MAX_PAIRED_DEVICE_NUM; devId++)
+
+    if (!s_isLoaded)
     {
-        if (PDS_IsAbleToRestore((uint16_t)BLE_DM_DDS_FILE_MAIN_ITEM_START + devId))
+        ble_dm_DdsLoad();
+    }
+
+    devId = BLE_DM_MAX_PAIRED_DEVICE_NUM;
+
+    if (p_bdAddr->addrType == BLE_GAP_ADDR_TYPE_RANDOM_RESOLVABLE)
+    {
+        /* the pairings visible to the peer depend on the local address */
+        if (memcmp(&s_rpaCacheLocalAddr, &addr, (uint16_t)sizeof(BLE_GAP_Addr_T)) != 0)
+        {
+            s_rpaCacheNum = 0;
+            s_rpaCacheLocalAddr = addr;
+        }
+
+        if (!ble_dm_DdsRpaCacheGet(p_bdAddr->addr, &devId))
         {
-            if (PDS_Restore((uint16_t)BLE_DM_DDS_FILE_MAIN_ITEM_START + devId))
+            for (pos = 0; pos < s_addrIndexNum; pos++)
             {
-                if (PDS_IsAbleToRestore((uint16_t)BLE_DM_DDS_FILE_EXT_ITEM_START + devId))
-                {
-                    if (PDS_Restore((uint16_t)BLE_DM_DDS_FILE_EXT_ITEM_START + devId))
-                    {
-                        if (memcmp(&s_extPairedInfo.localAddr, &addr, (uint16_t)sizeof(BLE_GAP_Addr_T)) != 0)
-                        {
-                            continue;
-                        }
-                    }
-                    else
-                    {
-                        continue;
-                    }
-                }
+                p_record = ble_dm_DdsGetRecord(s_addrIndex[pos]);
 
-                if (p_bdAddr->addrType == BLE_GAP_ADDR_TYPE_RANDOM_RESOLVABLE)
+                if (((p_record->flags & BLE_DM_DDS_RECORD_LOCAL_ADDR) != 0U)
+                    && (memcmp(&p_record->localAddr, &addr, (uint16_t)sizeof(BLE_GAP_Addr_T)) != 0))
                 {
-                    if (ble_dm_DdsCheckResolveAddress(s_mainPairedInfo.remoteIrk, p_bdAddr->addr)==true)
-                    {
-                        break;
-                    }
+                    continue;
                 }
-                else
+
+                if (ble_dm_DdsCheckResolveAddress(s_irkKey[s_addrIndex[pos]], p_bdAddr->addr)==true)
                 {
-                    if (memcmp(p_bdAddr->addr, s_mainPairedInfo.remoteAddr.addr, GAP_MAX_BD_ADDRESS_LEN) == 0)
-                    {
-                        break;
-                    }
+                    devId = s_addrIndex[pos];
+                    break;
                 }
             }
+
+            /* unresolved addresses are kept as well, so that an unknown peer does not cost a full search each time */
+            ble_dm_DdsRpaCachePut(p_bdAddr->addr, devId);
+        }
+    }
+    else if (ble_dm_DdsIndexFind(p_bdAddr, &pos))
+    {
+        p_record = ble_dm_DdsGetRecord(s_addrIndex[pos]);
+
+        if (((p_record->flags & BLE_DM_DDS_RECORD_LOCAL_ADDR) == 0U)
+            || (memcmp(&p_record->localAddr, &addr, (uint16_t)sizeof(BLE_GAP_Addr_T)) == 0))
+        {
+            devId = s_addrIndex[pos];
         }
     }
 
@@ -369,6 +813,83 @@ uint8_t BLE_DM_DdsGetDeviceId(BLE_GAP_Addr_T *p_bdAddr)
 }
 
 
+/**
+ * @brief Mark a paired device as the most recently used one.
+ *
+ * The record is only stored when another device was the most recent one, so that a peer
+ * reconnecting again and again does not write the flash each time. The store is committed
+ * with the other pending PDS items, from the idle task.
+ *
+ * @param[in] devId Device ID of the paired device.
+ *
+ * @retval MBA_RES_SUCCESS on success.
+ * @retval MBA_RES_INVALID_PARA if the device ID is invalid.
+ * @retval MBA_RES_FAIL on failure.
+ */
+uint16_t BLE_DM_DdsTouchDevice(uint8_t devId)
+{
+    if (!ble_dm_DdsIsValid(devId))
+    {
+        return MBA_RES_INVALID_PARA;
+    }
+
+    if (devId == s_recentDevId)
+    {
+        return MBA_RES_SUCCESS;
+    }
+
+    ble_dm_DdsGetRecord(devId)->useSeq = s_useSeq++;
+    s_recentDevId = devId;
+
+    return ble_dm_DdsStoreRecord(devId, false);
+}
+
+
+/**
+ * @brief Retrieve the device IDs of the paired devices, most recently used first.
+ *
+ * @param[in] maxCnt Size of the p_devId buffer.
+ * @param[out] p_devId Buffer to store the device IDs.
+ * @param[out] p_devCnt Number of device IDs stored in p_devId.
+ */
+void BLE_DM_DdsGetRecentDevices(uint8_t maxCnt, uint8_t *p_devId, uint8_t *p_devCnt)
+{
+    uint8_t devId;
+    uint8_t cnt = 0;
+    uint8_t pos;
+
+    for (devId = 0; devId < BLE_DM_MAX_PAIRED_DEVICE_NUM; devId++)
+    {
+        if (!ble_dm_DdsIsValid(devId))
+        {
+            continue;
+        }
+
+        /* insertion sort, the list is short and only built when the advertising changes */
+        pos = cnt;
+        while ((pos > 0U) && (ble_dm_DdsGetRecord(p_devId[pos - 1U])->useSeq < ble_dm_DdsGetRecord(devId)->useSeq))
+        {
+            if (pos < maxCnt)
+            {
+                p_devId[pos] = p_devId[pos - 1U];
+            }
+            pos--;
+        }
+
+        if (pos < maxCnt)
+        {
+            p_devId[pos] = devId;
+            if (cnt < maxCnt)
+            {
+                cnt++;
+            }
+        }
+    }
+
+    *p_devCnt = cnt;
+}
+
+
 /**
  * @brief Delete paired device information for a given device ID.
  * 
@@ -385,14 +906,18 @@ uint16_t BLE_DM_DdsDeletePairedDevice(uint8_t devId)
         return MBA_RES_INVALID_PARA;
     }
 
-    if (PDS_Delete((uint16_t)BLE_DM_DDS_FILE_MAIN_ITEM_START + devId) == PDS_SUCCESS)
+    if (ble_dm_DdsIsValid(devId))
     {
-        return MBA_RES_SUCCESS;
+        ble_dm_DdsIndexRemove(devId);
+        (void)memset(ble_dm_DdsGetRecord(devId), 0, sizeof(BLE_DM_DdsRecord_T));
+        s_rpaCacheNum = 0;
+        if (devId == s_recentDevId)
+        {
+            s_recentDevId = BLE_DM_MAX_PAIRED_DEVICE_NUM;
+        }
     }
-    else
-	{
-        return MBA_RES_FAIL;
-	}
+
+    return ble_dm_DdsStoreRecord(devId, false);
 }
 
 
@@ -404,11 +929,19 @@ uint16_t BLE_DM_DdsDeletePairedDevice(uint8_t devId)
  */
 uint16_t BLE_DM_DdsDeleteAllPairedDevice(void)
 {
-    uint8_t devId;
+    uint8_t i;
 
-    for (devId = 0; devId < BLE_DM_MAX_PAIRED_DEVICE_NUM; devId++)
+    (void)memset(s_bondFile, 0, sizeof(s_bondFile));
+    s_addrIndexNum = 0;
+    s_rpaCacheNum = 0;
+    s_recentDevId = BLE_DM_MAX_PAIRED_DEVICE_NUM;
+    s_isLoaded = true;
+
+    ble_dm_DdsDeleteLegacy();
+
+    for (i = 0; i < BLE_DM_DDS_FILE_NUM; i++)
     {
-        if (PDS_Delete((uint16_t)BLE_DM_DDS_FILE_MAIN_ITEM_START + devId) != PDS_SUCCESS)
+        if (PDS_Delete((uint16_t)BLE_DM_DDS_FILE_BOND_START + i) != PDS_SUCCESS)
 		{
             return MBA_RES_FAIL;
 		}
@@ -427,7 +960,7 @@ uint16_t BLE_DM_DdsDeleteAllPairedDevice(void)
  */
 bool BLE_DM_DdsChkDeviceId(uint8_t devId)
 {
-    return PDS_IsAbleToRestore((uint16_t)BLE_DM_DDS_FILE_MAIN_ITEM_START + devId);
+    return ble_dm_DdsIsValid(devId);
 }
 
 
@@ -438,11 +971,22 @@ bool BLE_DM_DdsChkDeviceId(uint8_t devId)
  */
 static void ble_dm_DdsWriteCompleteCallback(PDS_MemId_t memoryId)
 {
-    if ((memoryId >= (uint16_t)PDS_BLE_ITEM_ID_1) && (memoryId <= (uint16_t)PDS_BLE_ITEM_ID_8))
+    uint8_t file;
+    uint8_t pending;
+    uint8_t i;
+
+    if ((memoryId >= (uint16_t)BLE_DM_DDS_FILE_BOND_START) && (memoryId < ((uint16_t)BLE_DM_DDS_FILE_BOND_START + BLE_DM_DDS_FILE_NUM)))
     {
-        if (s_dmDdsCb!=NULL)
+        file = (uint8_t)(memoryId - (uint16_t)BLE_DM_DDS_FILE_BOND_START);
+        pending = s_pendingWrite[file];
+        s_pendingWrite[file] = 0;
+
+        for (i = 0; i < BLE_DM_DDS_RECORD_PER_FILE; i++)
         {
-            s_dmDdsCb(memoryId-(uint16_t)PDS_BLE_ITEM_ID_1);
+            if (((pending & (1U << i)) != 0U) && (s_dmDdsCb!=NULL))
+            {
+                s_dmDdsCb((uint8_t)((file * BLE_DM_DDS_RECORD_PER_FILE) + i));
+            }
         }
     }
 }
@@ -456,5 +1000,6 @@ static void ble_dm_DdsWriteCompleteCallback(PDS_MemId_t memoryId)
 void BLE_DM_DdsInit(BLE_DM_DdsWriteCompleteCb_T cb)
 {
     s_dmDdsCb=cb;
+    s_isLoaded = false;     /* the bond files are loaded on first use */
     PDS_RegisterWriteCompleteCallback(ble_dm_DdsWriteCompleteCallback);
 }
@@ -109,6 +109,14 @@ uint16_t BLE_DM_DdsSetPairedDevice(uint8_t devId, BLE_DM_PairedDevInfo_T *p_pair
 uint8_t BLE_DM_DdsGetFreeDeviceId(void);
 
 
+/**
+ * @brief Delete the least recently used paired device to free its device ID.
+ * 
+ * @retval The freed device ID, or BLE_DM_MAX_PAIRED_DEVICE_NUM on failure.
+ */
+uint8_t BLE_DM_DdsEvictDeviceId(void);
+
+
 /**
  * @brief Retrieve the device ID for a given Bluetooth address.
  * 
@@ -119,6 +127,29 @@ uint8_t BLE_DM_DdsGetFreeDeviceId(void);
 uint8_t BLE_DM_DdsGetDeviceId(BLE_GAP_Addr_T *p_bdAddr);
 
 
+/**
+ * @brief Mark a paired device as the most recently used one.
+ * @note  The record is only stored when another device was the most recent one.
+ * 
+ * @param[in] devId Device ID of the paired device.
+ * 
+ * @retval MBA_RES_SUCCESS on success.
+ * @retval MBA_RES_INVALID_PARA if the device ID is invalid.
+ * @retval MBA_RES_FAIL on failure.
+ */
+uint16_t BLE_DM_DdsTouchDevice(uint8_t devId);
+
+
+/**
+ * @brief Retrieve the device IDs of the paired devices, most recently used first.
+ * 
+ * @param[in] maxCnt Size of the p_devId buffer.
+ * @param[out] p_devId Buffer to store the device IDs.
+ * @param[out] p_devCnt Number of device IDs stored in p_devId.
+ */
+void BLE_DM_DdsGetRecentDevices(uint8_t maxCnt, uint8_t *p_devId, uint8_t *p_devCnt);
+
+
 /**
  * @brief Delete paired device information for a given device ID.
  * 
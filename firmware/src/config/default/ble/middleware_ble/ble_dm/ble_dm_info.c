@@ -50,6 +50,7 @@
 #include "osal/osal_freertos_extend.h"
 #include "mba_error_defs.h"
 #include "ble_gap.h"
+#include "ble_util/mw_conn.h"
 #include "ble_dm_internal.h"
 #include "ble_dm_info.h"
 #include "ble_dm_dds.h"
@@ -82,26 +83,27 @@ static BLE_DM_InfoCtrl_T      *sp_dmInfoCtrl;
 // *****************************************************************************
 
 /**
- * @brief Get a free connection object from the BLE Device Manager.
+ * @brief Get the free connection object assigned to a new connection.
+ * 
+ * @param[in] connHandle    The handle of the new connection.
  * 
  * @retval Pointer to the free connection object, or NULL if none are available.
  */
-static BLE_DM_InfoConn_T *ble_dm_InfoGetFreeConn(void)
+static BLE_DM_InfoConn_T *ble_dm_InfoGetFreeConn(uint16_t connHandle)
 {
-    uint8_t i;
+    uint8_t index;
 
-    for (i = 0; i < BLE_GAP_MAX_LINK_NBR; i++)
+    index = MW_CONN_GetIndex(connHandle);
+
+    if ((index < BLE_GAP_MAX_LINK_NBR) && (sp_dmInfoCtrl->conn[index] == NULL))
     {
-        if (sp_dmInfoCtrl->conn[i] == NULL)
-        {
-            sp_dmInfoCtrl->conn[i] = OSAL_Malloc(sizeof(BLE_DM_InfoConn_T));
+        sp_dmInfoCtrl->conn[index] = OSAL_Malloc(sizeof(BLE_DM_InfoConn_T));
 
-            if (sp_dmInfoCtrl->conn[i] != NULL)
-            {
-                (void)memset((uint8_t *)sp_dmInfoCtrl->conn[i], 0, sizeof(BLE_DM_InfoConn_T));
-            }
-            return sp_dmInfoCtrl->conn[i];
+        if (sp_dmInfoCtrl->conn[index] != NULL)
+        {
+            (void)memset((uint8_t *)sp_dmInfoCtrl->conn[index], 0, sizeof(BLE_DM_InfoConn_T));
         }
+        return sp_dmInfoCtrl->conn[index];
     }
     return NULL;
 }
@@ -116,15 +118,14 @@ static BLE_DM_InfoConn_T *ble_dm_InfoGetFreeConn(void)
  */
 BLE_DM_InfoConn_T *BLE_DM_InfoGetConnByHandle(uint16_t connHandle)
 {
-    uint8_t i;
+    uint8_t index;
 
-    for (i = 0; i < BLE_GAP_MAX_LINK_NBR; i++)
+    index = MW_CONN_GetIndex(connHandle);
+
+    if ((index < BLE_GAP_MAX_LINK_NBR) && (sp_dmInfoCtrl->conn[index] != NULL) 
+        && (sp_dmInfoCtrl->conn[index]->state == BLE_DM_INFO_STATE_CONNECTED) && (sp_dmInfoCtrl->conn[index]->connHandle == connHandle))
     {
-        if ((sp_dmInfoCtrl->conn[i] != NULL) 
-            && (sp_dmInfoCtrl->conn[i]->state == BLE_DM_INFO_STATE_CONNECTED) && (sp_dmInfoCtrl->conn[i]->connHandle == connHandle))
-        {
-            return sp_dmInfoCtrl->conn[i];
-        }
+        return sp_dmInfoCtrl->conn[index];
     }
     return NULL;
 }
@@ -208,7 +209,7 @@ void BLE_DM_Info(STACK_Event_T *p_stackEvent)
                 {
                     BLE_DM_Event_T          dmEvt;
 
-                    p_conn = ble_dm_InfoGetFreeConn();
+                    p_conn = ble_dm_InfoGetFreeConn(p_gapEvt->eventField.evtConnect.connHandle);
                     if (p_conn!= NULL)
                     {
                         p_conn->connHandle = p_gapEvt->eventField.evtConnect.connHandle;
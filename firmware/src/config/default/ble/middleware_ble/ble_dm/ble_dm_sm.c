@@ -291,7 +291,12 @@ static void ble_dm_SecurityManager(BLE_SMP_Event_T *p_event)
 
                     devId = BLE_DM_DdsGetFreeDeviceId();
 
-                    /* appliation does not delete device in callback function */
+                    /* appliation does not delete device in callback function, replace the least recently used one */
+                    if (devId == BLE_DM_MAX_PAIRED_DEVICE_NUM)
+                    {
+                        devId = BLE_DM_DdsEvictDeviceId();
+                    }
+
                     if (devId == BLE_DM_MAX_PAIRED_DEVICE_NUM)
                     {
                         OSAL_Free(p_devInfo);
@@ -410,6 +415,15 @@ void BLE_DM_Sm(STACK_Event_T *p_stackEvent)
         {
             if (p_evt->eventField.evtEncryptStatus.status == GAP_STATUS_SUCCESS)
             {
+                BLE_DM_InfoConn_T *p_conn;
+
+                /* only a peer holding the keys is counted as used, not any device showing a bonded address */
+                p_conn = BLE_DM_InfoGetConnByHandle(p_evt->eventField.evtEncryptStatus.connHandle);
+                if (p_conn != NULL)
+                {
+                    (void)BLE_DM_DdsTouchDevice(p_conn->devId);
+                }
+
                 ble_dm_SmConveySuccessEvt(p_evt->eventField.evtEncryptStatus.connHandle, DM_SECURITY_PROC_ENCRYPTION, false);
             }
             else
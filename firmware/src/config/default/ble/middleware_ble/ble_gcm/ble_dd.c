@@ -51,6 +51,7 @@
 #include "ble_gap.h"
 #include "gatt.h"
 #include "ble_util/byte_stream.h"
+#include "ble_util/mw_conn.h"
 #include "ble_dd.h"
 
 
@@ -131,22 +132,19 @@ static BLE_DD_Ctrl_T *             sp_ddCtrl;                   // Pointer to th
  */
 static void ble_dd_FreeConn(BLE_DD_Conn_T *p_conn)
 {
-    uint8_t i;
+    uint8_t index;
 
     if (p_conn->p_discInstance != NULL)
     {
         OSAL_Free(p_conn->p_discInstance);
     }
 
-    for (i=0; i<BLE_GAP_MAX_LINK_NBR; i++)
+    index = p_conn->connIndex;
+
+    if ((index < BLE_GAP_MAX_LINK_NBR) && (sp_ddCtrl->conn[index] == p_conn))
     {
-        if (sp_ddCtrl->conn[i] == p_conn)
-        {
-            OSAL_Free(sp_ddCtrl->conn[i]);
-            sp_ddCtrl->conn[i] = NULL;
-        
-            break;
-        }
+        OSAL_Free(sp_ddCtrl->conn[index]);
+        sp_ddCtrl->conn[index] = NULL;
     }
 }
 
@@ -154,29 +152,30 @@ static void ble_dd_FreeConn(BLE_DD_Conn_T *p_conn)
 /**
  * @brief Retrieves a free connection object for device discovery.
  *
- * This function searches for an available connection object and initializes it
- * if found. It allocates memory for the connection object and sets the connection
- * index.
+ * This function takes the connection object at the slot assigned to the new
+ * connection handle. It allocates memory for the connection object and sets the
+ * connection index.
+ *
+ * @param[in] connHandle The handle of the new connection.
  *
  * @retval Pointer to the initialized BLE_DD_Conn_T structure, or NULL if no free
  *         connection object is available.
  */
-static BLE_DD_Conn_T *ble_dd_GetFreeConn(void)
+static BLE_DD_Conn_T *ble_dd_GetFreeConn(uint16_t connHandle)
 {
-    uint8_t i;
+    uint8_t index;
+
+    index = MW_CONN_GetIndex(connHandle);
 
-    for (i=0; i<BLE_GAP_MAX_LINK_NBR; i++)
+    if ((index < BLE_GAP_MAX_LINK_NBR) && (sp_ddCtrl->conn[index] == NULL))
     {
-        if (sp_ddCtrl->conn[i] == NULL)
+        sp_ddCtrl->conn[index] = OSAL_Malloc(sizeof(BLE_DD_Conn_T));
+        if (sp_ddCtrl->conn[index] != NULL)
         {
-            sp_ddCtrl->conn[i] = OSAL_Malloc(sizeof(BLE_DD_Conn_T));
-            if (sp_ddCtrl->conn[i] != NULL)
-            {
-                (void)memset((uint8_t *)sp_ddCtrl->conn[i], 0, sizeof(BLE_DD_Conn_T));
-                sp_ddCtrl->conn[i]->connIndex = i;
-            }
-            return sp_ddCtrl->conn[i];
+            (void)memset((uint8_t *)sp_ddCtrl->conn[index], 0, sizeof(BLE_DD_Conn_T));
+            sp_ddCtrl->conn[index]->connIndex = index;
         }
+        return sp_ddCtrl->conn[index];
     }
     return NULL;
 }
@@ -185,8 +184,8 @@ static BLE_DD_Conn_T *ble_dd_GetFreeConn(void)
 /**
  * @brief Finds a connection object by its handle.
  *
- * This function searches for a connection object that matches the given connection
- * handle.
+ * This function looks up the slot assigned to the connection handle and returns
+ * the connection object stored there.
  *
  * @param[in] connHandle The handle of the connection to find.
  * 
@@ -194,15 +193,13 @@ static BLE_DD_Conn_T *ble_dd_GetFreeConn(void)
  */
 static BLE_DD_Conn_T *ble_dd_FindConnByHandle(uint16_t connHandle)
 {
-    uint8_t i;
+    uint8_t index;
 
-    for (i=0; i<BLE_GAP_MAX_LINK_NBR; i++)
+    index = MW_CONN_GetIndex(connHandle);
+
+    if ((index < BLE_GAP_MAX_LINK_NBR) && (sp_ddCtrl->conn[index]!= NULL) && (sp_ddCtrl->conn[index]->connHandle == connHandle))
     {
-        if ((sp_ddCtrl->conn[i]!= NULL) && (sp_ddCtrl->conn[i]->connHandle == connHandle))
-        {
-            sp_ddCtrl->conn[i]->connIndex = i;
-            return sp_ddCtrl->conn[i];
-        }
+        return sp_ddCtrl->conn[index];
     }
     return NULL;
 }
@@ -429,7 +426,7 @@ static void ble_dd_StackEvtBleGapHandler(BLE_DD_Config_T *p_config, BLE_GAP_Even
                 uint8_t         i;
 
                 /* Find free connection instance */
-                p_conn = ble_dd_GetFreeConn();
+                p_conn = ble_dd_GetFreeConn(p_event->eventField.evtConnect.connHandle);
 
                 if (p_conn != NULL)
                 {
@@ -49,6 +49,7 @@
 // *****************************************************************************
 
 #include "device.h"
+#include "osal/osal_freertos.h"
 #include "driver/security/cryptosym/keyref_api.h"
 #include "driver/security/cryptopk/statuscodes_api.h"
 #include "driver/security/cryptosym/aead_api.h"
@@ -56,11 +57,77 @@
 #include "mba_error_defs.h"
 #include "mw_aes.h"
 
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Variables
+// *****************************************************************************
+// *****************************************************************************
+static uint8_t s_clkHoldCnt;                // Number of holders keeping the crypto clock on between calls.
+static MW_AES_AcquireCb_T s_acquireCb;      // Called before the engine is used, see MW_AES_RegisterAcquireCb.
+
 // *****************************************************************************
 // *****************************************************************************
 // Section: Functions
 // *****************************************************************************
 // *****************************************************************************
+static void mw_aes_ClkEnable(void)
+{
+    // The owner of queued engine work hands the engine over first
+    if (s_acquireCb != NULL)
+    {
+        s_acquireCb();
+    }
+
+    CRYPTO_CLK_ENABLE();
+}
+
+static void mw_aes_ClkDisable(void)
+{
+    if (s_clkHoldCnt == 0U)
+    {
+        CRYPTO_CLK_DISABLE();
+    }
+}
+
+/**
+ * @brief Keeps the crypto clock on between AES calls, for a burst of operations.
+ *
+ * @param[in] hold                 True to take a hold, false to release one. The clock is
+ *                                 turned off when the last hold is released.
+ */
+void MW_AES_HoldClock(bool hold)
+{
+    OSAL_CRITSECT_DATA_TYPE critState;
+
+    // Holders may run in different tasks
+    critState = OSAL_CRIT_Enter(OSAL_CRIT_TYPE_LOW);
+    if (hold)
+    {
+        if (s_clkHoldCnt == 0U)
+        {
+            CRYPTO_CLK_ENABLE();
+        }
+        s_clkHoldCnt++;
+    }
+    else if (s_clkHoldCnt > 0U)
+    {
+        s_clkHoldCnt--;
+        mw_aes_ClkDisable();
+    }
+    OSAL_CRIT_Leave(OSAL_CRIT_TYPE_LOW, critState);
+}
+
+/**
+ * @brief Registers the function called before each AES call uses the engine.
+ *
+ * @param[in] cb                   Function completing the engine work started outside of the
+ *                                 MW_AES functions, or NULL. It is called in the task of the caller.
+ */
+void MW_AES_RegisterAcquireCb(MW_AES_AcquireCb_T cb)
+{
+    s_acquireCb = cb;
+}
+
 /** 
  * @brief Initializes AES CBC block cipher decryption.
  *
@@ -75,7 +142,7 @@ uint16_t MW_AES_CbcDecryptInit(MW_AES_Ctx_T * p_ctx, uint8_t *p_aesKey, uint8_t
 {
     uint16_t result;
 
-    CRYPTO_CLK_ENABLE();
+    mw_aes_ClkEnable();
     
     p_ctx->aesKeyRef=CRM_KEYREF_LOAD_MATERIAL(16, (char *)p_aesKey);
     if (CRM_OK!=CRM_BLKCIPHER_CREATE_AESCBC_DEC(&p_ctx->aesBlkCipher, &p_ctx->aesKeyRef, (char *)p_iv))
@@ -87,7 +154,7 @@ uint16_t MW_AES_CbcDecryptInit(MW_AES_Ctx_T * p_ctx, uint8_t *p_aesKey, uint8_t
         result = MBA_RES_SUCCESS;
     }
     
-    CRYPTO_CLK_DISABLE();
+    mw_aes_ClkDisable();
 
     return result;
 
@@ -109,7 +176,7 @@ uint16_t MW_AES_AesCbcDecrypt(MW_AES_Ctx_T * p_ctx, uint16_t length, uint8_t *p_
 {
     int32_t s;
 
-    CRYPTO_CLK_ENABLE();
+    mw_aes_ClkEnable();
 
     s = CRM_BLKCIPHER_CRYPT(&p_ctx->aesBlkCipher, (char *)p_cipherText, length, (char *)p_plainText);
     if (s == CRM_OK)
@@ -125,7 +192,7 @@ uint16_t MW_AES_AesCbcDecrypt(MW_AES_Ctx_T * p_ctx, uint16_t length, uint8_t *p_
     s = CRM_BLKCIPHER_RESUME_STATE(&p_ctx->aesBlkCipher);
     }
 
-    CRYPTO_CLK_DISABLE();
+    mw_aes_ClkDisable();
 
 
     if (s != CRM_OK)
@@ -150,7 +217,7 @@ uint16_t MW_AES_EcbEncryptInit(MW_AES_Ctx_T * p_ctx, uint8_t *p_aesKey)
 {
     uint16_t result;
 
-    CRYPTO_CLK_ENABLE();
+    mw_aes_ClkEnable();
     
     p_ctx->aesKeyRef=CRM_KEYREF_LOAD_MATERIAL(16, (char *)p_aesKey);
     if (CRM_OK!=CRM_BLKCIPHER_CREATE_AESECB_ENC(&p_ctx->aesBlkCipher, &p_ctx->aesKeyRef))
@@ -162,7 +229,7 @@ uint16_t MW_AES_EcbEncryptInit(MW_AES_Ctx_T * p_ctx, uint8_t *p_aesKey)
         result = MBA_RES_SUCCESS;
     }
     
-    CRYPTO_CLK_DISABLE();
+    mw_aes_ClkDisable();
 
     return result;
 
@@ -184,7 +251,7 @@ uint16_t MW_AES_AesEcbEncrypt(MW_AES_Ctx_T * p_ctx, uint16_t length, uint8_t *p_
 {
     int32_t s;
 
-    CRYPTO_CLK_ENABLE();
+    mw_aes_ClkEnable();
 
     s = CRM_BLKCIPHER_CRYPT(&p_ctx->aesBlkCipher, (char *)p_plainText, length, (char *)p_cipherText);
     if (s == CRM_OK)
@@ -196,7 +263,7 @@ uint16_t MW_AES_AesEcbEncrypt(MW_AES_Ctx_T * p_ctx, uint16_t length, uint8_t *p_
         s = CRM_BLKCIPHER_WAIT(&p_ctx->aesBlkCipher);
     }
 
-    CRYPTO_CLK_DISABLE();
+    mw_aes_ClkDisable();
 
 
     if (s != CRM_OK)
@@ -211,7 +278,8 @@ uint16_t MW_AES_AesEcbEncrypt(MW_AES_Ctx_T * p_ctx, uint16_t length, uint8_t *p_
  * @brief Initializes AES CCM encryption.
  *
  * @param[out] p_ctx               Pointer to the AES context structure.
- * @param[in] p_aesKey             Pointer to the 16-byte encryption key.
+ * @param[in] p_aesKey             Pointer to the 16-byte encryption key, or NULL to keep the key of the
+ *                                 previous initialization of p_ctx. The key must stay valid while p_ctx is used.
  * @param[in] p_nonce              Pointer to the nonce used for encryption.
  * @param[in] nonceSz              The size of p_nonce, between 7 and 13 bytes.
  * @param[in] tagSz                The tag size used for encryption, must be a value in {4, 6, 8, 10, 12, 14, 16}.
@@ -226,9 +294,12 @@ uint16_t MW_AES_CcmEncryptInit(MW_AES_Ctx_T * p_ctx, uint8_t *p_aesKey, uint8_t
 {
     int32_t s;
 
-    CRYPTO_CLK_ENABLE();
+    mw_aes_ClkEnable();
     
-    p_ctx->aesKeyRef=CRM_KEYREF_LOAD_MATERIAL(16, (char *)p_aesKey);
+    if (p_aesKey != NULL)
+    {
+        p_ctx->aesKeyRef=CRM_KEYREF_LOAD_MATERIAL(16, (char *)p_aesKey);
+    }
     s = CRM_AEAD_CREATE_AESCCM_ENC(&p_ctx->aeadCtx, &p_ctx->aesKeyRef, (char *)p_nonce, nonceSz, tagSz, aadSz, dataSz);
 
     if (s == CRM_OK)
@@ -237,7 +308,7 @@ uint16_t MW_AES_CcmEncryptInit(MW_AES_Ctx_T * p_ctx, uint8_t *p_aesKey, uint8_t
     }
     
     
-    CRYPTO_CLK_DISABLE();
+    mw_aes_ClkDisable();
 
     if (s != CRM_OK)
     {
@@ -268,7 +339,7 @@ uint16_t MW_AES_AesCcmEncrypt(MW_AES_Ctx_T * p_ctx, uint16_t length, uint8_t *p_
 {
     int32_t s;
 
-    CRYPTO_CLK_ENABLE();
+    mw_aes_ClkEnable();
 
 
     
@@ -303,7 +374,7 @@ uint16_t MW_AES_AesCcmEncrypt(MW_AES_Ctx_T * p_ctx, uint16_t length, uint8_t *p_
     }
 
 
-    CRYPTO_CLK_DISABLE();
+    mw_aes_ClkDisable();
 
 
     if (s != CRM_OK)
@@ -318,7 +389,8 @@ uint16_t MW_AES_AesCcmEncrypt(MW_AES_Ctx_T * p_ctx, uint16_t length, uint8_t *p_
  * @brief Initializes AES CCM decryption.
  *
  * @param[out] p_ctx               Pointer to the AES context structure.
- * @param[in] p_aesKey             Pointer to the 16-byte encryption key.
+ * @param[in] p_aesKey             Pointer to the 16-byte encryption key, or NULL to keep the key of the
+ *                                 previous initialization of p_ctx. The key must stay valid while p_ctx is used.
  * @param[in] p_nonce              Pointer to the nonce used for encryption.
  * @param[in] nonceSz              The size of p_nonce, between 7 and 13 bytes.
  * @param[in] tagSz                The tag size used for encryption, must be a value in {4, 6, 8, 10, 12, 14, 16}.
@@ -333,9 +405,12 @@ uint16_t MW_AES_CcmDecryptInit(MW_AES_Ctx_T * p_ctx, uint8_t *p_aesKey, uint8_t
 {
     int32_t s;
 
-    CRYPTO_CLK_ENABLE();
+    mw_aes_ClkEnable();
     
-    p_ctx->aesKeyRef=CRM_KEYREF_LOAD_MATERIAL(16, (char *)p_aesKey);
+    if (p_aesKey != NULL)
+    {
+        p_ctx->aesKeyRef=CRM_KEYREF_LOAD_MATERIAL(16, (char *)p_aesKey);
+    }
     s = CRM_AEAD_CREATE_AESCCM_DEC(&p_ctx->aeadCtx, &p_ctx->aesKeyRef, (char *)p_nonce, nonceSz, tagSz, aadSz, dataSz);
 
     if (s == CRM_OK)
@@ -344,7 +419,7 @@ uint16_t MW_AES_CcmDecryptInit(MW_AES_Ctx_T * p_ctx, uint8_t *p_aesKey, uint8_t
     }
     
     
-    CRYPTO_CLK_DISABLE();
+    mw_aes_ClkDisable();
 
     if (s != CRM_OK)
     {
@@ -366,6 +441,7 @@ uint16_t MW_AES_CcmDecryptInit(MW_AES_Ctx_T * p_ctx, uint8_t *p_aesKey, uint8_t
  * @param[in] p_tag                Pointer to the buffer containing the authentication tag.
  *                                 Only be used if p_chiperText is the last data fragment.
  * @param[out] p_plainText         Pointer to the buffer where the decrypted data will be stored.
+ *                                 May be p_cipherText to decrypt in place.
  *
  * @retval MBA_RES_SUCCESS         Encryption successful.
  * @retval MBA_RES_FAIL            Encryption failed.
@@ -374,7 +450,7 @@ uint16_t MW_AES_AesCcmDecrypt(MW_AES_Ctx_T * p_ctx, uint16_t length, uint8_t *p_
 {
     int32_t s;
 
-    CRYPTO_CLK_ENABLE();
+    mw_aes_ClkEnable();
 
     s = CRM_AEAD_CRYPT(&p_ctx->aeadCtx, (char *)p_cipherText, length, (char *)p_plainText);
 
@@ -407,7 +483,7 @@ uint16_t MW_AES_AesCcmDecrypt(MW_AES_Ctx_T * p_ctx, uint16_t length, uint8_t *p_
     }
 
 
-    CRYPTO_CLK_DISABLE();
+    mw_aes_ClkDisable();
 
 
     if (s != CRM_OK)
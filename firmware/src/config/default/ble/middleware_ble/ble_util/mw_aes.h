@@ -48,6 +48,7 @@
 // *****************************************************************************
 // *****************************************************************************
 
+#include <stdbool.h>
 #include "driver/security/cryptosym/blkcipher_api.h"
 
 // DOM-IGNORE-BEGIN
@@ -88,6 +89,9 @@ typedef struct MW_AES_Ctx_T
     uint16_t            aeadSize;                                    /**< Data size for AEAD operations. */
 } MW_AES_Ctx_T;
 
+/** @brief Function called before an AES call uses the engine, see @ref MW_AES_RegisterAcquireCb. */
+typedef void (*MW_AES_AcquireCb_T)(void);
+
 
 /** @} */ //MW_AES_STRUCTS
 
@@ -156,7 +160,8 @@ uint16_t MW_AES_AesEcbEncrypt(MW_AES_Ctx_T * p_ctx, uint16_t length, uint8_t *p_
  * @brief Initializes AES CCM encryption.
  *
  * @param[out] p_ctx               Pointer to the AES context structure.
- * @param[in] p_aesKey             Pointer to the 16-byte encryption key.
+ * @param[in] p_aesKey             Pointer to the 16-byte encryption key, or NULL to keep the key of the
+ *                                 previous initialization of p_ctx. The key must stay valid while p_ctx is used.
  * @param[in] p_nonce              Pointer to the nonce used for encryption.
  * @param[in] nonceSz              The size of p_nonce, between 7 and 13 bytes.
  * @param[in] tagSz                The tag size used for encryption, must be a value in {4, 6, 8, 10, 12, 14, 16}.
@@ -189,7 +194,8 @@ uint16_t MW_AES_AesCcmEncrypt(MW_AES_Ctx_T * p_ctx, uint16_t length, uint8_t *p_
  * @brief Initializes AES CCM decryption.
  *
  * @param[out] p_ctx               Pointer to the AES context structure.
- * @param[in] p_aesKey             Pointer to the 16-byte encryption key.
+ * @param[in] p_aesKey             Pointer to the 16-byte encryption key, or NULL to keep the key of the
+ *                                 previous initialization of p_ctx. The key must stay valid while p_ctx is used.
  * @param[in] p_nonce              Pointer to the nonce used for encryption.
  * @param[in] nonceSz              The size of p_nonce, between 7 and 13 bytes.
  * @param[in] tagSz                The tag size used for encryption, must be a value in {4, 6, 8, 10, 12, 14, 16}.
@@ -213,12 +219,29 @@ uint16_t MW_AES_CcmDecryptInit(MW_AES_Ctx_T * p_ctx, uint8_t *p_aesKey, uint8_t
  * @param[in] p_tag                Pointer to the buffer containing the authentication tag.
  *                                 Only be used if p_chiperText is the last data fragment.
  * @param[out] p_plainText         Pointer to the buffer where the decrypted data will be stored.
+ *                                 May be p_cipherText to decrypt in place.
  *
  * @retval MBA_RES_SUCCESS         Encryption successful.
  * @retval MBA_RES_FAIL            Encryption failed.
  */
 uint16_t MW_AES_AesCcmDecrypt(MW_AES_Ctx_T * p_ctx, uint16_t length, uint8_t *p_cipherText, uint8_t *p_tag, uint8_t *p_plainText);
 
+/**
+ * @brief Keeps the crypto clock on between AES calls, for a burst of operations.
+ *
+ * @param[in] hold                 True to take a hold, false to release one. The clock is
+ *                                 turned off when the last hold is released.
+ */
+void MW_AES_HoldClock(bool hold);
+
+/**
+ * @brief Registers the function called before each AES call uses the engine.
+ *
+ * @param[in] cb                   Function completing the engine work started outside of the
+ *                                 MW_AES functions, or NULL. It is called in the task of the caller.
+ */
+void MW_AES_RegisterAcquireCb(MW_AES_AcquireCb_T cb);
+
 
 /** @} */ //MW_AES_FUNS
 
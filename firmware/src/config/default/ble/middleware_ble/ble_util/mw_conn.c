@@ -0,0 +1,260 @@
+/*******************************************************************************
+* Copyright (C) 2025 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+/*******************************************************************************
+  Middleware Connection Index Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    mw_conn.c
+
+  Summary:
+    Implements the connection index shared by the BLE middleware.
+
+  Description:
+    This source file maps connection handles to connection slot indexes. A slot
+    is taken from a free list when a connection is established, and the handle
+    is hashed into a small bucket table so that lookups on every event and on
+    every send take constant time.
+ *******************************************************************************/
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "mw_assert.h"
+#include "mw_conn.h"
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Macros
+// *****************************************************************************
+// *****************************************************************************
+#define MW_CONN_HASH_SIZE             (16U)                       // Number of hash buckets, must be a power of two.
+#define MW_CONN_HASH_MASK             (MW_CONN_HASH_SIZE - 1U)
+
+MW_ASSERT((MW_CONN_HASH_SIZE & MW_CONN_HASH_MASK) == 0U);
+MW_ASSERT(MW_CONN_HASH_SIZE >= MW_CONN_MAX_NBR);
+MW_ASSERT(MW_CONN_MAX_NBR < MW_CONN_INDEX_INVALID);
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+/* Structure for a connection slot. */
+typedef struct MW_CONN_Slot_T
+{
+    uint16_t                connHandle;                         // Connection handle mapped to this slot.
+    uint8_t                 next;                               // Next slot in the same bucket, or in the free list.
+} MW_CONN_Slot_T;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Variables
+// *****************************************************************************
+// *****************************************************************************
+static MW_CONN_Slot_T         s_connSlot[MW_CONN_MAX_NBR];        // Connection slots.
+static uint8_t                s_connBucket[MW_CONN_HASH_SIZE];    // First slot of each hash bucket.
+static uint8_t                s_connFreeHead;                     // First slot of the free list.
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Functions
+// *****************************************************************************
+// *****************************************************************************
+/**
+ * @brief Get the hash bucket of a connection handle.
+ *
+ * @param[in] connHandle            Connection handle.
+ *
+ * @retval Hash bucket index.
+ */
+static uint8_t mw_conn_Hash(uint16_t connHandle)
+{
+    return (uint8_t)((connHandle ^ (connHandle >> 4U)) & MW_CONN_HASH_MASK);
+}
+
+
+/**
+ * @brief Assign a slot to a connection handle.
+ *
+ * @param[in] connHandle            Connection handle.
+ *
+ * @retval Slot index, or MW_CONN_INDEX_INVALID if all slots are in use.
+ */
+static uint8_t mw_conn_Add(uint16_t connHandle)
+{
+    uint8_t index;
+    uint8_t bucket;
+
+    index = MW_CONN_GetIndex(connHandle);
+    if (index != MW_CONN_INDEX_INVALID)
+    {
+        return index;
+    }
+
+    index = s_connFreeHead;
+    if (index == MW_CONN_INDEX_INVALID)
+    {
+        return MW_CONN_INDEX_INVALID;
+    }
+
+    s_connFreeHead = s_connSlot[index].next;
+
+    bucket = mw_conn_Hash(connHandle);
+    s_connSlot[index].connHandle = connHandle;
+    s_connSlot[index].next = s_connBucket[bucket];
+    s_connBucket[bucket] = index;
+
+    return index;
+}
+
+
+/**
+ * @brief Release the slot assigned to a connection handle.
+ *
+ * @param[in] connHandle            Connection handle.
+ */
+static void mw_conn_Remove(uint16_t connHandle)
+{
+    uint8_t *p_link;
+    uint8_t index;
+
+    p_link = &s_connBucket[mw_conn_Hash(connHandle)];
+
+    while (*p_link != MW_CONN_INDEX_INVALID)
+    {
+        index = *p_link;
+
+        if (s_connSlot[index].connHandle == connHandle)
+        {
+            *p_link = s_connSlot[index].next;
+            s_connSlot[index].next = s_connFreeHead;
+            s_connFreeHead = index;
+            return;
+        }
+
+        p_link = &s_connSlot[index].next;
+    }
+}
+
+
+/**
+ * @brief Initialize the connection index.
+ */
+void MW_CONN_Init(void)
+{
+    uint8_t i;
+
+    (void)memset(s_connBucket, MW_CONN_INDEX_INVALID, sizeof(s_connBucket));
+
+    for (i = 0; i < MW_CONN_MAX_NBR; i++)
+    {
+        s_connSlot[i].connHandle = 0;
+        s_connSlot[i].next = ((i + 1U) < MW_CONN_MAX_NBR) ? (i + 1U) : MW_CONN_INDEX_INVALID;
+    }
+
+    s_connFreeHead = 0;
+}
+
+
+/**
+ * @brief Get the slot index of a connection.
+ *
+ * @param[in] connHandle            Connection handle associated with the connection.
+ *
+ * @retval Slot index, or MW_CONN_INDEX_INVALID if the connection handle is not registered.
+ */
+uint8_t MW_CONN_GetIndex(uint16_t connHandle)
+{
+    uint8_t index;
+
+    index = s_connBucket[mw_conn_Hash(connHandle)];
+
+    while (index != MW_CONN_INDEX_INVALID)
+    {
+        if (s_connSlot[index].connHandle == connHandle)
+        {
+            return index;
+        }
+
+        index = s_connSlot[index].next;
+    }
+
+    return MW_CONN_INDEX_INVALID;
+}
+
+
+/**
+ * @brief Assign slot indexes when connections are established.
+ *
+ * @param[in] p_stackEvent          Pointer to the BLE stack event data.
+ */
+void MW_CONN_BleEventHandler(STACK_Event_T *p_stackEvent)
+{
+    BLE_GAP_Event_T *p_gapEvt;
+
+    if (p_stackEvent->groupId != STACK_GRP_BLE_GAP)
+    {
+        return;
+    }
+
+    p_gapEvt = (BLE_GAP_Event_T *)p_stackEvent->p_event;
+
+    if ((p_gapEvt->eventId == BLE_GAP_EVT_CONNECTED) && (p_gapEvt->eventField.evtConnect.status == GAP_STATUS_SUCCESS))
+    {
+        (void)mw_conn_Add(p_gapEvt->eventField.evtConnect.connHandle);
+    }
+}
+
+
+/**
+ * @brief Release slot indexes when connections are terminated.
+ *
+ * @param[in] p_stackEvent          Pointer to the BLE stack event data.
+ */
+void MW_CONN_BleEventPostHandler(STACK_Event_T *p_stackEvent)
+{
+    BLE_GAP_Event_T *p_gapEvt;
+
+    if (p_stackEvent->groupId != STACK_GRP_BLE_GAP)
+    {
+        return;
+    }
+
+    p_gapEvt = (BLE_GAP_Event_T *)p_stackEvent->p_event;
+
+    if (p_gapEvt->eventId == BLE_GAP_EVT_DISCONNECTED)
+    {
+        mw_conn_Remove(p_gapEvt->eventField.evtDisconnect.connHandle);
+    }
+}
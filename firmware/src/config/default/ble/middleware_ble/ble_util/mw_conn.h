@@ -0,0 +1,136 @@
+/*******************************************************************************
+* Copyright (C) 2025 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+/*******************************************************************************
+  Middleware Connection Index Header File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    mw_conn.h
+
+  Summary:
+    Interface for the connection index shared by the BLE middleware.
+
+  Description:
+    This header file declares the functions used to map a connection handle
+    to a connection slot index. The slot index is assigned once when the
+    connection is established and is shared by the BLE middleware and
+    profiles to index their per-connection state in constant time.
+ *******************************************************************************/
+
+#ifndef MW_CONN_H
+#define MW_CONN_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdint.h>
+#include "stack_mgr.h"
+#include "ble_gap.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+extern "C" {
+#endif
+// DOM-IGNORE-END
+
+/**
+ * @addtogroup MW_CONN
+ * @{
+ * @brief Provides the connection index shared by the BLE middleware.
+ * @note  This section declares the API for the connection index component of the BLE middleware.
+ */
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Macros
+// *****************************************************************************
+// *****************************************************************************
+/**
+ * @addtogroup MW_CONN_DEFINES Defines
+ * @{
+ */
+#define MW_CONN_MAX_NBR                 BLE_GAP_MAX_LINK_NBR    /**< Maximum number of connection slots. */
+#define MW_CONN_INDEX_INVALID           (0xFFU)                 /**< Value representing an invalid connection slot index. */
+/** @} */ //MW_CONN_DEFINES
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Function Prototypes
+// *****************************************************************************
+// *****************************************************************************
+/**
+ * @addtogroup MW_CONN_FUNS Functions
+ * @{ */
+
+/**
+ * @brief Initialize the connection index.
+ */
+void MW_CONN_Init(void);
+
+
+/**
+ * @brief Get the slot index of a connection.
+ * @note The lookup takes constant time regardless of @ref MW_CONN_MAX_NBR.
+ *
+ * @param[in] connHandle            Connection handle associated with the connection.
+ *
+ * @retval Slot index in the range of 0 to (@ref MW_CONN_MAX_NBR - 1), or @ref MW_CONN_INDEX_INVALID if the
+ *         connection handle is not registered.
+ */
+uint8_t MW_CONN_GetIndex(uint16_t connHandle);
+
+
+/**
+ * @brief Assign slot indexes when connections are established.
+ * @note This function shall be called before the BLE stack event is passed to the BLE middleware and profiles.
+ *
+ * @param[in] p_stackEvent          Pointer to the BLE stack event data.
+ */
+void MW_CONN_BleEventHandler(STACK_Event_T *p_stackEvent);
+
+
+/**
+ * @brief Release slot indexes when connections are terminated.
+ * @note This function shall be called after the BLE stack event has been passed to the BLE middleware and profiles.
+ *
+ * @param[in] p_stackEvent          Pointer to the BLE stack event data.
+ */
+void MW_CONN_BleEventPostHandler(STACK_Event_T *p_stackEvent);
+
+/** @} */ //MW_CONN_FUNS
+
+/** @} */
+
+//DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+//DOM-IGNORE-END
+
+#endif //MW_CONN_H
@@ -0,0 +1,310 @@
+/*******************************************************************************
+* Copyright (C) 2025 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  Middleware Entropy Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    mw_entropy.c
+
+  Summary:
+    Implements a pool of random bytes refilled from the hardware TRNG.
+
+  Description:
+    This source file keeps a ring of random bytes read from the hardware True
+    Random Number Generator (TRNG). The ring is refilled in idle time, a chunk
+    at a time and without waiting for the TRNG to gather entropy. Draws take
+    bytes from the ring, and read straight from the TRNG only when the ring
+    runs short.
+ *******************************************************************************/
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include <string.h>
+#include <stdint.h>
+#include "osal/osal_freertos.h"
+#include "driver/security/cryptosym/statuscodes.h"
+#include "driver/security/cryptosym/trng_api.h"
+#include "mba_error_defs.h"
+#include "mw_aes.h"
+#include "mw_entropy.h"
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Macros
+// *****************************************************************************
+// *****************************************************************************
+#define MW_ENTROPY_TRNG_RETRY           (32U)       // Attempts to read the TRNG when the pool is short.
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Variables
+// *****************************************************************************
+// *****************************************************************************
+static struct crm_trng s_trng;
+static bool s_isReady;
+static bool s_isTrngBusy;                   // A task is reading the TRNG.
+static uint8_t s_pool[MW_ENTROPY_POOL_SIZE];
+static uint16_t s_head;                     // Index of the next byte to draw.
+static MW_ENTROPY_Stats_T s_stats;          // The level field is the pool level.
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Functions
+// *****************************************************************************
+// *****************************************************************************
+static void mw_entropy_Wipe(uint8_t *p_buf, uint16_t length)
+{
+    volatile uint8_t *p_byte = p_buf;
+
+    while (length > 0U)
+    {
+        *p_byte++ = 0U;
+        length--;
+    }
+}
+
+/* Must be called in a critical section, with length not above the pool level. */
+static void mw_entropy_Take(uint8_t *p_buf, uint16_t length)
+{
+    uint16_t i;
+
+    for (i = 0; i < length; i++)
+    {
+        p_buf[i] = s_pool[s_head];
+        s_pool[s_head] = 0U;
+        s_head = (uint16_t)((s_head + 1U) % MW_ENTROPY_POOL_SIZE);
+    }
+
+    s_stats.level -= length;
+    s_stats.drawByteCnt += length;
+    if (s_stats.level < s_stats.lowLevel)
+    {
+        s_stats.lowLevel = s_stats.level;
+    }
+}
+
+/* Reserves the TRNG for the calling task, it must not be read from two tasks at once. */
+static bool mw_entropy_AcquireTrng(void)
+{
+    OSAL_CRITSECT_DATA_TYPE critState;
+    bool isAcquired = false;
+
+    critState = OSAL_CRIT_Enter(OSAL_CRIT_TYPE_LOW);
+    if (s_isReady && !s_isTrngBusy)
+    {
+        s_isTrngBusy = true;
+        isAcquired = true;
+    }
+    OSAL_CRIT_Leave(OSAL_CRIT_TYPE_LOW, critState);
+
+    return isAcquired;
+}
+
+/**
+ * @brief Initializes the TRNG and the entropy pool. The pool starts empty.
+ *
+ * @retval MBA_RES_SUCCESS         Initialization successful.
+ * @retval MBA_RES_FAIL            The TRNG could not be initialized.
+ */
+uint16_t MW_ENTROPY_Init(void)
+{
+    int32_t s;
+
+    memset(s_pool, 0, sizeof(s_pool));
+    memset(&s_stats, 0, sizeof(s_stats));
+    s_stats.lowLevel = MW_ENTROPY_POOL_SIZE;
+    s_head = 0;
+    s_isTrngBusy = false;
+
+    MW_AES_HoldClock(true);
+    s = CRM_TRNG_INIT(&s_trng, NULL);
+    MW_AES_HoldClock(false);
+
+    s_isReady = (s == CRM_OK);
+
+    return s_isReady ? MBA_RES_SUCCESS : MBA_RES_FAIL;
+}
+
+/**
+ * @brief Refills the pool from the TRNG. To be called in idle time.
+ * @note  The function does not wait for the TRNG. It adds at most
+ *        @ref MW_ENTROPY_REFILL_SIZE bytes at a time.
+ *
+ * @retval true                    Bytes were added and the pool is not full yet.
+ * @retval false                   The pool is full, or the TRNG is not ready.
+ */
+bool MW_ENTROPY_Refill(void)
+{
+    OSAL_CRITSECT_DATA_TYPE critState;
+    uint8_t chunk[MW_ENTROPY_REFILL_SIZE];
+    uint16_t tail;
+    uint16_t i;
+    int32_t s;
+    bool isMore = false;
+
+    if ((s_stats.level > (MW_ENTROPY_POOL_SIZE - MW_ENTROPY_REFILL_SIZE)) || !mw_entropy_AcquireTrng())
+    {
+        return false;
+    }
+
+    // The TRNG answers at once, with an error if it has not gathered enough entropy yet
+    MW_AES_HoldClock(true);
+    s = CRM_TRNG_GET(&s_trng, (char *)chunk, sizeof(chunk));
+    MW_AES_HoldClock(false);
+
+    critState = OSAL_CRIT_Enter(OSAL_CRIT_TYPE_LOW);
+    if (s == CRM_OK)
+    {
+        // Draws only lower the level meanwhile, the chunk still fits
+        tail = (uint16_t)((s_head + s_stats.level) % MW_ENTROPY_POOL_SIZE);
+        for (i = 0; i < sizeof(chunk); i++)
+        {
+            s_pool[tail] = chunk[i];
+            tail = (uint16_t)((tail + 1U) % MW_ENTROPY_POOL_SIZE);
+        }
+        s_stats.level += sizeof(chunk);
+        s_stats.refillCnt++;
+        isMore = (s_stats.level <= (MW_ENTROPY_POOL_SIZE - MW_ENTROPY_REFILL_SIZE));
+    }
+    else
+    {
+        s_stats.refillWaitCnt++;
+    }
+    s_isTrngBusy = false;
+    OSAL_CRIT_Leave(OSAL_CRIT_TYPE_LOW, critState);
+
+    mw_entropy_Wipe(chunk, sizeof(chunk));
+
+    return isMore;
+}
+
+/**
+ * @brief Draws random bytes from the pool, without waiting.
+ *
+ * @param[out] p_buf               Pointer to where the random bytes are stored.
+ * @param[in] length               Number of random bytes.
+ *
+ * @retval MBA_RES_SUCCESS         The random bytes are drawn.
+ * @retval MBA_RES_NO_RESOURCE     The pool has less than length bytes, nothing is drawn.
+ */
+uint16_t MW_ENTROPY_TryGet(uint8_t *p_buf, uint16_t length)
+{
+    OSAL_CRITSECT_DATA_TYPE critState;
+    uint16_t result = MBA_RES_SUCCESS;
+
+    critState = OSAL_CRIT_Enter(OSAL_CRIT_TYPE_LOW);
+    if (s_stats.level >= length)
+    {
+        mw_entropy_Take(p_buf, length);
+    }
+    else
+    {
+        s_stats.failCnt++;
+        result = MBA_RES_NO_RESOURCE;
+    }
+    OSAL_CRIT_Leave(OSAL_CRIT_TYPE_LOW, critState);
+
+    return result;
+}
+
+/**
+ * @brief Draws random bytes from the pool, and reads the missing bytes from the TRNG
+ *        if the pool is short.
+ *
+ * @param[out] p_buf               Pointer to where the random bytes are stored.
+ * @param[in] length               Number of random bytes.
+ *
+ * @retval MBA_RES_SUCCESS         The random bytes are drawn.
+ * @retval MBA_RES_FAIL            The TRNG could not provide the missing bytes.
+ */
+uint16_t MW_ENTROPY_Get(uint8_t *p_buf, uint16_t length)
+{
+    OSAL_CRITSECT_DATA_TYPE critState;
+    uint16_t drawn;
+    uint8_t retry;
+    int32_t s = CRM_ERR_HW_PROCESSING;
+
+    critState = OSAL_CRIT_Enter(OSAL_CRIT_TYPE_LOW);
+    drawn = (s_stats.level < length) ? s_stats.level : length;
+    mw_entropy_Take(p_buf, drawn);
+    OSAL_CRIT_Leave(OSAL_CRIT_TYPE_LOW, critState);
+
+    if (drawn == length)
+    {
+        return MBA_RES_SUCCESS;
+    }
+
+    // The pool ran short, wait on the TRNG for the rest
+    if (mw_entropy_AcquireTrng())
+    {
+        MW_AES_HoldClock(true);
+        for (retry = 0; retry < MW_ENTROPY_TRNG_RETRY; retry++)
+        {
+            s = CRM_TRNG_GET(&s_trng, (char *)&p_buf[drawn], length - drawn);
+            if (s == CRM_OK)
+            {
+                break;
+            }
+        }
+        MW_AES_HoldClock(false);
+        s_isTrngBusy = false;
+    }
+
+    critState = OSAL_CRIT_Enter(OSAL_CRIT_TYPE_LOW);
+    if (s == CRM_OK)
+    {
+        s_stats.directByteCnt += (length - drawn);
+    }
+    else
+    {
+        s_stats.failCnt++;
+    }
+    OSAL_CRIT_Leave(OSAL_CRIT_TYPE_LOW, critState);
+
+    return (s == CRM_OK) ? MBA_RES_SUCCESS : MBA_RES_FAIL;
+}
+
+/**
+ * @brief Gets the entropy pool statistics.
+ *
+ * @param[out] p_stats             Pointer to where the statistics are stored.
+ */
+void MW_ENTROPY_GetStats(MW_ENTROPY_Stats_T *p_stats)
+{
+    OSAL_CRITSECT_DATA_TYPE critState;
+
+    critState = OSAL_CRIT_Enter(OSAL_CRIT_TYPE_LOW);
+    *p_stats = s_stats;
+    OSAL_CRIT_Leave(OSAL_CRIT_TYPE_LOW, critState);
+}
@@ -0,0 +1,180 @@
+/*******************************************************************************
+* Copyright (C) 2025 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  Middleware Entropy Header File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    mw_entropy.h
+
+  Summary:
+    Provides a pool of random bytes from the hardware TRNG within the BLE
+    middleware.
+
+  Description:
+    This header file exposes a pool of random bytes that is refilled from the
+    hardware True Random Number Generator (TRNG) in idle time, so that random
+    numbers are drawn without waiting on the TRNG.
+ *******************************************************************************/
+#ifndef MW_ENTROPY_H
+#define MW_ENTROPY_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+extern "C" {
+#endif
+// DOM-IGNORE-END
+
+/**
+ * @addtogroup BLE_MW BLE Middleware
+ * @{
+ */
+
+/**
+ * @defgroup MW_ENTROPY Entropy Pool
+ *
+ * @brief Provides random bytes from the hardware TRNG for BLE applications.
+ * @note This section declares the API for the entropy component of the BLE middleware.
+ * @{
+ */
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Macros
+// *****************************************************************************
+// *****************************************************************************
+/**
+ * @addtogroup MW_ENTROPY_DEFINES Defines
+ * @{
+ */
+#define MW_ENTROPY_POOL_SIZE            (64U)       /**< Size of the pool in bytes. */
+#define MW_ENTROPY_REFILL_SIZE          (16U)       /**< Bytes read from the TRNG in one refill. */
+/** @} */ //MW_ENTROPY_DEFINES
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+/**
+ * @addtogroup MW_ENTROPY_STRUCTS Structures
+ * @{
+ */
+
+/** @brief Structure for the entropy pool statistics. */
+typedef struct MW_ENTROPY_Stats_T
+{
+    uint16_t  level;                              /**< Bytes available in the pool. */
+    uint16_t  lowLevel;                           /**< Lowest number of bytes left in the pool after a draw. */
+    uint32_t  refillCnt;                          /**< Refills from the TRNG. */
+    uint32_t  refillWaitCnt;                      /**< Refills skipped because the TRNG had not enough entropy yet. */
+    uint32_t  drawByteCnt;                        /**< Bytes drawn from the pool. */
+    uint32_t  directByteCnt;                      /**< Bytes read straight from the TRNG because the pool was short. */
+    uint32_t  failCnt;                            /**< Draws which could not be served. */
+} MW_ENTROPY_Stats_T;
+
+/** @} */ //MW_ENTROPY_STRUCTS
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Function Prototypes
+// *****************************************************************************
+// *****************************************************************************
+/**
+ * @addtogroup MW_ENTROPY_FUNS Functions
+ * @{
+ */
+
+/**
+ * @brief Initializes the TRNG and the entropy pool. The pool starts empty.
+ *
+ * @retval MBA_RES_SUCCESS         Initialization successful.
+ * @retval MBA_RES_FAIL            The TRNG could not be initialized.
+ */
+uint16_t MW_ENTROPY_Init(void);
+
+/**
+ * @brief Refills the pool from the TRNG. To be called in idle time.
+ * @note  The function does not wait for the TRNG. It adds at most
+ *        @ref MW_ENTROPY_REFILL_SIZE bytes at a time.
+ *
+ * @retval true                    Bytes were added and the pool is not full yet.
+ * @retval false                   The pool is full, or the TRNG is not ready.
+ */
+bool MW_ENTROPY_Refill(void);
+
+/**
+ * @brief Draws random bytes from the pool, without waiting.
+ *
+ * @param[out] p_buf               Pointer to where the random bytes are stored.
+ * @param[in] length               Number of random bytes.
+ *
+ * @retval MBA_RES_SUCCESS         The random bytes are drawn.
+ * @retval MBA_RES_NO_RESOURCE     The pool has less than length bytes, nothing is drawn.
+ */
+uint16_t MW_ENTROPY_TryGet(uint8_t *p_buf, uint16_t length);
+
+/**
+ * @brief Draws random bytes from the pool, and reads the missing bytes from the TRNG
+ *        if the pool is short.
+ *
+ * @param[out] p_buf               Pointer to where the random bytes are stored.
+ * @param[in] length               Number of random bytes.
+ *
+ * @retval MBA_RES_SUCCESS         The random bytes are drawn.
+ * @retval MBA_RES_FAIL            The TRNG could not provide the missing bytes.
+ */
+uint16_t MW_ENTROPY_Get(uint8_t *p_buf, uint16_t length);
+
+/**
+ * @brief Gets the entropy pool statistics.
+ *
+ * @param[out] p_stats             Pointer to where the statistics are stored.
+ */
+void MW_ENTROPY_GetStats(MW_ENTROPY_Stats_T *p_stats);
+
+/** @} */ //MW_ENTROPY_FUNS
+
+/** @} */
+
+/** @} */
+
+//DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+//DOM-IGNORE-END
+
+#endif //MW_ENTROPY_H
@@ -44,13 +44,13 @@
 // Section: Included Files
 // *****************************************************************************
 // *****************************************************************************
-#include <stdlib.h>
 #include <string.h>
 #include <stdint.h>
 #include "osal/osal_freertos.h"
 #include "mba_error_defs.h"
 #include "byte_stream.h"
 #include "mw_aes.h"
+#include "mw_entropy.h"
 #include "mw_misc.h"
 
 
@@ -67,29 +67,10 @@
 // *****************************************************************************
 // *****************************************************************************
 
-static void mw_misc_GenEncAdvDataRand(uint8_t *p_rand) 
+static uint16_t mw_misc_GenEncAdvDataRand(uint8_t *p_rand)
 {
-    int32_t r;
-    int32_t rQueue = 0;
-    int32_t rBitCount = 0;
-    uint8_t i;
-
-    for (i = 0; i < 5; i++) {
-        r = 0;
-        if (rBitCount < 8) {
-            int32_t need = 8 - rBitCount;
-            r = rQueue << need;
-            rQueue = rand();
-            r ^= rQueue;  
-            rQueue >>= need;
-            rBitCount = 31 - need;
-        } else {
-            r = rQueue;
-            rQueue >>= 8;
-            rBitCount -= 8;
-        }
-        p_rand[i] = r;
-    }
+    // The randomizer is part of the nonce, it must not repeat for a key
+    return MW_ENTROPY_Get(p_rand, 5);
 }
 
 
@@ -116,7 +97,10 @@ uint16_t MW_MISC_EncryptAdvData(MW_MISC_EncAdvData_T *p_encAdvData)
     U8_TO_STREAM(&p_buf, p_encAdvData->payloadLen + 10);
     U8_TO_STREAM(&p_buf, MW_AD_TYPE_ENC_DATA);
 
-    mw_misc_GenEncAdvDataRand(randomizer);
+    if (mw_misc_GenEncAdvDataRand(randomizer) != MBA_RES_SUCCESS)
+    {
+        return MBA_RES_FAIL;
+    }
     VARIABLE_COPY_TO_STREAM(&p_buf, randomizer, 5);
 
     BUF_TO_VARIABLE(key, p_encAdvData->p_key, sizeof(key));
@@ -54,6 +54,7 @@
 #include "gatt.h"
 #include "ble_util/mw_assert.h"
 #include "ble_util/byte_stream.h"
+#include "ble_util/mw_conn.h"
 #include "ble_trs/ble_trs.h"
 #include "ble_trsps.h"
 
@@ -68,6 +69,15 @@
 #define BLE_TRSPS_MAX_BUF_IN                    (BLE_TRSPS_INIT_CREDIT*BLE_TRSPS_MAX_CONN_NBR)
 
 #define BLE_TRSPS_MAX_RETURN_CREDIT             (13U)           // Maximum number of credits that can be returned to the peer device.
+#define BLE_TRSPS_MIN_RETURN_CREDIT             (2U)            // Minimum number of credits returned at once by the adaptive policy.
+#define BLE_TRSPS_EARLY_RETURN_CREDIT           (4U)            // Pending credits returned before another outgoing notification.
+#define BLE_TRSPS_BACKLOG_THRESHOLD             (BLE_TRSPS_INIT_CREDIT/2U)  // Input queue occupancy above which credit return is deferred.
+#define BLE_TRSPS_DEFAULT_CONN_INTERVAL         (0x0018U)       // Connection interval assumed before one is known, in units of 1.25ms.
+#define BLE_TRSPS_RATE_SHIFT                    (4U)            // Fixed-point shift of the receive rate estimate.
+#define BLE_TRSPS_RETURN_LOOKAHEAD              (2U)            // Connection intervals before returned credits can be used by the peer.
+#define BLE_TRSPS_CONN_INTERVAL_UNIT_US         (1250U)         // Connection interval unit, in microseconds.
+#define BLE_TRSPS_CYCLES_PER_US                 (configCPU_CLOCK_HZ / 1000000UL) // Cycle counter increments per microsecond.
+#define BLE_TRSPS_RATE_LONG_SAMPLE_MS           (10000U)        // Samples longer than this are timed in ticks, the cycle counter wraps after 33s.
 
 #define BLE_TRSPS_CBFC_TX_ENABLED               (1U)            // Enable flag for CBFC (Credit Based Flow Control) transmission.
 #define BLE_TRSPS_CBFC_RX_ENABLED               (1U << 1U)      // Enable flag for CBFC reception.
@@ -128,6 +138,13 @@ typedef struct BLE_TRSPS_ConnList_T
     uint8_t                    retryType;                       // Type of retry mechanism in use. See @ref BLE_TRSPS_RETRY_TYPE for retry types.
     uint8_t                    *p_retryData;                    // Pointer to the data buffer for retry operations.
     BLE_TRSPS_QueueIn_T        inputQueue;                      // Queue for incoming packets awaiting processing.
+    bool                       creditPending;                   // Flag indicating a credit return could not be sent and must be retried.
+    uint16_t                   connInterval;                    // Connection interval in use, in units of 1.25ms.
+    uint16_t                   rxRate;                          // Estimated packets received per connection interval, scaled by BLE_TRSPS_RATE_SHIFT.
+    uint16_t                   rxSampleCnt;                     // Packets received since the last rate sample.
+    uint32_t                   rxSampleTick;                    // Tick count at the start of the current rate sample.
+    uint32_t                   rxSampleStamp;                   // Cycle counter at the start of the current rate sample.
+    BLE_TRSPS_CreditStats_T    stats;                           // Credit flow statistics for this connection.
 } BLE_TRSPS_ConnList_T;
 
 
@@ -139,6 +156,7 @@ typedef struct BLE_TRSPS_ConnList_T
 
 static BLE_TRSPS_EventCb_T      bleTrspsProcess;                // Callback function type for BLE Transparent Service events processing.
 static BLE_TRSPS_ConnList_T     s_trsConnList[BLE_TRSPS_MAX_CONN_NBR];// An array to keep track of the connection list for BLE Transparent Service.
+static uint8_t                  s_trsCreditPolicy = BLE_TRSPS_CREDIT_POLICY_ADAPTIVE;// Policy used to return credits to the peer device.
 
 
 // Assert to ensure that the total initial credits multiplied by the maximum number of connections
@@ -160,6 +178,7 @@ static void ble_trsps_InitConnList(BLE_TRSPS_ConnList_T *p_conn)
 {
     (void)memset((uint8_t *)p_conn, 0, sizeof(BLE_TRSPS_ConnList_T));
     p_conn->attMtu= BLE_ATT_DEFAULT_MTU_LEN;
+    p_conn->connInterval = BLE_TRSPS_DEFAULT_CONN_INTERVAL;
 }
 
 
@@ -172,14 +191,14 @@ static void ble_trsps_InitConnList(BLE_TRSPS_ConnList_T *p_conn)
  */
 static BLE_TRSPS_ConnList_T * ble_trsps_GetConnListByHandle(uint16_t connHandle)
 {
-    uint8_t i;
+    uint8_t index;
+
+    index = MW_CONN_GetIndex(connHandle);
 
-    for(i=0; i<BLE_TRSPS_MAX_CONN_NBR;i++)
+    if ((index < BLE_TRSPS_MAX_CONN_NBR) && (s_trsConnList[index].state == BLE_TRSPS_STATE_CONNECTED)
+        && (s_trsConnList[index].connHandle == connHandle))
     {
-        if ((s_trsConnList[i].state == BLE_TRSPS_STATE_CONNECTED) && (s_trsConnList[i].connHandle == connHandle))
-        {
-            return &s_trsConnList[i];
-        }
+        return &s_trsConnList[index];
     }
 
     return NULL;
@@ -187,21 +206,22 @@ static BLE_TRSPS_ConnList_T * ble_trsps_GetConnListByHandle(uint16_t connHandle)
 
 
 /**
- * @brief Get a free connection list entry.
+ * @brief Get the connection list entry assigned to a new connection.
+ *
+ * @param connHandle The connection handle of the new connection.
  *
  * @retval Pointer to the free connection list entry if available, otherwise NULL.
  */
-static BLE_TRSPS_ConnList_T *ble_trsps_GetFreeConnList(void)
+static BLE_TRSPS_ConnList_T *ble_trsps_GetFreeConnList(uint16_t connHandle)
 {
-    uint8_t i;
+    uint8_t index;
+
+    index = MW_CONN_GetIndex(connHandle);
 
-    for(i=0; i<BLE_TRSPS_MAX_CONN_NBR;i++)
+    if ((index < BLE_TRSPS_MAX_CONN_NBR) && (s_trsConnList[index].state == BLE_TRSPS_STATE_IDLE))
     {
-        if (s_trsConnList[i].state == BLE_TRSPS_STATE_IDLE)
-        {
-            s_trsConnList[i].state = BLE_TRSPS_STATE_CONNECTED;
-            return &s_trsConnList[i];
-        }
+        s_trsConnList[index].state = BLE_TRSPS_STATE_CONNECTED;
+        return &s_trsConnList[index];
     }
 
     return NULL;
@@ -212,15 +232,20 @@ static BLE_TRSPS_ConnList_T *ble_trsps_GetFreeConnList(void)
  * @brief Return credit to the peer device for a given connection.
  *
  * @param p_conn Pointer to the BLE Transparent Service connection list entry.
+ *
+ * @retval MBA_RES_SUCCESS  Credits were returned or there were no credits to return.
+ * @retval Other            The credit notification could not be sent.
  */
-static void ble_trsps_ServerReturnCredit(BLE_TRSPS_ConnList_T *p_conn)
+static uint16_t ble_trsps_ServerReturnCredit(BLE_TRSPS_ConnList_T *p_conn)
 {
     GATTS_HandleValueParams_T hvParams;
     uint8_t *p_buf;
+    uint16_t result;
 
     if (p_conn->peerCredit == 0U)
     {
-        return;
+        p_conn->creditPending = false;
+        return MBA_RES_SUCCESS;
     }
 
     hvParams.sendType = ATT_HANDLE_VALUE_NTF;
@@ -233,10 +258,158 @@ static void ble_trsps_ServerReturnCredit(BLE_TRSPS_ConnList_T *p_conn)
     U16_TO_STREAM_BE(&p_buf, p_conn->attMtu);
     U8_TO_STREAM(&p_buf, p_conn->peerCredit);
 
-    if (GATTS_SendHandleValue(p_conn->connHandle, &hvParams) == MBA_RES_SUCCESS)
+    result = GATTS_SendHandleValue(p_conn->connHandle, &hvParams);
+    if (result == MBA_RES_SUCCESS)
     {
         p_conn ->peerCredit = 0;
+        p_conn->creditPending = false;
+        p_conn->stats.creditReturnCnt++;
     }
+
+    return result;
+}
+
+
+/**
+ * @brief Get the number of consumed credits at which credits are returned to the peer device.
+ *
+ * @note The adaptive policy returns credits early when the peer is about to run out of credits
+ *       before the returned credits reach it, and holds them while the application is backlogged.
+ *       The credit notification is sent in the next connection event and the peer uses the
+ *       credits in the event after it.
+ *
+ * @param p_conn Pointer to the BLE Transparent Service connection list entry.
+ *
+ * @retval The credit return threshold.
+ */
+static uint8_t ble_trsps_GetReturnThreshold(BLE_TRSPS_ConnList_T *p_conn)
+{
+    uint8_t peerHeld;
+    uint16_t expected;
+    uint16_t perInterval;
+
+    if (s_trsCreditPolicy != BLE_TRSPS_CREDIT_POLICY_ADAPTIVE)
+    {
+        return BLE_TRSPS_MAX_RETURN_CREDIT;
+    }
+
+    if (p_conn->inputQueue.usedNum > BLE_TRSPS_BACKLOG_THRESHOLD)
+    {
+        return BLE_TRSPS_MAX_RETURN_CREDIT;
+    }
+
+    // Credits still held by the peer and packets expected from it until returned credits can be used.
+    peerHeld = BLE_TRSPS_INIT_CREDIT - p_conn->inputQueue.usedNum - p_conn->peerCredit;
+    expected = (((p_conn->rxRate * BLE_TRSPS_RETURN_LOOKAHEAD) + (1U << BLE_TRSPS_RATE_SHIFT) - 1U) >> BLE_TRSPS_RATE_SHIFT) + 1U;
+
+    // Returning about one interval's worth at a time keeps it to one credit notification per interval.
+    if ((uint16_t)peerHeld <= expected)
+    {
+        perInterval = (p_conn->rxRate + (1U << BLE_TRSPS_RATE_SHIFT) - 1U) >> BLE_TRSPS_RATE_SHIFT;
+        return (perInterval > BLE_TRSPS_MIN_RETURN_CREDIT) ? (uint8_t)perInterval : BLE_TRSPS_MIN_RETURN_CREDIT;
+    }
+
+    return BLE_TRSPS_MAX_RETURN_CREDIT;
+}
+
+
+/**
+ * @brief Return credits to the peer device if the active credit policy requires it.
+ *
+ * @param p_conn Pointer to the BLE Transparent Service connection list entry.
+ */
+static void ble_trsps_CheckReturnCredit(BLE_TRSPS_ConnList_T *p_conn)
+{
+    if ((p_conn->creditPending) || (p_conn->peerCredit >= ble_trsps_GetReturnThreshold(p_conn)))
+    {
+        if (ble_trsps_ServerReturnCredit(p_conn) != MBA_RES_SUCCESS)
+        {
+            p_conn->creditPending = true;
+        }
+    }
+}
+
+
+/**
+ * @brief Return pending credits before another outgoing notification, below the return threshold.
+ *
+ * @note The credits are sent in their own control point notification, the TRS data PDU has no
+ *       field to carry them. Queuing it first only keeps it from waiting behind the data.
+ *       A failure is not recorded as pending since the return threshold has not been reached.
+ *
+ * @param p_conn Pointer to the BLE Transparent Service connection list entry.
+ */
+static void ble_trsps_ReturnCreditEarly(BLE_TRSPS_ConnList_T *p_conn)
+{
+    if ((s_trsCreditPolicy == BLE_TRSPS_CREDIT_POLICY_ADAPTIVE) && (!p_conn->creditPending)
+    && (p_conn->peerCredit >= BLE_TRSPS_EARLY_RETURN_CREDIT))
+    {
+        if (ble_trsps_ServerReturnCredit(p_conn) == MBA_RES_SUCCESS)
+        {
+            p_conn->stats.earlyReturnCnt++;
+        }
+    }
+}
+
+
+/**
+ * @brief Start a new receive rate sample of a connection.
+ *
+ * @param p_conn Pointer to the BLE Transparent Service connection list entry.
+ */
+static void ble_trsps_StartRxSample(BLE_TRSPS_ConnList_T *p_conn)
+{
+    p_conn->rxSampleCnt = 0;
+    p_conn->rxSampleTick = (uint32_t)xTaskGetTickCount();
+    p_conn->rxSampleStamp = DWT->CYCCNT;
+}
+
+
+/**
+ * @brief Update the receive rate estimate of a connection.
+ *
+ * @note The rate is sampled once per connection interval and smoothed with an exponential moving average.
+ *
+ * @param p_conn Pointer to the BLE Transparent Service connection list entry.
+ */
+static void ble_trsps_UpdateRxRate(BLE_TRSPS_ConnList_T *p_conn)
+{
+    uint32_t elapsedMs = ((uint32_t)xTaskGetTickCount() - p_conn->rxSampleTick) * portTICK_PERIOD_MS;
+    uint32_t elapsedUs;
+    uint32_t intervalUs = (uint32_t)p_conn->connInterval * BLE_TRSPS_CONN_INTERVAL_UNIT_US;
+    uint32_t sample;
+
+    p_conn->rxSampleCnt++;
+
+    // A 7.5ms interval is a few ticks long, the cycle counter times it to the microsecond.
+    if (elapsedMs >= BLE_TRSPS_RATE_LONG_SAMPLE_MS)
+    {
+        elapsedUs = BLE_TRSPS_RATE_LONG_SAMPLE_MS * 1000U;
+    }
+    else
+    {
+        elapsedUs = (DWT->CYCCNT - p_conn->rxSampleStamp) / BLE_TRSPS_CYCLES_PER_US;
+    }
+
+    if (intervalUs == 0U)
+    {
+        intervalUs = 1U;
+    }
+
+    if (elapsedUs < intervalUs)
+    {
+        return;
+    }
+
+    // A sample ends one interval after it starts, so rxSampleCnt is bounded by the credits granted.
+    sample = (((uint32_t)p_conn->rxSampleCnt << BLE_TRSPS_RATE_SHIFT) * intervalUs) / elapsedUs;
+    if (sample > ((uint32_t)BLE_TRSPS_INIT_CREDIT << BLE_TRSPS_RATE_SHIFT))
+    {
+        sample = ((uint32_t)BLE_TRSPS_INIT_CREDIT << BLE_TRSPS_RATE_SHIFT);
+    }
+
+    p_conn->rxRate = (uint16_t)((((uint32_t)p_conn->rxRate * 3U) + sample) / 4U);
+    ble_trsps_StartRxSample(p_conn);
 }
 
 
@@ -280,6 +453,17 @@ static void ble_trsps_RcvData(BLE_TRSPS_ConnList_T *p_conn, uint8_t writeType, u
         }
 
         p_conn->inputQueue.usedNum++;
+        p_conn->stats.rxByteCnt += receivedLen;
+
+        if (((p_conn->cbfcEnable&BLE_TRSPS_CBFC_RX_ENABLED)!=0U) && (writeType == ATT_WRITE_CMD))
+        {
+            ble_trsps_UpdateRxRate(p_conn);
+
+            if ((p_conn->inputQueue.usedNum + p_conn->peerCredit) >= BLE_TRSPS_INIT_CREDIT)
+            {
+                p_conn->stats.peerStallCnt++;
+            }
+        }
 
         evtPara.eventId=BLE_TRSPS_EVT_RECEIVE_DATA;
         evtPara.eventField.onReceiveData.connHandle = p_conn->connHandle;
@@ -309,20 +493,23 @@ static void ble_trsps_FreeRetryData(BLE_TRSPS_ConnList_T *p_conn)
 
 
 /**
- * @brief Check if there is any queued task that needs to be processed.
+ * @brief Check if there is any queued task that needs to be processed before sending on a connection.
+ *
+ * @param p_conn Pointer to the BLE Transparent Service connection list entry.
  *
  * @retval True if there is a queued task, false otherwise.
  */
-static bool ble_trsps_CheckQueuedTask(void)
+static bool ble_trsps_CheckQueuedTask(BLE_TRSPS_ConnList_T *p_conn)
 {
     uint8_t i;
-    
+
+    if (p_conn->creditPending)
+    {
+        return true;
+    }
+
     for(i=0; i < BLE_TRSPS_MAX_CONN_NBR; i++)
     {
-        if ((s_trsConnList[i].state == BLE_TRSPS_STATE_CONNECTED) && (s_trsConnList[i].peerCredit >= BLE_TRSPS_MAX_RETURN_CREDIT))
-        {
-            return true;
-        }
         if (s_trsConnList[i].p_retryData != NULL)
         {
             return true;
@@ -382,10 +569,7 @@ static void ble_trsps_ProcessQueuedTask(uint16_t connHandle)
 
     if (p_connList->state == BLE_TRSPS_STATE_CONNECTED)
     {
-        if (p_connList->peerCredit >= BLE_TRSPS_MAX_RETURN_CREDIT)
-        {
-            ble_trsps_ServerReturnCredit(p_connList);
-        }
+        ble_trsps_CheckReturnCredit(p_connList);
     }
 }
 
@@ -417,9 +601,59 @@ uint16_t BLE_TRSPS_Init(void)
         ble_trsps_InitConnList(&s_trsConnList[i]);
     }
 
+    // The cycle counter times the receive rate samples.
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
     return BLE_TRS_Add();
 }
 
+
+/**
+ * @brief Selects the policy used to return credits to the peer device.
+ *
+ * @param[in] policy                        Credit return policy. See @ref BLE_TRSPS_CREDIT_POLICY.
+ *
+ * @retval MBA_RES_SUCCESS                  Policy successfully selected.
+ * @retval MBA_RES_INVALID_PARA             Unknown policy.
+ */
+uint16_t BLE_TRSPS_SetCreditPolicy(uint8_t policy)
+{
+    if ((policy != BLE_TRSPS_CREDIT_POLICY_FIXED) && (policy != BLE_TRSPS_CREDIT_POLICY_ADAPTIVE))
+    {
+        return MBA_RES_INVALID_PARA;
+    }
+
+    s_trsCreditPolicy = policy;
+
+    return MBA_RES_SUCCESS;
+}
+
+
+/**
+ * @brief Retrieves the credit flow statistics of a connection.
+ *
+ * @param[in]  connHandle                   Connection handle associated with this connection.
+ * @param[out] p_stats                      Pointer to where the statistics will be stored.
+ *
+ * @retval MBA_RES_SUCCESS                  Statistics successfully retrieved.
+ * @retval MBA_RES_FAIL                     The connection link could not be found.
+ */
+uint16_t BLE_TRSPS_GetCreditStats(uint16_t connHandle, BLE_TRSPS_CreditStats_T *p_stats)
+{
+    BLE_TRSPS_ConnList_T *p_conn;
+
+    p_conn = ble_trsps_GetConnListByHandle(connHandle);
+    if (p_conn == NULL)
+    {
+        return MBA_RES_FAIL;
+    }
+
+    (void)memcpy((uint8_t *)p_stats, (uint8_t *)&p_conn->stats, sizeof(BLE_TRSPS_CreditStats_T));
+
+    return MBA_RES_SUCCESS;
+}
+
 uint16_t BLE_TRSPS_SendVendorCommand(uint16_t connHandle, uint8_t commandID, uint8_t commandLength, uint8_t *p_commandPayload)
 {
     BLE_TRSPS_ConnList_T *p_conn;
@@ -442,6 +676,8 @@ uint16_t BLE_TRSPS_SendVendorCommand(uint16_t connHandle, uint8_t commandID, uin
         return MBA_RES_INVALID_PARA;
     }
 
+    ble_trsps_ReturnCreditEarly(p_conn);
+
     p_hvParams = OSAL_Malloc(sizeof(GATTS_HandleValueParams_T));
     if (p_hvParams != NULL)
     {
@@ -462,6 +698,80 @@ uint16_t BLE_TRSPS_SendVendorCommand(uint16_t connHandle, uint8_t commandID, uin
 }
 
 
+/**
+ * @brief Check whether a notification of the given length can be sent on a connection.
+ *
+ * @param[in] p_conn                        Pointer to the BLE Transparent Service connection list entry.
+ * @param[in] len                           The length of the data to be sent.
+ *
+ * @retval MBA_RES_SUCCESS                  The notification can be sent.
+ * @retval MBA_RES_BAD_STATE                The peer device has not enabled the TX notification.
+ * @retval MBA_RES_NO_RESOURCE              No local credit or queued data is pending.
+ * @retval MBA_RES_FAIL                     The data length exceeds the ATT MTU.
+ */
+static uint16_t ble_trsps_CheckSendData(BLE_TRSPS_ConnList_T *p_conn, uint16_t len)
+{
+    if (p_conn->trsState != BLE_TRSPS_STATUS_TX_OPENED)
+    {
+        return MBA_RES_BAD_STATE;
+    }
+
+    if (((p_conn->cbfcEnable&BLE_TRSPS_CBFC_TX_ENABLED)!=0U) && (p_conn->localCredit == 0U))
+    {
+        p_conn->stats.localStallCnt++;
+        return MBA_RES_NO_RESOURCE;
+    }
+
+    if (p_conn->creditPending)
+    {
+        ble_trsps_CheckReturnCredit(p_conn);
+    }
+
+    if (ble_trsps_CheckQueuedTask(p_conn))
+    {
+        p_conn->stats.sendBlockedCnt++;
+        return MBA_RES_NO_RESOURCE;
+    }
+
+    if (len > (p_conn->attMtu - ATT_HANDLE_VALUE_HEADER_SIZE))
+    {
+        return MBA_RES_FAIL;
+    }
+
+    return MBA_RES_SUCCESS;
+}
+
+
+/**
+ * @brief Send a prepared TX notification on a connection and consume a local credit.
+ *
+ * @param[in] p_conn                        Pointer to the BLE Transparent Service connection list entry.
+ * @param[in] p_hvParams                    Pointer to the prepared notification parameters.
+ *
+ * @retval MBA_RES_SUCCESS                  Notification successfully sent.
+ * @retval Other                            The notification could not be sent.
+ */
+static uint16_t ble_trsps_SendNotify(BLE_TRSPS_ConnList_T *p_conn, GATTS_HandleValueParams_T *p_hvParams)
+{
+    uint16_t result;
+
+    ble_trsps_ReturnCreditEarly(p_conn);
+
+    result = GATTS_SendHandleValue(p_conn->connHandle, p_hvParams);
+    if (result == MBA_RES_SUCCESS)
+    {
+        p_conn->stats.txByteCnt += p_hvParams->charLength;
+
+        if ((p_conn->cbfcEnable&BLE_TRSPS_CBFC_TX_ENABLED) != 0U)
+        {
+            p_conn->localCredit--;
+        }
+    }
+
+    return result;
+}
+
+
 /**
  * @brief Sends transparent data over BLE.
  *
@@ -485,24 +795,43 @@ uint16_t BLE_TRSPS_SendData(uint16_t connHandle, uint16_t len, uint8_t *p_data)
         return MBA_RES_FAIL;
     }
 
-    if (p_conn->trsState != BLE_TRSPS_STATUS_TX_OPENED)
+    result = ble_trsps_CheckSendData(p_conn, len);
+    if (result != MBA_RES_SUCCESS)
     {
-        return MBA_RES_BAD_STATE;
+        return result;
     }
 
-    if (((p_conn->cbfcEnable&BLE_TRSPS_CBFC_TX_ENABLED)!=0U) && (p_conn->localCredit == 0U))
-    {
-        return MBA_RES_NO_RESOURCE;
-    }
+    hvParams.charHandle = (uint16_t)TRS_HDL_CHARVAL_TX;
+    hvParams.charLength = len;
+    (void)memcpy(hvParams.charValue, p_data, hvParams.charLength);
+    hvParams.sendType = ATT_HANDLE_VALUE_NTF;
 
-    if (ble_trsps_CheckQueuedTask())
-    {
-        return MBA_RES_NO_RESOURCE;
-    }
+    return ble_trsps_SendNotify(p_conn, &hvParams);
+}
 
-    if (len > (p_conn->attMtu - ATT_HANDLE_VALUE_HEADER_SIZE))
+
+/**
+ * @brief Sends transparent data to every connection that has enabled the TX notification.
+ *
+ * @param[in]  len                          The length of the data to be sent.
+ * @param[in]  p_data                       Pointer to the data to be sent.
+ * @param[out] p_sentNum                    Pointer to store the number of connections the data was sent to. Can be NULL.
+ *
+ * @retval MBA_RES_SUCCESS                  Data sent to every subscribed connection.
+ * @retval MBA_RES_NO_RESOURCE              Data could not be sent to at least one subscribed connection.
+ * @retval MBA_RES_BAD_STATE                No connection has enabled the TX notification.
+ * @retval MBA_RES_INVALID_PARA             Invalid parameters; data length does not meet specifications.
+ */
+uint16_t BLE_TRSPS_BroadcastData(uint16_t len, uint8_t *p_data, uint8_t *p_sentNum)
+{
+    GATTS_HandleValueParams_T  hvParams;
+    uint8_t i;
+    uint8_t subscribedNum = 0;
+    uint8_t sentNum = 0;
+
+    if ((p_data == NULL) || (len == 0U) || (len > sizeof(hvParams.charValue)))
     {
-        return MBA_RES_FAIL;
+        return MBA_RES_INVALID_PARA;
     }
 
     hvParams.charHandle = (uint16_t)TRS_HDL_CHARVAL_TX;
@@ -510,16 +839,33 @@ uint16_t BLE_TRSPS_SendData(uint16_t connHandle, uint16_t len, uint8_t *p_data)
     (void)memcpy(hvParams.charValue, p_data, hvParams.charLength);
     hvParams.sendType = ATT_HANDLE_VALUE_NTF;
 
-    result = GATTS_SendHandleValue(p_conn->connHandle, &hvParams);
-    if (result == MBA_RES_SUCCESS)
+    for (i = 0; i < BLE_TRSPS_MAX_CONN_NBR; i++)
     {
-        if ((p_conn->cbfcEnable&BLE_TRSPS_CBFC_TX_ENABLED) != 0U)
+        if ((s_trsConnList[i].state != BLE_TRSPS_STATE_CONNECTED) || (s_trsConnList[i].trsState != BLE_TRSPS_STATUS_TX_OPENED))
         {
-            p_conn->localCredit--;
+            continue;
+        }
+
+        subscribedNum++;
+
+        if ((ble_trsps_CheckSendData(&s_trsConnList[i], len) == MBA_RES_SUCCESS)
+            && (ble_trsps_SendNotify(&s_trsConnList[i], &hvParams) == MBA_RES_SUCCESS))
+        {
+            sentNum++;
         }
     }
 
-    return result;
+    if (p_sentNum != NULL)
+    {
+        *p_sentNum = sentNum;
+    }
+
+    if (subscribedNum == 0U)
+    {
+        return MBA_RES_BAD_STATE;
+    }
+
+    return (sentNum == subscribedNum) ? MBA_RES_SUCCESS : MBA_RES_NO_RESOURCE;
 }
 
 
@@ -594,10 +940,7 @@ uint16_t BLE_TRSPS_GetData(uint16_t connHandle, uint8_t *p_data)
             && (writeType == ATT_WRITE_CMD))
             {
                 p_conn->peerCredit++;
-                if (p_conn->peerCredit >= BLE_TRSPS_MAX_RETURN_CREDIT)
-                {
-                    ble_trsps_ServerReturnCredit(p_conn);
-                }
+                ble_trsps_CheckReturnCredit(p_conn);
             }
 
             return MBA_RES_SUCCESS;
@@ -689,7 +1032,11 @@ static void ble_trsps_CtrlValue(BLE_TRSPS_ConnList_T *p_conn, uint16_t length, u
         {
             p_conn->cbfcEnable |= BLE_TRSPS_CBFC_RX_ENABLED;
             p_conn->peerCredit = BLE_TRSPS_INIT_CREDIT;
-            ble_trsps_ServerReturnCredit(p_conn);
+            ble_trsps_StartRxSample(p_conn);
+            if (ble_trsps_ServerReturnCredit(p_conn) != MBA_RES_SUCCESS)
+            {
+                p_conn->creditPending = true;
+            }
             
             if (bleTrspsProcess != NULL)
             {
@@ -964,7 +1311,7 @@ static void ble_trsps_GapEventProcess(BLE_GAP_Event_T *p_event)
             {
                 BLE_TRSPS_ConnList_T    *p_conn;
                 
-                p_conn=ble_trsps_GetFreeConnList();
+                p_conn=ble_trsps_GetFreeConnList(p_event->eventField.evtConnect.connHandle);
                 if(p_conn==NULL)
                 {
                     BLE_TRSPS_Event_T evtPara;
@@ -977,6 +1324,22 @@ static void ble_trsps_GapEventProcess(BLE_GAP_Event_T *p_event)
                 }
 
                 p_conn->connHandle=p_event->eventField.evtConnect.connHandle;
+                p_conn->connInterval=p_event->eventField.evtConnect.interval;
+            }
+        }
+        break;
+
+        case BLE_GAP_EVT_CONN_PARAM_UPDATE:
+        {
+            BLE_TRSPS_ConnList_T    *p_conn;
+
+            if (p_event->eventField.evtConnParamUpdate.status == GAP_STATUS_SUCCESS)
+            {
+                p_conn=ble_trsps_GetConnListByHandle(p_event->eventField.evtConnParamUpdate.connHandle);
+                if (p_conn != NULL)
+                {
+                    p_conn->connInterval=p_event->eventField.evtConnParamUpdate.connParam.intervalMax;
+                }
             }
         }
         break;
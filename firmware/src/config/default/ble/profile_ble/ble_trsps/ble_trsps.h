@@ -102,6 +102,15 @@ extern "C" {
 #define BLE_TRSPS_STATUS_TX_OPENED              (0x01U)                 /**< Transparent Service TX characteristic CCCD is enabled. */
 /** @} */
 
+/**
+ * @defgroup BLE_TRSPS_CREDIT_POLICY TRSPS credit return policy
+ * @brief Defines the policy used to return credits to the peer device.
+ * @{
+ */
+#define BLE_TRSPS_CREDIT_POLICY_FIXED           (0x00U)                 /**< Credits are returned after a fixed number of packets has been consumed. */
+#define BLE_TRSPS_CREDIT_POLICY_ADAPTIVE        (0x01U)                 /**< Credits are returned based on consumption rate, connection interval and queue occupancy. */
+/** @} */
+
 /** @} */ //BLE_TRSPS_DEFINES
 
 
@@ -175,6 +184,19 @@ typedef struct BLE_TRSPS_EvtVendorCmd_T
 }BLE_TRSPS_EvtVendorCmd_T;
 
 
+/** @brief Credit flow statistics of a connection. */
+typedef struct BLE_TRSPS_CreditStats_T
+{
+    uint32_t         peerStallCnt;                            /**< Number of times the peer ran out of credits granted by the local device. */
+    uint32_t         localStallCnt;                           /**< Number of sends rejected because the peer granted no credits. */
+    uint32_t         sendBlockedCnt;                          /**< Number of sends blocked by a pending credit return or write response. */
+    uint32_t         creditReturnCnt;                         /**< Number of credit notifications sent to the peer. */
+    uint32_t         earlyReturnCnt;                          /**< Number of credit notifications sent below the return threshold, before another notification. */
+    uint32_t         txByteCnt;                               /**< Number of data bytes sent to the peer. */
+    uint32_t         rxByteCnt;                               /**< Number of data bytes received from the peer. */
+}BLE_TRSPS_CreditStats_T;
+
+
 /** @brief Union of BLE Transparent profile server event types. */
 typedef union
 {
@@ -233,6 +255,31 @@ void BLE_TRSPS_EventRegister(BLE_TRSPS_EventCb_T bleTranServHandler);
 uint16_t BLE_TRSPS_Init(void);
 
 
+/**
+ * @brief Selects the policy used to return credits to the peer device.
+ *
+ * @note The adaptive policy is selected by default.
+ *
+ * @param[in] policy                        Credit return policy. See @ref BLE_TRSPS_CREDIT_POLICY.
+ *
+ * @retval MBA_RES_SUCCESS                  Policy successfully selected.
+ * @retval MBA_RES_INVALID_PARA             Unknown policy.
+ */
+uint16_t BLE_TRSPS_SetCreditPolicy(uint8_t policy);
+
+
+/**
+ * @brief Retrieves the credit flow statistics of a connection.
+ *
+ * @param[in]  connHandle                   Connection handle associated with this connection.
+ * @param[out] p_stats                      Pointer to where the statistics will be stored. See @ref BLE_TRSPS_CreditStats_T.
+ *
+ * @retval MBA_RES_SUCCESS                  Statistics successfully retrieved.
+ * @retval MBA_RES_FAIL                     The connection link could not be found.
+ */
+uint16_t BLE_TRSPS_GetCreditStats(uint16_t connHandle, BLE_TRSPS_CreditStats_T *p_stats);
+
+
 /**
  * @brief Sends a vendor-specific command over BLE.
  *
@@ -263,6 +310,22 @@ uint16_t BLE_TRSPS_SendVendorCommand(uint16_t connHandle, uint8_t commandID, uin
 uint16_t BLE_TRSPS_SendData(uint16_t connHandle, uint16_t len, uint8_t *p_data);
 
 
+/**
+ * @brief Sends transparent data to every connection that has enabled the TX notification.
+ * @note The notification is built once and sent to each subscribed connection, so the payload is copied a single time.
+ *
+ * @param[in]  len                          The length of the data to be sent.
+ * @param[in]  p_data                       Pointer to the data to be sent.
+ * @param[out] p_sentNum                    Pointer to store the number of connections the data was sent to. Can be NULL.
+ *
+ * @retval MBA_RES_SUCCESS                  Data sent to every subscribed connection.
+ * @retval MBA_RES_NO_RESOURCE              Data could not be sent to at least one subscribed connection.
+ * @retval MBA_RES_BAD_STATE                No connection has enabled the TX notification.
+ * @retval MBA_RES_INVALID_PARA             Invalid parameters; data length does not meet specifications.
+ */
+uint16_t BLE_TRSPS_BroadcastData(uint16_t len, uint8_t *p_data, uint8_t *p_sentNum);
+
+
 /**
  * @brief Retrieves the length of data queued for transmission.
  *
@@ -0,0 +1,149 @@
+/*******************************************************************************
+* Copyright (C) 2025 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  BLE Link Status Service Source File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    ble_lss.c
+
+  Summary:
+    Implements the BLE Link Status Service functions used by the application.
+
+  Description:
+    This source file declares the attributes of the BLE Link Status Service.
+    Reads of the status value and writes of its CCCD are forwarded to the
+    application, which answers with the values of the requesting connection.
+ *******************************************************************************/
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <string.h>
+#include <stdint.h>
+#include "mba_error_defs.h"
+#include "gatt.h"
+#include "ble_util/byte_stream.h"
+#include "ble_lss.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Variables
+// *****************************************************************************
+// *****************************************************************************
+/* Link Status Service Declaration */
+static uint8_t s_svcUuidLss[] = {UUID_LSS_SERVICE_16};
+static const uint16_t s_svcUuidLssLen = (uint16_t)sizeof (s_svcUuidLss);
+
+/* Link Status Characteristic Declaration */
+static uint8_t s_charLssStatus[] = {(ATT_PROP_READ | ATT_PROP_NOTIFY), UINT16_TO_BYTES(LSS_HDL_CHARVAL_STATUS), UUID_LSS_STATUS_16};
+static const uint16_t s_charLssStatusLen = (uint16_t)sizeof (s_charLssStatus);
+
+/* Link Status Characteristic Value */
+static uint8_t s_chUuidLssStatus[] = {UUID_LSS_STATUS_16};
+static uint8_t s_lssStatusVal[BLE_LSS_STATUS_LEN] = {0};
+static uint16_t s_lssStatusValLen = BLE_LSS_STATUS_LEN;
+
+/* Link Status Client Characteristic Configuration Descriptor */
+static uint8_t s_descCccLssStatus[] = {UINT16_TO_BYTES(0x0000)};
+static const uint16_t s_descCccLssStatusLen = (uint16_t)sizeof (s_descCccLssStatus);
+
+/* Attribute list for Link Status service */
+static GATTS_Attribute_T s_lssList[] = {
+    /* Service Declaration */
+    {
+        (uint8_t *) g_gattUuidPrimSvc,
+        (uint8_t *) s_svcUuidLss,
+        (uint16_t *) & s_svcUuidLssLen,
+        (uint16_t)sizeof (s_svcUuidLss),
+        0,
+        PERMISSION_READ
+    },
+    /* Characteristic Declaration */
+    {
+        (uint8_t *) g_gattUuidChar,
+        (uint8_t *) s_charLssStatus,
+        (uint16_t *) & s_charLssStatusLen,
+        (uint16_t)sizeof (s_charLssStatus),
+        0,
+        PERMISSION_READ
+    },
+    /* Characteristic Value */
+    {
+        (uint8_t *) s_chUuidLssStatus,
+        (uint8_t *) s_lssStatusVal,
+        (uint16_t *) & s_lssStatusValLen,
+        (uint16_t)sizeof (s_lssStatusVal),
+        (SETTING_MANUAL_READ_RSP | SETTING_UUID_16),
+        PERMISSION_READ
+    },
+    /* Client Characteristic Configuration Descriptor */
+    {
+        (uint8_t *) g_descUuidCcc,
+        (uint8_t *) s_descCccLssStatus,
+        (uint16_t *) & s_descCccLssStatusLen,
+        (uint16_t)sizeof (s_descCccLssStatus),
+        (SETTING_MANUAL_WRITE_RSP | SETTING_CCCD),
+        (PERMISSION_READ | PERMISSION_WRITE)
+    }
+};
+
+/* CCCD settings for the Link Status Service characteristics. */
+static const GATTS_CccdSetting_T s_lssCccdSetting[] =
+{
+    {(uint16_t)LSS_HDL_CCCD_STATUS, (NOTIFICATION)}
+};
+
+/* Link Status Service structure */
+static GATTS_Service_T s_svcLss = 
+{
+    NULL,
+    (GATTS_Attribute_T *) s_lssList,
+    (GATTS_CccdSetting_T *)s_lssCccdSetting,
+    (uint16_t)LSS_START_HDL,
+    (uint16_t)LSS_END_HDL,
+    1
+};
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Functions
+// *****************************************************************************
+// *****************************************************************************
+/**
+ * @brief Adds the BLE Link Status Service to the GATT server.
+ *
+ * @retval MBA_RES_SUCCESS                    The BLE Link Status service was successfully added.
+ * @retval MBA_RES_NO_RESOURCE                Insufficient resource to add the BLE Link Status service.
+ */
+uint16_t BLE_LSS_Add(void) 
+{
+    return GATTS_AddService(&s_svcLss, (uint8_t)((uint16_t)LSS_END_HDL - (uint16_t)LSS_START_HDL + 1U));
+}
@@ -0,0 +1,149 @@
+/*******************************************************************************
+* Copyright (C) 2025 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+/*******************************************************************************
+  BLE Link Status Service (LSS) Header File
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    ble_lss.h
+
+  Summary:
+    Interface for the BLE Link Status Service, which reports the negotiated
+    link parameters and throughput of a connection.
+
+  Description:
+    Provides function prototypes and constants necessary for the integration and
+    use of LSS in BLE applications.
+ *******************************************************************************/
+#ifndef BLE_LSS_H
+#define BLE_LSS_H
+
+#include "configuration.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+extern "C" {
+#endif
+// DOM-IGNORE-END
+
+/**
+ * @addtogroup BLE_SERVICE BLE Service
+ * @{
+ */
+
+/**
+ * @addtogroup BLE_LSS BLE Link Status Service
+ * @{
+ * @brief Provides an interface for the BLE Link Status Service.
+ * @note The status characteristic is read and notified with manual responses, so the
+ * application provides the value of each connection. See @ref BLE_LSS_STATUS_FORMAT.
+ */
+// *****************************************************************************
+// *****************************************************************************
+// Section: Macros
+// *****************************************************************************
+// *****************************************************************************
+/**
+ * @addtogroup BLE_LSS_DEFINES Defines
+ * @{
+ */
+
+/**
+ * @defgroup BLE_LSS_UUID_DEF BLE Link Status Service UUID definitions
+ * @brief UUIDs for the BLE Link Status Service characteristics.
+ * @{
+ */
+#define UUID_LSS_SERVICE_16                          CONFIG_BLE_SVC_LSS_UUID_SERVICE_16
+#define UUID_LSS_STATUS_16                           CONFIG_BLE_SVC_LSS_UUID_STATUS_16
+/** @} */
+
+/**
+ * @defgroup BLE_LSS_STATUS_FORMAT Link status characteristic format
+ * @brief Layout of the link status characteristic value. All fields are little endian.
+ * @{
+ */
+#define BLE_LSS_STATUS_OFFSET_TX_PHY                 (0U)       /**< TX PHY. See @ref BLE_GAP_PHY_TYPE. (1 byte) */
+#define BLE_LSS_STATUS_OFFSET_RX_PHY                 (1U)       /**< RX PHY. See @ref BLE_GAP_PHY_TYPE. (1 byte) */
+#define BLE_LSS_STATUS_OFFSET_ATT_MTU                (2U)       /**< Negotiated ATT MTU. (2 bytes) */
+#define BLE_LSS_STATUS_OFFSET_CONN_INTERVAL          (4U)       /**< Connection interval in 1.25 ms units. (2 bytes) */
+#define BLE_LSS_STATUS_OFFSET_TX_THROUGHPUT          (6U)       /**< Transparent data sent to the peer, in bytes per second. (4 bytes) */
+#define BLE_LSS_STATUS_OFFSET_RX_THROUGHPUT          (10U)      /**< Transparent data received from the peer, in bytes per second. (4 bytes) */
+#define BLE_LSS_STATUS_OFFSET_PATH_LOSS_ZONE         (14U)      /**< Path loss zone. See @ref BLE_GAP_PATH_LOSS_ZONE. (1 byte) */
+#define BLE_LSS_STATUS_LEN                           (15U)      /**< Length of the link status characteristic value. */
+/** @} */
+
+/**
+ * @defgroup BLE_LSS_ASSIGN_HANDLE LSS assigned handles
+ * @brief Handles associated with the BLE Link Status Service attributes.
+ * @{
+ */
+#define LSS_START_HDL                               (0x00B0U)             /**< Start handle for the BLE Link Status service. */
+
+/* Enumeration of attribute handles for the BLE Link Status Service. */
+typedef enum BLE_LSS_AttributeHandle_T
+{
+    LSS_HDL_SVC = LSS_START_HDL,                                          /**< Handle for the BLE Link Status Service primary service. */
+    LSS_HDL_CHAR_STATUS,                                                  /**< Handle for the link status characteristic. */
+    LSS_HDL_CHARVAL_STATUS,                                               /**< Handle for the link status characteristic value. */
+    LSS_HDL_CCCD_STATUS                                                   /**< Handle for the link status characteristic CCCD value.*/
+}BLE_LSS_AttributeHandle_T;
+
+#define LSS_END_HDL                                 LSS_HDL_CCCD_STATUS   /**< End handle for the BLE Link Status Service.  */
+/** @} */
+
+/** @} */ //BLE_LSS_DEFINES
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Function Prototypes
+// *****************************************************************************
+// *****************************************************************************
+/**
+ * @addtogroup BLE_LSS_FUNS Functions
+ * @{
+ */
+
+/**
+ * @brief Adds the BLE Link Status Service to the GATT server.
+ *
+ * @retval MBA_RES_SUCCESS                    The BLE Link Status service was successfully added.
+ * @retval MBA_RES_NO_RESOURCE                Insufficient resource to add the BLE Link Status service.
+ */
+uint16_t BLE_LSS_Add(void);
+
+/** @} */ //BLE_LSS_FUNS
+
+/** @} */
+
+/** @} */
+
+//DOM-IGNORE-BEGIN
+#ifdef __cplusplus
+}
+#endif
+//DOM-IGNORE-END
+
+#endif //BLE_LSS_H
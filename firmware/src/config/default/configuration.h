@@ -128,11 +128,31 @@ extern "C" {
 #define CONFIG_BLE_GAP_ADV_INTERVAL_MIN              32 /* Advertising Interval Min */
 #define CONFIG_BLE_GAP_ADV_INTERVAL_MAX              32 /* Advertising Interval Max */
 #define CONFIG_BLE_GAP_ADV_TYPE                      BLE_GAP_ADV_TYPE_ADV_IND /* Advertising Type */
+#define CONFIG_BLE_GAP_EXT_ADV_EVT_PROP              (BLE_GAP_EXT_ADV_EVT_PROP_LEGACY_ADV | BLE_GAP_EXT_ADV_EVT_PROP_CONNECTABLE_ADV | BLE_GAP_EXT_ADV_EVT_PROP_SCANNABLE_ADV) /* Advertising Event Properties, legacy ADV_IND */
 #define CONFIG_BLE_GAP_ADV_CHANNEL_MAP               BLE_GAP_ADV_CHANNEL_ALL /* Advertising Channel Map */
 #define CONFIG_BLE_GAP_ADV_FILT_POLICY               BLE_GAP_ADV_FILTER_DEFAULT /* Advertising Filter Policy */
 
 
 #define CONFIG_BLE_GAP_CONN_TX_PWR               14 /* Connection TX Power */
+#define CONFIG_APP_MAX_CONN_NBR                  4 /* Maximum number of simultaneous connections */
+#define CONFIG_APP_GROUP_ID                      0x0000 /* Group of the setpoint listener, 0 disables the listener */
+#define CONFIG_APP_GROUP_CHANNEL                 0 /* Channel of this servo within the group */
+#define CONFIG_APP_SERVO_RESUME                  0 /* Come up at the last setpoint of the sessions instead of stopped */
+#define CONFIG_APP_AUTH_REQUIRED                 0 /* Accept the servo commands only in authenticated frames */
+#ifndef CONFIG_APP_AUTH_PSK
+/* The plant key is given by the build, -DCONFIG_APP_AUTH_PSK={...}, and kept out of the sources */
+#define CONFIG_APP_AUTH_PSK                      {0x5A, 0x3C, 0x96, 0x0F, 0xE1, 0x27, 0x4B, 0xD8, 0x72, 0x19, 0xA6, 0xC3, 0x8E, 0x54, 0x0D, 0xB1} /* Placeholder pre-shared key of the authenticated frames */
+#define CONFIG_APP_AUTH_PSK_PLACEHOLDER          1 /* No session is started with the placeholder key */
+#endif
+#define CONFIG_APP_ADV_ENC_ENABLE                0 /* Send the status record as Encrypted Advertising Data */
+#ifndef CONFIG_APP_ADV_ENC_KEY
+/* The session key is given by the build, -DCONFIG_APP_ADV_ENC_KEY={...}, and kept out of the sources */
+#define CONFIG_APP_ADV_ENC_KEY                   {0x19, 0x6B, 0xD2, 0x45, 0x8A, 0x3F, 0xE0, 0x71, 0x0C, 0xB7, 0x54, 0x2E, 0x93, 0xF8, 0x66, 0xA1} /* Placeholder session key of the Encrypted Data Key Material */
+#define CONFIG_APP_ADV_ENC_KEY_PLACEHOLDER       1 /* The status is not encrypted with the placeholder key */
+#endif
+#ifndef CONFIG_APP_ADV_ENC_IV
+#define CONFIG_APP_ADV_ENC_IV                    {0xC4, 0x2D, 0x70, 0x9B, 0x13, 0xE6, 0x5F, 0x88} /* Placeholder IV of the Encrypted Data Key Material, given by the build with the key */
+#endif
 
 // Configure SMP parameters
 #define CONFIG_BLE_SMP_IOCAP_TYPE   BLE_SMP_IO_NOINPUTNOOUTPUT  /* IO Capability */
@@ -159,6 +179,10 @@ extern "C" {
 #define CONFIG_BLE_SVC_TRS_UUID_MCHP_TRANS_RX_16                   0xB3,0x9B,0x72,0x34,0xBE,0xEC,0xD4,0xA8,0xF4,0x43,0x41,0x88,0x43,0x53,0x53,0x49    /* RX Characteristic UUID */
 #define CONFIG_BLE_SVC_TRS_UUID_MCHP_TRANS_CTRL_16                 0x7E,0x3B,0x07,0xFF,0x1C,0x51,0x49,0x2F,0xB3,0x39,0x8A,0x4C,0x43,0x53,0x53,0x49    /* CP Characteristic UUID */
 
+// Configuration of Service LSS
+#define CONFIG_BLE_SVC_LSS_UUID_SERVICE_16                         0x1B,0x5C,0x8E,0x30,0x6A,0x41,0x4F,0x2D,0x9C,0x57,0xE2,0x10,0x4C,0x53,0x53,0x49    /* Link Status Service UUID */
+#define CONFIG_BLE_SVC_LSS_UUID_STATUS_16                          0x1B,0x5C,0x8E,0x30,0x6A,0x41,0x4F,0x2D,0x9C,0x57,0xE2,0x11,0x4C,0x53,0x53,0x49    /* Link Status Characteristic UUID */
+
 
 
 //DOM-IGNORE-BEGIN
@@ -38,9 +38,9 @@
 // DOM-IGNORE-END
 
 
-#define PDS_APP_MAX_ITEMS_AMOUNT        0
+#define PDS_APP_MAX_ITEMS_AMOUNT        1
 #define PDS_APP_MAX_DIR_MEM_ID_AMOUNT   0
-#define PDS_BLE_MAX_ITEMS_AMOUNT        16
+#define PDS_BLE_MAX_ITEMS_AMOUNT        20
 
 
 #define MAX_PDS_ITEMS_COUNT         (PDS_APP_MAX_ITEMS_AMOUNT) + (PDS_BLE_MAX_ITEMS_AMOUNT)
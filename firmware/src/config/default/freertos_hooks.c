@@ -39,6 +39,7 @@
 #include "FreeRTOS.h"
 #include "task.h"
 #include "definitions.h"
+#include "app_rec/app_rec.h"
 
 void vApplicationIdleHook( void );
 void vApplicationTickHook( void );
@@ -115,6 +116,7 @@ void vApplicationMallocFailedHook( void )
       to query the size of free heap space that remains (although it does not
       provide information on how the remaining heap might be fragmented). */
 
+   APP_REC_Record(APP_REC_TYPE_HEAP_FAIL, 0, xPortGetFreeHeapSize());
    taskDISABLE_INTERRUPTS();
    for( ;; )
    {
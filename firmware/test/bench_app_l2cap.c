@@ -0,0 +1,310 @@
+/*******************************************************************************
+  L2CAP Bridge Benchmark Source File
+
+  File Name:
+    bench_app_l2cap.c
+
+  Summary:
+    Runs the L2CAP credit-based bridge on simulated links into a 115200 baud
+    UART.
+
+  Description:
+    Each central sends single-frame 245-byte SDUs on a 7.5ms connection, at
+    most six per connection event and one per credit. Credits returned by the
+    bridge are sent in the next connection event and used from the event after
+    it. The UART takes bytes into its 128-byte ring buffer, which empties at
+    11.52 bytes/ms, and the drain timer of the bridge polls it every 10ms. The
+    bridge must keep the UART busy without dropping an SDU, and refuse a
+    channel whose initial credits the receive FIFO cannot take.
+ *******************************************************************************/
+
+#include <string.h>
+#include "osal/osal_freertos.h"
+#include "ble_util/mw_conn.h"
+#include "app_timer/app_timer.h"
+#include "app_l2cap.h"
+#include "fake_rtos.h"
+#include "unit_test.h"
+
+#define BENCH_LINK_MAX              (CONFIG_APP_MAX_CONN_NBR)
+#define BENCH_EVENT_US              (7500U)
+#define BENCH_FRAMES_PER_EVENT      (6U)
+#define BENCH_SDU_LEN               (APP_L2CAP_MPS - 2U)
+#define BENCH_STEP_US               (250U)
+#define BENCH_DURATION_US           (10000000U)
+#define BENCH_UART_RING_SIZE        (128U)
+#define BENCH_UART_MBYTES_PER_STEP  (2880U)     // 115200 baud, 10 bits per byte, in thousandths of a byte
+
+typedef struct BENCH_Peer_T
+{
+    uint16_t    credits;
+    uint16_t    creditQueued;
+    uint16_t    creditInFlight;
+} BENCH_Peer_T;
+
+static BENCH_Peer_T s_peer[BENCH_LINK_MAX];
+static uint32_t     s_uartRing;
+static uint32_t     s_uartMBytes;
+static uint32_t     s_uartByteCnt;
+static bool         s_isUartStalled;
+static bool         s_isDrainArmed;
+static uint64_t     s_drainDueUs;
+static uint32_t     s_addCreditsCnt;
+static uint8_t      s_discId;
+static uint32_t     s_discCnt;
+
+uint8_t MW_CONN_GetIndex(uint16_t connHandle)
+{
+    return ((connHandle >= 1U) && (connHandle <= MW_CONN_MAX_NBR)) ? (uint8_t)(connHandle - 1U) : 0xFFU;
+}
+
+uint16_t APP_TIMER_SetTimer(uint8_t timerId, uint32_t timeout, bool isPeriodicTimer)
+{
+    (void)isPeriodicTimer;
+
+    if (timerId == APP_TIMER_L2CAP_DRAIN)
+    {
+        s_isDrainArmed = true;
+        s_drainDueUs = FAKE_RTOS_GetTimeUs() + (timeout * 1000U);
+    }
+
+    return APP_RES_SUCCESS;
+}
+
+uint16_t BLE_L2CAP_CbRegisterSpsm(uint16_t spsm, uint16_t mtu, uint16_t mps, uint16_t initCredits, uint8_t permission)
+{
+    (void)spsm;
+    (void)mtu;
+    (void)mps;
+    (void)initCredits;
+    (void)permission;
+
+    return MBA_RES_SUCCESS;
+}
+
+uint16_t BLE_L2CAP_CbAddCredits(uint8_t leL2capId, uint16_t credits)
+{
+    s_peer[leL2capId].creditQueued += credits;
+    s_addCreditsCnt++;
+
+    return MBA_RES_SUCCESS;
+}
+
+uint16_t BLE_L2CAP_CbDiscReq(uint8_t leL2capId)
+{
+    s_discId = leL2capId;
+    s_discCnt++;
+
+    return MBA_RES_SUCCESS;
+}
+
+uint16_t BLE_L2CAP_CbSendSdu(uint8_t leL2capId, uint16_t length, uint8_t *p_payload)
+{
+    (void)leL2capId;
+    (void)length;
+    (void)p_payload;
+
+    return MBA_RES_SUCCESS;
+}
+
+size_t SERCOM0_USART_Write(uint8_t *pWrBuffer, const size_t size)
+{
+    size_t written;
+
+    (void)pWrBuffer;
+
+    written = BENCH_UART_RING_SIZE - s_uartRing;
+    if (written > size)
+    {
+        written = size;
+    }
+    s_uartRing += written;
+
+    return written;
+}
+
+static void bench_UartStep(void)
+{
+    if (s_isUartStalled)
+    {
+        return;
+    }
+
+    s_uartMBytes += BENCH_UART_MBYTES_PER_STEP;
+    while ((s_uartMBytes >= 1000U) && (s_uartRing > 0U))
+    {
+        s_uartMBytes -= 1000U;
+        s_uartRing--;
+        s_uartByteCnt++;
+    }
+    if (s_uartRing == 0U)
+    {
+        s_uartMBytes = 0U;
+    }
+}
+
+static void bench_Reset(void)
+{
+    memset(s_peer, 0, sizeof(s_peer));
+    s_uartRing = 0U;
+    s_uartMBytes = 0U;
+    s_uartByteCnt = 0U;
+    s_isUartStalled = false;
+    s_isDrainArmed = false;
+    s_addCreditsCnt = 0U;
+    s_discCnt = 0U;
+    FAKE_RTOS_Reset();
+    TEST_ASSERT_EQUAL(APP_RES_SUCCESS, APP_L2CAP_Init());
+}
+
+static void bench_Open(uint8_t link)
+{
+    BLE_L2CAP_Event_T evt;
+
+    memset(&evt, 0, sizeof(evt));
+    evt.eventId = BLE_L2CAP_EVT_CB_CONN_IND;
+    evt.eventField.evtCbConnInd.leL2capId = link;
+    evt.eventField.evtCbConnInd.connHandle = (uint16_t)(link + 1U);
+    evt.eventField.evtCbConnInd.spsm = APP_L2CAP_SPSM;
+    evt.eventField.evtCbConnInd.remoteMtu = APP_L2CAP_MTU;
+    evt.eventField.evtCbConnInd.remoteMps = APP_L2CAP_MPS;
+    evt.eventField.evtCbConnInd.initialCredits = APP_L2CAP_INIT_CREDITS;
+    APP_L2CAP_EvtHandler(&evt);
+
+    s_peer[link].credits = APP_L2CAP_INIT_CREDITS;
+}
+
+static void bench_SendSdu(uint8_t link)
+{
+    static BLE_L2CAP_Event_T evt;
+
+    evt.eventId = BLE_L2CAP_EVT_CB_SDU_IND;
+    evt.eventField.evtCbSduInd.leL2capId = link;
+    evt.eventField.evtCbSduInd.length = BENCH_SDU_LEN;
+    evt.eventField.evtCbSduInd.frames = 1U;
+    APP_L2CAP_EvtHandler(&evt);
+}
+
+// Runs the links for a while, returns the connection events limited by the credits of the central
+static uint32_t bench_Run(uint8_t linkNum, uint32_t durationUs)
+{
+    uint32_t limitedEvents = 0U;
+    uint32_t t;
+    uint8_t link;
+    uint8_t i;
+
+    for (t = 0U; t < durationUs; t += BENCH_STEP_US)
+    {
+        if ((t % BENCH_EVENT_US) == 0U)
+        {
+            for (link = 0U; link < linkNum; link++)
+            {
+                BENCH_Peer_T *p_peer = &s_peer[link];
+
+                p_peer->credits += p_peer->creditInFlight;
+                p_peer->creditInFlight = p_peer->creditQueued;
+                p_peer->creditQueued = 0U;
+                if (p_peer->credits < BENCH_FRAMES_PER_EVENT)
+                {
+                    limitedEvents++;
+                }
+                for (i = 0U; (i < BENCH_FRAMES_PER_EVENT) && (p_peer->credits > 0U); i++)
+                {
+                    p_peer->credits--;
+                    bench_SendSdu(link);
+                }
+            }
+        }
+
+        if ((s_isDrainArmed) && (FAKE_RTOS_GetTimeUs() >= s_drainDueUs))
+        {
+            s_isDrainArmed = false;
+            APP_L2CAP_Drain();
+        }
+
+        bench_UartStep();
+        FAKE_RTOS_AdvanceUs(BENCH_STEP_US);
+    }
+
+    return limitedEvents;
+}
+
+static uint32_t bench_GetDrops(uint8_t linkNum)
+{
+    APP_L2CAP_Stats_T stats;
+    uint32_t drops = 0U;
+    uint8_t link;
+
+    for (link = 0U; link < linkNum; link++)
+    {
+        TEST_ASSERT_EQUAL(APP_RES_SUCCESS, APP_L2CAP_GetStats((uint16_t)(link + 1U), &stats));
+        drops += stats.rxDropCnt;
+    }
+
+    return drops;
+}
+
+static void bench_Throughput(void)
+{
+    uint8_t linkNum;
+    uint8_t link;
+    uint32_t limitedEvents;
+    uint32_t drops;
+    double uartRate;
+
+    for (linkNum = 1U; linkNum <= BENCH_LINK_MAX; linkNum++)
+    {
+        bench_Reset();
+        for (link = 0U; link < linkNum; link++)
+        {
+            bench_Open(link);
+        }
+        TEST_ASSERT_EQUAL(0, s_discCnt);
+
+        limitedEvents = bench_Run(linkNum, BENCH_DURATION_US);
+        drops = bench_GetDrops(linkNum);
+        uartRate = s_uartByteCnt * 1e6 / BENCH_DURATION_US;
+
+        printf("  %u link(s): UART %7.0f B/s (%5.1f%% of 115200 baud), %u SDUs dropped, "
+            "%5u credit PDUs, %5u credit-limited events\n", linkNum, uartRate, uartRate * 100.0 / 11520.0,
+            (unsigned)drops, (unsigned)s_addCreditsCnt, (unsigned)limitedEvents);
+
+        // A slow UART throttles the centrals, it does not drop data
+        TEST_ASSERT_EQUAL(0, drops);
+        TEST_ASSERT(uartRate > (11520.0 * 0.9));
+    }
+}
+
+static void bench_RefuseWithoutRoom(void)
+{
+    bench_Reset();
+    bench_Open(0U);
+
+    // The UART stops, the first channel fills the FIFO with the credits it is given
+    s_isUartStalled = true;
+    (void)bench_Run(1U, 200000U);
+    TEST_ASSERT_EQUAL(0, s_discCnt);
+
+    bench_Open(1U);
+    TEST_ASSERT_EQUAL(1, s_discCnt);
+    TEST_ASSERT_EQUAL(1, s_discId);
+
+    // Nothing was dropped on the channel that was open
+    (void)bench_Run(1U, 200000U);
+    TEST_ASSERT_EQUAL(0, bench_GetDrops(1U));
+
+    // Once the central pauses and the UART takes the data, a new channel is accepted again
+    s_isUartStalled = false;
+    (void)bench_Run(0U, 1000000U);
+    s_discCnt = 0U;
+    bench_Open(1U);
+    TEST_ASSERT_EQUAL(0, s_discCnt);
+}
+
+int main(void)
+{
+    TEST_RUN(bench_Throughput);
+    TEST_RUN(bench_RefuseWithoutRoom);
+
+    return TEST_RESULT();
+}
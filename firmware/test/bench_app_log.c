@@ -0,0 +1,187 @@
+/*******************************************************************************
+  Application Log Bandwidth Benchmark Source File
+
+  File Name:
+    bench_app_log.c
+
+  Summary:
+    Compares the UART bytes of the log records with the strings they replaced.
+
+  Description:
+    The messages of a session are logged through app_log.c and drained into a
+    UART which counts the bytes of the frames. Each message is also printed
+    as the string the firmware would send for it: the string it sent before
+    the log records where there was one, else the text the decoder rebuilds,
+    with its line end. The bytes and the time at 115200 baud are reported per
+    message. The records must take fewer bytes than the strings overall, and
+    than the text of each message with numeric arguments. A command echo
+    carries the command as it is and grows by the 3 bytes of the frame.
+ *******************************************************************************/
+
+#include <string.h>
+#include "definitions.h"
+#include "app_log/app_log.h"
+#include "fake_rtos.h"
+#include "unit_test.h"
+
+#define BENCH_ARG_MAX               (4U)
+#define BENCH_TEXT_MAX              (128U)
+#define BENCH_UART_BYTES_PER_S      (11520U)    // 115200 baud, 10 bits per byte
+
+typedef struct BENCH_Load_T
+{
+    APP_LOG_Id_T    id;
+    uint32_t        num;                    // Times logged in the session.
+    uint8_t         argNum;
+    uint32_t        arg[BENCH_ARG_MAX];
+    const char      *p_cmd;                 // Text of a command echo.
+    const char      *p_old;                 // String sent before the log records, NULL if none.
+} BENCH_Load_T;
+
+#define BENCH_NAME_(id, text)       #id,
+#define BENCH_FORMAT_(id, text)     text,
+
+static const char *const s_name[] =
+{
+    APP_LOG_TABLE(BENCH_NAME_)
+};
+
+static const char *const s_format[] =
+{
+    APP_LOG_TABLE(BENCH_FORMAT_)
+};
+
+// A session: 20 connections, a servo command every second for 200 s, a latency report every 20 s
+static const BENCH_Load_T s_load[] =
+{
+    {APP_LOG_ID_BOOT,           1U,   0U, {0U},                    NULL,         "WBZ653 SERVO MOTOR\r\n"},
+    {APP_LOG_ID_ADVERTISING,    20U,  0U, {0U},                    NULL,         "Advertising\r\n"},
+    {APP_LOG_ID_CONNECTED,      20U,  1U, {0x41U},                 NULL,         "Connected\r\n"},
+    {APP_LOG_ID_DISCONNECTED,   20U,  2U, {0x41U, 0x13U},          NULL,         "Disconnected\r\n"},
+    {APP_LOG_ID_BLE_CMD,        200U, 0U, {0U},                    "servo 1500", "servo 1500\r\n"},
+    {APP_LOG_ID_LATENCY,        90U,  4U, {3U, 412U, 1870U, 2315U}, NULL,        NULL},
+    {APP_LOG_ID_LANE,           30U,  2U, {0U, 2U},                NULL,         NULL},
+    {APP_LOG_ID_SETPOINTS,      10U,  2U, {1520U, 37U},            NULL,         NULL},
+};
+
+static uint32_t         s_uartByteCnt;
+
+size_t SERCOM0_USART_WriteFreeBufferCountGet(void)
+{
+    return 1024U;
+}
+
+size_t SERCOM0_USART_Write(uint8_t *pWrBuffer, const size_t size)
+{
+    (void)pWrBuffer;
+    s_uartByteCnt += size;
+
+    return size;
+}
+
+// Length of the text of a record with its line end, as tools/app_log_decode.py rebuilds it
+static uint32_t bench_TextLen(const BENCH_Load_T *p_load)
+{
+    char text[BENCH_TEXT_MAX];
+    const char *p_fmt = s_format[p_load->id];
+    uint32_t len = 0;
+    uint8_t argIdx = 0;
+
+    while (*p_fmt != '\0')
+    {
+        if ((p_fmt[0] == '%') && (p_fmt[1] != '\0'))
+        {
+            switch (p_fmt[1])
+            {
+                case 'u':
+                    len += (uint32_t)snprintf(text, sizeof(text), "%u", (unsigned int)p_load->arg[argIdx++]);
+                    break;
+                case 'd':
+                    len += (uint32_t)snprintf(text, sizeof(text), "%d", (int)p_load->arg[argIdx++]);
+                    break;
+                case 'x':
+                    len += (uint32_t)snprintf(text, sizeof(text), "%x", (unsigned int)p_load->arg[argIdx++]);
+                    break;
+                case 's':
+                    len += (uint32_t)strlen(p_load->p_cmd);
+                    break;
+                default:
+                    len++;
+                    break;
+            }
+            p_fmt += 2;
+        }
+        else
+        {
+            len++;
+            p_fmt++;
+        }
+    }
+
+    return len + 2U;
+}
+
+static void bench_Session(void)
+{
+    APP_LOG_Stats_T stats;
+    const BENCH_Load_T *p_load;
+    uint32_t frameLen, oldLen;
+    uint32_t frameTotal = 0;
+    uint32_t oldTotal = 0;
+    uint32_t i, n;
+
+    FAKE_RTOS_Reset();
+    APP_LOG_Init();
+
+    printf("  %-24s %5s %9s %9s %9s\n", "message", "count", "string B", "record B", "saved");
+    for (i = 0; i < (sizeof(s_load) / sizeof(s_load[0])); i++)
+    {
+        p_load = &s_load[i];
+
+        // Drained after each message, as the idle task does between them
+        s_uartByteCnt = 0;
+        for (n = 0; n < p_load->num; n++)
+        {
+            if (p_load->p_cmd != NULL)
+            {
+                APP_LOG_Write(p_load->id, (uint16_t)strlen(p_load->p_cmd), p_load->p_cmd);
+            }
+            else
+            {
+                APP_LOG_Write(p_load->id, (uint16_t)(p_load->argNum * 4U), p_load->arg);
+            }
+            APP_LOG_Drain();
+        }
+        frameLen = s_uartByteCnt / p_load->num;
+        oldLen = (p_load->p_old != NULL) ? (uint32_t)strlen(p_load->p_old) : bench_TextLen(p_load);
+
+        printf("  %-24s %5u %9u %9u %8.0f%%\n", s_name[p_load->id], (unsigned int)p_load->num,
+            (unsigned int)(oldLen * p_load->num), (unsigned int)s_uartByteCnt,
+            100.0 * (1.0 - ((double)frameLen / (double)oldLen)));
+
+        // A number takes 4 bytes in a record and its digits in a string
+        if (p_load->argNum > 0U)
+        {
+            TEST_ASSERT(frameLen < bench_TextLen(p_load));
+        }
+        frameTotal += s_uartByteCnt;
+        oldTotal += oldLen * p_load->num;
+    }
+
+    printf("  %-24s %5s %9u %9u %8.0f%%\n", "total", "", (unsigned int)oldTotal, (unsigned int)frameTotal,
+        100.0 * (1.0 - ((double)frameTotal / (double)oldTotal)));
+    printf("  UART time at 115200 baud: strings %.1f ms, records %.1f ms\n",
+        (1000.0 * oldTotal) / BENCH_UART_BYTES_PER_S, (1000.0 * frameTotal) / BENCH_UART_BYTES_PER_S);
+
+    APP_LOG_GetStats(&stats);
+    TEST_ASSERT_EQUAL(frameTotal, stats.byteCnt);
+    TEST_ASSERT_EQUAL(0, stats.dropCnt);
+    TEST_ASSERT(frameTotal < oldTotal);
+}
+
+int main(void)
+{
+    TEST_RUN(bench_Session);
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,339 @@
+/*******************************************************************************
+  Application Queue Residency Benchmark Source File
+
+  File Name:
+    bench_app_queue.c
+
+  Summary:
+    Measures the time messages wait in each lane of the application queue.
+
+  Description:
+    The application task runs its passes as APP_Tasks() does, on a load of
+    UART bridge bursts, stack event bursts and servo setpoints. Each message
+    keeps the task busy for a fixed time. The residency of each lane is
+    reported as p50, p99 and max, and compared with the single FIFO the
+    lanes replaced, run on the same load. A setpoint must never wait longer
+    than the message being handled when it arrives, and no pass may take
+    more than APP_QUEUE_BULK_BUDGET bulk messages.
+ *******************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include "app.h"
+#include "app_error_defs.h"
+#include "app_rec/app_rec.h"
+#include "app_lat/app_lat.h"
+#include "app_queue/app_queue.h"
+#include "fake_rtos.h"
+#include "unit_test.h"
+
+#define BENCH_DURATION_US           (2000000U)
+#define BENCH_SAMPLE_MAX            (4096U)
+#define BENCH_FIFO_SIZE             (APP_QUEUE_URGENT_SIZE + APP_QUEUE_NORMAL_SIZE + APP_QUEUE_BULK_SIZE)
+
+// UART bridge: a burst of chunks every 20 ms, 1 ms to hand each one to the UART
+#define BENCH_BULK_PERIOD_US        (20000U)
+#define BENCH_BULK_BURST            (8U)
+#define BENCH_BULK_COST_US          (1000U)
+// Stack events: one every 2 ms and a burst of 30 every 100 ms
+#define BENCH_NORMAL_PERIOD_US      (2000U)
+#define BENCH_NORMAL_BURST_PERIOD_US (100000U)
+#define BENCH_NORMAL_BURST          (30U)
+#define BENCH_NORMAL_COST_US        (150U)
+// Servo setpoints
+#define BENCH_URGENT_PERIOD_US      (37000U)
+#define BENCH_URGENT_COST_US        (60U)
+
+typedef struct BENCH_Source_T
+{
+    uint8_t     msgId;
+    uint32_t    periodUs;
+    uint32_t    burst;
+    uint64_t    nextUs;
+} BENCH_Source_T;
+
+typedef struct BENCH_Lane_T
+{
+    uint32_t    us[BENCH_SAMPLE_MAX];
+    uint32_t    num;
+} BENCH_Lane_T;
+
+static BENCH_Source_T   s_source[] =
+{
+    {APP_MSG_UART_CB, BENCH_BULK_PERIOD_US, BENCH_BULK_BURST, 0U},
+    {APP_MSG_BLE_STACK_EVT, BENCH_NORMAL_PERIOD_US, 1U, 0U},
+    {APP_MSG_BLE_STACK_EVT, BENCH_NORMAL_BURST_PERIOD_US, BENCH_NORMAL_BURST, 0U},
+    {APP_MSG_SERVO_SETPOINT, BENCH_URGENT_PERIOD_US, 1U, 0U},
+};
+
+static bool             s_isFifo;           // Run on the single FIFO instead of the lanes.
+static APP_Msg_T        s_fifo[BENCH_FIFO_SIZE];
+static uint32_t         s_fifoRead;
+static uint32_t         s_fifoNum;
+static uint32_t         s_lostNum;
+static BENCH_Lane_T     s_lane[APP_QUEUE_LANE_NUM];
+
+uint32_t APP_LAT_Stamp(void)
+{
+    return DWT->CYCCNT;
+}
+
+void APP_LAT_Count(APP_LAT_Stage_T stage, uint32_t cycles)
+{
+    BENCH_Lane_T *p_lane = &s_lane[stage - APP_LAT_STAGE_LANE_URGENT];
+
+    if (p_lane->num < BENCH_SAMPLE_MAX)
+    {
+        p_lane->us[p_lane->num++] = FAKE_RTOS_CyclesToUs(cycles);
+    }
+}
+
+void APP_REC_Record(APP_REC_Type_T type, uint16_t arg16, uint32_t arg32)
+{
+    (void)arg16;
+    (void)arg32;
+
+    if (type == APP_REC_TYPE_QUEUE_FULL)
+    {
+        s_lostNum++;
+    }
+}
+
+static APP_QUEUE_Lane_T bench_GetLane(uint8_t msgId)
+{
+    if (msgId == APP_MSG_SERVO_SETPOINT)
+    {
+        return APP_QUEUE_LANE_URGENT;
+    }
+
+    return (msgId == APP_MSG_UART_CB) ? APP_QUEUE_LANE_BULK : APP_QUEUE_LANE_NORMAL;
+}
+
+static uint32_t bench_GetCost(uint8_t msgId)
+{
+    switch (bench_GetLane(msgId))
+    {
+        case APP_QUEUE_LANE_URGENT:
+            return BENCH_URGENT_COST_US;
+
+        case APP_QUEUE_LANE_NORMAL:
+            return BENCH_NORMAL_COST_US;
+
+        default:
+            return BENCH_BULK_COST_US;
+    }
+}
+
+static void bench_Send(uint8_t msgId)
+{
+    APP_Msg_T msg;
+
+    (void)memset(&msg, 0, sizeof(msg));
+    msg.msgId = msgId;
+    if (!s_isFifo)
+    {
+        (void)APP_QUEUE_Send(&msg, 0U);
+        return;
+    }
+
+    if (s_fifoNum == BENCH_FIFO_SIZE)
+    {
+        s_lostNum++;
+        return;
+    }
+    msg.msgStamp = APP_LAT_Stamp();
+    s_fifo[(s_fifoRead + s_fifoNum) % BENCH_FIFO_SIZE] = msg;
+    s_fifoNum++;
+}
+
+static bool bench_FifoReceive(APP_Msg_T *p_msg)
+{
+    if (s_fifoNum == 0U)
+    {
+        return false;
+    }
+
+    *p_msg = s_fifo[s_fifoRead];
+    s_fifoRead = (s_fifoRead + 1U) % BENCH_FIFO_SIZE;
+    s_fifoNum--;
+    APP_LAT_Count((APP_LAT_Stage_T)(APP_LAT_STAGE_LANE_URGENT + (uint8_t)bench_GetLane(p_msg->msgId)),
+        APP_LAT_Stamp() - p_msg->msgStamp);
+
+    return true;
+}
+
+static BENCH_Source_T *bench_GetNextSource(void)
+{
+    BENCH_Source_T *p_next = &s_source[0];
+    uint8_t i;
+
+    for (i = 1U; i < (sizeof(s_source) / sizeof(s_source[0])); i++)
+    {
+        if (s_source[i].nextUs < p_next->nextUs)
+        {
+            p_next = &s_source[i];
+        }
+    }
+
+    return p_next;
+}
+
+// Lets the time pass, the messages produced meanwhile are queued at their own time
+static void bench_Advance(uint32_t us)
+{
+    uint64_t target = FAKE_RTOS_GetTimeUs() + us;
+    BENCH_Source_T *p_source = bench_GetNextSource();
+    uint32_t i;
+
+    while (p_source->nextUs <= target)
+    {
+        FAKE_RTOS_AdvanceUs((uint32_t)(p_source->nextUs - FAKE_RTOS_GetTimeUs()));
+        for (i = 0U; i < p_source->burst; i++)
+        {
+            bench_Send(p_source->msgId);
+        }
+        p_source->nextUs += p_source->periodUs;
+        p_source = bench_GetNextSource();
+    }
+
+    FAKE_RTOS_AdvanceUs((uint32_t)(target - FAKE_RTOS_GetTimeUs()));
+}
+
+// Runs the load, returns the most bulk messages taken in a pass
+static uint32_t bench_Run(bool isFifo)
+{
+    APP_Msg_T msg;
+    uint32_t waitMs;
+    uint32_t bulkNum;
+    uint32_t bulkMax = 0U;
+    uint8_t i;
+
+    FAKE_RTOS_Reset();
+    APP_QUEUE_Init();
+    s_isFifo = isFifo;
+    s_fifoRead = 0U;
+    s_fifoNum = 0U;
+    s_lostNum = 0U;
+    (void)memset(s_lane, 0, sizeof(s_lane));
+    for (i = 0U; i < (sizeof(s_source) / sizeof(s_source[0])); i++)
+    {
+        // The sources start out of phase
+        s_source[i].nextUs = 1000U + (i * 3100U);
+    }
+
+    while (FAKE_RTOS_GetTimeUs() < BENCH_DURATION_US)
+    {
+        if ((isFifo) ? (s_fifoNum == 0U) : APP_QUEUE_IsEmpty())
+        {
+            // Idle until the next message
+            bench_Advance((uint32_t)(bench_GetNextSource()->nextUs - FAKE_RTOS_GetTimeUs()));
+            continue;
+        }
+
+        // A pass of APP_Tasks(), the FIFO took one message per pass
+        bulkNum = 0U;
+        if (isFifo)
+        {
+            if (bench_FifoReceive(&msg))
+            {
+                bench_Advance(bench_GetCost(msg.msgId));
+            }
+            continue;
+        }
+
+        APP_QUEUE_StartPass();
+        waitMs = OSAL_WAIT_FOREVER;
+        while (APP_QUEUE_Receive(&msg, waitMs))
+        {
+            waitMs = 0U;
+            if (bench_GetLane(msg.msgId) == APP_QUEUE_LANE_BULK)
+            {
+                bulkNum++;
+            }
+            bench_Advance(bench_GetCost(msg.msgId));
+        }
+        if (bulkNum > bulkMax)
+        {
+            bulkMax = bulkNum;
+        }
+    }
+
+    return bulkMax;
+}
+
+static int bench_Compare(const void *p_a, const void *p_b)
+{
+    uint32_t a = *(const uint32_t *)p_a;
+    uint32_t b = *(const uint32_t *)p_b;
+
+    return (a > b) - (a < b);
+}
+
+static uint32_t bench_Percentile(BENCH_Lane_T *p_lane, uint32_t percent)
+{
+    uint32_t rank;
+
+    if (p_lane->num == 0U)
+    {
+        return 0U;
+    }
+
+    rank = ((p_lane->num * percent) + 99U) / 100U;
+
+    return p_lane->us[(rank == 0U) ? 0U : (rank - 1U)];
+}
+
+// Prints the lanes, returns the longest wait of a setpoint
+static uint32_t bench_Report(const char *p_name)
+{
+    static const char *const s_laneName[APP_QUEUE_LANE_NUM] = {"urgent", "normal", "bulk"};
+    BENCH_Lane_T *p_lane;
+    uint8_t lane;
+
+    for (lane = 0U; lane < APP_QUEUE_LANE_NUM; lane++)
+    {
+        p_lane = &s_lane[lane];
+        qsort(p_lane->us, p_lane->num, sizeof(p_lane->us[0]), bench_Compare);
+        printf("  %-6s %-7s %5u msgs  p50 %6u us  p99 %6u us  max %6u us\n", p_name, s_laneName[lane],
+            (unsigned)p_lane->num, (unsigned)bench_Percentile(p_lane, 50U), (unsigned)bench_Percentile(p_lane, 99U),
+            (unsigned)bench_Percentile(p_lane, 100U));
+    }
+
+    return bench_Percentile(&s_lane[APP_QUEUE_LANE_URGENT], 100U);
+}
+
+static void bench_Residency(void)
+{
+    APP_QUEUE_Stats_T stats;
+    uint32_t fifoUrgentMax;
+    uint32_t urgentMax;
+    uint32_t bulkMax;
+
+    (void)bench_Run(true);
+    fifoUrgentMax = bench_Report("fifo");
+    TEST_ASSERT_EQUAL(0, s_lostNum);
+
+    bulkMax = bench_Run(false);
+    urgentMax = bench_Report("lanes");
+    APP_QUEUE_GetStats(APP_QUEUE_LANE_BULK, &stats);
+    printf("  lanes: at most %u bulk messages in a pass, %u passes ended on the bulk budget\n", (unsigned)bulkMax,
+        (unsigned)stats.budgetCnt);
+
+    // Nothing lost, a setpoint waits at most for the message being handled when it arrives
+    TEST_ASSERT_EQUAL(0, s_lostNum);
+    TEST_ASSERT(s_lane[APP_QUEUE_LANE_URGENT].num > 0U);
+    TEST_ASSERT(urgentMax <= BENCH_BULK_COST_US);
+    TEST_ASSERT(urgentMax < fifoUrgentMax);
+
+    // The bulk lane is served in every pass, never more than its budget
+    TEST_ASSERT(bulkMax <= APP_QUEUE_BULK_BUDGET);
+    TEST_ASSERT(stats.budgetCnt > 0U);
+    TEST_ASSERT_EQUAL(s_lane[APP_QUEUE_LANE_BULK].num, stats.recvCnt);
+}
+
+int main(void)
+{
+    TEST_RUN(bench_Residency);
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,363 @@
+/*******************************************************************************
+  Device Data Storage Resolution Benchmark Source File
+
+  File Name:
+    bench_ble_dm_dds.c
+
+  Summary:
+    Measures the cost of resolving a peer address and of maintaining the
+    bond store against the number of bonds.
+
+  Description:
+    Bonds are stored with random IRKs and identity addresses, then peers
+    connect with fresh resolvable private addresses, with addresses seen just
+    before, with addresses no bond resolves and with identity addresses. The
+    cost is counted in AES blocks, one per IRK tried: the AES middleware is a
+    stub on top of the reference AES.
+
+    The bond store is then timed on the host for lookups, pairings and
+    deletions, with the PDS writes each takes, and the recency order of the
+    bonds is checked to survive a reset: the filter accept list and the
+    eviction both rely on it.
+ *******************************************************************************/
+
+#include <string.h>
+#include <stdlib.h>
+#include <time.h>
+#include "ble_dm/ble_dm.h"
+#include "ble_dm/ble_dm_dds.h"
+#include "fake_rtos.h"
+#include "fake_pds.h"
+#include "fake_mw_aes.h"
+#include "ref_aes.h"
+#include "unit_test.h"
+
+extern const ItemIdToMemoryMapping_t pds_ff_PDS_BLE_ITEM_BOND_ID_1;
+extern const ItemIdToMemoryMapping_t pds_ff_PDS_BLE_ITEM_BOND_ID_2;
+extern const ItemIdToMemoryMapping_t pds_ff_PDS_BLE_ITEM_BOND_ID_3;
+extern const ItemIdToMemoryMapping_t pds_ff_PDS_BLE_ITEM_BOND_ID_4;
+
+static const BLE_GAP_Addr_T s_localAddr = {BLE_GAP_ADDR_TYPE_PUBLIC, {0x11, 0x22, 0x33, 0x44, 0x55, 0x66}};
+static BLE_DM_PairedDevInfo_T s_bond[BLE_DM_MAX_PAIRED_DEVICE_NUM];
+
+uint16_t BLE_GAP_GetDeviceAddr(BLE_GAP_Addr_T *p_addr)
+{
+    *p_addr = s_localAddr;
+
+    return MBA_RES_SUCCESS;
+}
+
+static void bench_Random(uint8_t *p_buf, uint8_t len)
+{
+    uint8_t i;
+
+    for (i = 0; i < len; i++)
+    {
+        p_buf[i] = (uint8_t)rand();
+    }
+}
+
+// Builds a resolvable private address from an IRK, as the peer would: hash = ah(IRK, prand)
+static void bench_MakeRpa(const uint8_t *p_irk, BLE_GAP_Addr_T *p_addr)
+{
+    uint8_t key[16];
+    uint8_t block[16];
+    uint8_t i;
+
+    for (i = 0; i < 16U; i++)
+    {
+        key[i] = p_irk[15U - i];
+    }
+
+    p_addr->addrType = BLE_GAP_ADDR_TYPE_RANDOM_RESOLVABLE;
+    bench_Random(&p_addr->addr[3], 3U);
+    p_addr->addr[5] = (uint8_t)((p_addr->addr[5] & 0x3FU) | 0x40U);
+
+    memset(block, 0, sizeof(block));
+    block[13] = p_addr->addr[5];
+    block[14] = p_addr->addr[4];
+    block[15] = p_addr->addr[3];
+    REF_AES_Encrypt(key, block, block);
+
+    p_addr->addr[0] = block[15];
+    p_addr->addr[1] = block[14];
+    p_addr->addr[2] = block[13];
+}
+
+static void bench_Bond(uint8_t bondNum)
+{
+    uint8_t devId;
+
+    TEST_ASSERT_EQUAL(MBA_RES_SUCCESS, BLE_DM_DdsDeleteAllPairedDevice());
+
+    for (devId = 0; devId < bondNum; devId++)
+    {
+        BLE_DM_PairedDevInfo_T *p_bond = &s_bond[devId];
+
+        memset(p_bond, 0, sizeof(BLE_DM_PairedDevInfo_T));
+        p_bond->remoteAddr.addrType = BLE_GAP_ADDR_TYPE_RANDOM_STATIC;
+        bench_Random(p_bond->remoteAddr.addr, GAP_MAX_BD_ADDRESS_LEN);
+        p_bond->remoteAddr.addr[5] |= 0xC0U;
+        bench_Random(p_bond->remoteIrk, 16U);
+        p_bond->localAddr = s_localAddr;
+        bench_Random(p_bond->ltk, 16U);
+        p_bond->lesc = 1;
+        p_bond->encryptKeySize = 16;
+        TEST_ASSERT_EQUAL(MBA_RES_SUCCESS, BLE_DM_DdsSetPairedDevice(devId, p_bond));
+    }
+
+    FAKE_PDS_Flush();
+}
+
+// Resolves an address, returns the AES blocks it took
+static uint32_t bench_Resolve(BLE_GAP_Addr_T *p_addr, uint8_t expectedDevId)
+{
+    FAKE_MW_AES_Reset();
+    TEST_ASSERT_EQUAL(expectedDevId, BLE_DM_DdsGetDeviceId(p_addr));
+
+    return FAKE_MW_AES_GetBlockNum();
+}
+
+static void bench_ResolutionCost(void)
+{
+    static const uint8_t bondNums[] = {1U, 2U, 4U, 8U, 16U, 32U};
+    BLE_GAP_Addr_T addr;
+    uint8_t unknownIrk[16];
+    uint32_t coldSum;
+    uint32_t coldMax;
+    uint32_t repeatMax;
+    uint32_t identityMax;
+    uint32_t unknownFirst;
+    uint32_t unknownRepeat;
+    uint32_t cost;
+    uint8_t n;
+    uint8_t devId;
+
+    printf("  bonds  RPA new avg  RPA new max  RPA repeat  RPA unknown 1st/2nd  identity  (AES blocks)\n");
+
+    for (n = 0; n < sizeof(bondNums); n++)
+    {
+        uint8_t bondNum = bondNums[n];
+
+        bench_Bond(bondNum);
+        coldSum = 0U;
+        coldMax = 0U;
+        repeatMax = 0U;
+        identityMax = 0U;
+
+        for (devId = 0; devId < bondNum; devId++)
+        {
+            bench_MakeRpa(s_bond[devId].remoteIrk, &addr);
+            cost = bench_Resolve(&addr, devId);
+            coldSum += cost;
+            coldMax = (cost > coldMax) ? cost : coldMax;
+
+            // The phone reconnects with the same address
+            cost = bench_Resolve(&addr, devId);
+            repeatMax = (cost > repeatMax) ? cost : repeatMax;
+
+            cost = bench_Resolve(&s_bond[devId].remoteAddr, devId);
+            identityMax = (cost > identityMax) ? cost : identityMax;
+        }
+
+        bench_Random(unknownIrk, 16U);
+        bench_MakeRpa(unknownIrk, &addr);
+        unknownFirst = bench_Resolve(&addr, BLE_DM_MAX_PAIRED_DEVICE_NUM);
+        unknownRepeat = bench_Resolve(&addr, BLE_DM_MAX_PAIRED_DEVICE_NUM);
+
+        printf("  %5u  %11.1f  %11u  %10u  %11u/%-7u  %8u\n", bondNum, (double)coldSum / bondNum,
+            (unsigned)coldMax, (unsigned)repeatMax, (unsigned)unknownFirst, (unsigned)unknownRepeat,
+            (unsigned)identityMax);
+
+        // A new address costs at most one AES per bond, a known one none
+        TEST_ASSERT(coldMax <= bondNum);
+        TEST_ASSERT_EQUAL(bondNum, unknownFirst);
+        TEST_ASSERT_EQUAL(0, repeatMax);
+        TEST_ASSERT_EQUAL(0, unknownRepeat);
+        TEST_ASSERT_EQUAL(0, identityMax);
+    }
+}
+
+static void bench_CacheInvalidation(void)
+{
+    BLE_GAP_Addr_T addr;
+
+    bench_Bond(4U);
+    bench_MakeRpa(s_bond[2].remoteIrk, &addr);
+    TEST_ASSERT(bench_Resolve(&addr, 2U) > 0U);
+    TEST_ASSERT_EQUAL(0, bench_Resolve(&addr, 2U));
+
+    // A deleted bond no longer resolves, even from the cache
+    TEST_ASSERT_EQUAL(MBA_RES_SUCCESS, BLE_DM_DdsDeletePairedDevice(2U));
+    TEST_ASSERT_EQUAL(3, bench_Resolve(&addr, BLE_DM_MAX_PAIRED_DEVICE_NUM));
+
+    // An unresolved address resolves once the peer bonds
+    TEST_ASSERT_EQUAL(MBA_RES_SUCCESS, BLE_DM_DdsSetPairedDevice(2U, &s_bond[2]));
+    TEST_ASSERT(bench_Resolve(&addr, 2U) > 0U);
+}
+
+static double bench_NowUs(void)
+{
+    struct timespec ts;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (ts.tv_sec * 1e6) + (ts.tv_nsec / 1e3);
+}
+
+// Resets the device: the RAM of the PDS items is lost and the bonds are loaded again from the flash
+static void bench_Reboot(void)
+{
+    FAKE_PDS_Flush();
+    FAKE_PDS_ClearRam();
+    BLE_DM_DdsInit(NULL);
+}
+
+static void bench_StoreCost(void)
+{
+    static const uint8_t bondNums[] = {8U, 16U, 32U};
+    const uint32_t rounds = 2000U;
+    double lookupUs;
+    double pairUs;
+    double deleteUs;
+    double t0;
+    uint32_t writes;
+    uint32_t r;
+    uint8_t n;
+    uint8_t devId;
+
+    printf("  bonds  lookup us  pairing us  delete us  PDS writes per pairing  (host)\n");
+
+    for (n = 0; n < sizeof(bondNums); n++)
+    {
+        uint8_t bondNum = bondNums[n];
+
+        bench_Bond(bondNum);
+
+        t0 = bench_NowUs();
+        for (r = 0; r < rounds; r++)
+        {
+            devId = (uint8_t)(r % bondNum);
+            TEST_ASSERT_EQUAL(devId, BLE_DM_DdsGetDeviceId(&s_bond[devId].remoteAddr));
+        }
+        lookupUs = (bench_NowUs() - t0) / rounds;
+
+        pairUs = 0.0;
+        deleteUs = 0.0;
+        writes = FAKE_PDS_GetWriteNum();
+        for (r = 0; r < rounds; r++)
+        {
+            devId = (uint8_t)(r % bondNum);
+
+            t0 = bench_NowUs();
+            TEST_ASSERT_EQUAL(MBA_RES_SUCCESS, BLE_DM_DdsDeletePairedDevice(devId));
+            deleteUs += bench_NowUs() - t0;
+
+            t0 = bench_NowUs();
+            TEST_ASSERT_EQUAL(MBA_RES_SUCCESS, BLE_DM_DdsSetPairedDevice(devId, &s_bond[devId]));
+            pairUs += bench_NowUs() - t0;
+
+            // Each pairing is committed on its own, as the idle task would
+            FAKE_PDS_Flush();
+        }
+        writes = FAKE_PDS_GetWriteNum() - writes;
+
+        printf("  %5u  %9.3f  %10.3f  %9.3f  %22.1f\n", bondNum, lookupUs, pairUs / rounds, deleteUs / rounds,
+            (double)writes / rounds);
+
+        // A deletion and a pairing of the same record are coalesced in one file write
+        TEST_ASSERT_EQUAL(rounds, writes);
+    }
+}
+
+static void bench_Recency(void)
+{
+    uint8_t order[BLE_DM_MAX_PAIRED_DEVICE_NUM];
+    uint8_t recent[BLE_DM_MAX_PAIRED_DEVICE_NUM];
+    uint8_t recentNum;
+    uint32_t writes;
+    uint8_t i;
+    uint8_t j;
+    uint8_t tmp;
+
+    bench_Bond(BLE_DM_MAX_PAIRED_DEVICE_NUM);
+
+    // The peers encrypt their links in a shuffled order
+    for (i = 0; i < BLE_DM_MAX_PAIRED_DEVICE_NUM; i++)
+    {
+        order[i] = i;
+    }
+    for (i = BLE_DM_MAX_PAIRED_DEVICE_NUM - 1U; i > 0U; i--)
+    {
+        j = (uint8_t)(rand() % (i + 1U));
+        tmp = order[i];
+        order[i] = order[j];
+        order[j] = tmp;
+    }
+    for (i = 0; i < BLE_DM_MAX_PAIRED_DEVICE_NUM; i++)
+    {
+        TEST_ASSERT_EQUAL(MBA_RES_SUCCESS, BLE_DM_DdsTouchDevice(order[i]));
+    }
+    FAKE_PDS_Flush();
+
+    // The same peer reconnecting again does not write the flash
+    writes = FAKE_PDS_GetWriteNum();
+    for (i = 0; i < 100U; i++)
+    {
+        TEST_ASSERT_EQUAL(MBA_RES_SUCCESS, BLE_DM_DdsTouchDevice(order[BLE_DM_MAX_PAIRED_DEVICE_NUM - 1U]));
+        FAKE_PDS_Flush();
+    }
+    printf("  100 reconnections of the most recent peer: %u PDS writes\n",
+        (unsigned)(FAKE_PDS_GetWriteNum() - writes));
+    TEST_ASSERT_EQUAL(0, FAKE_PDS_GetWriteNum() - writes);
+
+    bench_Reboot();
+
+    // The filter accept list takes the most recent peers, in the order they used the device
+    BLE_DM_DdsGetRecentDevices(BLE_DM_MAX_FILTER_ACCEPT_LIST_NUM, recent, &recentNum);
+    TEST_ASSERT_EQUAL(BLE_DM_MAX_FILTER_ACCEPT_LIST_NUM, recentNum);
+    for (i = 0; i < recentNum; i++)
+    {
+        TEST_ASSERT_EQUAL(order[BLE_DM_MAX_PAIRED_DEVICE_NUM - 1U - i], recent[i]);
+    }
+
+    BLE_DM_DdsGetRecentDevices(BLE_DM_MAX_PAIRED_DEVICE_NUM, recent, &recentNum);
+    TEST_ASSERT_EQUAL(BLE_DM_MAX_PAIRED_DEVICE_NUM, recentNum);
+    for (i = 0; i < recentNum; i++)
+    {
+        TEST_ASSERT_EQUAL(order[BLE_DM_MAX_PAIRED_DEVICE_NUM - 1U - i], recent[i]);
+    }
+
+    // The store is full, a new pairing takes the place of the least recent peer
+    TEST_ASSERT_EQUAL(BLE_DM_MAX_PAIRED_DEVICE_NUM, BLE_DM_DdsGetFreeDeviceId());
+    TEST_ASSERT_EQUAL(order[0], BLE_DM_DdsEvictDeviceId());
+    TEST_ASSERT_EQUAL(order[1], BLE_DM_DdsEvictDeviceId());
+
+    // A new bond is the most recent one
+    TEST_ASSERT_EQUAL(MBA_RES_SUCCESS, BLE_DM_DdsSetPairedDevice(order[0], &s_bond[order[0]]));
+    bench_Reboot();
+    BLE_DM_DdsGetRecentDevices(2U, recent, &recentNum);
+    TEST_ASSERT_EQUAL(2, recentNum);
+    TEST_ASSERT_EQUAL(order[0], recent[0]);
+    TEST_ASSERT_EQUAL(order[BLE_DM_MAX_PAIRED_DEVICE_NUM - 1U], recent[1]);
+    printf("  recency order and eviction kept across a reset with %u bonds\n", BLE_DM_MAX_PAIRED_DEVICE_NUM - 1U);
+}
+
+int main(void)
+{
+    srand(1U);
+    FAKE_RTOS_Reset();
+    FAKE_PDS_Reset();
+    FAKE_PDS_Register(&pds_ff_PDS_BLE_ITEM_BOND_ID_1);
+    FAKE_PDS_Register(&pds_ff_PDS_BLE_ITEM_BOND_ID_2);
+    FAKE_PDS_Register(&pds_ff_PDS_BLE_ITEM_BOND_ID_3);
+    FAKE_PDS_Register(&pds_ff_PDS_BLE_ITEM_BOND_ID_4);
+    BLE_DM_DdsInit(NULL);
+
+    TEST_RUN(bench_ResolutionCost);
+    TEST_RUN(bench_CacheInvalidation);
+    TEST_RUN(bench_StoreCost);
+    TEST_RUN(bench_Recency);
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,243 @@
+/*******************************************************************************
+  TRSPS Credit Policy Benchmark Source File
+
+  File Name:
+    bench_ble_trsps_credit.c
+
+  Summary:
+    Compares the fixed and adaptive TRSPS credit return policies on a
+    simulated link.
+
+  Description:
+    The central writes 244-byte packets without response on a 7.5ms
+    connection, at most six per connection event and one per credit. A
+    credit notification queued by the profile is sent in the next connection
+    event, so the central can use those credits from the event after it. The
+    application reads one packet every 500us (bulk: the link is the limit) or
+    every 2ms (slow: the application is the limit).
+ *******************************************************************************/
+
+#include <string.h>
+#include "osal/osal_freertos.h"
+#include "mba_error_defs.h"
+#include "ble_gap.h"
+#include "gatt.h"
+#include "ble_trs/ble_trs.h"
+#include "ble_trsps/ble_trsps.h"
+#include "fake_rtos.h"
+#include "unit_test.h"
+
+#define BENCH_CONN_HANDLE           (0x0001U)
+#define BENCH_CONN_INTERVAL         (6U)            // 7.5ms
+#define BENCH_EVENT_US              (BENCH_CONN_INTERVAL * 1250U)
+#define BENCH_PACKETS_PER_EVENT     (6U)
+#define BENCH_PACKET_LEN            (244U)
+#define BENCH_STEP_US               (250U)
+#define BENCH_DURATION_US           (10000000U)
+#define BENCH_EVENT_NUM             (BENCH_DURATION_US / BENCH_EVENT_US)
+
+typedef struct BENCH_Result_T
+{
+    uint32_t    rxPackets;
+    uint32_t    stallEvents;        // Events where the central had fewer credits than it could send
+    uint32_t    creditNotifs;
+} BENCH_Result_T;
+
+static uint32_t s_creditQueued;
+static uint32_t s_creditInFlight;
+static uint32_t s_creditNotifs;
+
+uint16_t BLE_TRS_Add(void)
+{
+    return MBA_RES_SUCCESS;
+}
+
+uint8_t MW_CONN_GetIndex(uint16_t connHandle)
+{
+    return (connHandle == BENCH_CONN_HANDLE) ? 0U : 0xFFU;
+}
+
+uint16_t GATTS_SendHandleValue(uint16_t connHandle, GATTS_HandleValueParams_T *p_hvParams)
+{
+    (void)connHandle;
+
+    if ((p_hvParams->charHandle == (uint16_t)TRS_HDL_CHARVAL_CTRL) && (p_hvParams->charValue[1] == 0x14U))
+    {
+        s_creditQueued += p_hvParams->charValue[4];
+        s_creditNotifs++;
+    }
+
+    return MBA_RES_SUCCESS;
+}
+
+uint16_t GATTS_SendWriteResponse(uint16_t connHandle, GATTS_SendWriteRespParams_T *p_respParams)
+{
+    (void)connHandle;
+    (void)p_respParams;
+
+    return MBA_RES_SUCCESS;
+}
+
+uint16_t GATTS_SendErrorResponse(uint16_t connHandle, GATTS_SendErrRespParams_T *p_errParams)
+{
+    (void)connHandle;
+    (void)p_errParams;
+
+    return MBA_RES_SUCCESS;
+}
+
+static void bench_GapEvent(BLE_GAP_Event_T *p_gapEvt)
+{
+    STACK_Event_T stackEvt;
+
+    stackEvt.groupId = STACK_GRP_BLE_GAP;
+    stackEvt.evtLen = sizeof(BLE_GAP_Event_T);
+    stackEvt.p_event = (uint8_t *)p_gapEvt;
+    BLE_TRSPS_BleEventHandler(&stackEvt);
+}
+
+static void bench_Write(uint16_t attrHandle, uint8_t writeType, uint16_t len, const uint8_t *p_value)
+{
+    static GATT_Event_T gattEvt;
+    STACK_Event_T stackEvt;
+
+    memset(&gattEvt, 0, sizeof(gattEvt));
+    gattEvt.eventId = GATTS_EVT_WRITE;
+    gattEvt.eventField.onWrite.connHandle = BENCH_CONN_HANDLE;
+    gattEvt.eventField.onWrite.attrHandle = attrHandle;
+    gattEvt.eventField.onWrite.writeType = writeType;
+    gattEvt.eventField.onWrite.writeDataLength = len;
+    memcpy(gattEvt.eventField.onWrite.writeValue, p_value, len);
+
+    stackEvt.groupId = STACK_GRP_GATT;
+    stackEvt.evtLen = sizeof(GATT_Event_T);
+    stackEvt.p_event = (uint8_t *)&gattEvt;
+    BLE_TRSPS_BleEventHandler(&stackEvt);
+}
+
+static void bench_Connect(void)
+{
+    BLE_GAP_Event_T gapEvt;
+    uint8_t enable = 0x14U;     // CBFC server enabled
+
+    memset(&gapEvt, 0, sizeof(gapEvt));
+    gapEvt.eventId = BLE_GAP_EVT_CONNECTED;
+    gapEvt.eventField.evtConnect.status = GAP_STATUS_SUCCESS;
+    gapEvt.eventField.evtConnect.connHandle = BENCH_CONN_HANDLE;
+    gapEvt.eventField.evtConnect.interval = BENCH_CONN_INTERVAL;
+    bench_GapEvent(&gapEvt);
+
+    bench_Write((uint16_t)TRS_HDL_CHARVAL_CTRL, ATT_WRITE_REQ, 1U, &enable);
+}
+
+static void bench_Disconnect(void)
+{
+    BLE_GAP_Event_T gapEvt;
+
+    memset(&gapEvt, 0, sizeof(gapEvt));
+    gapEvt.eventId = BLE_GAP_EVT_DISCONNECTED;
+    gapEvt.eventField.evtDisconnect.connHandle = BENCH_CONN_HANDLE;
+    bench_GapEvent(&gapEvt);
+}
+
+static void bench_Run(uint8_t policy, uint32_t readPeriodUs, BENCH_Result_T *p_result)
+{
+    static uint8_t packet[BENCH_PACKET_LEN];
+    static uint8_t rxBuf[BLE_ATT_MAX_MTU_LEN];
+    uint32_t credit = 0U;
+    uint32_t t;
+    uint32_t i;
+    uint16_t len;
+
+    memset(p_result, 0, sizeof(BENCH_Result_T));
+    s_creditQueued = 0U;
+    s_creditInFlight = 0U;
+    s_creditNotifs = 0U;
+    FAKE_RTOS_Reset();
+
+    (void)BLE_TRSPS_Init();
+    (void)BLE_TRSPS_SetCreditPolicy(policy);
+    bench_Connect();
+
+    for (t = 0U; t < BENCH_DURATION_US; t += BENCH_STEP_US)
+    {
+        if ((t % BENCH_EVENT_US) == 0U)
+        {
+            credit += s_creditInFlight;
+            s_creditInFlight = s_creditQueued;
+            s_creditQueued = 0U;
+
+            if (credit < BENCH_PACKETS_PER_EVENT)
+            {
+                p_result->stallEvents++;
+            }
+            for (i = 0U; (i < BENCH_PACKETS_PER_EVENT) && (credit > 0U); i++)
+            {
+                bench_Write((uint16_t)TRS_HDL_CHARVAL_RX, ATT_WRITE_CMD, BENCH_PACKET_LEN, packet);
+                credit--;
+            }
+        }
+
+        if ((t % readPeriodUs) == 0U)
+        {
+            BLE_TRSPS_GetDataLength(BENCH_CONN_HANDLE, &len);
+            if ((len != 0U) && (BLE_TRSPS_GetData(BENCH_CONN_HANDLE, rxBuf) == MBA_RES_SUCCESS))
+            {
+                p_result->rxPackets++;
+            }
+        }
+
+        FAKE_RTOS_AdvanceUs(BENCH_STEP_US);
+    }
+
+    p_result->creditNotifs = s_creditNotifs;
+    bench_Disconnect();
+    TEST_ASSERT_EQUAL(0, FAKE_RTOS_GetAllocNum());
+}
+
+static void bench_Print(const char *p_name, const BENCH_Result_T *p_result)
+{
+    printf("  %-18s %8.0f pkt/s %8.1f kB/s %6u credit-limited events %6u credit notifications\n", p_name,
+        p_result->rxPackets * 1e6 / BENCH_DURATION_US,
+        p_result->rxPackets * (double)BENCH_PACKET_LEN / (BENCH_DURATION_US / 1e3),
+        (unsigned)p_result->stallEvents, (unsigned)p_result->creditNotifs);
+}
+
+static void bench_Bulk(void)
+{
+    BENCH_Result_T fixed;
+    BENCH_Result_T adaptive;
+
+    bench_Run(BLE_TRSPS_CREDIT_POLICY_FIXED, 500U, &fixed);
+    bench_Run(BLE_TRSPS_CREDIT_POLICY_ADAPTIVE, 500U, &adaptive);
+    bench_Print("bulk fixed", &fixed);
+    bench_Print("bulk adaptive", &adaptive);
+
+    // The link is the bottleneck: returning credits early keeps the central sending
+    TEST_ASSERT(adaptive.rxPackets > fixed.rxPackets);
+    TEST_ASSERT(adaptive.stallEvents < fixed.stallEvents);
+    TEST_ASSERT(adaptive.creditNotifs <= BENCH_EVENT_NUM);
+}
+
+static void bench_SlowReader(void)
+{
+    BENCH_Result_T fixed;
+    BENCH_Result_T adaptive;
+
+    bench_Run(BLE_TRSPS_CREDIT_POLICY_FIXED, 2000U, &fixed);
+    bench_Run(BLE_TRSPS_CREDIT_POLICY_ADAPTIVE, 2000U, &adaptive);
+    bench_Print("slow fixed", &fixed);
+    bench_Print("slow adaptive", &adaptive);
+
+    // The application is the bottleneck: credits follow the reads, at most one notification per event
+    TEST_ASSERT(adaptive.rxPackets >= fixed.rxPackets);
+    TEST_ASSERT(adaptive.creditNotifs <= BENCH_EVENT_NUM);
+}
+
+int main(void)
+{
+    TEST_RUN(bench_Bulk);
+    TEST_RUN(bench_SlowReader);
+
+    return TEST_RESULT();
+}
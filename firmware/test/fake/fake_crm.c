@@ -0,0 +1,597 @@
+/*******************************************************************************
+  Host Test Fake Crypto Engine Source File
+
+  File Name:
+    fake_crm.c
+
+  Summary:
+    Host stand-in for the CRM block cipher and AEAD API of the crypto engine.
+
+  Description:
+    The data fed to a context is copied, the results are computed when the
+    operation ends. A CCM operation of a fragment runs the reference on all
+    the data fed so far, the counter mode output of the fragment does not
+    depend on the data after it.
+ *******************************************************************************/
+
+#include <string.h>
+#include <sys/mman.h>
+#include "driver/security/cryptosym/statuscodes.h"
+#include "driver/security/cryptosym/keyref_api.h"
+#include "driver/security/cryptosym/blkcipher_api.h"
+#include "driver/security/cryptosym/aead_api.h"
+#include "driver/security/cryptosym/interrupts_api.h"
+#include "ref_aes.h"
+#include "fake_crm.h"
+
+#define FAKE_CRM_PAGE_SIZE          (0x1000U)
+#define FAKE_CRM_CLK_REG_ADDRESS    (0x43000000U)       // See CRYPTO_CLK_ENABLE.
+#define FAKE_CRM_CLK_EN             (0x02U)
+#define FAKE_CRM_CTX_NUM            (8U)
+#define FAKE_CRM_DATA_LEN           (512U)
+#define FAKE_CRM_AAD_LEN            (64U)
+#define FAKE_CRM_CRYPT_NUM          (8U)
+#define FAKE_CRM_NONCE_LEN          (13U)
+
+typedef enum FAKE_CRM_Op_T
+{
+    FAKE_CRM_OP_ECB,
+    FAKE_CRM_OP_CCM_PART,
+    FAKE_CRM_OP_CCM_TAG,
+    FAKE_CRM_OP_CCM_VERIFY
+} FAKE_CRM_Op_T;
+
+// Data fed to a block cipher or AEAD context of the firmware
+typedef struct FAKE_CRM_Ctx_T
+{
+    const void              *p_owner;
+    const struct crmkeyref  *p_key;
+    bool                    isDecrypt;
+    uint8_t                 nonce[FAKE_CRM_NONCE_LEN];
+    uint8_t                 nonceLen;
+    uint8_t                 tagLen;
+    uint8_t                 tag[REF_AES_BLOCK_LEN];     // Expected tag of a decryption.
+    uint8_t                 aad[FAKE_CRM_AAD_LEN];
+    uint16_t                aadLen;
+    uint8_t                 data[FAKE_CRM_DATA_LEN];    // Input fed since the creation.
+    uint16_t                dataLen;
+    uint16_t                cryptOffset[FAKE_CRM_CRYPT_NUM];
+    uint16_t                cryptLen[FAKE_CRM_CRYPT_NUM];
+    char                    *p_cryptOut[FAKE_CRM_CRYPT_NUM];
+    uint8_t                 cryptNum;                   // Inputs not processed yet.
+    int                     status;
+} FAKE_CRM_Ctx_T;
+
+void SILEX_0_Handler(void);
+
+static bool             s_isMapped;
+static FAKE_CRM_Ctx_T   s_ctx[FAKE_CRM_CTX_NUM];
+static uint8_t          s_nextCtx;
+static FAKE_CRM_Ctx_T   *sp_running;
+static FAKE_CRM_Op_T    s_op;
+static char             *sp_tagOut;
+static uint8_t          s_pollNum;              // Status reads of the running operation.
+static bool             s_isIrqEnabled;
+static uint32_t         s_runNum;
+static uint32_t         s_busyFaultNum;
+static uint32_t         s_clockFaultNum;
+
+static FAKE_CRM_Ctx_T *fake_crm_GetCtx(const void *p_owner, bool isCreate)
+{
+    FAKE_CRM_Ctx_T *p_ctx = NULL;
+    uint8_t i;
+
+    for (i = 0; i < FAKE_CRM_CTX_NUM; i++)
+    {
+        if (s_ctx[i].p_owner == p_owner)
+        {
+            p_ctx = &s_ctx[i];
+            break;
+        }
+    }
+
+    if (i == FAKE_CRM_CTX_NUM)
+    {
+        if (!isCreate)
+        {
+            return NULL;
+        }
+
+        // The contexts of the firmware may live on the stack, the oldest is reused
+        p_ctx = &s_ctx[s_nextCtx];
+        s_nextCtx = (uint8_t)((s_nextCtx + 1U) % FAKE_CRM_CTX_NUM);
+    }
+
+    if (isCreate)
+    {
+        (void)memset(p_ctx, 0, sizeof(FAKE_CRM_Ctx_T));
+        p_ctx->p_owner = p_owner;
+        p_ctx->status = CRM_OK;
+    }
+
+    return p_ctx;
+}
+
+static int fake_crm_Feed(FAKE_CRM_Ctx_T *p_ctx, const char *p_in, size_t sz, char *p_out)
+{
+    if ((sz > (FAKE_CRM_DATA_LEN - p_ctx->dataLen)) || (p_ctx->cryptNum == FAKE_CRM_CRYPT_NUM))
+    {
+        return CRM_ERR_TOO_BIG;
+    }
+
+    (void)memcpy(&p_ctx->data[p_ctx->dataLen], p_in, sz);
+    p_ctx->cryptOffset[p_ctx->cryptNum] = p_ctx->dataLen;
+    p_ctx->cryptLen[p_ctx->cryptNum] = (uint16_t)sz;
+    p_ctx->p_cryptOut[p_ctx->cryptNum] = p_out;
+    p_ctx->cryptNum++;
+    p_ctx->dataLen = (uint16_t)(p_ctx->dataLen + sz);
+
+    return CRM_OK;
+}
+
+static int fake_crm_Start(FAKE_CRM_Ctx_T *p_ctx, FAKE_CRM_Op_T op)
+{
+    if (sp_running != NULL)
+    {
+        s_busyFaultNum++;
+    }
+    if (!FAKE_CRM_IsClockOn())
+    {
+        s_clockFaultNum++;
+    }
+
+    s_runNum++;
+    sp_running = p_ctx;
+    s_op = op;
+    s_pollNum = 0U;
+    p_ctx->status = CRM_ERR_HW_PROCESSING;
+
+    return CRM_OK;
+}
+
+static void fake_crm_EndEcb(FAKE_CRM_Ctx_T *p_ctx, const uint8_t *p_key)
+{
+    uint8_t block[REF_AES_BLOCK_LEN];
+    uint16_t i;
+    uint8_t j;
+
+    for (j = 0; j < p_ctx->cryptNum; j++)
+    {
+        for (i = 0; i < p_ctx->cryptLen[j]; i += REF_AES_BLOCK_LEN)
+        {
+            REF_AES_Encrypt(p_key, &p_ctx->data[p_ctx->cryptOffset[j] + i], block);
+            (void)memcpy(&p_ctx->p_cryptOut[j][i], block, REF_AES_BLOCK_LEN);
+        }
+    }
+
+    // The context may run again with new data
+    p_ctx->dataLen = 0;
+}
+
+static void fake_crm_EndCcm(FAKE_CRM_Ctx_T *p_ctx, const uint8_t *p_key)
+{
+    uint8_t out[FAKE_CRM_DATA_LEN];
+    uint8_t tag[REF_AES_BLOCK_LEN];
+    bool isValid;
+    uint8_t j;
+
+    if (p_ctx->isDecrypt)
+    {
+        isValid = REF_AES_CcmDecrypt(p_key, p_ctx->nonce, p_ctx->nonceLen, p_ctx->aad, p_ctx->aadLen, p_ctx->data,
+            p_ctx->dataLen, out, p_ctx->tag, p_ctx->tagLen);
+    }
+    else
+    {
+        REF_AES_CcmEncrypt(p_key, p_ctx->nonce, p_ctx->nonceLen, p_ctx->aad, p_ctx->aadLen, p_ctx->data,
+            p_ctx->dataLen, out, tag, p_ctx->tagLen);
+        isValid = true;
+    }
+
+    for (j = 0; j < p_ctx->cryptNum; j++)
+    {
+        (void)memcpy(p_ctx->p_cryptOut[j], &out[p_ctx->cryptOffset[j]], p_ctx->cryptLen[j]);
+    }
+
+    if (s_op == FAKE_CRM_OP_CCM_TAG)
+    {
+        (void)memcpy(sp_tagOut, tag, p_ctx->tagLen);
+    }
+    else if ((s_op == FAKE_CRM_OP_CCM_VERIFY) && (!isValid))
+    {
+        p_ctx->status = CRM_ERR_INVALID_TAG;
+    }
+}
+
+static void fake_crm_EndOp(void)
+{
+    FAKE_CRM_Ctx_T *p_ctx = sp_running;
+    const uint8_t *p_key = (const uint8_t *)p_ctx->p_key->key;
+
+    if (!FAKE_CRM_IsClockOn())
+    {
+        s_clockFaultNum++;
+    }
+
+    sp_running = NULL;
+    p_ctx->status = CRM_OK;
+
+    if (s_op == FAKE_CRM_OP_ECB)
+    {
+        fake_crm_EndEcb(p_ctx, p_key);
+    }
+    else
+    {
+        fake_crm_EndCcm(p_ctx, p_key);
+    }
+
+    p_ctx->cryptNum = 0;
+}
+
+static struct crmkeyref fake_crm_KeyrefLoadMaterial(size_t keysz, const char *keymaterial)
+{
+    struct crmkeyref keyRef;
+
+    (void)memset(&keyRef, 0, sizeof(keyRef));
+    keyRef.key = keymaterial;
+    keyRef.sz = keysz;
+
+    return keyRef;
+}
+
+static int fake_crm_BlkcipherCreateAesEcbEnc(struct crmblkcipher *c, const struct crmkeyref *key)
+{
+    FAKE_CRM_Ctx_T *p_ctx = fake_crm_GetCtx(c, true);
+
+    if (key->sz != REF_AES_BLOCK_LEN)
+    {
+        return CRM_ERR_INVALID_KEY_SZ;
+    }
+    p_ctx->p_key = key;
+
+    return CRM_OK;
+}
+
+static int fake_crm_BlkcipherCrypt(struct crmblkcipher *c, const char *datain, size_t sz, char *dataout)
+{
+    FAKE_CRM_Ctx_T *p_ctx = fake_crm_GetCtx(c, false);
+
+    if (p_ctx == NULL)
+    {
+        return CRM_ERR_UNITIALIZED_OBJ;
+    }
+    if ((sz % REF_AES_BLOCK_LEN) != 0U)
+    {
+        return CRM_ERR_WRONG_SIZE_GRANULARITY;
+    }
+
+    return fake_crm_Feed(p_ctx, datain, sz, dataout);
+}
+
+static int fake_crm_BlkcipherRun(struct crmblkcipher *c)
+{
+    FAKE_CRM_Ctx_T *p_ctx = fake_crm_GetCtx(c, false);
+
+    if (p_ctx == NULL)
+    {
+        return CRM_ERR_UNITIALIZED_OBJ;
+    }
+
+    return fake_crm_Start(p_ctx, FAKE_CRM_OP_ECB);
+}
+
+// The engine ends on its own: a busy wait on the status sees the end at its second read
+static int fake_crm_Status(const void *p_owner)
+{
+    FAKE_CRM_Ctx_T *p_ctx = fake_crm_GetCtx(p_owner, false);
+
+    if (p_ctx == NULL)
+    {
+        return CRM_ERR_UNITIALIZED_OBJ;
+    }
+    if (sp_running == p_ctx)
+    {
+        s_pollNum++;
+        if (s_pollNum > 1U)
+        {
+            fake_crm_EndOp();
+        }
+    }
+
+    return p_ctx->status;
+}
+
+// The firmware polls the engine until the operation ends, no interrupt is raised
+static int fake_crm_Wait(const void *p_owner)
+{
+    FAKE_CRM_Ctx_T *p_ctx = fake_crm_GetCtx(p_owner, false);
+
+    if (p_ctx == NULL)
+    {
+        return CRM_ERR_UNITIALIZED_OBJ;
+    }
+    if (sp_running == p_ctx)
+    {
+        fake_crm_EndOp();
+    }
+
+    return p_ctx->status;
+}
+
+static int fake_crm_BlkcipherWait(struct crmblkcipher *c)
+{
+    return fake_crm_Wait(c);
+}
+
+static int fake_crm_BlkcipherStatus(struct crmblkcipher *c)
+{
+    return fake_crm_Status(c);
+}
+
+static int fake_crm_AeadCreateAesCcm(struct crmaead *c, const struct crmkeyref *key, const char *nonce,
+    size_t noncesz, size_t tagsz, size_t aadsz, bool isDecrypt)
+{
+    FAKE_CRM_Ctx_T *p_ctx;
+
+    if (key->sz != REF_AES_BLOCK_LEN)
+    {
+        return CRM_ERR_INVALID_KEY_SZ;
+    }
+    if ((noncesz < 7U) || (noncesz > FAKE_CRM_NONCE_LEN))
+    {
+        return CRM_ERR_INVALID_NONCE_SIZE;
+    }
+    if ((tagsz < 4U) || (tagsz > REF_AES_BLOCK_LEN) || ((tagsz % 2U) != 0U))
+    {
+        return CRM_ERR_INVALID_TAG_SIZE;
+    }
+    if (aadsz > FAKE_CRM_AAD_LEN)
+    {
+        return CRM_ERR_TOO_BIG;
+    }
+
+    p_ctx = fake_crm_GetCtx(c, true);
+    p_ctx->p_key = key;
+    p_ctx->isDecrypt = isDecrypt;
+    (void)memcpy(p_ctx->nonce, nonce, noncesz);
+    p_ctx->nonceLen = (uint8_t)noncesz;
+    p_ctx->tagLen = (uint8_t)tagsz;
+    c->dataintotalsz = 0;
+
+    return CRM_OK;
+}
+
+static int fake_crm_AeadCreateAesCcmEnc(struct crmaead *c, const struct crmkeyref *key, const char *nonce,
+    size_t noncesz, size_t tagsz, size_t aadsz, size_t datasz)
+{
+    (void)datasz;
+
+    return fake_crm_AeadCreateAesCcm(c, key, nonce, noncesz, tagsz, aadsz, false);
+}
+
+static int fake_crm_AeadCreateAesCcmDec(struct crmaead *c, const struct crmkeyref *key, const char *nonce,
+    size_t noncesz, size_t tagsz, size_t aadsz, size_t datasz)
+{
+    (void)datasz;
+
+    return fake_crm_AeadCreateAesCcm(c, key, nonce, noncesz, tagsz, aadsz, true);
+}
+
+static int fake_crm_AeadFeedAad(struct crmaead *c, const char *aad, size_t aadsz)
+{
+    FAKE_CRM_Ctx_T *p_ctx = fake_crm_GetCtx(c, false);
+
+    if (p_ctx == NULL)
+    {
+        return CRM_ERR_UNITIALIZED_OBJ;
+    }
+    if (p_ctx->dataLen > 0U)
+    {
+        return CRM_ERR_FEED_AFTER_DATA;
+    }
+    if (aadsz > (FAKE_CRM_AAD_LEN - p_ctx->aadLen))
+    {
+        return CRM_ERR_TOO_BIG;
+    }
+
+    (void)memcpy(&p_ctx->aad[p_ctx->aadLen], aad, aadsz);
+    p_ctx->aadLen = (uint16_t)(p_ctx->aadLen + aadsz);
+
+    return CRM_OK;
+}
+
+static int fake_crm_AeadCrypt(struct crmaead *c, const char *datain, size_t datainsz, char *dataout)
+{
+    FAKE_CRM_Ctx_T *p_ctx = fake_crm_GetCtx(c, false);
+    int s;
+
+    if (p_ctx == NULL)
+    {
+        return CRM_ERR_UNITIALIZED_OBJ;
+    }
+
+    s = fake_crm_Feed(p_ctx, datain, datainsz, dataout);
+    if (s == CRM_OK)
+    {
+        c->dataintotalsz += datainsz;
+    }
+
+    return s;
+}
+
+static int fake_crm_AeadProduceTag(struct crmaead *c, char *tagout)
+{
+    FAKE_CRM_Ctx_T *p_ctx = fake_crm_GetCtx(c, false);
+
+    if ((p_ctx == NULL) || p_ctx->isDecrypt)
+    {
+        return CRM_ERR_UNITIALIZED_OBJ;
+    }
+
+    sp_tagOut = tagout;
+
+    return fake_crm_Start(p_ctx, FAKE_CRM_OP_CCM_TAG);
+}
+
+static int fake_crm_AeadVerifyTag(struct crmaead *c, const char *tagin)
+{
+    FAKE_CRM_Ctx_T *p_ctx = fake_crm_GetCtx(c, false);
+
+    if ((p_ctx == NULL) || (!p_ctx->isDecrypt))
+    {
+        return CRM_ERR_UNITIALIZED_OBJ;
+    }
+
+    (void)memcpy(p_ctx->tag, tagin, p_ctx->tagLen);
+
+    return fake_crm_Start(p_ctx, FAKE_CRM_OP_CCM_VERIFY);
+}
+
+// Saving the state runs the fragments fed so far
+static int fake_crm_AeadSaveState(struct crmaead *c)
+{
+    FAKE_CRM_Ctx_T *p_ctx = fake_crm_GetCtx(c, false);
+
+    if (p_ctx == NULL)
+    {
+        return CRM_ERR_UNITIALIZED_OBJ;
+    }
+
+    return fake_crm_Start(p_ctx, FAKE_CRM_OP_CCM_PART);
+}
+
+static int fake_crm_AeadResumeState(struct crmaead *c)
+{
+    return (fake_crm_GetCtx(c, false) == NULL) ? CRM_ERR_UNITIALIZED_OBJ : CRM_OK;
+}
+
+static int fake_crm_AeadWait(struct crmaead *c)
+{
+    return fake_crm_Wait(c);
+}
+
+static int fake_crm_AeadStatus(struct crmaead *c)
+{
+    return fake_crm_Status(c);
+}
+
+static int fake_crm_InterruptsEnable(void)
+{
+    s_isIrqEnabled = true;
+
+    return CRM_OK;
+}
+
+// The table holds 32-bit addresses, as on the device
+static bool fake_crm_SetEntry(uint32_t offset, void (*p_func)(void))
+{
+    uintptr_t address = (uintptr_t)p_func;
+
+    if (address > UINT32_MAX)
+    {
+        return false;
+    }
+
+    *(uint32_t *)(uintptr_t)(API_TABLE_BASE_ADDRESS + offset) = (uint32_t)address;
+
+    return true;
+}
+
+static bool fake_crm_Map(uint32_t address)
+{
+    void *p_page;
+
+    p_page = mmap((void *)(uintptr_t)address, FAKE_CRM_PAGE_SIZE, PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+
+    return (p_page == (void *)(uintptr_t)address);
+}
+
+bool FAKE_CRM_Reset(void)
+{
+    bool isSet = true;
+
+    if (!s_isMapped)
+    {
+        s_isMapped = fake_crm_Map(API_TABLE_BASE_ADDRESS) && fake_crm_Map(FAKE_CRM_CLK_REG_ADDRESS);
+        if (!s_isMapped)
+        {
+            return false;
+        }
+    }
+
+    // The other entries stay zero, calling them crashes the test
+    isSet &= fake_crm_SetEntry(ATO_CRM_KEYREF_LOAD_MATERIAL, (void (*)(void))fake_crm_KeyrefLoadMaterial);
+    isSet &= fake_crm_SetEntry(ATO_CRM_BLKCIPHER_CREATE_AESECB_ENC, (void (*)(void))fake_crm_BlkcipherCreateAesEcbEnc);
+    isSet &= fake_crm_SetEntry(ATO_CRM_BLKCIPHER_CRYPT, (void (*)(void))fake_crm_BlkcipherCrypt);
+    isSet &= fake_crm_SetEntry(ATO_CRM_BLKCIPHER_RUN, (void (*)(void))fake_crm_BlkcipherRun);
+    isSet &= fake_crm_SetEntry(ATO_CRM_BLKCIPHER_WAIT, (void (*)(void))fake_crm_BlkcipherWait);
+    isSet &= fake_crm_SetEntry(ATO_CRM_BLKCIPHER_STATUS, (void (*)(void))fake_crm_BlkcipherStatus);
+    isSet &= fake_crm_SetEntry(ATO_CRM_AEAD_CREATE_AESCCM_ENC, (void (*)(void))fake_crm_AeadCreateAesCcmEnc);
+    isSet &= fake_crm_SetEntry(ATO_CRM_AEAD_CREATE_AESCCM_DEC, (void (*)(void))fake_crm_AeadCreateAesCcmDec);
+    isSet &= fake_crm_SetEntry(ATO_CRM_AEAD_FEED_AAD, (void (*)(void))fake_crm_AeadFeedAad);
+    isSet &= fake_crm_SetEntry(ATO_CRM_AEAD_CRYPT, (void (*)(void))fake_crm_AeadCrypt);
+    isSet &= fake_crm_SetEntry(ATO_CRM_AEAD_PRODUCE_TAG, (void (*)(void))fake_crm_AeadProduceTag);
+    isSet &= fake_crm_SetEntry(ATO_CRM_AEAD_VERIFY_TAG, (void (*)(void))fake_crm_AeadVerifyTag);
+    isSet &= fake_crm_SetEntry(ATO_CRM_AEAD_SAVE_STATE, (void (*)(void))fake_crm_AeadSaveState);
+    isSet &= fake_crm_SetEntry(ATO_CRM_AEAD_RESUME_STATE, (void (*)(void))fake_crm_AeadResumeState);
+    isSet &= fake_crm_SetEntry(ATO_CRM_AEAD_WAIT, (void (*)(void))fake_crm_AeadWait);
+    isSet &= fake_crm_SetEntry(ATO_CRM_AEAD_STATUS, (void (*)(void))fake_crm_AeadStatus);
+    isSet &= fake_crm_SetEntry(ATO_CRM_INTERRUPTS_ENABLE, (void (*)(void))fake_crm_InterruptsEnable);
+
+    *(volatile uint32_t *)(uintptr_t)FAKE_CRM_CLK_REG_ADDRESS = 0U;
+    (void)memset(s_ctx, 0, sizeof(s_ctx));
+    s_nextCtx = 0U;
+    sp_running = NULL;
+    s_isIrqEnabled = false;
+    s_runNum = 0U;
+    s_busyFaultNum = 0U;
+    s_clockFaultNum = 0U;
+
+    return isSet;
+}
+
+bool FAKE_CRM_IsBusy(void)
+{
+    return (sp_running != NULL);
+}
+
+void FAKE_CRM_End(bool isInterrupt)
+{
+    if (sp_running != NULL)
+    {
+        fake_crm_EndOp();
+    }
+
+    if (isInterrupt)
+    {
+        FAKE_CRM_Interrupt();
+    }
+}
+
+void FAKE_CRM_Interrupt(void)
+{
+    if (s_isIrqEnabled)
+    {
+        SILEX_0_Handler();
+    }
+}
+
+bool FAKE_CRM_IsClockOn(void)
+{
+    return ((*(volatile uint32_t *)(uintptr_t)FAKE_CRM_CLK_REG_ADDRESS & FAKE_CRM_CLK_EN) != 0U);
+}
+
+uint32_t FAKE_CRM_GetRunNum(void)
+{
+    return s_runNum;
+}
+
+uint32_t FAKE_CRM_GetBusyFaultNum(void)
+{
+    return s_busyFaultNum;
+}
+
+uint32_t FAKE_CRM_GetClockFaultNum(void)
+{
+    return s_clockFaultNum;
+}
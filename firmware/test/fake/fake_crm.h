@@ -0,0 +1,79 @@
+/*******************************************************************************
+  Host Test Fake Crypto Engine Header File
+
+  File Name:
+    fake_crm.h
+
+  Summary:
+    Host stand-in for the CRM block cipher and AEAD API of the crypto engine.
+
+  Description:
+    The CRM functions are called through the ROM API table, so the table is
+    mapped at its device address and filled with the functions of the fake:
+    the firmware calls the CRM macros unchanged. The crypto clock register is
+    mapped too. The AES results come from the reference implementation. An
+    operation started on the engine keeps it busy until the test ends it with
+    FAKE_CRM_End(), until the firmware waits on it, or until the firmware
+    reads its status a second time. The misuses a real engine would not
+    report, starting an operation while another one runs or with the clock
+    off, are counted. Only the AES-ECB encryption and AES-CCM entries are
+    provided, the tests must be linked without -pie.
+ *******************************************************************************/
+
+#ifndef FAKE_CRM_H
+#define FAKE_CRM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**@brief Maps the API table and the clock register if needed, ends any operation and clears the counters.
+ *
+ * @retval true                     The table is mapped at its device address.
+ * @retval false                    The address range is not available on the host, or the
+ *                                  functions do not fit the 32-bit entries of the table.
+ */
+bool FAKE_CRM_Reset(void);
+
+/**@brief Checks if an operation runs on the engine.
+ *
+ * @retval true                     An operation runs.
+ * @retval false                    The engine is free.
+ */
+bool FAKE_CRM_IsBusy(void);
+
+/**@brief Ends the running operation: the outputs are written and the status is set.
+ *
+ * @param[in] isInterrupt           False to drop the interrupt. The interrupt is raised only
+ *                                  once CRM_INTERRUPTS_ENABLE has been called.
+ */
+void FAKE_CRM_End(bool isInterrupt);
+
+/**@brief Raises the engine interrupt without ending the running operation. */
+void FAKE_CRM_Interrupt(void);
+
+/**@brief Checks if the crypto clock is on.
+ *
+ * @retval true                     The clock is on.
+ * @retval false                    The clock is off.
+ */
+bool FAKE_CRM_IsClockOn(void);
+
+/**@brief Gets the number of operations started since the last reset.
+ *
+ * @retval The number of operations.
+ */
+uint32_t FAKE_CRM_GetRunNum(void);
+
+/**@brief Gets the number of operations started while another one was running.
+ *
+ * @retval The number of operations.
+ */
+uint32_t FAKE_CRM_GetBusyFaultNum(void);
+
+/**@brief Gets the number of operations started or ended with the clock off.
+ *
+ * @retval The number of operations.
+ */
+uint32_t FAKE_CRM_GetClockFaultNum(void);
+
+#endif // FAKE_CRM_H
@@ -0,0 +1,227 @@
+/*******************************************************************************
+  Host Test Fake MW_AES Source File
+
+  File Name:
+    fake_mw_aes.c
+
+  Summary:
+    Host stand-in for the AES middleware, on top of the reference AES.
+
+  Description:
+    The context layout belongs to the crypto library, so the key and the
+    CCM parameters of each context are kept here instead, in a small table
+    looked up by address. A CCM message is processed in a single fragment.
+ *******************************************************************************/
+
+#include <string.h>
+#include "mba_error_defs.h"
+#include "ble_util/mw_aes.h"
+#include "ref_aes.h"
+#include "fake_mw_aes.h"
+
+#define FAKE_MW_AES_CTX_MAX         (8U)
+#define FAKE_MW_AES_AAD_MAX         (32U)
+
+typedef struct FAKE_MW_AES_Key_T
+{
+    const MW_AES_Ctx_T  *p_ctx;
+    uint8_t             key[REF_AES_BLOCK_LEN];
+    uint8_t             nonce[13];
+    uint8_t             nonceSz;
+    uint8_t             tagSz;
+    uint8_t             aad[FAKE_MW_AES_AAD_MAX];
+    uint16_t            aadSz;
+    uint16_t            dataSz;
+} FAKE_MW_AES_Key_T;
+
+static FAKE_MW_AES_Key_T    s_key[FAKE_MW_AES_CTX_MAX];
+static uint32_t             s_keyNext;
+static uint32_t             s_blockNum;
+static uint32_t             s_keyLoadNum;
+static uint32_t             s_clkHoldNum;
+static uint8_t              s_clkHoldCnt;
+
+static FAKE_MW_AES_Key_T *fake_mw_aes_Find(const MW_AES_Ctx_T *p_ctx)
+{
+    uint32_t i;
+
+    for (i = 0; i < FAKE_MW_AES_CTX_MAX; i++)
+    {
+        if (s_key[i].p_ctx == p_ctx)
+        {
+            return &s_key[i];
+        }
+    }
+
+    return NULL;
+}
+
+static FAKE_MW_AES_Key_T *fake_mw_aes_Load(const MW_AES_Ctx_T *p_ctx, const uint8_t *p_aesKey)
+{
+    FAKE_MW_AES_Key_T *p_key;
+
+    p_key = fake_mw_aes_Find(p_ctx);
+    if (p_aesKey == NULL)
+    {
+        return p_key;
+    }
+
+    if (p_key == NULL)
+    {
+        // Contexts live on the stack of the callers, the oldest entry is reused
+        p_key = &s_key[s_keyNext];
+        s_keyNext = (s_keyNext + 1U) % FAKE_MW_AES_CTX_MAX;
+        p_key->p_ctx = p_ctx;
+    }
+    memcpy(p_key->key, p_aesKey, REF_AES_BLOCK_LEN);
+    s_keyLoadNum++;
+
+    return p_key;
+}
+
+void FAKE_MW_AES_Reset(void)
+{
+    s_blockNum = 0U;
+    s_keyLoadNum = 0U;
+    s_clkHoldNum = 0U;
+}
+
+uint32_t FAKE_MW_AES_GetBlockNum(void)
+{
+    return s_blockNum;
+}
+
+uint32_t FAKE_MW_AES_GetKeyLoadNum(void)
+{
+    return s_keyLoadNum;
+}
+
+uint32_t FAKE_MW_AES_GetClockHoldNum(void)
+{
+    return s_clkHoldNum;
+}
+
+bool FAKE_MW_AES_IsClockHeld(void)
+{
+    return (s_clkHoldCnt > 0U);
+}
+
+void MW_AES_HoldClock(bool hold)
+{
+    if (hold)
+    {
+        s_clkHoldCnt++;
+        s_clkHoldNum++;
+    }
+    else if (s_clkHoldCnt > 0U)
+    {
+        s_clkHoldCnt--;
+    }
+}
+
+uint16_t MW_AES_EcbEncryptInit(MW_AES_Ctx_T *p_ctx, uint8_t *p_aesKey)
+{
+    (void)fake_mw_aes_Load(p_ctx, p_aesKey);
+
+    return MBA_RES_SUCCESS;
+}
+
+uint16_t MW_AES_AesEcbEncrypt(MW_AES_Ctx_T *p_ctx, uint16_t length, uint8_t *p_cipherText, uint8_t *p_plainText)
+{
+    FAKE_MW_AES_Key_T *p_key;
+    uint16_t offset;
+
+    p_key = fake_mw_aes_Find(p_ctx);
+    if ((p_key == NULL) || ((length % REF_AES_BLOCK_LEN) != 0U))
+    {
+        return MBA_RES_FAIL;
+    }
+
+    for (offset = 0; offset < length; offset += REF_AES_BLOCK_LEN)
+    {
+        REF_AES_Encrypt(p_key->key, &p_plainText[offset], &p_cipherText[offset]);
+        s_blockNum++;
+    }
+
+    return MBA_RES_SUCCESS;
+}
+
+static uint16_t fake_mw_aes_CcmInit(MW_AES_Ctx_T *p_ctx, uint8_t *p_aesKey, uint8_t *p_nonce, uint8_t nonceSz,
+    uint8_t tagSz, uint8_t *p_aad, uint16_t aadSz, uint16_t dataSz)
+{
+    FAKE_MW_AES_Key_T *p_key;
+
+    p_key = fake_mw_aes_Load(p_ctx, p_aesKey);
+    if ((p_key == NULL) || (nonceSz < 7U) || (nonceSz > 13U) || (aadSz > FAKE_MW_AES_AAD_MAX))
+    {
+        return MBA_RES_FAIL;
+    }
+
+    memcpy(p_key->nonce, p_nonce, nonceSz);
+    p_key->nonceSz = nonceSz;
+    p_key->tagSz = tagSz;
+    memcpy(p_key->aad, p_aad, aadSz);
+    p_key->aadSz = aadSz;
+    p_key->dataSz = dataSz;
+
+    return MBA_RES_SUCCESS;
+}
+
+// Two AES blocks per 16 bytes of data, for the MAC and the counter, and the first blocks of both
+static void fake_mw_aes_CountCcm(const FAKE_MW_AES_Key_T *p_key)
+{
+    uint32_t aadBlocks = (p_key->aadSz > 0U) ? ((p_key->aadSz + 2U + REF_AES_BLOCK_LEN - 1U) / REF_AES_BLOCK_LEN) : 0U;
+
+    s_blockNum += 2U + aadBlocks + (2U * ((p_key->dataSz + REF_AES_BLOCK_LEN - 1U) / REF_AES_BLOCK_LEN));
+}
+
+uint16_t MW_AES_CcmEncryptInit(MW_AES_Ctx_T *p_ctx, uint8_t *p_aesKey, uint8_t *p_nonce, uint8_t nonceSz,
+    uint8_t tagSz, uint8_t *p_aad, uint16_t aadSz, uint16_t dataSz)
+{
+    return fake_mw_aes_CcmInit(p_ctx, p_aesKey, p_nonce, nonceSz, tagSz, p_aad, aadSz, dataSz);
+}
+
+uint16_t MW_AES_AesCcmEncrypt(MW_AES_Ctx_T *p_ctx, uint16_t length, uint8_t *p_plainText, uint8_t *p_cipherText,
+    uint8_t *p_tag)
+{
+    FAKE_MW_AES_Key_T *p_key;
+
+    p_key = fake_mw_aes_Find(p_ctx);
+    if ((p_key == NULL) || (length != p_key->dataSz))
+    {
+        return MBA_RES_FAIL;
+    }
+
+    REF_AES_CcmEncrypt(p_key->key, p_key->nonce, p_key->nonceSz, p_key->aad, p_key->aadSz, p_plainText, length,
+        p_cipherText, p_tag, p_key->tagSz);
+    fake_mw_aes_CountCcm(p_key);
+
+    return MBA_RES_SUCCESS;
+}
+
+uint16_t MW_AES_CcmDecryptInit(MW_AES_Ctx_T *p_ctx, uint8_t *p_aesKey, uint8_t *p_nonce, uint8_t nonceSz,
+    uint8_t tagSz, uint8_t *p_aad, uint16_t aadSz, uint16_t dataSz)
+{
+    return fake_mw_aes_CcmInit(p_ctx, p_aesKey, p_nonce, nonceSz, tagSz, p_aad, aadSz, dataSz);
+}
+
+uint16_t MW_AES_AesCcmDecrypt(MW_AES_Ctx_T *p_ctx, uint16_t length, uint8_t *p_cipherText, uint8_t *p_tag,
+    uint8_t *p_plainText)
+{
+    FAKE_MW_AES_Key_T *p_key;
+
+    p_key = fake_mw_aes_Find(p_ctx);
+    if ((p_key == NULL) || (length != p_key->dataSz))
+    {
+        return MBA_RES_FAIL;
+    }
+
+    fake_mw_aes_CountCcm(p_key);
+    if (!REF_AES_CcmDecrypt(p_key->key, p_key->nonce, p_key->nonceSz, p_key->aad, p_key->aadSz, p_cipherText, length,
+        p_plainText, p_tag, p_key->tagSz))
+    {
+        return MBA_RES_FAIL;
+    }
+
+    return MBA_RES_SUCCESS;
+}
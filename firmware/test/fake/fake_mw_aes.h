@@ -0,0 +1,50 @@
+/*******************************************************************************
+  Host Test Fake MW_AES Header File
+
+  File Name:
+    fake_mw_aes.h
+
+  Summary:
+    Host stand-in for the AES middleware, on top of the reference AES.
+
+  Description:
+    The ECB encryption and the CCM encryption and decryption are provided.
+    The AES blocks, the key loads and the clock holds are counted, so a test
+    measures the crypto work of the code under test.
+ *******************************************************************************/
+
+#ifndef FAKE_MW_AES_H
+#define FAKE_MW_AES_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**@brief Resets the counts of encrypted blocks, key loads and clock holds. */
+void FAKE_MW_AES_Reset(void);
+
+/**@brief Gets the number of blocks encrypted since the last reset.
+ *
+ * @retval The number of blocks.
+ */
+uint32_t FAKE_MW_AES_GetBlockNum(void);
+
+/**@brief Gets the number of keys loaded since the last reset, an initialization given a NULL key loads none.
+ *
+ * @retval The number of key loads.
+ */
+uint32_t FAKE_MW_AES_GetKeyLoadNum(void);
+
+/**@brief Gets the number of holds taken on the crypto clock since the last reset.
+ *
+ * @retval The number of holds.
+ */
+uint32_t FAKE_MW_AES_GetClockHoldNum(void);
+
+/**@brief Checks if a hold is kept on the crypto clock.
+ *
+ * @retval true                     The clock is held.
+ * @retval false                    No hold is kept.
+ */
+bool FAKE_MW_AES_IsClockHeld(void);
+
+#endif // FAKE_MW_AES_H
@@ -0,0 +1,142 @@
+/*******************************************************************************
+  Host Test Fake NVM Source File
+
+  File Name:
+    fake_nvm.c
+
+  Summary:
+    Host stand-in for the NVM peripheral library.
+
+  Description:
+    A row write programs the bits to zero only, like the flash: a row written
+    without an erase does not read back as the data.
+ *******************************************************************************/
+
+#include <string.h>
+#include <sys/mman.h>
+#include "fake_nvm.h"
+
+#ifndef MAP_FIXED_NOREPLACE
+#define MAP_FIXED_NOREPLACE         (0x100000)
+#endif
+
+static bool             s_isMapped;
+static NVM_CALLBACK     s_cb;
+static uintptr_t        s_context;
+static FAKE_NVM_Op_T    s_op;
+static uint32_t         s_opAddress;
+static const uint32_t   *s_p_opData;
+static NVM_ERROR        s_error;
+static uint32_t         s_opNum;
+
+bool FAKE_NVM_Reset(void)
+{
+    void *p_flash;
+
+    if (!s_isMapped)
+    {
+        p_flash = mmap((void *)(uintptr_t)NVM_FLASH_START_ADDRESS, NVM_FLASH_SIZE, PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+        s_isMapped = (p_flash == (void *)(uintptr_t)NVM_FLASH_START_ADDRESS);
+        if (!s_isMapped)
+        {
+            return false;
+        }
+    }
+
+    (void)memset((void *)(uintptr_t)NVM_FLASH_START_ADDRESS, 0x5A, NVM_FLASH_SIZE);
+    s_op = FAKE_NVM_OP_NONE;
+    s_error = NVM_ERROR_NONE;
+    s_opNum = 0U;
+
+    return true;
+}
+
+FAKE_NVM_Op_T FAKE_NVM_GetOp(uint32_t *p_address)
+{
+    if (p_address != NULL)
+    {
+        *p_address = s_opAddress;
+    }
+
+    return s_op;
+}
+
+void FAKE_NVM_End(NVM_ERROR error, bool isInterrupt)
+{
+    uint8_t *p_flash = (uint8_t *)(uintptr_t)s_opAddress;
+    const uint8_t *p_data = (const uint8_t *)s_p_opData;
+    uint32_t i;
+
+    s_error = error;
+
+    if (error == NVM_ERROR_NONE)
+    {
+        if (s_op == FAKE_NVM_OP_ERASE)
+        {
+            (void)memset(p_flash, 0xFF, NVM_FLASH_PAGESIZE);
+        }
+        else if (s_op == FAKE_NVM_OP_WRITE)
+        {
+            // The source row is read while the operation runs, as the controller does
+            for (i = 0U; i < NVM_FLASH_ROWSIZE; i++)
+            {
+                p_flash[i] &= p_data[i];
+            }
+        }
+    }
+
+    s_op = FAKE_NVM_OP_NONE;
+
+    if (isInterrupt && (s_cb != NULL))
+    {
+        s_cb(s_context);
+    }
+}
+
+uint32_t FAKE_NVM_GetOpNum(void)
+{
+    return s_opNum;
+}
+
+static bool fake_nvm_Start(FAKE_NVM_Op_T op, const uint32_t *p_data, uint32_t address)
+{
+    if (s_op != FAKE_NVM_OP_NONE)
+    {
+        return false;
+    }
+
+    s_op = op;
+    s_p_opData = p_data;
+    s_opAddress = address;
+    s_error = NVM_ERROR_NONE;
+    s_opNum++;
+
+    return true;
+}
+
+bool NVM_PageErase(uint32_t address)
+{
+    return fake_nvm_Start(FAKE_NVM_OP_ERASE, NULL, address - (address % NVM_FLASH_PAGESIZE));
+}
+
+bool NVM_RowWrite(uint32_t *data, uint32_t address)
+{
+    return fake_nvm_Start(FAKE_NVM_OP_WRITE, data, address - (address % NVM_FLASH_ROWSIZE));
+}
+
+NVM_ERROR NVM_ErrorGet(void)
+{
+    return s_error;
+}
+
+bool NVM_IsBusy(void)
+{
+    return (s_op != FAKE_NVM_OP_NONE);
+}
+
+void NVM_CallbackRegister(NVM_CALLBACK callback, uintptr_t context)
+{
+    s_cb = callback;
+    s_context = context;
+}
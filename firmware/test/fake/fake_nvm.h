@@ -0,0 +1,60 @@
+/*******************************************************************************
+  Host Test Fake NVM Header File
+
+  File Name:
+    fake_nvm.h
+
+  Summary:
+    Host stand-in for the NVM peripheral library.
+
+  Description:
+    The flash is mapped at its device address, so the firmware reads it back
+    as it does on the device. An erase or a row write keeps the NVM busy
+    until the test ends it with FAKE_NVM_End(), which applies the operation
+    and, unless the test drops it, calls the interrupt callback.
+ *******************************************************************************/
+
+#ifndef FAKE_NVM_H
+#define FAKE_NVM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "peripheral/nvm/plib_nvm.h"
+
+/**@brief Fake NVM operation. */
+typedef enum FAKE_NVM_Op_T
+{
+    FAKE_NVM_OP_NONE,
+    FAKE_NVM_OP_ERASE,
+    FAKE_NVM_OP_WRITE
+} FAKE_NVM_Op_T;
+
+/**@brief Maps the flash if needed, fills it with a pattern that is neither erased nor written, and ends any operation.
+ *
+ * @retval true                     The flash is mapped at its device address.
+ * @retval false                    The address range is not available on the host.
+ */
+bool FAKE_NVM_Reset(void);
+
+/**@brief Gets the operation in progress.
+ *
+ * @param[out] p_address            Address of the operation, may be NULL.
+ *
+ * @retval The operation, FAKE_NVM_OP_NONE if the NVM is not busy.
+ */
+FAKE_NVM_Op_T FAKE_NVM_GetOp(uint32_t *p_address);
+
+/**@brief Ends the operation in progress.
+ *
+ * @param[in] error                 Error reported by NVM_ErrorGet(), the flash is left unchanged if not NVM_ERROR_NONE.
+ * @param[in] isInterrupt           False to drop the interrupt.
+ */
+void FAKE_NVM_End(NVM_ERROR error, bool isInterrupt);
+
+/**@brief Gets the number of operations started since the last reset.
+ *
+ * @retval The number of operations.
+ */
+uint32_t FAKE_NVM_GetOpNum(void);
+
+#endif // FAKE_NVM_H
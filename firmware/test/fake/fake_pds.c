@@ -0,0 +1,165 @@
+/*******************************************************************************
+  Host Test Fake PDS Source File
+
+  File Name:
+    fake_pds.c
+
+  Summary:
+    Host stand-in for the persistent data server.
+
+  Description:
+    Stores of the same item are coalesced until the next flush, like the
+    pending items of the real server.
+ *******************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include "fake_pds.h"
+
+#define FAKE_PDS_ITEM_MAX           (64U)
+
+typedef struct FAKE_PDS_Item_T
+{
+    const ItemIdToMemoryMapping_t   *p_item;
+    uint8_t                         *p_image;       // NULL while the item is not in flash.
+    bool                            isPending;
+} FAKE_PDS_Item_T;
+
+static FAKE_PDS_Item_T  s_item[FAKE_PDS_ITEM_MAX];
+static uint32_t         s_itemNum;
+static uint32_t         s_writeNum;
+static void             (*s_writeCompleteCb)(PDS_MemId_t);
+
+static FAKE_PDS_Item_T *fake_pds_Find(PDS_MemId_t memoryId)
+{
+    uint32_t i;
+
+    for (i = 0; i < s_itemNum; i++)
+    {
+        if (s_item[i].p_item->itemId == memoryId)
+        {
+            return &s_item[i];
+        }
+    }
+
+    return NULL;
+}
+
+void FAKE_PDS_Reset(void)
+{
+    uint32_t i;
+
+    for (i = 0; i < s_itemNum; i++)
+    {
+        free(s_item[i].p_image);
+    }
+    memset(s_item, 0, sizeof(s_item));
+    s_itemNum = 0U;
+    s_writeNum = 0U;
+}
+
+void FAKE_PDS_Register(const ItemIdToMemoryMapping_t *p_item)
+{
+    if ((s_itemNum < FAKE_PDS_ITEM_MAX) && (fake_pds_Find(p_item->itemId) == NULL))
+    {
+        s_item[s_itemNum++].p_item = p_item;
+    }
+}
+
+void FAKE_PDS_Flush(void)
+{
+    uint32_t i;
+
+    for (i = 0; i < s_itemNum; i++)
+    {
+        FAKE_PDS_Item_T *p_fake = &s_item[i];
+
+        if (!p_fake->isPending)
+        {
+            continue;
+        }
+
+        p_fake->isPending = false;
+        if (p_fake->p_image == NULL)
+        {
+            p_fake->p_image = malloc(p_fake->p_item->itemSize);
+        }
+        memcpy(p_fake->p_image, p_fake->p_item->itemData, p_fake->p_item->itemSize);
+        s_writeNum++;
+
+        if (s_writeCompleteCb != NULL)
+        {
+            s_writeCompleteCb(p_fake->p_item->itemId);
+        }
+    }
+}
+
+void FAKE_PDS_ClearRam(void)
+{
+    uint32_t i;
+
+    for (i = 0; i < s_itemNum; i++)
+    {
+        memset(s_item[i].p_item->itemData, 0, s_item[i].p_item->itemSize);
+        s_item[i].isPending = false;
+    }
+}
+
+uint32_t FAKE_PDS_GetWriteNum(void)
+{
+    return s_writeNum;
+}
+
+bool PDS_IsAbleToRestore(PDS_MemId_t memoryId)
+{
+    FAKE_PDS_Item_T *p_fake = fake_pds_Find(memoryId);
+
+    return (p_fake != NULL) && (p_fake->p_image != NULL);
+}
+
+bool PDS_Restore(PDS_MemId_t memoryId)
+{
+    FAKE_PDS_Item_T *p_fake = fake_pds_Find(memoryId);
+
+    if ((p_fake == NULL) || (p_fake->p_image == NULL))
+    {
+        return false;
+    }
+
+    memcpy(p_fake->p_item->itemData, p_fake->p_image, p_fake->p_item->itemSize);
+
+    return true;
+}
+
+bool PDS_Store(PDS_MemId_t memoryId)
+{
+    FAKE_PDS_Item_T *p_fake = fake_pds_Find(memoryId);
+
+    if (p_fake == NULL)
+    {
+        return false;
+    }
+
+    p_fake->isPending = true;
+
+    return true;
+}
+
+PDS_DataServerState_t PDS_Delete(PDS_MemId_t memoryId)
+{
+    FAKE_PDS_Item_T *p_fake = fake_pds_Find(memoryId);
+
+    if (p_fake != NULL)
+    {
+        free(p_fake->p_image);
+        p_fake->p_image = NULL;
+        p_fake->isPending = false;
+    }
+
+    return PDS_SUCCESS;
+}
+
+void PDS_RegisterWriteCompleteCallback(void (*callbackFn)(PDS_MemId_t))
+{
+    s_writeCompleteCb = callbackFn;
+}
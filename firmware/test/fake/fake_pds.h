@@ -0,0 +1,45 @@
+/*******************************************************************************
+  Host Test Fake PDS Header File
+
+  File Name:
+    fake_pds.h
+
+  Summary:
+    Host stand-in for the persistent data server.
+
+  Description:
+    The flash image of each item is kept in host memory. A store is only
+    written by FAKE_PDS_Flush(), as the idle task would, which then calls the
+    write complete callback. The items are the ones declared with
+    PDS_DECLARE_FILE; a test registers the ones of the module under test
+    through their pds_ff_<id> descriptors.
+ *******************************************************************************/
+
+#ifndef FAKE_PDS_H
+#define FAKE_PDS_H
+
+#include <stdint.h>
+#include "pds.h"
+
+/**@brief Erases the flash images and forgets the registered items. */
+void FAKE_PDS_Reset(void);
+
+/**@brief Registers an item declared with PDS_DECLARE_FILE.
+ *
+ * @param[in] p_item                Descriptor of the item, pds_ff_<id>.
+ */
+void FAKE_PDS_Register(const ItemIdToMemoryMapping_t *p_item);
+
+/**@brief Writes the items waiting to be stored and calls the write complete callback of each. */
+void FAKE_PDS_Flush(void);
+
+/**@brief Clears the RAM of the registered items, as a reset would.*/
+void FAKE_PDS_ClearRam(void);
+
+/**@brief Gets the number of item writes since the last reset.
+ *
+ * @retval The number of writes.
+ */
+uint32_t FAKE_PDS_GetWriteNum(void);
+
+#endif // FAKE_PDS_H
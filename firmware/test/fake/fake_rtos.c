@@ -0,0 +1,237 @@
+/*******************************************************************************
+  Host Test Fake RTOS Source File
+
+  File Name:
+    fake_rtos.c
+
+  Summary:
+    Host stand-ins for the FreeRTOS tick, the cycle counter and the OSAL.
+
+  Description:
+    A queue or a semaphore is a ring of items, a semaphore item has no data.
+    Critical sections do nothing, the tests run in a single thread and call
+    the interrupt handlers themselves.
+ *******************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include "osal/osal_freertos_extend.h"
+#include "fake_rtos.h"
+
+#define FAKE_RTOS_QUEUE_MAX         (32U)
+
+struct QueueDefinition
+{
+    uint8_t     *p_items;
+    uint32_t    length;
+    uint32_t    itemSize;
+    uint32_t    readIndex;
+    uint32_t    count;
+};
+
+static DWT_Type                 s_dwt;
+static CoreDebug_Type           s_coreDebug;
+static SysTick_Type             s_sysTick;
+static SCB_Type                 s_scb;
+DWT_Type                        *DWT = &s_dwt;
+CoreDebug_Type                  *CoreDebug = &s_coreDebug;
+SysTick_Type                    *SysTick = &s_sysTick;
+SCB_Type                        *SCB = &s_scb;
+
+static uint64_t                 s_timeUs;
+static uint32_t                 s_allocNum;
+static struct QueueDefinition   *s_queue[FAKE_RTOS_QUEUE_MAX];
+static uint32_t                 s_queueNum;
+
+#define FAKE_RTOS_CYCLES_PER_US     (configCPU_CLOCK_HZ / 1000000UL)
+
+void FAKE_RTOS_Reset(void)
+{
+    uint32_t i;
+
+    for (i = 0U; i < s_queueNum; i++)
+    {
+        free(s_queue[i]->p_items);
+        free(s_queue[i]);
+    }
+    s_queueNum = 0U;
+    s_timeUs = 0U;
+    s_dwt.CYCCNT = 0U;
+}
+
+void FAKE_RTOS_AdvanceUs(uint32_t us)
+{
+    s_timeUs += us;
+    s_dwt.CYCCNT += us * FAKE_RTOS_CYCLES_PER_US;
+}
+
+uint64_t FAKE_RTOS_GetTimeUs(void)
+{
+    return s_timeUs;
+}
+
+uint32_t FAKE_RTOS_CyclesToUs(uint32_t cycles)
+{
+    return cycles / FAKE_RTOS_CYCLES_PER_US;
+}
+
+uint32_t FAKE_RTOS_GetAllocNum(void)
+{
+    return s_allocNum;
+}
+
+TickType_t xTaskGetTickCount(void)
+{
+    return (TickType_t)((s_timeUs / 1000U) / portTICK_PERIOD_MS);
+}
+
+TickType_t xTaskGetTickCountFromISR(void)
+{
+    return xTaskGetTickCount();
+}
+
+void *OSAL_Malloc(size_t size)
+{
+    s_allocNum++;
+
+    return malloc(size);
+}
+
+void OSAL_Free(void *pData)
+{
+    if (pData != NULL)
+    {
+        s_allocNum--;
+    }
+    free(pData);
+}
+
+OSAL_CRITSECT_DATA_TYPE OSAL_CRIT_Enter(OSAL_CRIT_TYPE severity)
+{
+    (void)severity;
+
+    return 0;
+}
+
+void OSAL_CRIT_Leave(OSAL_CRIT_TYPE severity, OSAL_CRITSECT_DATA_TYPE status)
+{
+    (void)severity;
+    (void)status;
+}
+
+static struct QueueDefinition *fake_rtos_CreateQueue(uint32_t length, uint32_t itemSize)
+{
+    struct QueueDefinition *p_queue;
+
+    if (s_queueNum >= FAKE_RTOS_QUEUE_MAX)
+    {
+        return NULL;
+    }
+
+    p_queue = calloc(1U, sizeof(struct QueueDefinition));
+    p_queue->p_items = calloc(length, (itemSize == 0U) ? 1U : itemSize);
+    p_queue->length = length;
+    p_queue->itemSize = itemSize;
+    s_queue[s_queueNum++] = p_queue;
+
+    return p_queue;
+}
+
+static OSAL_RESULT fake_rtos_Put(struct QueueDefinition *p_queue, const void *p_item)
+{
+    if (p_queue->count >= p_queue->length)
+    {
+        return OSAL_RESULT_FAIL;
+    }
+
+    if (p_queue->itemSize != 0U)
+    {
+        (void)memcpy(&p_queue->p_items[((p_queue->readIndex + p_queue->count) % p_queue->length) * p_queue->itemSize],
+            p_item, p_queue->itemSize);
+    }
+    p_queue->count++;
+
+    return OSAL_RESULT_SUCCESS;
+}
+
+static OSAL_RESULT fake_rtos_Get(struct QueueDefinition *p_queue, void *p_item)
+{
+    if (p_queue->count == 0U)
+    {
+        return OSAL_RESULT_FAIL;
+    }
+
+    if (p_queue->itemSize != 0U)
+    {
+        (void)memcpy(p_item, &p_queue->p_items[p_queue->readIndex * p_queue->itemSize], p_queue->itemSize);
+    }
+    p_queue->readIndex = (p_queue->readIndex + 1U) % p_queue->length;
+    p_queue->count--;
+
+    return OSAL_RESULT_SUCCESS;
+}
+
+OSAL_RESULT OSAL_QUEUE_Create(OSAL_QUEUE_HANDLE_TYPE *queID, uint32_t queueLength, uint32_t itemSize)
+{
+    *queID = fake_rtos_CreateQueue(queueLength, itemSize);
+
+    return (*queID != NULL) ? OSAL_RESULT_SUCCESS : OSAL_RESULT_FAIL;
+}
+
+OSAL_RESULT OSAL_QUEUE_Send(OSAL_QUEUE_HANDLE_TYPE *queID, void *itemToQueue, uint32_t waitMS)
+{
+    (void)waitMS;
+
+    return fake_rtos_Put(*queID, itemToQueue);
+}
+
+OSAL_RESULT OSAL_QUEUE_SendISR(OSAL_QUEUE_HANDLE_TYPE *queID, void *itemToQueue)
+{
+    return fake_rtos_Put(*queID, itemToQueue);
+}
+
+OSAL_RESULT OSAL_QUEUE_Receive(OSAL_QUEUE_HANDLE_TYPE *queID, void *pBuffer, uint32_t waitMS)
+{
+    (void)waitMS;
+
+    return fake_rtos_Get(*queID, pBuffer);
+}
+
+uint8_t OSAL_QUEUE_MessagesWaiting(OSAL_QUEUE_HANDLE_TYPE queID)
+{
+    return (uint8_t)queID->count;
+}
+
+OSAL_RESULT OSAL_SEM_Create(OSAL_SEM_HANDLE_TYPE *semID, OSAL_SEM_TYPE type, uint8_t maxCount, uint8_t initialCount)
+{
+    *semID = fake_rtos_CreateQueue((type == OSAL_SEM_TYPE_BINARY) ? 1U : maxCount, 0U);
+    if (*semID == NULL)
+    {
+        return OSAL_RESULT_FAIL;
+    }
+    (*semID)->count = initialCount;
+
+    return OSAL_RESULT_SUCCESS;
+}
+
+OSAL_RESULT OSAL_SEM_Pend(OSAL_SEM_HANDLE_TYPE *semID, uint32_t waitMS)
+{
+    (void)waitMS;
+
+    return fake_rtos_Get(*semID, NULL);
+}
+
+OSAL_RESULT OSAL_SEM_Post(OSAL_SEM_HANDLE_TYPE *semID)
+{
+    return fake_rtos_Put(*semID, NULL);
+}
+
+OSAL_RESULT OSAL_SEM_PostISR(OSAL_SEM_HANDLE_TYPE *semID)
+{
+    return fake_rtos_Put(*semID, NULL);
+}
+
+uint8_t OSAL_SEM_GetCount(OSAL_SEM_HANDLE_TYPE *semID)
+{
+    return (uint8_t)(*semID)->count;
+}
@@ -0,0 +1,53 @@
+/*******************************************************************************
+  Host Test Fake RTOS Header File
+
+  File Name:
+    fake_rtos.h
+
+  Summary:
+    Host stand-ins for the FreeRTOS tick, the cycle counter and the OSAL.
+
+  Description:
+    The firmware sources run on the host against these functions. Time only
+    moves when a test advances it: FAKE_RTOS_AdvanceUs() moves the cycle
+    counter at the CPU clock and the tick count at the FreeRTOS tick rate.
+    The OSAL queues and semaphores never block; a wait that cannot be served
+    at once fails.
+ *******************************************************************************/
+
+#ifndef FAKE_RTOS_H
+#define FAKE_RTOS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**@brief Resets the time to zero and releases the OSAL queues and semaphores. */
+void FAKE_RTOS_Reset(void);
+
+/**@brief Advances the time.
+ *
+ * @param[in] us                    Microseconds to advance.
+ */
+void FAKE_RTOS_AdvanceUs(uint32_t us);
+
+/**@brief Gets the time elapsed since the last reset.
+ *
+ * @retval The time in microseconds.
+ */
+uint64_t FAKE_RTOS_GetTimeUs(void);
+
+/**@brief Converts cycle counter ticks to microseconds.
+ *
+ * @param[in] cycles                Cycle count.
+ *
+ * @retval The time in microseconds.
+ */
+uint32_t FAKE_RTOS_CyclesToUs(uint32_t cycles);
+
+/**@brief Gets the number of blocks allocated with OSAL_Malloc and not freed yet.
+ *
+ * @retval The number of blocks.
+ */
+uint32_t FAKE_RTOS_GetAllocNum(void);
+
+#endif // FAKE_RTOS_H
@@ -0,0 +1,266 @@
+/*******************************************************************************
+  Host Test Reference AES Source File
+
+  File Name:
+    ref_aes.c
+
+  Summary:
+    Plain C AES-128 and AES-CCM used as the reference of the cryptographic
+    tests.
+
+  Description:
+    The S-box is computed once from its definition, the multiplicative
+    inverse in GF(2^8) followed by the affine transform, so no table is
+    copied from elsewhere. CCM follows NIST SP 800-38C: a CBC-MAC over the
+    formatted blocks, then CTR mode from counter block 1, counter block 0
+    masking the tag.
+ *******************************************************************************/
+
+#include <string.h>
+#include <stdbool.h>
+#include "ref_aes.h"
+
+static uint8_t  s_sbox[256];
+static bool     s_isSboxReady;
+
+static uint8_t ref_aes_Xtime(uint8_t x)
+{
+    return (uint8_t)((x << 1) ^ (((x & 0x80U) != 0U) ? 0x1BU : 0x00U));
+}
+
+static uint8_t ref_aes_Mul(uint8_t a, uint8_t b)
+{
+    uint8_t p = 0;
+
+    while (b != 0U)
+    {
+        if ((b & 1U) != 0U)
+        {
+            p ^= a;
+        }
+        a = ref_aes_Xtime(a);
+        b >>= 1;
+    }
+
+    return p;
+}
+
+static uint8_t ref_aes_Rotl(uint8_t x, uint8_t n)
+{
+    return (uint8_t)((x << n) | (x >> (8U - n)));
+}
+
+static void ref_aes_BuildSbox(void)
+{
+    uint16_t x;
+    uint16_t y;
+    uint8_t inv;
+
+    for (x = 0; x < 256U; x++)
+    {
+        inv = 0;
+        for (y = 1; (x != 0U) && (y < 256U); y++)
+        {
+            if (ref_aes_Mul((uint8_t)x, (uint8_t)y) == 1U)
+            {
+                inv = (uint8_t)y;
+                break;
+            }
+        }
+        s_sbox[x] = (uint8_t)(inv ^ ref_aes_Rotl(inv, 1) ^ ref_aes_Rotl(inv, 2) ^ ref_aes_Rotl(inv, 3)
+            ^ ref_aes_Rotl(inv, 4) ^ 0x63U);
+    }
+
+    s_isSboxReady = true;
+}
+
+void REF_AES_Encrypt(const uint8_t *p_key, const uint8_t *p_in, uint8_t *p_out)
+{
+    uint8_t roundKey[176];
+    uint8_t state[16];
+    uint8_t tmp[16];
+    uint8_t rcon = 1;
+    uint8_t round;
+    uint8_t i;
+    uint8_t c;
+
+    if (!s_isSboxReady)
+    {
+        ref_aes_BuildSbox();
+    }
+
+    // Key expansion
+    memcpy(roundKey, p_key, 16);
+    for (i = 16; i < 176U; i += 4U)
+    {
+        memcpy(tmp, &roundKey[i - 4U], 4);
+        if ((i % 16U) == 0U)
+        {
+            c = tmp[0];
+            tmp[0] = (uint8_t)(s_sbox[tmp[1]] ^ rcon);
+            tmp[1] = s_sbox[tmp[2]];
+            tmp[2] = s_sbox[tmp[3]];
+            tmp[3] = s_sbox[c];
+            rcon = ref_aes_Xtime(rcon);
+        }
+        for (c = 0; c < 4U; c++)
+        {
+            roundKey[i + c] = roundKey[i - 16U + c] ^ tmp[c];
+        }
+    }
+
+    for (i = 0; i < 16U; i++)
+    {
+        state[i] = p_in[i] ^ roundKey[i];
+    }
+
+    for (round = 1; round <= 10U; round++)
+    {
+        // SubBytes and ShiftRows, the state is stored column by column
+        for (i = 0; i < 16U; i++)
+        {
+            tmp[i] = s_sbox[state[((i + (4U * (i % 4U))) % 16U)]];
+        }
+
+        // MixColumns, except in the last round
+        for (c = 0; (round < 10U) && (c < 4U); c++)
+        {
+            uint8_t *p_col = &tmp[4U * c];
+            uint8_t a0 = p_col[0];
+            uint8_t a1 = p_col[1];
+            uint8_t a2 = p_col[2];
+            uint8_t a3 = p_col[3];
+
+            p_col[0] = (uint8_t)(ref_aes_Xtime(a0) ^ ref_aes_Xtime(a1) ^ a1 ^ a2 ^ a3);
+            p_col[1] = (uint8_t)(a0 ^ ref_aes_Xtime(a1) ^ ref_aes_Xtime(a2) ^ a2 ^ a3);
+            p_col[2] = (uint8_t)(a0 ^ a1 ^ ref_aes_Xtime(a2) ^ ref_aes_Xtime(a3) ^ a3);
+            p_col[3] = (uint8_t)(ref_aes_Xtime(a0) ^ a0 ^ a1 ^ a2 ^ ref_aes_Xtime(a3));
+        }
+
+        for (i = 0; i < 16U; i++)
+        {
+            state[i] = tmp[i] ^ roundKey[(16U * round) + i];
+        }
+    }
+
+    memcpy(p_out, state, 16);
+}
+
+// Builds the counter block i: flags, nonce, counter on the remaining bytes
+static void ref_aes_CcmCounter(const uint8_t *p_nonce, uint8_t nonceLen, uint32_t i, uint8_t *p_block)
+{
+    uint8_t q = (uint8_t)(15U - nonceLen);
+    uint8_t j;
+
+    memset(p_block, 0, REF_AES_BLOCK_LEN);
+    p_block[0] = (uint8_t)(q - 1U);
+    memcpy(&p_block[1], p_nonce, nonceLen);
+    for (j = 0; (j < q) && (j < 4U); j++)
+    {
+        p_block[15U - j] = (uint8_t)(i >> (8U * j));
+    }
+}
+
+static void ref_aes_CcmMac(const uint8_t *p_key, const uint8_t *p_nonce, uint8_t nonceLen, const uint8_t *p_aad,
+    uint16_t aadLen, const uint8_t *p_data, uint16_t len, uint8_t tagLen, uint8_t *p_mac)
+{
+    uint8_t q = (uint8_t)(15U - nonceLen);
+    uint8_t pos;
+    uint16_t i;
+    uint8_t j;
+
+    // B0: flags, nonce, message length
+    memset(p_mac, 0, REF_AES_BLOCK_LEN);
+    p_mac[0] = (uint8_t)(((aadLen > 0U) ? 0x40U : 0x00U) | (((tagLen - 2U) / 2U) << 3) | (q - 1U));
+    memcpy(&p_mac[1], p_nonce, nonceLen);
+    for (j = 0; (j < q) && (j < 2U); j++)
+    {
+        p_mac[15U - j] = (uint8_t)(len >> (8U * j));
+    }
+    REF_AES_Encrypt(p_key, p_mac, p_mac);
+
+    // Additional data, after its 2-byte length, zero padded to a block
+    if (aadLen > 0U)
+    {
+        p_mac[0] ^= (uint8_t)(aadLen >> 8);
+        p_mac[1] ^= (uint8_t)aadLen;
+        pos = 2U;
+        for (i = 0; i < aadLen; i++)
+        {
+            p_mac[pos++] ^= p_aad[i];
+            if (pos == REF_AES_BLOCK_LEN)
+            {
+                REF_AES_Encrypt(p_key, p_mac, p_mac);
+                pos = 0U;
+            }
+        }
+        if (pos > 0U)
+        {
+            REF_AES_Encrypt(p_key, p_mac, p_mac);
+        }
+    }
+
+    // Message, zero padded to a block
+    for (i = 0; i < len; i += REF_AES_BLOCK_LEN)
+    {
+        for (j = 0; (j < REF_AES_BLOCK_LEN) && ((i + j) < len); j++)
+        {
+            p_mac[j] ^= p_data[i + j];
+        }
+        REF_AES_Encrypt(p_key, p_mac, p_mac);
+    }
+}
+
+static void ref_aes_CcmCtr(const uint8_t *p_key, const uint8_t *p_nonce, uint8_t nonceLen, const uint8_t *p_in,
+    uint16_t len, uint8_t *p_out)
+{
+    uint8_t block[REF_AES_BLOCK_LEN];
+    uint16_t i;
+    uint8_t j;
+
+    for (i = 0; i < len; i += REF_AES_BLOCK_LEN)
+    {
+        ref_aes_CcmCounter(p_nonce, nonceLen, (uint32_t)(i / REF_AES_BLOCK_LEN) + 1U, block);
+        REF_AES_Encrypt(p_key, block, block);
+        for (j = 0; (j < REF_AES_BLOCK_LEN) && ((i + j) < len); j++)
+        {
+            p_out[i + j] = p_in[i + j] ^ block[j];
+        }
+    }
+}
+
+static void ref_aes_CcmMaskTag(const uint8_t *p_key, const uint8_t *p_nonce, uint8_t nonceLen, uint8_t *p_mac)
+{
+    uint8_t block[REF_AES_BLOCK_LEN];
+    uint8_t j;
+
+    ref_aes_CcmCounter(p_nonce, nonceLen, 0U, block);
+    REF_AES_Encrypt(p_key, block, block);
+    for (j = 0; j < REF_AES_BLOCK_LEN; j++)
+    {
+        p_mac[j] ^= block[j];
+    }
+}
+
+void REF_AES_CcmEncrypt(const uint8_t *p_key, const uint8_t *p_nonce, uint8_t nonceLen, const uint8_t *p_aad,
+    uint16_t aadLen, const uint8_t *p_in, uint16_t len, uint8_t *p_out, uint8_t *p_tag, uint8_t tagLen)
+{
+    uint8_t mac[REF_AES_BLOCK_LEN];
+
+    ref_aes_CcmMac(p_key, p_nonce, nonceLen, p_aad, aadLen, p_in, len, tagLen, mac);
+    ref_aes_CcmMaskTag(p_key, p_nonce, nonceLen, mac);
+    ref_aes_CcmCtr(p_key, p_nonce, nonceLen, p_in, len, p_out);
+    memcpy(p_tag, mac, tagLen);
+}
+
+bool REF_AES_CcmDecrypt(const uint8_t *p_key, const uint8_t *p_nonce, uint8_t nonceLen, const uint8_t *p_aad,
+    uint16_t aadLen, const uint8_t *p_in, uint16_t len, uint8_t *p_out, const uint8_t *p_tag, uint8_t tagLen)
+{
+    uint8_t mac[REF_AES_BLOCK_LEN];
+
+    ref_aes_CcmCtr(p_key, p_nonce, nonceLen, p_in, len, p_out);
+    ref_aes_CcmMac(p_key, p_nonce, nonceLen, p_aad, aadLen, p_out, len, tagLen, mac);
+    ref_aes_CcmMaskTag(p_key, p_nonce, nonceLen, mac);
+
+    return (memcmp(mac, p_tag, tagLen) == 0);
+}
@@ -0,0 +1,68 @@
+/*******************************************************************************
+  Host Test Reference AES Header File
+
+  File Name:
+    ref_aes.h
+
+  Summary:
+    Plain C AES-128 and AES-CCM used as the reference of the cryptographic
+    tests.
+
+  Description:
+    A straightforward FIPS-197 implementation, written for clarity rather
+    than speed. Byte arrays are in the order of the standard: the first byte
+    of a block is the most significant one.
+ *******************************************************************************/
+
+#ifndef REF_AES_H
+#define REF_AES_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define REF_AES_BLOCK_LEN           (16U)
+
+/**@brief Encrypts a block with AES-128.
+ *
+ * @param[in] p_key                 Key, 16 bytes.
+ * @param[in] p_in                  Plaintext block.
+ * @param[out] p_out                Ciphertext block, may be the same buffer as p_in.
+ */
+void REF_AES_Encrypt(const uint8_t *p_key, const uint8_t *p_in, uint8_t *p_out);
+
+/**@brief Encrypts and authenticates a message with AES-CCM (NIST SP 800-38C).
+ *
+ * @param[in] p_key                 Key, 16 bytes.
+ * @param[in] p_nonce               Nonce.
+ * @param[in] nonceLen              Length of the nonce, 7 to 13 bytes.
+ * @param[in] p_aad                 Additional authenticated data, may be NULL if aadLen is 0.
+ * @param[in] aadLen                Length of the additional authenticated data, below 0xFF00.
+ * @param[in] p_in                  Plaintext.
+ * @param[in] len                   Length of the plaintext.
+ * @param[out] p_out                Ciphertext, may be the same buffer as p_in.
+ * @param[out] p_tag                Tag.
+ * @param[in] tagLen                Length of the tag, 4 to 16 bytes.
+ */
+void REF_AES_CcmEncrypt(const uint8_t *p_key, const uint8_t *p_nonce, uint8_t nonceLen, const uint8_t *p_aad,
+    uint16_t aadLen, const uint8_t *p_in, uint16_t len, uint8_t *p_out, uint8_t *p_tag, uint8_t tagLen);
+
+/**@brief Decrypts a message with AES-CCM and verifies its tag.
+ *
+ * @param[in] p_key                 Key, 16 bytes.
+ * @param[in] p_nonce               Nonce.
+ * @param[in] nonceLen              Length of the nonce, 7 to 13 bytes.
+ * @param[in] p_aad                 Additional authenticated data, may be NULL if aadLen is 0.
+ * @param[in] aadLen                Length of the additional authenticated data, below 0xFF00.
+ * @param[in] p_in                  Ciphertext.
+ * @param[in] len                   Length of the ciphertext.
+ * @param[out] p_out                Plaintext, may be the same buffer as p_in.
+ * @param[in] p_tag                 Tag to verify.
+ * @param[in] tagLen                Length of the tag, 4 to 16 bytes.
+ *
+ * @retval true                     The tag is valid.
+ * @retval false                    The tag is not valid.
+ */
+bool REF_AES_CcmDecrypt(const uint8_t *p_key, const uint8_t *p_nonce, uint8_t nonceLen, const uint8_t *p_aad,
+    uint16_t aadLen, const uint8_t *p_in, uint16_t len, uint8_t *p_out, const uint8_t *p_tag, uint8_t tagLen);
+
+#endif // REF_AES_H
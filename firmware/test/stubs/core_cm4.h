@@ -0,0 +1,75 @@
+/*******************************************************************************
+  Host Test Cortex-M4 Core Stub Header File
+
+  File Name:
+    core_cm4.h
+
+  Summary:
+    Stands in for the CMSIS Cortex-M4 core header in the host tests.
+
+  Description:
+    The device header includes this file instead of the CMSIS one, so the
+    firmware sources compile on the host. The intrinsics are plain C, the
+    exclusive accesses always succeed, and the core peripherals used by the
+    application are variables updated by the fake RTOS (fake_rtos.c).
+ *******************************************************************************/
+
+#ifndef CORE_CM4_H
+#define CORE_CM4_H
+
+#include <stdint.h>
+
+#define __I                         volatile const
+#define __O                         volatile
+#define __IO                        volatile
+#define __IM                        volatile const
+#define __OM                        volatile
+#define __IOM                       volatile
+#define __STATIC_INLINE             static inline
+#define __STATIC_FORCEINLINE        static inline
+#define __INLINE                    inline
+#define __ALIGNED(x)                __attribute__((aligned(x)))
+#define __NO_RETURN                 __attribute__((noreturn))
+#define __WEAK                      __attribute__((weak))
+#define __USED                      __attribute__((used))
+#define __PACKED                    __attribute__((packed))
+
+#define __NOP()                     do {} while (0)
+#define __DSB()                     do {} while (0)
+#define __ISB()                     do {} while (0)
+#define __DMB()                     do {} while (0)
+#define __WFI()                     do {} while (0)
+#define __CLZ(x)                    ((uint8_t)(((x) == 0U) ? 32U : (uint32_t)__builtin_clz(x)))
+
+static inline uint32_t __LDREXW(volatile uint32_t *p_addr) { return *p_addr; }
+static inline uint32_t __STREXW(uint32_t value, volatile uint32_t *p_addr) { *p_addr = value; return 0U; }
+static inline void __CLREX(void) {}
+static inline uint32_t __get_PRIMASK(void) { return 0U; }
+static inline void __set_PRIMASK(uint32_t priMask) { (void)priMask; }
+static inline void __disable_irq(void) {}
+static inline void __enable_irq(void) {}
+static inline uint32_t __get_IPSR(void) { return 0U; }
+static inline uint32_t __get_BASEPRI(void) { return 0U; }
+static inline void __set_BASEPRI(uint32_t basePri) { (void)basePri; }
+
+static inline void NVIC_EnableIRQ(int irq) { (void)irq; }
+static inline void NVIC_DisableIRQ(int irq) { (void)irq; }
+static inline void NVIC_SetPriority(int irq, uint32_t priority) { (void)irq; (void)priority; }
+static inline void NVIC_ClearPendingIRQ(int irq) { (void)irq; }
+static inline void NVIC_SetPendingIRQ(int irq) { (void)irq; }
+static inline void NVIC_SystemReset(void) {}
+
+typedef struct { volatile uint32_t CTRL, CYCCNT; } DWT_Type;
+typedef struct { volatile uint32_t DEMCR; } CoreDebug_Type;
+typedef struct { volatile uint32_t CTRL, LOAD, VAL, CALIB; } SysTick_Type;
+typedef struct { volatile uint32_t CPUID, ICSR, VTOR, AIRCR, SCR, CCR; } SCB_Type;
+
+extern DWT_Type         *DWT;
+extern CoreDebug_Type   *CoreDebug;
+extern SysTick_Type     *SysTick;
+extern SCB_Type         *SCB;
+
+#define DWT_CTRL_CYCCNTENA_Msk          (1UL)
+#define CoreDebug_DEMCR_TRCENA_Msk      (1UL << 24U)
+
+#endif // CORE_CM4_H
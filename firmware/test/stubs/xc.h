@@ -0,0 +1 @@
+#include "device.h"
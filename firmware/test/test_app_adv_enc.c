@@ -0,0 +1,249 @@
+/*******************************************************************************
+  Application Encrypted Advertising Test Source File
+
+  File Name:
+    test_app_adv_enc.c
+
+  Summary:
+    Checks that the payloads encrypted by crypto jobs are in the Encrypted
+    Data format of MW_MISC_EncryptAdvData.
+
+  Description:
+    The real app_adv_enc.c, app_crypto.c, mw_aes.c and mw_misc.c run on the
+    fake crypto engine. Each payload handed to the controller is compared
+    byte for byte with the AD structure MW_MISC_EncryptAdvData builds from
+    the same key, IV, data and randomizer, and with the reference AES-CCM.
+    MW_MISC_DecryptAdvData must recover the data from every rotation.
+ *******************************************************************************/
+
+#include <string.h>
+#include "ble_gap.h"
+#include "mba_error_defs.h"
+#include "app_error_defs.h"
+#include "app_queue/app_queue.h"
+#include "app_crypto/app_crypto.h"
+#include "app_timer/app_timer.h"
+#include "ble_util/mw_entropy.h"
+#include "ble_util/mw_misc.h"
+#include "app_adv_enc.h"
+#include "fake_crm.h"
+#include "ref_aes.h"
+#include "unit_test.h"
+
+#define TEST_DATA_LEN               (20U)
+#define TEST_RANDOMIZER_LEN         (5U)
+#define TEST_MIC_LEN                (4U)
+#define TEST_HEADER_LEN             (2U + TEST_RANDOMIZER_LEN)
+#define TEST_ROTATE_NUM             (6U)
+
+// Key material as given to MW_MISC_EncryptAdvData, least significant octet first
+static const uint8_t s_key[APP_ADV_ENC_KEY_LEN] =
+    {0x2B, 0x7E, 0x15, 0x16, 0x28, 0xAE, 0xD2, 0xA6, 0xAB, 0xF7, 0x15, 0x88, 0x09, 0xCF, 0x4F, 0x3C};
+static const uint8_t s_iv[APP_ADV_ENC_IV_LEN] =
+    {0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27};
+
+static uint8_t          s_data[TEST_DATA_LEN];
+static uint8_t          s_air[APP_ADV_ENC_OVERHEAD + APP_ADV_ENC_DATA_MAX];
+static uint16_t         s_airLen;
+static uint32_t         s_airNum;
+static uint8_t          s_entropy;
+static const uint8_t    *s_p_replay;        // Randomizer the next MW_ENTROPY_Get returns.
+static uint32_t         s_wakeNum;
+
+uint16_t MW_ENTROPY_Get(uint8_t *p_buf, uint16_t length)
+{
+    uint16_t i;
+
+    if (s_p_replay != NULL)
+    {
+        (void)memcpy(p_buf, s_p_replay, length);
+        s_p_replay = NULL;
+        return MBA_RES_SUCCESS;
+    }
+
+    for (i = 0; i < length; i++)
+    {
+        p_buf[i] = s_entropy;
+        s_entropy = (uint8_t)((s_entropy * 5U) + 1U);
+    }
+
+    return MBA_RES_SUCCESS;
+}
+
+uint16_t APP_TIMER_SetTimer(uint8_t timerId, uint32_t timeout, bool isPeriodicTimer)
+{
+    (void)timerId;
+    (void)timeout;
+    (void)isPeriodicTimer;
+
+    return APP_RES_SUCCESS;
+}
+
+uint16_t BLE_GAP_SetPeriAdvData(BLE_GAP_PeriAdvDataParams_T *p_advDataParam)
+{
+    TEST_ASSERT(p_advDataParam->advLen <= sizeof(s_air));
+    (void)memcpy(s_air, p_advDataParam->p_advData, p_advDataParam->advLen);
+    s_airLen = p_advDataParam->advLen;
+    s_airNum++;
+
+    return MBA_RES_SUCCESS;
+}
+
+void APP_QUEUE_Wake(void)
+{
+    s_wakeNum++;
+}
+
+void APP_QUEUE_WakeISR(void)
+{
+    APP_QUEUE_Wake();
+}
+
+static void test_Reset(void)
+{
+    uint8_t i;
+
+    TEST_ASSERT(FAKE_CRM_Reset());
+    for (i = 0; i < TEST_DATA_LEN; i++)
+    {
+        s_data[i] = (uint8_t)((i * 13U) + 1U);
+    }
+    (void)memset(s_air, 0, sizeof(s_air));
+    s_airLen = 0U;
+    s_airNum = 0U;
+    s_entropy = 0x11U;
+    s_p_replay = NULL;
+    s_wakeNum = 0U;
+    APP_CRYPTO_Init();
+    APP_ADV_ENC_Init(0, s_key, s_iv);
+}
+
+// Ends the operations on the engine, the application task runs a pass each time it is woken
+static void test_RunEngine(void)
+{
+    while (FAKE_CRM_IsBusy())
+    {
+        FAKE_CRM_End(true);
+        while (s_wakeNum > 0U)
+        {
+            s_wakeNum--;
+            APP_CRYPTO_Poll();
+        }
+    }
+}
+
+// Checks the payload on air against MW_MISC_EncryptAdvData and the reference CCM
+static void test_CheckAir(void)
+{
+    MW_MISC_EncAdvData_T enc;
+    MW_MISC_DecAdvData_T dec;
+    uint8_t adv[APP_ADV_ENC_OVERHEAD + APP_ADV_ENC_DATA_MAX];
+    uint16_t advLen = 0U;
+    uint8_t key[APP_ADV_ENC_KEY_LEN];
+    uint8_t nonce[TEST_RANDOMIZER_LEN + APP_ADV_ENC_IV_LEN];
+    uint8_t aad = 0xEA;
+    uint8_t cipher[TEST_DATA_LEN];
+    uint8_t mic[TEST_MIC_LEN];
+    uint8_t plain[APP_ADV_ENC_DATA_MAX];
+    uint8_t plainLen = 0U;
+    uint8_t i;
+
+    TEST_ASSERT_EQUAL(TEST_DATA_LEN + APP_ADV_ENC_OVERHEAD, s_airLen);
+
+    // The same AD structure from MW_MISC, given the randomizer of the payload
+    s_p_replay = &s_air[2];
+    enc.p_key = (uint8_t *)s_key;
+    enc.p_iv = (uint8_t *)s_iv;
+    enc.payloadLen = TEST_DATA_LEN;
+    enc.p_payload = s_data;
+    enc.p_advDataLen = &advLen;
+    enc.p_advData = adv;
+    TEST_ASSERT_EQUAL(MBA_RES_SUCCESS, MW_MISC_EncryptAdvData(&enc));
+    TEST_ASSERT_EQUAL(s_airLen, advLen);
+    TEST_ASSERT(memcmp(adv, s_air, s_airLen) == 0);
+
+    // The reference: the key reversed, the nonce is the randomizer followed by the IV
+    for (i = 0; i < APP_ADV_ENC_KEY_LEN; i++)
+    {
+        key[i] = s_key[APP_ADV_ENC_KEY_LEN - 1U - i];
+    }
+    (void)memcpy(nonce, &s_air[2], TEST_RANDOMIZER_LEN);
+    (void)memcpy(&nonce[TEST_RANDOMIZER_LEN], s_iv, APP_ADV_ENC_IV_LEN);
+    REF_AES_CcmEncrypt(key, nonce, sizeof(nonce), &aad, 1U, s_data, TEST_DATA_LEN, cipher, mic, TEST_MIC_LEN);
+    TEST_ASSERT_EQUAL(TEST_DATA_LEN + 10U, s_air[0]);
+    TEST_ASSERT_EQUAL(0x31, s_air[1]);
+    TEST_ASSERT(memcmp(cipher, &s_air[TEST_HEADER_LEN], TEST_DATA_LEN) == 0);
+    TEST_ASSERT(memcmp(mic, &s_air[TEST_HEADER_LEN + TEST_DATA_LEN], TEST_MIC_LEN) == 0);
+
+    // A receiver decrypts it with MW_MISC
+    (void)memcpy(adv, s_air, s_airLen);
+    dec.p_key = (uint8_t *)s_key;
+    dec.p_iv = (uint8_t *)s_iv;
+    dec.p_payloadLen = &plainLen;
+    dec.p_payload = plain;
+    dec.advDataLen = s_airLen;
+    dec.p_advData = adv;
+    TEST_ASSERT_EQUAL(MBA_RES_SUCCESS, MW_MISC_DecryptAdvData(&dec));
+    TEST_ASSERT_EQUAL(TEST_DATA_LEN, plainLen);
+    TEST_ASSERT(memcmp(s_data, plain, TEST_DATA_LEN) == 0);
+}
+
+static void test_Format(void)
+{
+    test_Reset();
+
+    TEST_ASSERT_EQUAL(APP_RES_SUCCESS, APP_ADV_ENC_SetData(TEST_DATA_LEN, s_data));
+    test_RunEngine();
+    TEST_ASSERT_EQUAL(1, s_airNum);
+    test_CheckAir();
+
+    APP_ADV_ENC_Tick();
+    TEST_ASSERT_EQUAL(2, s_airNum);
+    test_CheckAir();
+}
+
+static void test_Rotation(void)
+{
+    uint8_t randomizer[TEST_ROTATE_NUM][TEST_RANDOMIZER_LEN];
+    APP_ADV_ENC_Stats_T stats;
+    uint8_t i;
+    uint8_t j;
+
+    test_Reset();
+
+    TEST_ASSERT_EQUAL(APP_RES_SUCCESS, APP_ADV_ENC_SetData(TEST_DATA_LEN, s_data));
+    test_RunEngine();
+
+    // Each payload carries its own randomizer and decrypts
+    for (i = 0; i < TEST_ROTATE_NUM; i++)
+    {
+        APP_ADV_ENC_Tick();
+        test_RunEngine();
+        test_CheckAir();
+        (void)memcpy(randomizer[i], &s_air[2], TEST_RANDOMIZER_LEN);
+        for (j = 0; j < i; j++)
+        {
+            TEST_ASSERT(memcmp(randomizer[i], randomizer[j], TEST_RANDOMIZER_LEN) != 0);
+        }
+    }
+
+    // New data is encrypted again with the same key
+    s_data[0] ^= 0xFFU;
+    TEST_ASSERT_EQUAL(APP_RES_SUCCESS, APP_ADV_ENC_SetData(TEST_DATA_LEN, s_data));
+    test_RunEngine();
+    test_CheckAir();
+
+    APP_ADV_ENC_GetStats(&stats);
+    TEST_ASSERT_EQUAL(0, stats.failCnt);
+    TEST_ASSERT_EQUAL(0, stats.missCnt);
+    TEST_ASSERT_EQUAL(0, FAKE_CRM_GetBusyFaultNum());
+    TEST_ASSERT_EQUAL(0, FAKE_CRM_GetClockFaultNum());
+}
+
+int main(void)
+{
+    TEST_RUN(test_Format);
+    TEST_RUN(test_Rotation);
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,352 @@
+/*******************************************************************************
+  Application Authentication Test Source File
+
+  File Name:
+    test_app_auth.c
+
+  Summary:
+    Checks the authenticated command frames against a reference central and
+    measures the verification.
+
+  Description:
+    The central is written from the frame format alone, on top of the
+    reference AES-CCM, which is itself checked against RFC 3610. The AES
+    middleware is a stub on the same reference, so the host time of a
+    verification is that of the reference, not of the engine; the test
+    checks what the engine would do per frame instead: no key is loaded and
+    the crypto clock is not toggled within a burst.
+
+    Built without CONFIG_APP_AUTH_PSK, the test checks that no session is
+    started with the placeholder key.
+ *******************************************************************************/
+
+#include <string.h>
+#include <time.h>
+#include "configuration.h"
+#include "app_error_defs.h"
+#include "ble_util/mw_conn.h"
+#include "ble_util/byte_stream.h"
+#include "app_auth.h"
+#include "fake_rtos.h"
+#include "fake_mw_aes.h"
+#include "ref_aes.h"
+#include "unit_test.h"
+
+#define TEST_CONN_HANDLE            (0x0041U)
+#define TEST_OTHER_CONN_HANDLE      (0x0042U)
+#define TEST_FRAME_MAX              (APP_AUTH_FRAME_OVERHEAD + 244U)
+
+typedef struct TEST_Central_T
+{
+    uint8_t     salt[APP_AUTH_SALT_LEN];
+    uint8_t     key[APP_AUTH_KEY_LEN];
+    uint32_t    counter;
+} TEST_Central_T;
+
+static const uint8_t    s_psk[APP_AUTH_KEY_LEN] = CONFIG_APP_AUTH_PSK;
+static uint8_t          s_entropy;
+
+uint8_t MW_CONN_GetIndex(uint16_t connHandle)
+{
+    if ((connHandle == TEST_CONN_HANDLE) || (connHandle == TEST_OTHER_CONN_HANDLE))
+    {
+        return (uint8_t)(connHandle - TEST_CONN_HANDLE);
+    }
+
+    return 0xFFU;
+}
+
+uint16_t MW_ENTROPY_Get(uint8_t *p_buf, uint16_t length)
+{
+    uint16_t i;
+
+    for (i = 0; i < length; i++)
+    {
+        s_entropy = (uint8_t)((s_entropy * 29U) + 71U);
+        p_buf[i] = s_entropy;
+    }
+
+    return APP_RES_SUCCESS;
+}
+
+// The central derives the session key from the salt of the "auth" reply
+static void test_CentralStart(TEST_Central_T *p_central, uint16_t connHandle)
+{
+    uint8_t block[APP_AUTH_KEY_LEN];
+
+    TEST_ASSERT_EQUAL(APP_RES_SUCCESS, APP_AUTH_Start(connHandle, p_central->salt));
+    memcpy(block, p_central->salt, APP_AUTH_SALT_LEN);
+    memcpy(&block[APP_AUTH_SALT_LEN], "SRVOAUTH", APP_AUTH_KEY_LEN - APP_AUTH_SALT_LEN);
+    REF_AES_Encrypt(s_psk, block, p_central->key);
+    p_central->counter = 0U;
+}
+
+// 0xA5 | counter | CCM(command) | tag, the header is the additional data
+static uint16_t test_CentralFrame(TEST_Central_T *p_central, const char *p_cmd, uint16_t cmdLen, uint8_t *p_frame)
+{
+    uint8_t nonce[13];
+
+    p_central->counter++;
+    p_frame[0] = APP_AUTH_FRAME_MAGIC;
+    U32_TO_BUF_LE(&p_frame[1], p_central->counter);
+
+    memcpy(nonce, p_central->salt, APP_AUTH_SALT_LEN);
+    U32_TO_BUF_LE(&nonce[APP_AUTH_SALT_LEN], p_central->counter);
+    nonce[12] = 0x00U;
+
+    REF_AES_CcmEncrypt(p_central->key, nonce, sizeof(nonce), p_frame, APP_AUTH_HEADER_LEN, (const uint8_t *)p_cmd,
+        cmdLen, &p_frame[APP_AUTH_HEADER_LEN], &p_frame[APP_AUTH_HEADER_LEN + cmdLen], APP_AUTH_TAG_LEN);
+
+    return (uint16_t)(cmdLen + APP_AUTH_FRAME_OVERHEAD);
+}
+
+static uint16_t test_Verify(uint16_t connHandle, uint8_t *p_frame, uint16_t len, const char *p_expected)
+{
+    uint8_t *p_data = p_frame;
+    uint16_t result;
+
+    TEST_ASSERT(APP_AUTH_IsFrame(len, p_frame));
+    result = APP_AUTH_VerifyFrame(connHandle, &p_data, &len);
+    if ((result == APP_RES_SUCCESS) && (p_expected != NULL))
+    {
+        // Decrypted in place, right after the header
+        TEST_ASSERT(p_data == &p_frame[APP_AUTH_HEADER_LEN]);
+        TEST_ASSERT_EQUAL(strlen(p_expected), len);
+        TEST_ASSERT_EQUAL(0, memcmp(p_data, p_expected, len));
+    }
+
+    return result;
+}
+
+static void test_Reset(void)
+{
+    FAKE_RTOS_Reset();
+    FAKE_MW_AES_Reset();
+    APP_AUTH_Init();
+}
+
+static void test_ReferenceCcm(void)
+{
+    // RFC 3610, packet vector #1
+    static const uint8_t nonce[13] = {0x00, 0x00, 0x00, 0x03, 0x02, 0x01, 0x00, 0xA0, 0xA1, 0xA2, 0xA3, 0xA4, 0xA5};
+    static const uint8_t expected[31] = {0x58, 0x8C, 0x97, 0x9A, 0x61, 0xC6, 0x63, 0xD2, 0xF0, 0x66, 0xD0, 0xC2,
+        0xC0, 0xF9, 0x89, 0x80, 0x6D, 0x5F, 0x6B, 0x61, 0xDA, 0xC3, 0x84, 0x17, 0xE8, 0xD1, 0x2C, 0xFD, 0xF9, 0x26,
+        0xE0};
+    uint8_t key[16];
+    uint8_t header[8];
+    uint8_t data[23];
+    uint8_t out[31];
+    uint8_t i;
+
+    for (i = 0; i < sizeof(key); i++)
+    {
+        key[i] = (uint8_t)(0xC0U + i);
+    }
+    for (i = 0; i < sizeof(header); i++)
+    {
+        header[i] = i;
+    }
+    for (i = 0; i < sizeof(data); i++)
+    {
+        data[i] = (uint8_t)(sizeof(header) + i);
+    }
+
+    REF_AES_CcmEncrypt(key, nonce, sizeof(nonce), header, sizeof(header), data, sizeof(data), out, &out[23], 8U);
+    TEST_ASSERT_EQUAL(0, memcmp(out, expected, sizeof(expected)));
+    TEST_ASSERT(REF_AES_CcmDecrypt(key, nonce, sizeof(nonce), header, sizeof(header), out, sizeof(data), out,
+        &out[23], 8U));
+    TEST_ASSERT_EQUAL(0, memcmp(out, data, sizeof(data)));
+}
+
+static void test_Frames(void)
+{
+    TEST_Central_T central;
+    uint8_t frame[TEST_FRAME_MAX];
+    uint16_t len;
+
+    test_Reset();
+    test_CentralStart(&central, TEST_CONN_HANDLE);
+
+    len = test_CentralFrame(&central, "start", 5U, frame);
+    TEST_ASSERT_EQUAL(APP_RES_SUCCESS, test_Verify(TEST_CONN_HANDLE, frame, len, "start"));
+
+    // Counters may skip, a lost frame does not stop the session
+    central.counter += 10U;
+    len = test_CentralFrame(&central, "set 1500", 8U, frame);
+    TEST_ASSERT_EQUAL(APP_RES_SUCCESS, test_Verify(TEST_CONN_HANDLE, frame, len, "set 1500"));
+    APP_AUTH_EndBurst();
+}
+
+static void test_Rejects(void)
+{
+    TEST_Central_T central;
+    TEST_Central_T other;
+    uint8_t frame[TEST_FRAME_MAX];
+    uint8_t copy[TEST_FRAME_MAX];
+    uint16_t len;
+    uint16_t i;
+    APP_AUTH_Stats_T stats;
+
+    test_Reset();
+
+    // No session
+    memset(&central, 0, sizeof(central));
+    len = test_CentralFrame(&central, "stop", 4U, frame);
+    TEST_ASSERT_EQUAL(APP_RES_BAD_STATE, test_Verify(TEST_CONN_HANDLE, frame, len, NULL));
+
+    test_CentralStart(&central, TEST_CONN_HANDLE);
+    test_CentralStart(&other, TEST_OTHER_CONN_HANDLE);
+
+    // Any changed byte, header, command or tag, fails the frame
+    len = test_CentralFrame(&central, "reverse", 7U, frame);
+    for (i = 1U; i < len; i++)
+    {
+        memcpy(copy, frame, len);
+        copy[i] ^= 0x01U;
+        TEST_ASSERT(test_Verify(TEST_CONN_HANDLE, copy, len, NULL) != APP_RES_SUCCESS);
+    }
+
+    // The frame of a connection is not accepted on another one, a failed frame is left garbled
+    memcpy(copy, frame, len);
+    TEST_ASSERT_EQUAL(APP_RES_FAIL, test_Verify(TEST_OTHER_CONN_HANDLE, copy, len, NULL));
+
+    TEST_ASSERT_EQUAL(APP_RES_SUCCESS, test_Verify(TEST_CONN_HANDLE, frame, len, "reverse"));
+
+    // Replays, of the same frame or of an older one, fail
+    len = test_CentralFrame(&central, "reverse", 7U, frame);
+    memcpy(copy, frame, len);
+    TEST_ASSERT_EQUAL(APP_RES_SUCCESS, test_Verify(TEST_CONN_HANDLE, frame, len, "reverse"));
+    TEST_ASSERT_EQUAL(APP_RES_FAIL, test_Verify(TEST_CONN_HANDLE, copy, len, NULL));
+
+    // Too short to hold a command
+    TEST_ASSERT_EQUAL(APP_RES_INVALID_PARA, test_Verify(TEST_CONN_HANDLE, frame, APP_AUTH_FRAME_OVERHEAD, NULL));
+
+    // A new session restarts the counter and drops the old key
+    len = test_CentralFrame(&central, "cal", 3U, copy);
+    test_CentralStart(&central, TEST_CONN_HANDLE);
+    TEST_ASSERT_EQUAL(APP_RES_FAIL, test_Verify(TEST_CONN_HANDLE, copy, len, NULL));
+    len = test_CentralFrame(&central, "cal", 3U, frame);
+    TEST_ASSERT_EQUAL(APP_RES_SUCCESS, test_Verify(TEST_CONN_HANDLE, frame, len, "cal"));
+
+    APP_AUTH_Stop(TEST_CONN_HANDLE);
+    len = test_CentralFrame(&central, "cal", 3U, frame);
+    TEST_ASSERT_EQUAL(APP_RES_BAD_STATE, test_Verify(TEST_CONN_HANDLE, frame, len, NULL));
+    APP_AUTH_EndBurst();
+
+    APP_AUTH_GetStats(&stats);
+    TEST_ASSERT_EQUAL(3, stats.verifyCnt);
+    TEST_ASSERT_EQUAL(2, stats.replayCnt);
+}
+
+static void test_KeyAndClockKept(void)
+{
+    TEST_Central_T central;
+    uint8_t frame[TEST_FRAME_MAX];
+    uint16_t len;
+    uint32_t i;
+
+    test_Reset();
+    test_CentralStart(&central, TEST_CONN_HANDLE);
+
+    // The pre-shared key for the derivation, then the session key for the first frame only
+    TEST_ASSERT_EQUAL(1, FAKE_MW_AES_GetKeyLoadNum());
+    for (i = 0U; i < 20U; i++)
+    {
+        len = test_CentralFrame(&central, "set 1500", 8U, frame);
+        TEST_ASSERT_EQUAL(APP_RES_SUCCESS, test_Verify(TEST_CONN_HANDLE, frame, len, "set 1500"));
+        TEST_ASSERT(FAKE_MW_AES_IsClockHeld());
+    }
+    TEST_ASSERT_EQUAL(2, FAKE_MW_AES_GetKeyLoadNum());
+    TEST_ASSERT_EQUAL(1, FAKE_MW_AES_GetClockHoldNum());
+
+    // The clock is released between bursts, the key stays loaded
+    APP_AUTH_EndBurst();
+    TEST_ASSERT(!FAKE_MW_AES_IsClockHeld());
+    len = test_CentralFrame(&central, "stop", 4U, frame);
+    TEST_ASSERT_EQUAL(APP_RES_SUCCESS, test_Verify(TEST_CONN_HANDLE, frame, len, "stop"));
+    APP_AUTH_EndBurst();
+    TEST_ASSERT_EQUAL(2, FAKE_MW_AES_GetKeyLoadNum());
+    TEST_ASSERT_EQUAL(2, FAKE_MW_AES_GetClockHoldNum());
+}
+
+static void test_VerifyLatency(void)
+{
+    static const uint16_t cmdLens[] = {4U, 16U, 64U, 128U, 244U};
+    const uint32_t rounds = 2000U;
+    TEST_Central_T central;
+    uint8_t frame[TEST_FRAME_MAX];
+    char cmd[244];
+    struct timespec t0;
+    struct timespec t1;
+    double refUs;
+    double verifyUs;
+    uint32_t blocks;
+    uint32_t loads;
+    uint16_t len;
+    uint32_t r;
+    uint8_t n;
+
+    test_Reset();
+    memset(cmd, 'x', sizeof(cmd));
+    test_CentralStart(&central, TEST_CONN_HANDLE);
+
+    // The first frame of the session loads its key
+    len = test_CentralFrame(&central, cmd, 4U, frame);
+    TEST_ASSERT_EQUAL(APP_RES_SUCCESS, test_Verify(TEST_CONN_HANDLE, frame, len, NULL));
+
+    printf("  command B  AES blocks/frame  key loads/frame  host verify us  (reference CCM us)\n");
+
+    for (n = 0; n < (sizeof(cmdLens) / sizeof(cmdLens[0])); n++)
+    {
+        verifyUs = 0.0;
+        refUs = 0.0;
+        FAKE_MW_AES_Reset();
+
+        for (r = 0U; r < rounds; r++)
+        {
+            (void)clock_gettime(CLOCK_MONOTONIC, &t0);
+            len = test_CentralFrame(&central, cmd, cmdLens[n], frame);
+            (void)clock_gettime(CLOCK_MONOTONIC, &t1);
+            refUs += ((t1.tv_sec - t0.tv_sec) * 1e6) + ((t1.tv_nsec - t0.tv_nsec) / 1e3);
+
+            t0 = t1;
+            TEST_ASSERT_EQUAL(APP_RES_SUCCESS, test_Verify(TEST_CONN_HANDLE, frame, len, NULL));
+            (void)clock_gettime(CLOCK_MONOTONIC, &t1);
+            verifyUs += ((t1.tv_sec - t0.tv_sec) * 1e6) + ((t1.tv_nsec - t0.tv_nsec) / 1e3);
+        }
+        APP_AUTH_EndBurst();
+
+        blocks = FAKE_MW_AES_GetBlockNum() / rounds;
+        loads = FAKE_MW_AES_GetKeyLoadNum();
+        printf("  %9u  %16u  %15.3f  %14.2f  (%.2f)\n", cmdLens[n], (unsigned)blocks, (double)loads / rounds,
+            verifyUs / rounds, refUs / rounds);
+
+        // B0, the header block and the first counter block, then two blocks per 16 bytes of command
+        TEST_ASSERT_EQUAL(3U + (2U * ((cmdLens[n] + 15U) / 16U)), blocks);
+        TEST_ASSERT_EQUAL(0, loads);
+    }
+}
+
+static void test_PlaceholderKey(void)
+{
+    uint8_t salt[APP_AUTH_SALT_LEN];
+
+    test_Reset();
+    TEST_ASSERT_EQUAL(APP_RES_BAD_STATE, APP_AUTH_Start(TEST_CONN_HANDLE, salt));
+    TEST_ASSERT_EQUAL(0, FAKE_MW_AES_GetKeyLoadNum());
+}
+
+int main(void)
+{
+    TEST_RUN(test_ReferenceCcm);
+#if defined(CONFIG_APP_AUTH_PSK_PLACEHOLDER)
+    TEST_RUN(test_PlaceholderKey);
+#else
+    TEST_RUN(test_Frames);
+    TEST_RUN(test_Rejects);
+    TEST_RUN(test_KeyAndClockKept);
+    TEST_RUN(test_VerifyLatency);
+#endif
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,401 @@
+/*******************************************************************************
+  Application Crypto Job Test Source File
+
+  File Name:
+    test_app_crypto.c
+
+  Summary:
+    Checks the scheduling of the crypto jobs against a fake crypto engine.
+
+  Description:
+    The real app_crypto.c and mw_aes.c run on the fake engine. The test plays
+    the application task: it runs a pass, polling the jobs, each time it is
+    woken. The results are checked against the reference AES. A completion
+    must not be lost when the wake cannot be counted, and a blocking MW_AES
+    call must complete the running jobs before it uses the engine.
+ *******************************************************************************/
+
+#include <string.h>
+#include "app.h"
+#include "app_error_defs.h"
+#include "app_queue/app_queue.h"
+#include "app_crypto/app_crypto.h"
+#include "ble_util/mw_aes.h"
+#include "mba_error_defs.h"
+#include "fake_crm.h"
+#include "ref_aes.h"
+#include "unit_test.h"
+
+#define TEST_JOB_NUM                (6U)
+#define TEST_CCM_LEN                (37U)
+#define TEST_TAG_LEN                (4U)
+#define TEST_WAKE_MAX               (4U)
+
+static const uint8_t s_key[APP_CRYPTO_KEY_LEN] =
+    {0x2B, 0x7E, 0x15, 0x16, 0x28, 0xAE, 0xD2, 0xA6, 0xAB, 0xF7, 0x15, 0x88, 0x09, 0xCF, 0x4F, 0x3C};
+static const uint8_t s_otherKey[APP_CRYPTO_KEY_LEN] =
+    {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F};
+static const uint8_t s_nonce[13] =
+    {0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1A, 0x1B, 0x1C};
+static const uint8_t s_aad[1] = {0xEA};
+
+static uint8_t  s_in[TEST_JOB_NUM][REF_AES_BLOCK_LEN];
+static uint8_t  s_out[TEST_JOB_NUM][REF_AES_BLOCK_LEN];
+static uint8_t  s_ccmIn[TEST_CCM_LEN];
+static uint8_t  s_ccmOut[TEST_CCM_LEN];
+static uint8_t  s_tag[TEST_TAG_LEN];
+static uint32_t s_wakeNum;                  // Count of the semaphore of the application task.
+static uint32_t s_wakeMax;
+static uint32_t s_doneNum;
+static uint16_t s_result[TEST_JOB_NUM];
+static bool     s_isResubmitting;
+
+void APP_QUEUE_Wake(void)
+{
+    if (s_wakeNum < s_wakeMax)
+    {
+        s_wakeNum++;
+    }
+}
+
+void APP_QUEUE_WakeISR(void)
+{
+    APP_QUEUE_Wake();
+}
+
+static void test_JobCb(uint16_t result, uintptr_t context);
+
+static void test_SubmitEcb(uint8_t index, const uint8_t *p_key)
+{
+    APP_CRYPTO_Job_T job;
+
+    (void)memset(&job, 0, sizeof(job));
+    job.op = APP_CRYPTO_OP_ECB_ENC;
+    job.p_key = p_key;
+    job.p_in = s_in[index];
+    job.p_out = s_out[index];
+    job.length = REF_AES_BLOCK_LEN;
+    job.cb = test_JobCb;
+    job.context = index;
+    TEST_ASSERT_EQUAL(APP_RES_SUCCESS, APP_CRYPTO_Submit(&job));
+}
+
+static void test_SubmitCcm(APP_CRYPTO_Op_T op, uint8_t index)
+{
+    APP_CRYPTO_Job_T job;
+
+    (void)memset(&job, 0, sizeof(job));
+    job.op = op;
+    job.p_key = s_key;
+    job.p_nonce = s_nonce;
+    job.nonceLen = sizeof(s_nonce);
+    job.tagLen = TEST_TAG_LEN;
+    job.p_aad = s_aad;
+    job.aadLen = sizeof(s_aad);
+    job.p_in = s_ccmIn;
+    job.p_out = s_ccmOut;
+    job.length = TEST_CCM_LEN;
+    job.p_tag = s_tag;
+    job.cb = test_JobCb;
+    job.context = index;
+    TEST_ASSERT_EQUAL(APP_RES_SUCCESS, APP_CRYPTO_Submit(&job));
+}
+
+static void test_JobCb(uint16_t result, uintptr_t context)
+{
+    TEST_ASSERT(context < TEST_JOB_NUM);
+    s_result[context] = result;
+    s_doneNum++;
+
+    // A job submitted from a callback
+    if (s_isResubmitting)
+    {
+        s_isResubmitting = false;
+        test_SubmitEcb(TEST_JOB_NUM - 1U, s_key);
+    }
+}
+
+static void test_Reset(void)
+{
+    uint8_t i;
+    uint8_t j;
+
+    TEST_ASSERT(FAKE_CRM_Reset());
+    for (i = 0; i < TEST_JOB_NUM; i++)
+    {
+        for (j = 0; j < REF_AES_BLOCK_LEN; j++)
+        {
+            s_in[i][j] = (uint8_t)((i * 16U) + j);
+        }
+        s_result[i] = 0xFFFFU;
+    }
+    for (i = 0; i < TEST_CCM_LEN; i++)
+    {
+        s_ccmIn[i] = (uint8_t)((i * 7U) + 3U);
+    }
+    (void)memset(s_out, 0, sizeof(s_out));
+    (void)memset(s_ccmOut, 0, sizeof(s_ccmOut));
+    s_wakeNum = 0U;
+    s_wakeMax = TEST_WAKE_MAX;
+    s_doneNum = 0U;
+    s_isResubmitting = false;
+    APP_CRYPTO_Init();
+}
+
+// The application task runs a pass each time it is woken, as APP_Tasks() does
+static uint32_t test_App(void)
+{
+    uint32_t passNum = 0U;
+
+    while (s_wakeNum > 0U)
+    {
+        s_wakeNum--;
+        APP_CRYPTO_Poll();
+        passNum++;
+    }
+
+    return passNum;
+}
+
+static void test_CheckEcb(uint8_t index, const uint8_t *p_key)
+{
+    uint8_t expected[REF_AES_BLOCK_LEN];
+
+    REF_AES_Encrypt(p_key, s_in[index], expected);
+    TEST_ASSERT_EQUAL(APP_RES_SUCCESS, s_result[index]);
+    TEST_ASSERT(memcmp(expected, s_out[index], REF_AES_BLOCK_LEN) == 0);
+}
+
+static void test_CheckIdle(void)
+{
+    TEST_ASSERT(!APP_CRYPTO_IsActive());
+    TEST_ASSERT(!FAKE_CRM_IsBusy());
+    TEST_ASSERT(!FAKE_CRM_IsClockOn());
+    TEST_ASSERT_EQUAL(0, FAKE_CRM_GetBusyFaultNum());
+    TEST_ASSERT_EQUAL(0, FAKE_CRM_GetClockFaultNum());
+}
+
+static void test_EcbBatch(void)
+{
+    APP_CRYPTO_Stats_T stats;
+    uint8_t i;
+
+    test_Reset();
+
+    for (i = 0; i < TEST_JOB_NUM; i++)
+    {
+        test_SubmitEcb(i, s_key);
+    }
+
+    // The first job started alone, the clock stays on while it runs
+    TEST_ASSERT_EQUAL(1, FAKE_CRM_GetRunNum());
+    TEST_ASSERT(FAKE_CRM_IsClockOn());
+    FAKE_CRM_End(true);
+    TEST_ASSERT_EQUAL(1, test_App());
+    TEST_ASSERT_EQUAL(1, s_doneNum);
+
+    // The same pass starts the jobs queued meanwhile, APP_CRYPTO_BATCH_MAX in one operation
+    TEST_ASSERT_EQUAL(2, FAKE_CRM_GetRunNum());
+    FAKE_CRM_End(true);
+    TEST_ASSERT_EQUAL(1, test_App());
+    TEST_ASSERT_EQUAL(1U + APP_CRYPTO_BATCH_MAX, s_doneNum);
+
+    TEST_ASSERT_EQUAL(3, FAKE_CRM_GetRunNum());
+    FAKE_CRM_End(true);
+    TEST_ASSERT_EQUAL(1, test_App());
+    TEST_ASSERT_EQUAL(TEST_JOB_NUM, s_doneNum);
+
+    for (i = 0; i < TEST_JOB_NUM; i++)
+    {
+        test_CheckEcb(i, s_key);
+    }
+
+    APP_CRYPTO_GetStats(&stats);
+    TEST_ASSERT_EQUAL(TEST_JOB_NUM, stats.jobCnt);
+    TEST_ASSERT_EQUAL(3, stats.runCnt);
+    TEST_ASSERT_EQUAL(0, stats.failCnt);
+    test_CheckIdle();
+}
+
+static void test_EcbKeyChange(void)
+{
+    test_Reset();
+
+    test_SubmitEcb(0, s_key);
+    test_SubmitEcb(1, s_key);
+    test_SubmitEcb(2, s_key);
+    test_SubmitEcb(3, s_otherKey);
+    test_SubmitEcb(4, s_key);
+
+    // Only the jobs following the first one with the same key are batched
+    FAKE_CRM_End(true);
+    (void)test_App();
+    TEST_ASSERT_EQUAL(1, s_doneNum);
+    FAKE_CRM_End(true);
+    (void)test_App();
+    TEST_ASSERT_EQUAL(3, s_doneNum);
+    FAKE_CRM_End(true);
+    (void)test_App();
+    TEST_ASSERT_EQUAL(4, s_doneNum);
+    FAKE_CRM_End(true);
+    (void)test_App();
+    TEST_ASSERT_EQUAL(5, s_doneNum);
+    TEST_ASSERT_EQUAL(4, FAKE_CRM_GetRunNum());
+
+    test_CheckEcb(0, s_key);
+    test_CheckEcb(1, s_key);
+    test_CheckEcb(2, s_key);
+    test_CheckEcb(3, s_otherKey);
+    test_CheckEcb(4, s_key);
+    test_CheckIdle();
+}
+
+static void test_Ccm(void)
+{
+    uint8_t expected[TEST_CCM_LEN];
+    uint8_t expectedTag[TEST_TAG_LEN];
+
+    test_Reset();
+
+    REF_AES_CcmEncrypt(s_key, s_nonce, sizeof(s_nonce), s_aad, sizeof(s_aad), s_ccmIn, TEST_CCM_LEN, expected,
+        expectedTag, TEST_TAG_LEN);
+
+    test_SubmitCcm(APP_CRYPTO_OP_CCM_ENC, 0);
+    FAKE_CRM_End(true);
+    (void)test_App();
+    TEST_ASSERT_EQUAL(APP_RES_SUCCESS, s_result[0]);
+    TEST_ASSERT(memcmp(expected, s_ccmOut, TEST_CCM_LEN) == 0);
+    TEST_ASSERT(memcmp(expectedTag, s_tag, TEST_TAG_LEN) == 0);
+
+    // Decrypt the ciphertext back
+    (void)memcpy(s_ccmIn, expected, TEST_CCM_LEN);
+    test_SubmitCcm(APP_CRYPTO_OP_CCM_DEC, 1);
+    FAKE_CRM_End(true);
+    (void)test_App();
+    TEST_ASSERT_EQUAL(APP_RES_SUCCESS, s_result[1]);
+    REF_AES_CcmDecrypt(s_key, s_nonce, sizeof(s_nonce), s_aad, sizeof(s_aad), expected, TEST_CCM_LEN, expected,
+        expectedTag, TEST_TAG_LEN);
+    TEST_ASSERT(memcmp(expected, s_ccmOut, TEST_CCM_LEN) == 0);
+
+    // A wrong tag fails the job
+    s_tag[0] ^= 0x01U;
+    test_SubmitCcm(APP_CRYPTO_OP_CCM_DEC, 2);
+    FAKE_CRM_End(true);
+    (void)test_App();
+    TEST_ASSERT_EQUAL(APP_RES_FAIL, s_result[2]);
+    test_CheckIdle();
+}
+
+static void test_WakeNotCounted(void)
+{
+    test_Reset();
+
+    test_SubmitEcb(0, s_key);
+
+    // The queue is full, the wake of the interrupt is not counted
+    s_wakeNum = TEST_WAKE_MAX;
+    FAKE_CRM_End(true);
+    TEST_ASSERT_EQUAL(TEST_WAKE_MAX, s_wakeNum);
+
+    // The first pass for another message completes the job
+    s_wakeNum = 1U;
+    TEST_ASSERT_EQUAL(1, test_App());
+    TEST_ASSERT_EQUAL(1, s_doneNum);
+    test_CheckEcb(0, s_key);
+    test_CheckIdle();
+}
+
+static void test_EarlyInterrupt(void)
+{
+    test_Reset();
+
+    test_SubmitCcm(APP_CRYPTO_OP_CCM_ENC, 0);
+
+    // An interrupt before the end of the operation, the job waits for the next one
+    FAKE_CRM_Interrupt();
+    TEST_ASSERT_EQUAL(1, test_App());
+    TEST_ASSERT_EQUAL(0, s_doneNum);
+    TEST_ASSERT(APP_CRYPTO_IsActive());
+    TEST_ASSERT(FAKE_CRM_IsClockOn());
+
+    FAKE_CRM_End(true);
+    TEST_ASSERT_EQUAL(1, test_App());
+    TEST_ASSERT_EQUAL(1, s_doneNum);
+    TEST_ASSERT_EQUAL(APP_RES_SUCCESS, s_result[0]);
+    test_CheckIdle();
+}
+
+static void test_MwAesTakesEngine(void)
+{
+    MW_AES_Ctx_T ctx;
+    uint8_t block[REF_AES_BLOCK_LEN];
+    uint8_t expected[REF_AES_BLOCK_LEN];
+
+    test_Reset();
+
+    // A job runs when the stack resolves an address, a callback submits another job
+    test_SubmitEcb(0, s_key);
+    s_isResubmitting = true;
+    (void)memset(block, 0x5A, sizeof(block));
+    TEST_ASSERT_EQUAL(MBA_RES_SUCCESS, MW_AES_EcbEncryptInit(&ctx, (uint8_t *)s_otherKey));
+
+    // The running job is completed first, the job of the callback waits for the next pass
+    TEST_ASSERT_EQUAL(1, s_doneNum);
+    test_CheckEcb(0, s_key);
+    TEST_ASSERT(!FAKE_CRM_IsBusy());
+    TEST_ASSERT_EQUAL(MBA_RES_SUCCESS, MW_AES_AesEcbEncrypt(&ctx, REF_AES_BLOCK_LEN, block, block));
+    (void)memset(expected, 0x5A, sizeof(expected));
+    REF_AES_Encrypt(s_otherKey, expected, expected);
+    TEST_ASSERT(memcmp(expected, block, REF_AES_BLOCK_LEN) == 0);
+    TEST_ASSERT_EQUAL(2, FAKE_CRM_GetRunNum());
+    TEST_ASSERT_EQUAL(0, FAKE_CRM_GetBusyFaultNum());
+
+    // The interrupt of the completed job, already masked on the device, changes nothing
+    FAKE_CRM_Interrupt();
+    TEST_ASSERT_EQUAL(1, s_doneNum);
+
+    TEST_ASSERT_EQUAL(1, test_App());
+    TEST_ASSERT_EQUAL(3, FAKE_CRM_GetRunNum());
+    FAKE_CRM_End(true);
+    (void)test_App();
+    TEST_ASSERT_EQUAL(2, s_doneNum);
+    test_CheckEcb(TEST_JOB_NUM - 1U, s_key);
+    test_CheckIdle();
+}
+
+static void test_MwAesIdle(void)
+{
+    MW_AES_Ctx_T ctx;
+    uint8_t tag[TEST_TAG_LEN];
+    uint8_t expected[TEST_CCM_LEN];
+    uint8_t expectedTag[TEST_TAG_LEN];
+
+    test_Reset();
+
+    // No job: the engine is taken without waking the task, a message is encrypted in two fragments
+    TEST_ASSERT_EQUAL(MBA_RES_SUCCESS, MW_AES_CcmEncryptInit(&ctx, (uint8_t *)s_key, (uint8_t *)s_nonce,
+        sizeof(s_nonce), TEST_TAG_LEN, (uint8_t *)s_aad, sizeof(s_aad), TEST_CCM_LEN));
+    TEST_ASSERT_EQUAL(MBA_RES_SUCCESS, MW_AES_AesCcmEncrypt(&ctx, 32U, s_ccmIn, s_ccmOut, tag));
+    TEST_ASSERT_EQUAL(MBA_RES_SUCCESS, MW_AES_AesCcmEncrypt(&ctx, TEST_CCM_LEN - 32U, &s_ccmIn[32], &s_ccmOut[32],
+        tag));
+    TEST_ASSERT_EQUAL(0, s_wakeNum);
+
+    REF_AES_CcmEncrypt(s_key, s_nonce, sizeof(s_nonce), s_aad, sizeof(s_aad), s_ccmIn, TEST_CCM_LEN, expected,
+        expectedTag, TEST_TAG_LEN);
+    TEST_ASSERT(memcmp(expected, s_ccmOut, TEST_CCM_LEN) == 0);
+    TEST_ASSERT(memcmp(expectedTag, tag, TEST_TAG_LEN) == 0);
+    test_CheckIdle();
+}
+
+int main(void)
+{
+    TEST_RUN(test_EcbBatch);
+    TEST_RUN(test_EcbKeyChange);
+    TEST_RUN(test_Ccm);
+    TEST_RUN(test_WakeNotCounted);
+    TEST_RUN(test_EarlyInterrupt);
+    TEST_RUN(test_MwAesTakesEngine);
+    TEST_RUN(test_MwAesIdle);
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,404 @@
+/*******************************************************************************
+  Group Listener Test Source File
+
+  File Name:
+    test_app_group.c
+
+  Summary:
+    Tests the parsing of the group records and the scheduling of the group
+    setpoints.
+
+  Description:
+    The records are built as a controller would advertise them, among other
+    AD structures, and fed to APP_GROUP_ParseFrame and to the GAP event
+    handler. The record search itself, app_group_FindRecord, is reached
+    through both. The calibration of the servo gives the range of the
+    setpoints the listener applies.
+ *******************************************************************************/
+
+#include <string.h>
+#include "ble_gap.h"
+#include "mba_error_defs.h"
+#include "app_error_defs.h"
+#include "app_timer/app_timer.h"
+#include "app_cal/app_cal.h"
+#include "app_group.h"
+#include "fake_rtos.h"
+#include "unit_test.h"
+
+#define TEST_GROUP_ID               (0x1234U)
+#define TEST_SYNC_HANDLE            (0x0042U)
+#define TEST_SERVO_CH               (0U)
+
+static uint32_t s_createSyncCnt;
+static bool     s_isApplyArmed;
+static uint32_t s_applyDelay;
+static uint32_t s_appliedCnt;
+static uint32_t s_appliedDuty;
+static APP_CAL_Channel_T s_cal;
+
+uint16_t BLE_GAP_SetExtScanningParams(uint8_t filterPolicy, BLE_GAP_ExtScanningPhy_T *p_extScanPhy)
+{
+    (void)filterPolicy;
+    (void)p_extScanPhy;
+
+    return MBA_RES_SUCCESS;
+}
+
+uint16_t BLE_GAP_SetExtScanningEnable(uint8_t mode, BLE_GAP_ExtScanningEnable_T *p_enable)
+{
+    (void)mode;
+    (void)p_enable;
+
+    return MBA_RES_SUCCESS;
+}
+
+uint16_t BLE_GAP_CreateSync(BLE_GAP_CreateSync_T *p_periSync)
+{
+    (void)p_periSync;
+    s_createSyncCnt++;
+
+    return MBA_RES_SUCCESS;
+}
+
+uint16_t BLE_GAP_CreateSyncCancel(void)
+{
+    return MBA_RES_SUCCESS;
+}
+
+uint16_t BLE_GAP_TerminateSync(uint16_t syncHandle)
+{
+    (void)syncHandle;
+
+    return MBA_RES_SUCCESS;
+}
+
+uint16_t APP_TIMER_SetTimer(uint8_t timerId, uint32_t timeout, bool isPeriodicTimer)
+{
+    (void)isPeriodicTimer;
+
+    if (timerId == APP_TIMER_GROUP_APPLY)
+    {
+        s_isApplyArmed = true;
+        s_applyDelay = timeout;
+    }
+
+    return APP_RES_SUCCESS;
+}
+
+uint16_t APP_TIMER_StopTimer(uint8_t timerId)
+{
+    if (timerId == APP_TIMER_GROUP_APPLY)
+    {
+        s_isApplyArmed = false;
+    }
+
+    return APP_RES_SUCCESS;
+}
+
+const APP_CAL_Channel_T *APP_CAL_GetChannel(uint8_t ch)
+{
+    return (ch == TEST_SERVO_CH) ? &s_cal : NULL;
+}
+
+static void test_Apply(uint32_t duty)
+{
+    s_appliedCnt++;
+    s_appliedDuty = duty;
+}
+
+// Appends an AD structure, returns the new length
+static uint8_t test_AddAd(uint8_t *p_buf, uint8_t len, uint8_t type, const uint8_t *p_value, uint8_t valueLen)
+{
+    p_buf[len] = (uint8_t)(valueLen + 1U);
+    p_buf[len + 1U] = type;
+    memcpy(&p_buf[len + 2U], p_value, valueLen);
+
+    return (uint8_t)(len + 2U + valueLen);
+}
+
+// Appends a group record in manufacturer specific data, returns the new length
+static uint8_t test_AddRecord(uint8_t *p_buf, uint8_t len, uint16_t companyId, uint8_t type, uint16_t groupId,
+    const uint8_t *p_body, uint8_t bodyLen)
+{
+    uint8_t value[64];
+
+    value[0] = (uint8_t)companyId;
+    value[1] = (uint8_t)(companyId >> 8);
+    value[2 + APP_GROUP_RECORD_OFFSET_TYPE] = type;
+    value[2 + APP_GROUP_RECORD_OFFSET_GROUP_ID] = (uint8_t)groupId;
+    value[3 + APP_GROUP_RECORD_OFFSET_GROUP_ID] = (uint8_t)(groupId >> 8);
+    memcpy(&value[2 + APP_GROUP_ANNOUNCE_LEN], p_body, bodyLen);
+
+    return test_AddAd(p_buf, len, 0xFFU, value, (uint8_t)(2U + APP_GROUP_ANNOUNCE_LEN + bodyLen));
+}
+
+// Builds the body of a setpoint frame after the group ID, returns its length
+static uint8_t test_FrameBody(uint8_t *p_body, uint8_t seq, uint16_t delay, uint8_t firstCh, uint8_t chNum,
+    const uint32_t *p_duty)
+{
+    uint8_t len = 0;
+    uint8_t i;
+
+    p_body[len++] = seq;
+    p_body[len++] = (uint8_t)delay;
+    p_body[len++] = (uint8_t)(delay >> 8);
+    p_body[len++] = firstCh;
+    p_body[len++] = chNum;
+    for (i = 0; i < chNum; i++)
+    {
+        p_body[len++] = (uint8_t)p_duty[i];
+        p_body[len++] = (uint8_t)(p_duty[i] >> 8);
+        p_body[len++] = (uint8_t)(p_duty[i] >> 16);
+        p_body[len++] = (uint8_t)(p_duty[i] >> 24);
+    }
+
+    return len;
+}
+
+// Flags, a record of another company, then the setpoint frame of the group for channels 2 to 4
+static uint8_t test_Frame(uint8_t *p_buf, uint8_t seq, uint16_t delay)
+{
+    static const uint32_t duty[3] = {70000U, 100000U, 0x12345678U};
+    static const uint8_t flags = 0x06U;
+    uint8_t body[32];
+    uint8_t bodyLen;
+    uint8_t len = 0;
+
+    bodyLen = test_FrameBody(body, seq, delay, 2U, 3U, duty);
+    len = test_AddAd(p_buf, len, 0x01U, &flags, 1U);
+    len = test_AddRecord(p_buf, len, 0x0059U, APP_GROUP_RECORD_TYPE_SETPOINT, TEST_GROUP_ID, body, bodyLen);
+    len = test_AddRecord(p_buf, len, APP_GROUP_COMPANY_ID, APP_GROUP_RECORD_TYPE_SETPOINT, TEST_GROUP_ID, body, bodyLen);
+
+    return len;
+}
+
+static void test_ParseFrame(void)
+{
+    APP_GROUP_Setpoint_T setpoint;
+    uint8_t buf[128];
+    uint8_t len;
+
+    len = test_Frame(buf, 7U, 300U);
+
+    TEST_ASSERT_EQUAL(APP_RES_SUCCESS, APP_GROUP_ParseFrame(buf, len, TEST_GROUP_ID, 2U, &setpoint));
+    TEST_ASSERT_EQUAL(7, setpoint.seq);
+    TEST_ASSERT_EQUAL(300, setpoint.delay);
+    TEST_ASSERT_EQUAL(70000U, setpoint.duty);
+
+    TEST_ASSERT_EQUAL(APP_RES_SUCCESS, APP_GROUP_ParseFrame(buf, len, TEST_GROUP_ID, 4U, &setpoint));
+    TEST_ASSERT_EQUAL(0x12345678U, setpoint.duty);
+
+    // Channels outside of the frame
+    TEST_ASSERT_EQUAL(APP_RES_FAIL, APP_GROUP_ParseFrame(buf, len, TEST_GROUP_ID, 1U, &setpoint));
+    TEST_ASSERT_EQUAL(APP_RES_FAIL, APP_GROUP_ParseFrame(buf, len, TEST_GROUP_ID, 5U, &setpoint));
+
+    // Another group
+    TEST_ASSERT_EQUAL(APP_RES_INVALID_PARA, APP_GROUP_ParseFrame(buf, len, TEST_GROUP_ID + 1U, 2U, &setpoint));
+}
+
+static void test_ParseFrameInvalid(void)
+{
+    static const uint32_t duty[2] = {1U, 2U};
+    APP_GROUP_Setpoint_T setpoint;
+    uint8_t buf[128];
+    uint8_t body[32];
+    uint8_t bodyLen;
+    uint8_t len;
+
+    // An announce is not a frame
+    len = test_AddRecord(buf, 0U, APP_GROUP_COMPANY_ID, APP_GROUP_RECORD_TYPE_ANNOUNCE, TEST_GROUP_ID, NULL, 0U);
+    TEST_ASSERT_EQUAL(APP_RES_INVALID_PARA, APP_GROUP_ParseFrame(buf, len, TEST_GROUP_ID, 0U, &setpoint));
+
+    // The frame announces more setpoints than it carries
+    bodyLen = test_FrameBody(body, 1U, 0U, 0U, 2U, duty);
+    body[4] = 3U;
+    len = test_AddRecord(buf, 0U, APP_GROUP_COMPANY_ID, APP_GROUP_RECORD_TYPE_SETPOINT, TEST_GROUP_ID, body, bodyLen);
+    TEST_ASSERT_EQUAL(APP_RES_INVALID_PARA, APP_GROUP_ParseFrame(buf, len, TEST_GROUP_ID, 0U, &setpoint));
+
+    // The frame header is cut
+    len = test_AddRecord(buf, 0U, APP_GROUP_COMPANY_ID, APP_GROUP_RECORD_TYPE_SETPOINT, TEST_GROUP_ID, body, 3U);
+    TEST_ASSERT_EQUAL(APP_RES_INVALID_PARA, APP_GROUP_ParseFrame(buf, len, TEST_GROUP_ID, 0U, &setpoint));
+
+    // The AD structure runs past the data
+    bodyLen = test_FrameBody(body, 1U, 0U, 0U, 2U, duty);
+    len = test_AddRecord(buf, 0U, APP_GROUP_COMPANY_ID, APP_GROUP_RECORD_TYPE_SETPOINT, TEST_GROUP_ID, body, bodyLen);
+    TEST_ASSERT_EQUAL(APP_RES_INVALID_PARA, APP_GROUP_ParseFrame(buf, (uint8_t)(len - 1U), TEST_GROUP_ID, 0U, &setpoint));
+    TEST_ASSERT_EQUAL(APP_RES_SUCCESS, APP_GROUP_ParseFrame(buf, len, TEST_GROUP_ID, 0U, &setpoint));
+
+    // A zero length AD structure ends the data
+    memmove(&buf[1], buf, len);
+    buf[0] = 0U;
+    TEST_ASSERT_EQUAL(APP_RES_INVALID_PARA, APP_GROUP_ParseFrame(buf, (uint8_t)(len + 1U), TEST_GROUP_ID, 0U, &setpoint));
+
+    // A manufacturer specific data too short for a record is skipped
+    buf[0] = 2U;
+    buf[1] = 0xFFU;
+    buf[2] = (uint8_t)APP_GROUP_COMPANY_ID;
+    TEST_ASSERT_EQUAL(APP_RES_INVALID_PARA, APP_GROUP_ParseFrame(buf, 3U, TEST_GROUP_ID, 0U, &setpoint));
+    len = test_AddRecord(buf, 3U, APP_GROUP_COMPANY_ID, APP_GROUP_RECORD_TYPE_SETPOINT, TEST_GROUP_ID, body, bodyLen);
+    TEST_ASSERT_EQUAL(APP_RES_SUCCESS, APP_GROUP_ParseFrame(buf, len, TEST_GROUP_ID, 1U, &setpoint));
+    TEST_ASSERT_EQUAL(2, setpoint.duty);
+}
+
+static void test_ExtAdvReport(const uint8_t *p_data, uint8_t len)
+{
+    static BLE_GAP_Event_T evt;
+
+    memset(&evt, 0, sizeof(evt));
+    evt.eventId = BLE_GAP_EVT_EXT_ADV_REPORT;
+    evt.eventField.evtExtAdvReport.periodAdvInterval = 80U;
+    evt.eventField.evtExtAdvReport.dataStatus = BLE_GAP_EXT_ADV_RPT_DATA_COMPLETE;
+    evt.eventField.evtExtAdvReport.length = len;
+    memcpy(evt.eventField.evtExtAdvReport.advData, p_data, len);
+    APP_GROUP_GapEvtHandler(&evt);
+}
+
+static void test_PeriAdvReport(const uint8_t *p_data, uint8_t len)
+{
+    static BLE_GAP_Event_T evt;
+
+    memset(&evt, 0, sizeof(evt));
+    evt.eventId = BLE_GAP_EVT_PERI_ADV_REPORT;
+    evt.eventField.evtPeriAdvReport.syncHandle = TEST_SYNC_HANDLE;
+    evt.eventField.evtPeriAdvReport.dataStatus = BLE_GAP_DATA_STATUS_COMPLETE;
+    evt.eventField.evtPeriAdvReport.dataLength = len;
+    memcpy(evt.eventField.evtPeriAdvReport.advData, p_data, len);
+    APP_GROUP_GapEvtHandler(&evt);
+}
+
+static void test_Listener(void)
+{
+    BLE_GAP_Event_T evt;
+    uint8_t buf[128];
+    uint8_t len;
+
+    s_createSyncCnt = 0U;
+    s_appliedCnt = 0U;
+    s_isApplyArmed = false;
+    s_cal.point[APP_CAL_POINT_FORWARD] = APP_CAL_DUTY_FORWARD;
+    s_cal.point[APP_CAL_POINT_NEUTRAL] = APP_CAL_DUTY_NEUTRAL;
+    s_cal.point[APP_CAL_POINT_REVERSE] = APP_CAL_DUTY_REVERSE;
+    APP_GROUP_Init(test_Apply, TEST_SERVO_CH);
+    TEST_ASSERT_EQUAL(APP_RES_SUCCESS, APP_GROUP_Start(TEST_GROUP_ID, 3U));
+
+    // Only the announce of the group starts the sync
+    len = test_AddRecord(buf, 0U, APP_GROUP_COMPANY_ID, APP_GROUP_RECORD_TYPE_ANNOUNCE, TEST_GROUP_ID + 1U, NULL, 0U);
+    test_ExtAdvReport(buf, len);
+    TEST_ASSERT_EQUAL(0, s_createSyncCnt);
+    len = test_Frame(buf, 1U, 0U);
+    test_ExtAdvReport(buf, len);
+    TEST_ASSERT_EQUAL(0, s_createSyncCnt);
+    len = test_AddRecord(buf, len, APP_GROUP_COMPANY_ID, APP_GROUP_RECORD_TYPE_ANNOUNCE, TEST_GROUP_ID, NULL, 0U);
+    test_ExtAdvReport(buf, len);
+    TEST_ASSERT_EQUAL(1, s_createSyncCnt);
+
+    memset(&evt, 0, sizeof(evt));
+    evt.eventId = BLE_GAP_EVT_PERI_ADV_SYNC_EST;
+    evt.eventField.evtPeriAdvSyncEst.status = GAP_STATUS_SUCCESS;
+    evt.eventField.evtPeriAdvSyncEst.syncHandle = TEST_SYNC_HANDLE;
+    APP_GROUP_GapEvtHandler(&evt);
+
+    // A frame without delay is applied at once, its repetitions are ignored
+    len = test_Frame(buf, 1U, 0U);
+    test_PeriAdvReport(buf, len);
+    TEST_ASSERT_EQUAL(1, s_appliedCnt);
+    TEST_ASSERT_EQUAL(100000U, s_appliedDuty);
+    test_PeriAdvReport(buf, len);
+    TEST_ASSERT_EQUAL(1, s_appliedCnt);
+
+    // A delayed frame is applied by the apply timer
+    len = test_Frame(buf, 2U, 250U);
+    test_PeriAdvReport(buf, len);
+    TEST_ASSERT_EQUAL(1, s_appliedCnt);
+    TEST_ASSERT(s_isApplyArmed);
+    TEST_ASSERT_EQUAL(250, s_applyDelay);
+    APP_GROUP_Tick();
+    TEST_ASSERT_EQUAL(2, s_appliedCnt);
+    APP_GROUP_Tick();
+    TEST_ASSERT_EQUAL(2, s_appliedCnt);
+
+    // A newer frame replaces a setpoint still waiting
+    len = test_Frame(buf, 3U, 250U);
+    test_PeriAdvReport(buf, len);
+    len = test_Frame(buf, 4U, 0U);
+    test_PeriAdvReport(buf, len);
+    TEST_ASSERT_EQUAL(3, s_appliedCnt);
+    TEST_ASSERT(!s_isApplyArmed);
+    APP_GROUP_Tick();
+    TEST_ASSERT_EQUAL(3, s_appliedCnt);
+}
+
+// Frame of the group for channel 0 only
+static uint8_t test_OneFrame(uint8_t *p_buf, uint8_t seq, uint32_t duty)
+{
+    uint8_t body[32];
+    uint8_t bodyLen;
+
+    bodyLen = test_FrameBody(body, seq, 0U, 0U, 1U, &duty);
+
+    return test_AddRecord(p_buf, 0U, APP_GROUP_COMPANY_ID, APP_GROUP_RECORD_TYPE_SETPOINT, TEST_GROUP_ID, body, bodyLen);
+}
+
+static void test_ListenerRange(void)
+{
+    BLE_GAP_Event_T evt;
+    uint8_t buf[128];
+    uint8_t len;
+
+    s_appliedCnt = 0U;
+    s_isApplyArmed = false;
+    s_cal.point[APP_CAL_POINT_FORWARD] = APP_CAL_DUTY_FORWARD;
+    s_cal.point[APP_CAL_POINT_NEUTRAL] = APP_CAL_DUTY_NEUTRAL;
+    s_cal.point[APP_CAL_POINT_REVERSE] = APP_CAL_DUTY_REVERSE;
+    APP_GROUP_Init(test_Apply, TEST_SERVO_CH);
+    TEST_ASSERT_EQUAL(APP_RES_SUCCESS, APP_GROUP_Start(TEST_GROUP_ID, 0U));
+    len = test_AddRecord(buf, 0U, APP_GROUP_COMPANY_ID, APP_GROUP_RECORD_TYPE_ANNOUNCE, TEST_GROUP_ID, NULL, 0U);
+    test_ExtAdvReport(buf, len);
+    memset(&evt, 0, sizeof(evt));
+    evt.eventId = BLE_GAP_EVT_PERI_ADV_SYNC_EST;
+    evt.eventField.evtPeriAdvSyncEst.status = GAP_STATUS_SUCCESS;
+    evt.eventField.evtPeriAdvSyncEst.syncHandle = TEST_SYNC_HANDLE;
+    APP_GROUP_GapEvtHandler(&evt);
+
+    // The calibrated points are the bounds
+    len = test_OneFrame(buf, 1U, APP_CAL_DUTY_FORWARD);
+    test_PeriAdvReport(buf, len);
+    len = test_OneFrame(buf, 2U, APP_CAL_DUTY_REVERSE);
+    test_PeriAdvReport(buf, len);
+    TEST_ASSERT_EQUAL(2, s_appliedCnt);
+    TEST_ASSERT_EQUAL(APP_CAL_DUTY_REVERSE, s_appliedDuty);
+
+    // A full period duty, or one just outside of the points, is ignored
+    len = test_OneFrame(buf, 3U, APP_CAL_DUTY_MAX);
+    test_PeriAdvReport(buf, len);
+    len = test_OneFrame(buf, 4U, APP_CAL_DUTY_REVERSE + 1U);
+    test_PeriAdvReport(buf, len);
+    len = test_OneFrame(buf, 5U, APP_CAL_DUTY_FORWARD - 1U);
+    test_PeriAdvReport(buf, len);
+    len = test_OneFrame(buf, 6U, 0U);
+    test_PeriAdvReport(buf, len);
+    TEST_ASSERT_EQUAL(2, s_appliedCnt);
+    TEST_ASSERT_EQUAL(APP_CAL_DUTY_REVERSE, s_appliedDuty);
+
+    // The range follows the calibration, whichever point is the higher duty
+    s_cal.point[APP_CAL_POINT_FORWARD] = 130000U;
+    s_cal.point[APP_CAL_POINT_REVERSE] = 60000U;
+    len = test_OneFrame(buf, 7U, 129000U);
+    test_PeriAdvReport(buf, len);
+    TEST_ASSERT_EQUAL(3, s_appliedCnt);
+    TEST_ASSERT_EQUAL(129000U, s_appliedDuty);
+    len = test_OneFrame(buf, 8U, 59999U);
+    test_PeriAdvReport(buf, len);
+    TEST_ASSERT_EQUAL(3, s_appliedCnt);
+}
+
+int main(void)
+{
+    TEST_RUN(test_ParseFrame);
+    TEST_RUN(test_ParseFrameInvalid);
+    TEST_RUN(test_Listener);
+    TEST_RUN(test_ListenerRange);
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,224 @@
+/*******************************************************************************
+  Application Latency Test Source File
+
+  File Name:
+    test_app_lat.c
+
+  Summary:
+    Tests which PWM writes end the measurement of a servo command and what
+    each stage counts.
+
+  Description:
+    The application task is played as app.c runs it: a command is begun when
+    its message is taken from the queue, a setpoint is handed over to its
+    message of the urgent lane and resumed when that message is applied. The
+    time is advanced between the points, the histograms are read back with
+    APP_LAT_GetSummary.
+ *******************************************************************************/
+
+#include <string.h>
+#include "mba_error_defs.h"
+#include "ble_gap.h"
+#include "gatt.h"
+#include "ble_trsps/ble_trsps.h"
+#include "app_log/app_log.h"
+#include "app_queue/app_queue.h"
+#include "app_link.h"
+#include "app_lat/app_lat.h"
+#include "fake_rtos.h"
+#include "unit_test.h"
+
+#define TEST_QUEUE_US               (300U)
+#define TEST_PARSE_US               (40U)
+#define TEST_LANE_US                (900U)
+#define TEST_ACTUATE_US             (20U)
+#define TEST_RAMP_US                (20000U)
+
+uint16_t BLE_TRSPS_SendData(uint16_t connHandle, uint16_t len, uint8_t *p_data)
+{
+    (void)connHandle;
+    (void)len;
+    (void)p_data;
+
+    return 0U;
+}
+
+uint16_t BLE_TRSPS_SendVendorCommand(uint16_t connHandle, uint8_t commandID, uint8_t commandLength, uint8_t *p_commandPayload)
+{
+    (void)connHandle;
+    (void)commandID;
+    (void)commandLength;
+    (void)p_commandPayload;
+
+    return 0U;
+}
+
+void APP_LOG_Write(APP_LOG_Id_T id, uint16_t len, const void *p_data)
+{
+    (void)id;
+    (void)len;
+    (void)p_data;
+}
+
+uint16_t APP_LINK_GetMtu(uint16_t connHandle)
+{
+    (void)connHandle;
+
+    return 23U;
+}
+
+void APP_QUEUE_GetStats(APP_QUEUE_Lane_T lane, APP_QUEUE_Stats_T *p_stats)
+{
+    (void)lane;
+    (void)memset(p_stats, 0, sizeof(*p_stats));
+}
+
+static void test_Reset(void)
+{
+    FAKE_RTOS_Reset();
+    APP_LAT_Init();
+}
+
+static uint32_t test_GetCount(APP_LAT_Stage_T stage)
+{
+    APP_LAT_Summary_T summary;
+
+    APP_LAT_GetSummary(stage, &summary);
+
+    return summary.count;
+}
+
+static uint32_t test_GetMaxUs(APP_LAT_Stage_T stage)
+{
+    APP_LAT_Summary_T summary;
+
+    APP_LAT_GetSummary(stage, &summary);
+
+    return FAKE_RTOS_CyclesToUs(summary.maxCycles);
+}
+
+// A servo command received and parsed, its setpoint queued; returns the stamp of the setpoint message
+static uint32_t test_SendSetpoint(uint8_t *p_lat)
+{
+    uint32_t rxStamp = APP_LAT_Stamp();
+
+    FAKE_RTOS_AdvanceUs(TEST_QUEUE_US);
+    APP_LAT_Begin(rxStamp);
+    FAKE_RTOS_AdvanceUs(TEST_PARSE_US);
+    APP_LAT_Defer(p_lat);
+    APP_LAT_End();
+
+    return APP_LAT_Stamp();
+}
+
+// The setpoint message taken from the urgent lane and applied, the ramp goes on with later writes
+static void test_ApplySetpoint(const uint8_t *p_lat, uint32_t msgStamp)
+{
+    APP_LAT_Resume(p_lat, msgStamp);
+    FAKE_RTOS_AdvanceUs(TEST_ACTUATE_US);
+    APP_LAT_Mark(APP_LAT_POINT_PWM);
+    APP_LAT_End();
+
+    FAKE_RTOS_AdvanceUs(TEST_RAMP_US);
+    APP_LAT_Mark(APP_LAT_POINT_PWM);
+}
+
+static void test_Setpoint(void)
+{
+    uint8_t lat[APP_LAT_CMD_LEN];
+    uint32_t msgStamp;
+
+    test_Reset();
+
+    msgStamp = test_SendSetpoint(lat);
+    FAKE_RTOS_AdvanceUs(TEST_LANE_US);
+    test_ApplySetpoint(lat, msgStamp);
+
+    // Counted once, the wait in the urgent lane is in the total only
+    TEST_ASSERT_EQUAL(1, test_GetCount(APP_LAT_STAGE_ACTUATE));
+    TEST_ASSERT_EQUAL(1, test_GetCount(APP_LAT_STAGE_TOTAL));
+    TEST_ASSERT_EQUAL(TEST_QUEUE_US, test_GetMaxUs(APP_LAT_STAGE_QUEUE));
+    TEST_ASSERT_EQUAL(TEST_PARSE_US, test_GetMaxUs(APP_LAT_STAGE_PARSE));
+    TEST_ASSERT_EQUAL(TEST_ACTUATE_US, test_GetMaxUs(APP_LAT_STAGE_ACTUATE));
+    TEST_ASSERT_EQUAL(TEST_QUEUE_US + TEST_PARSE_US + TEST_LANE_US + TEST_ACTUATE_US,
+        test_GetMaxUs(APP_LAT_STAGE_TOTAL));
+}
+
+static void test_Coalesced(void)
+{
+    uint8_t oldLat[APP_LAT_CMD_LEN];
+    uint8_t newLat[APP_LAT_CMD_LEN];
+    uint32_t msgStamp;
+
+    test_Reset();
+
+    // The first setpoint is replaced in the lane before it is applied
+    (void)test_SendSetpoint(oldLat);
+    FAKE_RTOS_AdvanceUs(TEST_RAMP_US);
+    msgStamp = test_SendSetpoint(newLat);
+    FAKE_RTOS_AdvanceUs(TEST_LANE_US);
+
+    // A write of the ramp of an earlier setpoint meanwhile ends nothing
+    APP_LAT_Mark(APP_LAT_POINT_PWM);
+    TEST_ASSERT_EQUAL(0, test_GetCount(APP_LAT_STAGE_TOTAL));
+
+    // Only the newest command is counted, from its own stamps
+    test_ApplySetpoint(newLat, msgStamp);
+    TEST_ASSERT_EQUAL(1, test_GetCount(APP_LAT_STAGE_TOTAL));
+    TEST_ASSERT_EQUAL(TEST_QUEUE_US + TEST_PARSE_US + TEST_LANE_US + TEST_ACTUATE_US,
+        test_GetMaxUs(APP_LAT_STAGE_TOTAL));
+    TEST_ASSERT_EQUAL(TEST_ACTUATE_US, test_GetMaxUs(APP_LAT_STAGE_ACTUATE));
+}
+
+static void test_Group(void)
+{
+    uint8_t lat[APP_LAT_CMD_LEN];
+
+    test_Reset();
+
+    // A setpoint of the group carries no command
+    (void)memset(lat, 0, sizeof(lat));
+    test_ApplySetpoint(lat, APP_LAT_Stamp());
+    TEST_ASSERT_EQUAL(0, test_GetCount(APP_LAT_STAGE_TOTAL));
+
+    // Nor does a setpoint queued while no command is measured
+    APP_LAT_Defer(lat);
+    test_ApplySetpoint(lat, APP_LAT_Stamp());
+    TEST_ASSERT_EQUAL(0, test_GetCount(APP_LAT_STAGE_TOTAL));
+}
+
+static void test_Direct(void)
+{
+    uint32_t rxStamp;
+
+    test_Reset();
+
+    // A calibration command is applied while its message is handled
+    rxStamp = APP_LAT_Stamp();
+    FAKE_RTOS_AdvanceUs(TEST_QUEUE_US);
+    APP_LAT_Begin(rxStamp);
+    FAKE_RTOS_AdvanceUs(TEST_PARSE_US);
+    APP_LAT_Mark(APP_LAT_POINT_PARSE);
+    FAKE_RTOS_AdvanceUs(TEST_ACTUATE_US);
+    APP_LAT_Mark(APP_LAT_POINT_PWM);
+    APP_LAT_End();
+    TEST_ASSERT_EQUAL(1, test_GetCount(APP_LAT_STAGE_TOTAL));
+    TEST_ASSERT_EQUAL(TEST_ACTUATE_US, test_GetMaxUs(APP_LAT_STAGE_ACTUATE));
+
+    // A command not applied ends with its message
+    rxStamp = APP_LAT_Stamp();
+    APP_LAT_Begin(rxStamp);
+    APP_LAT_End();
+    APP_LAT_Mark(APP_LAT_POINT_PWM);
+    TEST_ASSERT_EQUAL(1, test_GetCount(APP_LAT_STAGE_TOTAL));
+}
+
+int main(void)
+{
+    TEST_RUN(test_Setpoint);
+    TEST_RUN(test_Coalesced);
+    TEST_RUN(test_Group);
+    TEST_RUN(test_Direct);
+
+    return TEST_RESULT();
+}
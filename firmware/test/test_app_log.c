@@ -0,0 +1,428 @@
+/*******************************************************************************
+  Application Log Test Source File
+
+  File Name:
+    test_app_log.c
+
+  Summary:
+    Checks the record ring of the log and the frames it sends on the UART.
+
+  Description:
+    The UART is a buffer with a free count set by each test. The copy of the
+    arguments into a record is wrapped at link time: it stands for the point
+    where an interrupt preempts a record being written, the interrupt logs
+    its own record and the ring is drained before the first one is complete.
+
+    Given a directory, the test also writes there a capture of frames mixed
+    with bridged data, for the decoder round trip (test_app_log_decode.py).
+ *******************************************************************************/
+
+#include <string.h>
+#include "definitions.h"
+#include "app_log/app_log.h"
+#include "fake_rtos.h"
+#include "unit_test.h"
+
+#define TEST_UART_MAX               (2048U)
+#define TEST_HANDLE                 (0x0041U)
+#define TEST_REASON                 (0x13U)
+#define TEST_PATH_MAX               (512U)
+
+typedef struct TEST_Frame_T
+{
+    uint16_t    id;
+    uint8_t     len;
+    uint8_t     data[APP_LOG_DATA_MAX];
+} TEST_Frame_T;
+
+static uint8_t          s_uart[TEST_UART_MAX];
+static size_t           s_uartLen;
+static size_t           s_uartFree;         // Room left in the UART buffer.
+static size_t           s_uartRead;         // Next byte parsed by test_NextFrame.
+static bool             s_isPreempting;     // The next copy into a record is preempted by an interrupt.
+static size_t           s_preemptLen;       // UART bytes written when the interrupt returns.
+
+void *__real_memcpy(void *p_dst, const void *p_src, size_t len);
+
+size_t SERCOM0_USART_WriteFreeBufferCountGet(void)
+{
+    return s_uartFree;
+}
+
+size_t SERCOM0_USART_Write(uint8_t *pWrBuffer, const size_t size)
+{
+    TEST_ASSERT(size <= s_uartFree);
+    TEST_ASSERT((s_uartLen + size) <= TEST_UART_MAX);
+    (void)__real_memcpy(&s_uart[s_uartLen], pWrBuffer, size);
+    s_uartLen += size;
+    s_uartFree -= size;
+
+    return size;
+}
+
+static void test_Reset(void)
+{
+    FAKE_RTOS_Reset();
+    APP_LOG_Init();
+    s_uartLen = 0;
+    s_uartRead = 0;
+    s_uartFree = TEST_UART_MAX;
+    s_isPreempting = false;
+    s_preemptLen = 0;
+}
+
+// Parses the next frame written on the UART, checking its layout
+static bool test_NextFrame(TEST_Frame_T *p_frame)
+{
+    const uint8_t *p_frameStart = &s_uart[s_uartRead];
+    uint8_t check = 0;
+    uint8_t i;
+
+    if ((s_uartLen - s_uartRead) < APP_LOG_FRAME_OVERHEAD)
+    {
+        TEST_ASSERT_EQUAL(s_uartLen, s_uartRead);
+        return false;
+    }
+
+    TEST_ASSERT_EQUAL(APP_LOG_FRAME_SYNC, p_frameStart[0]);
+    p_frame->id = (uint16_t)(p_frameStart[1] | (p_frameStart[2] << 8));
+    p_frame->len = p_frameStart[3];
+    TEST_ASSERT(p_frame->len <= APP_LOG_DATA_MAX);
+    TEST_ASSERT((s_uartRead + APP_LOG_FRAME_OVERHEAD + p_frame->len) <= s_uartLen);
+    (void)__real_memcpy(p_frame->data, &p_frameStart[4], p_frame->len);
+
+    // The check covers the bytes from the log ID to the last argument
+    for (i = 1; i < (APP_LOG_FRAME_OVERHEAD - 1U + p_frame->len); i++)
+    {
+        check ^= p_frameStart[i];
+    }
+    TEST_ASSERT_EQUAL(check, p_frameStart[APP_LOG_FRAME_OVERHEAD - 1U + p_frame->len]);
+
+    s_uartRead += APP_LOG_FRAME_OVERHEAD + p_frame->len;
+
+    return true;
+}
+
+static uint32_t test_GetArg(const TEST_Frame_T *p_frame, uint8_t argIdx)
+{
+    uint32_t value;
+
+    (void)__real_memcpy(&value, &p_frame->data[argIdx * 4U], sizeof(value));
+
+    return value;
+}
+
+void *__wrap_memcpy(void *p_dst, const void *p_src, size_t len)
+{
+    if (s_isPreempting)
+    {
+        s_isPreempting = false;
+
+        // The interrupt claims the next record, completes it first and drains the ring
+        APP_LOG_1(APP_LOG_ID_CONNECTED, TEST_HANDLE);
+        APP_LOG_Drain();
+        s_preemptLen = s_uartLen;
+    }
+
+    return __real_memcpy(p_dst, p_src, len);
+}
+
+static void test_Frame(void)
+{
+    static const uint8_t cmd[] = "led on";
+    static const uint8_t expected[] =
+    {
+        APP_LOG_FRAME_SYNC, APP_LOG_ID_DISCONNECTED, 0x00, 0x08,
+        0x41, 0x00, 0x00, 0x00, 0x13, 0x00, 0x00, 0x00,
+        APP_LOG_ID_DISCONNECTED ^ 0x08 ^ 0x41 ^ 0x13
+    };
+    TEST_Frame_T frame;
+
+    test_Reset();
+
+    // The frame of each record, byte for byte
+    APP_LOG_2(APP_LOG_ID_DISCONNECTED, TEST_HANDLE, TEST_REASON);
+    APP_LOG_Drain();
+    TEST_ASSERT_EQUAL(sizeof(expected), s_uartLen);
+    TEST_ASSERT(memcmp(expected, s_uart, sizeof(expected)) == 0);
+
+    // Without arguments, with text, and with the arguments cut to APP_LOG_DATA_MAX
+    s_uartLen = 0;
+    APP_LOG(APP_LOG_ID_BOOT);
+    APP_LOG_Write(APP_LOG_ID_BLE_CMD, sizeof(cmd) - 1U, cmd);
+    APP_LOG_Write(APP_LOG_ID_BLE_CMD, APP_LOG_DATA_MAX + 4U, "0123456789abcdefghij");
+    APP_LOG_Drain();
+
+    TEST_ASSERT(test_NextFrame(&frame));
+    TEST_ASSERT_EQUAL(APP_LOG_ID_BOOT, frame.id);
+    TEST_ASSERT_EQUAL(0, frame.len);
+    TEST_ASSERT(test_NextFrame(&frame));
+    TEST_ASSERT_EQUAL(APP_LOG_ID_BLE_CMD, frame.id);
+    TEST_ASSERT_EQUAL(sizeof(cmd) - 1U, frame.len);
+    TEST_ASSERT(memcmp(cmd, frame.data, frame.len) == 0);
+    TEST_ASSERT(test_NextFrame(&frame));
+    TEST_ASSERT_EQUAL(APP_LOG_DATA_MAX, frame.len);
+    TEST_ASSERT(memcmp("0123456789abcdef", frame.data, frame.len) == 0);
+    TEST_ASSERT(!test_NextFrame(&frame));
+}
+
+static void test_Publish(void)
+{
+    APP_LOG_Stats_T stats;
+    TEST_Frame_T frame;
+    uint32_t i;
+
+    test_Reset();
+
+    // Nothing is sent before a record is published
+    APP_LOG_Drain();
+    TEST_ASSERT_EQUAL(0, s_uartLen);
+
+    // The records are sent in the order of the claims, once
+    for (i = 0; i < 3U; i++)
+    {
+        APP_LOG_1(APP_LOG_ID_CONNECTED, i);
+    }
+    APP_LOG_Drain();
+    APP_LOG_Drain();
+    for (i = 0; i < 3U; i++)
+    {
+        TEST_ASSERT(test_NextFrame(&frame));
+        TEST_ASSERT_EQUAL(APP_LOG_ID_CONNECTED, frame.id);
+        TEST_ASSERT_EQUAL(i, test_GetArg(&frame, 0));
+    }
+    TEST_ASSERT(!test_NextFrame(&frame));
+
+    // The ring wraps, each slot is claimed again once it is sent
+    for (i = 0; i < (APP_LOG_RECORD_NUM * 3U); i++)
+    {
+        APP_LOG_1(APP_LOG_ID_CONNECTED, i);
+        if ((i % 5U) == 4U)
+        {
+            APP_LOG_Drain();
+        }
+    }
+    APP_LOG_Drain();
+    for (i = 0; i < (APP_LOG_RECORD_NUM * 3U); i++)
+    {
+        TEST_ASSERT(test_NextFrame(&frame));
+        TEST_ASSERT_EQUAL(i, test_GetArg(&frame, 0));
+    }
+    TEST_ASSERT(!test_NextFrame(&frame));
+
+    APP_LOG_GetStats(&stats);
+    TEST_ASSERT_EQUAL(3U + (APP_LOG_RECORD_NUM * 3U), stats.recordCnt);
+    TEST_ASSERT_EQUAL(0, stats.dropCnt);
+    TEST_ASSERT_EQUAL(s_uartLen, stats.byteCnt);
+}
+
+static void test_Drop(void)
+{
+    APP_LOG_Stats_T stats;
+    TEST_Frame_T frame;
+    uint32_t i;
+
+    test_Reset();
+
+    // A full ring drops the newest records
+    for (i = 0; i < (APP_LOG_RECORD_NUM + 5U); i++)
+    {
+        APP_LOG_1(APP_LOG_ID_CONNECTED, i);
+    }
+    APP_LOG_GetStats(&stats);
+    TEST_ASSERT_EQUAL(5, stats.dropCnt);
+
+    // The drops are reported ahead of the records kept
+    APP_LOG_Drain();
+    TEST_ASSERT(test_NextFrame(&frame));
+    TEST_ASSERT_EQUAL(APP_LOG_ID_DROPPED, frame.id);
+    TEST_ASSERT_EQUAL(4, frame.len);
+    TEST_ASSERT_EQUAL(5, test_GetArg(&frame, 0));
+    for (i = 0; i < APP_LOG_RECORD_NUM; i++)
+    {
+        TEST_ASSERT(test_NextFrame(&frame));
+        TEST_ASSERT_EQUAL(APP_LOG_ID_CONNECTED, frame.id);
+        TEST_ASSERT_EQUAL(i, test_GetArg(&frame, 0));
+    }
+    TEST_ASSERT(!test_NextFrame(&frame));
+
+    // Once, then only the drops since
+    APP_LOG_Drain();
+    TEST_ASSERT(!test_NextFrame(&frame));
+    for (i = 0; i < (APP_LOG_RECORD_NUM + 2U); i++)
+    {
+        APP_LOG(APP_LOG_ID_ADVERTISING);
+    }
+    APP_LOG_Drain();
+    TEST_ASSERT(test_NextFrame(&frame));
+    TEST_ASSERT_EQUAL(APP_LOG_ID_DROPPED, frame.id);
+    TEST_ASSERT_EQUAL(2, test_GetArg(&frame, 0));
+
+    APP_LOG_GetStats(&stats);
+    TEST_ASSERT_EQUAL(7, stats.dropCnt);
+    TEST_ASSERT_EQUAL(2U + (APP_LOG_RECORD_NUM * 2U), stats.recordCnt);
+}
+
+static void test_Unpublished(void)
+{
+    TEST_Frame_T frame;
+
+    test_Reset();
+
+    // A record preempted while it is written
+    s_isPreempting = true;
+    APP_LOG_2(APP_LOG_ID_DISCONNECTED, TEST_HANDLE, TEST_REASON);
+    TEST_ASSERT(!s_isPreempting);
+
+    // Neither record is sent while the first one is written
+    TEST_ASSERT_EQUAL(0, s_preemptLen);
+
+    // Once complete, both are sent in the order of the claims
+    APP_LOG_Drain();
+    TEST_ASSERT(test_NextFrame(&frame));
+    TEST_ASSERT_EQUAL(APP_LOG_ID_DISCONNECTED, frame.id);
+    TEST_ASSERT_EQUAL(TEST_REASON, test_GetArg(&frame, 1));
+    TEST_ASSERT(test_NextFrame(&frame));
+    TEST_ASSERT_EQUAL(APP_LOG_ID_CONNECTED, frame.id);
+    TEST_ASSERT_EQUAL(TEST_HANDLE, test_GetArg(&frame, 0));
+    TEST_ASSERT(!test_NextFrame(&frame));
+
+    // Records ahead of the one being written are sent, the drain stops at it
+    APP_LOG(APP_LOG_ID_BOOT);
+    s_isPreempting = true;
+    APP_LOG_1(APP_LOG_ID_CONNECTED, 1U);
+    TEST_ASSERT_EQUAL(s_uartRead + APP_LOG_FRAME_OVERHEAD, s_preemptLen);
+    TEST_ASSERT(test_NextFrame(&frame));
+    TEST_ASSERT_EQUAL(APP_LOG_ID_BOOT, frame.id);
+    TEST_ASSERT(!test_NextFrame(&frame));
+    APP_LOG_Drain();
+    TEST_ASSERT(test_NextFrame(&frame));
+    TEST_ASSERT_EQUAL(1, test_GetArg(&frame, 0));
+    TEST_ASSERT(test_NextFrame(&frame));
+    TEST_ASSERT_EQUAL(TEST_HANDLE, test_GetArg(&frame, 0));
+    TEST_ASSERT(!test_NextFrame(&frame));
+}
+
+static void test_UartFull(void)
+{
+    APP_LOG_Stats_T stats;
+    TEST_Frame_T frame;
+    uint32_t i;
+
+    test_Reset();
+
+    // Only whole frames are written, the rest waits for room
+    APP_LOG(APP_LOG_ID_BOOT);
+    APP_LOG_2(APP_LOG_ID_DISCONNECTED, TEST_HANDLE, TEST_REASON);
+    s_uartFree = APP_LOG_FRAME_OVERHEAD + 7U;
+    APP_LOG_Drain();
+    TEST_ASSERT_EQUAL(APP_LOG_FRAME_OVERHEAD, s_uartLen);
+    TEST_ASSERT(test_NextFrame(&frame));
+    TEST_ASSERT_EQUAL(APP_LOG_ID_BOOT, frame.id);
+
+    s_uartFree = APP_LOG_FRAME_OVERHEAD + 8U;
+    APP_LOG_Drain();
+    TEST_ASSERT(test_NextFrame(&frame));
+    TEST_ASSERT_EQUAL(APP_LOG_ID_DISCONNECTED, frame.id);
+    TEST_ASSERT(!test_NextFrame(&frame));
+
+    // The drop report waits for room as well, ahead of the records
+    for (i = 0; i < (APP_LOG_RECORD_NUM + 3U); i++)
+    {
+        APP_LOG(APP_LOG_ID_ADVERTISING);
+    }
+    s_uartFree = APP_LOG_FRAME_OVERHEAD + 3U;
+    APP_LOG_Drain();
+    TEST_ASSERT(!test_NextFrame(&frame));
+
+    s_uartFree = TEST_UART_MAX - s_uartLen;
+    APP_LOG_Drain();
+    TEST_ASSERT(test_NextFrame(&frame));
+    TEST_ASSERT_EQUAL(APP_LOG_ID_DROPPED, frame.id);
+    TEST_ASSERT_EQUAL(3, test_GetArg(&frame, 0));
+    for (i = 0; i < APP_LOG_RECORD_NUM; i++)
+    {
+        TEST_ASSERT(test_NextFrame(&frame));
+        TEST_ASSERT_EQUAL(APP_LOG_ID_ADVERTISING, frame.id);
+    }
+    TEST_ASSERT(!test_NextFrame(&frame));
+
+    // The records left unsent are not counted
+    APP_LOG_GetStats(&stats);
+    TEST_ASSERT_EQUAL(3U + APP_LOG_RECORD_NUM, stats.recordCnt);
+    TEST_ASSERT_EQUAL(s_uartLen, stats.byteCnt);
+}
+
+// Bridged data as the application task writes it, between the frames
+static void test_Bridge(const char *p_text, size_t len)
+{
+    (void)SERCOM0_USART_Write((uint8_t *)p_text, len);
+}
+
+static bool test_WriteFile(const char *p_dir, const char *p_name, const uint8_t *p_data, size_t len)
+{
+    char path[TEST_PATH_MAX];
+    FILE *p_file;
+    bool isWritten;
+
+    (void)snprintf(path, sizeof(path), "%s/%s", p_dir, p_name);
+    p_file = fopen(path, "wb");
+    if (p_file == NULL)
+    {
+        return false;
+    }
+    isWritten = (fwrite(p_data, 1, len, p_file) == len);
+
+    return (fclose(p_file) == 0) && isWritten;
+}
+
+// The capture checked by test_app_log_decode.py, keep the two in step
+static bool test_Capture(const char *p_dir)
+{
+    static const char padding[] = "................................................................";
+    uint32_t i;
+
+    test_Reset();
+
+    test_Bridge("AT\x1E+X\r\n", 7U);
+    APP_LOG(APP_LOG_ID_BOOT);
+    APP_LOG(APP_LOG_ID_ADVERTISING);
+    APP_LOG_Drain();
+
+    // Bridged bytes which start like a frame of a known log ID
+    test_Bridge("\x1E\x03\x00\x04\x41\x00\x00\x00\x00", 9U);
+    APP_LOG_1(APP_LOG_ID_CONNECTED, TEST_HANDLE);
+    APP_LOG_Write(APP_LOG_ID_BLE_CMD, 6U, "led on");
+    APP_LOG_Drain();
+
+    // A frame across the chunks read by the decoder
+    for (i = 0; i < 3U; i++)
+    {
+        test_Bridge(padding, sizeof(padding) - 1U);
+    }
+    test_Bridge("\x1E\x1E........", 10U);
+    APP_LOG_2(APP_LOG_ID_DISCONNECTED, TEST_HANDLE, TEST_REASON);
+    APP_LOG_Drain();
+
+    // A sync byte at the end of the capture
+    test_Bridge("ok\x1E", 3U);
+
+    return test_WriteFile(p_dir, "app_log.bin", s_uart, s_uartLen);
+}
+
+int main(int argc, char **argv)
+{
+    TEST_RUN(test_Frame);
+    TEST_RUN(test_Publish);
+    TEST_RUN(test_Drop);
+    TEST_RUN(test_Unpublished);
+    TEST_RUN(test_UartFull);
+
+    if ((argc > 1) && !test_Capture(argv[1]))
+    {
+        printf("FAIL cannot write the capture to %s\n", argv[1]);
+        return 1;
+    }
+
+    return TEST_RESULT();
+}
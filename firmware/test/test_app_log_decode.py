@@ -0,0 +1,55 @@
+#!/usr/bin/env python3
+"""Round trip of the log frames through tools/app_log_decode.py.
+
+Runs test_app_log to write a capture of the frames sent by app_log.c mixed
+with bridged data, some of it holding the sync byte, then checks the text
+the decoder rebuilds from it.
+
+Usage:
+    test_app_log_decode.py <test_app_log executable>
+"""
+
+import io
+import os
+import subprocess
+import sys
+import tempfile
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "tools"))
+import app_log_decode  # noqa: E402
+
+# Written by test_Capture() in test_app_log.c, keep the two in step
+EXPECTED = (
+    "AT\x1e+X\r\n"
+    "WBZ653 SERVO MOTOR\n"
+    "Advertising\n"
+    "\x1e\x03\x00\x04A\x00\x00\x00\x00"
+    "Connected 0x41\n"
+    "cmd: led on\n"
+    + "." * 192 + "\x1e\x1e" + "." * 8 +
+    "Disconnected 0x41 reason 0x13\n"
+    "ok\x1e"
+)
+
+
+def main():
+    table = app_log_decode.load_table(app_log_decode.DEFAULT_IDS)
+
+    with tempfile.TemporaryDirectory() as capture_dir:
+        subprocess.run([sys.argv[1], capture_dir], check=True, stdout=subprocess.DEVNULL)
+        with open(os.path.join(capture_dir, "app_log.bin"), "rb") as f:
+            capture = f.read()
+
+    # The frame after the padding lies across two reads of the decoder
+    out = io.StringIO()
+    app_log_decode.decode(io.BytesIO(capture), table, out)
+    if out.getvalue() != EXPECTED:
+        print("FAIL decoded text differs\n  expected %r\n  got      %r" % (EXPECTED, out.getvalue()))
+        return 1
+
+    print("ok   decoded %d bytes" % len(capture))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
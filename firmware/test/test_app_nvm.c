@@ -0,0 +1,384 @@
+/*******************************************************************************
+  Application Flash Job Test Source File
+
+  File Name:
+    test_app_nvm.c
+
+  Summary:
+    Checks the sequencing of the flash jobs against a fake NVM.
+
+  Description:
+    The test plays the idle task and the application task: the idle task
+    ends a finished step and starts the next one, the application task
+    verifies a step when its completion message arrives. The RF must be
+    suspended exactly while an operation runs, whether the interrupt is
+    delivered, its message is lost, or the interrupt never comes.
+ *******************************************************************************/
+
+#include <string.h>
+#include "app.h"
+#include "app_error_defs.h"
+#include "bt_sys.h"
+#include "app_nvm/app_nvm.h"
+#include "fake_nvm.h"
+#include "unit_test.h"
+
+#define TEST_JOB_ADDRESS            (APP_NVM_REGION_START + 0x2000U)
+#define TEST_JOB_LENGTH             (NVM_FLASH_PAGESIZE + 1500U)
+
+static uint8_t  s_data[TEST_JOB_LENGTH];
+static bool     s_isRfSuspended;
+static bool     s_isRfRefused;
+static uint32_t s_rfSuspendNum;
+static bool     s_isSendIsrFailing;
+static uint32_t s_postNum;                  // Completion messages waiting for the application task.
+static uint32_t s_repostNum;
+static uint32_t s_jobDoneNum;
+static uint16_t s_jobResult;
+
+uint8_t BT_SYS_RfSuspendReq(bool enable)
+{
+    if (!enable)
+    {
+        TEST_ASSERT(s_isRfSuspended);
+        s_isRfSuspended = false;
+        return 0U;
+    }
+
+    if (s_isRfRefused)
+    {
+        return 0U;
+    }
+
+    TEST_ASSERT(!s_isRfSuspended);
+    s_isRfSuspended = true;
+    s_rfSuspendNum++;
+
+    return BT_SYS_RF_SUSPENDED_NO_SLEEP;
+}
+
+uint16_t APP_QUEUE_SendISR(APP_Msg_T *p_msg)
+{
+    TEST_ASSERT_EQUAL(APP_MSG_NVM_CB, p_msg->msgId);
+    if (s_isSendIsrFailing)
+    {
+        return APP_RES_NO_RESOURCE;
+    }
+    s_postNum++;
+
+    return APP_RES_SUCCESS;
+}
+
+uint16_t APP_QUEUE_Send(APP_Msg_T *p_msg, uint32_t waitMs)
+{
+    TEST_ASSERT_EQUAL(APP_MSG_NVM_CB, p_msg->msgId);
+    TEST_ASSERT_EQUAL(0, waitMs);
+    s_postNum++;
+    s_repostNum++;
+
+    return APP_RES_SUCCESS;
+}
+
+static void test_JobCb(uint16_t result, uintptr_t context)
+{
+    TEST_ASSERT_EQUAL(0x1234, context);
+    s_jobDoneNum++;
+    s_jobResult = result;
+}
+
+static void test_Reset(void)
+{
+    uint32_t i;
+
+    TEST_ASSERT(FAKE_NVM_Reset());
+    s_isRfSuspended = false;
+    s_isRfRefused = false;
+    s_rfSuspendNum = 0U;
+    s_isSendIsrFailing = false;
+    s_postNum = 0U;
+    s_repostNum = 0U;
+    s_jobDoneNum = 0U;
+    for (i = 0U; i < TEST_JOB_LENGTH; i++)
+    {
+        s_data[i] = (uint8_t)((i * 7U) + 3U);
+    }
+    APP_NVM_Init();
+}
+
+static void test_Submit(void)
+{
+    APP_NVM_Job_T job;
+
+    job.address = TEST_JOB_ADDRESS;
+    job.p_data = s_data;
+    job.length = TEST_JOB_LENGTH;
+    job.cb = test_JobCb;
+    job.context = 0x1234;
+    TEST_ASSERT_EQUAL(APP_RES_SUCCESS, APP_NVM_Submit(&job));
+}
+
+// One pass of the idle task, as app_idle_task() runs it
+static bool test_Idle(void)
+{
+    APP_NVM_IdleCheck();
+    if (APP_NVM_IsActive())
+    {
+        return true;
+    }
+
+    return APP_NVM_IdleHandler();
+}
+
+// The application task takes its messages
+static void test_App(void)
+{
+    while (s_postNum > 0U)
+    {
+        s_postNum--;
+        APP_NVM_Complete();
+    }
+}
+
+// Runs the job to its end, every operation ending with its interrupt, returns the operations it took
+static uint32_t test_Run(void)
+{
+    uint32_t guard;
+
+    for (guard = 0U; (guard < 100U) && (s_jobDoneNum == 0U); guard++)
+    {
+        (void)test_Idle();
+        if (FAKE_NVM_GetOp(NULL) != FAKE_NVM_OP_NONE)
+        {
+            TEST_ASSERT(s_isRfSuspended);
+            FAKE_NVM_End(NVM_ERROR_NONE, true);
+        }
+        test_App();
+        TEST_ASSERT(!s_isRfSuspended);
+    }
+
+    return FAKE_NVM_GetOpNum();
+}
+
+static void test_Sequence(void)
+{
+    static const FAKE_NVM_Op_T expectedOp[] = {FAKE_NVM_OP_ERASE, FAKE_NVM_OP_WRITE, FAKE_NVM_OP_WRITE,
+        FAKE_NVM_OP_WRITE, FAKE_NVM_OP_WRITE, FAKE_NVM_OP_ERASE, FAKE_NVM_OP_WRITE, FAKE_NVM_OP_WRITE};
+    static const uint32_t expectedOffset[] = {0U, 0U, 1024U, 2048U, 3072U, 4096U, 4096U, 5120U};
+    const uint8_t *p_flash = (const uint8_t *)(uintptr_t)TEST_JOB_ADDRESS;
+    uint32_t address;
+    uint32_t i;
+
+    test_Reset();
+    test_Submit();
+
+    for (i = 0U; i < (sizeof(expectedOp) / sizeof(expectedOp[0])); i++)
+    {
+        TEST_ASSERT(test_Idle());
+        TEST_ASSERT_EQUAL(expectedOp[i], FAKE_NVM_GetOp(&address));
+        TEST_ASSERT_EQUAL(TEST_JOB_ADDRESS + expectedOffset[i], address);
+        TEST_ASSERT(s_isRfSuspended);
+
+        // Nothing else starts while the operation runs
+        TEST_ASSERT(test_Idle());
+        TEST_ASSERT_EQUAL(i + 1U, FAKE_NVM_GetOpNum());
+
+        FAKE_NVM_End(NVM_ERROR_NONE, true);
+        test_App();
+        TEST_ASSERT(!s_isRfSuspended);
+    }
+
+    TEST_ASSERT(!test_Idle());
+    TEST_ASSERT_EQUAL(1, s_jobDoneNum);
+    TEST_ASSERT_EQUAL(APP_RES_SUCCESS, s_jobResult);
+    TEST_ASSERT_EQUAL(8, s_rfSuspendNum);
+    TEST_ASSERT_EQUAL(0, memcmp(p_flash, s_data, TEST_JOB_LENGTH));
+
+    // The last row is padded, the rest of the page is erased
+    for (i = TEST_JOB_LENGTH; i < (2U * NVM_FLASH_PAGESIZE); i++)
+    {
+        TEST_ASSERT_EQUAL(0xFF, p_flash[i]);
+    }
+}
+
+static void test_RfResumedAtStepEnd(void)
+{
+    test_Reset();
+    test_Submit();
+
+    TEST_ASSERT(test_Idle());
+    FAKE_NVM_End(NVM_ERROR_NONE, true);
+
+    // The application task is busy, the idle task resumes the RF without waiting for it
+    TEST_ASSERT(!test_Idle());
+    TEST_ASSERT(!s_isRfSuspended);
+    TEST_ASSERT_EQUAL(1, FAKE_NVM_GetOpNum());
+    TEST_ASSERT_EQUAL(0, s_repostNum);
+
+    // The next step waits for the verification of this one
+    test_App();
+    TEST_ASSERT(test_Idle());
+    TEST_ASSERT_EQUAL(FAKE_NVM_OP_WRITE, FAKE_NVM_GetOp(NULL));
+}
+
+static void test_LostMessage(void)
+{
+    test_Reset();
+    test_Submit();
+
+    TEST_ASSERT(test_Idle());
+    s_isSendIsrFailing = true;
+    FAKE_NVM_End(NVM_ERROR_NONE, true);
+    TEST_ASSERT_EQUAL(0, s_postNum);
+
+    // The idle task posts the completion again, once
+    (void)test_Idle();
+    TEST_ASSERT(!s_isRfSuspended);
+    TEST_ASSERT_EQUAL(1, s_repostNum);
+    (void)test_Idle();
+    TEST_ASSERT_EQUAL(1, s_repostNum);
+    test_App();
+
+    s_isSendIsrFailing = false;
+    TEST_ASSERT_EQUAL(8, test_Run());
+    TEST_ASSERT_EQUAL(1, s_jobDoneNum);
+    TEST_ASSERT_EQUAL(APP_RES_SUCCESS, s_jobResult);
+}
+
+static void test_MissedInterrupt(void)
+{
+    test_Reset();
+    test_Submit();
+
+    TEST_ASSERT(test_Idle());
+    FAKE_NVM_End(NVM_ERROR_NONE, false);
+
+    (void)test_Idle();
+    TEST_ASSERT(!s_isRfSuspended);
+    TEST_ASSERT_EQUAL(1, s_repostNum);
+    test_App();
+
+    TEST_ASSERT_EQUAL(8, test_Run());
+    TEST_ASSERT_EQUAL(APP_RES_SUCCESS, s_jobResult);
+
+    // A late interrupt after the step is handled is ignored
+    test_Reset();
+    test_Submit();
+    TEST_ASSERT(test_Idle());
+    FAKE_NVM_End(NVM_ERROR_NONE, false);
+    (void)test_Idle();
+    test_App();
+    FAKE_NVM_End(NVM_ERROR_NONE, true);
+    TEST_ASSERT_EQUAL(0, s_postNum);
+}
+
+static void test_Errors(void)
+{
+    uint32_t address;
+
+    // A write error fails the job and the next one runs
+    test_Reset();
+    test_Submit();
+    test_Submit();
+    TEST_ASSERT(test_Idle());
+    FAKE_NVM_End(NVM_ERROR_NONE, true);
+    test_App();
+    TEST_ASSERT(test_Idle());
+    FAKE_NVM_End(NVM_ERROR_WRITE, true);
+    test_App();
+    TEST_ASSERT(!s_isRfSuspended);
+    TEST_ASSERT_EQUAL(1, s_jobDoneNum);
+    TEST_ASSERT_EQUAL(APP_RES_FAIL, s_jobResult);
+
+    TEST_ASSERT(test_Idle());
+    TEST_ASSERT_EQUAL(FAKE_NVM_OP_ERASE, FAKE_NVM_GetOp(&address));
+    TEST_ASSERT_EQUAL(TEST_JOB_ADDRESS, address);
+    FAKE_NVM_End(NVM_ERROR_NONE, true);
+    test_App();
+    s_jobDoneNum = 0U;
+    TEST_ASSERT_EQUAL(10, test_Run());
+    TEST_ASSERT_EQUAL(APP_RES_SUCCESS, s_jobResult);
+
+    // A row that does not read back fails the job
+    test_Reset();
+    test_Submit();
+    TEST_ASSERT(test_Idle());
+    FAKE_NVM_End(NVM_ERROR_NONE, true);
+    test_App();
+    TEST_ASSERT(test_Idle());
+    FAKE_NVM_End(NVM_ERROR_NONE, true);
+    ((uint8_t *)(uintptr_t)TEST_JOB_ADDRESS)[10] ^= 0x01U;
+    test_App();
+    TEST_ASSERT_EQUAL(1, s_jobDoneNum);
+    TEST_ASSERT_EQUAL(APP_RES_FAIL, s_jobResult);
+}
+
+static void test_RfRefused(void)
+{
+    test_Reset();
+    test_Submit();
+
+    // A connection event is close, the step waits for the next idle slot
+    s_isRfRefused = true;
+    TEST_ASSERT(!test_Idle());
+    TEST_ASSERT_EQUAL(0, FAKE_NVM_GetOpNum());
+
+    s_isRfRefused = false;
+    TEST_ASSERT_EQUAL(8, test_Run());
+    TEST_ASSERT_EQUAL(APP_RES_SUCCESS, s_jobResult);
+}
+
+static void test_InvalidJob(void)
+{
+    APP_NVM_Job_T job;
+    uint8_t i;
+
+    test_Reset();
+    job.address = TEST_JOB_ADDRESS + 1U;
+    job.p_data = s_data;
+    job.length = TEST_JOB_LENGTH;
+    job.cb = NULL;
+    job.context = 0;
+    TEST_ASSERT_EQUAL(APP_RES_INVALID_PARA, APP_NVM_Submit(&job));
+
+    job.address = NVM_FLASH_START_ADDRESS + NVM_FLASH_SIZE - NVM_FLASH_PAGESIZE;
+    TEST_ASSERT_EQUAL(APP_RES_INVALID_PARA, APP_NVM_Submit(&job));
+
+    // The image and anything else outside of the region of the jobs is never erased
+    job.address = NVM_FLASH_START_ADDRESS;
+    TEST_ASSERT_EQUAL(APP_RES_INVALID_PARA, APP_NVM_Submit(&job));
+    job.address = APP_NVM_REGION_START - NVM_FLASH_PAGESIZE;
+    TEST_ASSERT_EQUAL(APP_RES_INVALID_PARA, APP_NVM_Submit(&job));
+    job.address = APP_NVM_REGION_START - (2U * NVM_FLASH_PAGESIZE);
+    job.length = 3U * NVM_FLASH_PAGESIZE;
+    TEST_ASSERT_EQUAL(APP_RES_INVALID_PARA, APP_NVM_Submit(&job));
+    job.address = 0x00807000U;
+    job.length = NVM_FLASH_PAGESIZE;
+    TEST_ASSERT_EQUAL(APP_RES_INVALID_PARA, APP_NVM_Submit(&job));
+
+    // The whole region can be written
+    job.address = APP_NVM_REGION_START;
+    job.length = APP_NVM_REGION_SIZE;
+    TEST_ASSERT_EQUAL(APP_RES_SUCCESS, APP_NVM_Submit(&job));
+    test_Reset();
+    job.length = TEST_JOB_LENGTH;
+
+    job.address = TEST_JOB_ADDRESS;
+    for (i = 0U; i < APP_NVM_JOB_NUM; i++)
+    {
+        TEST_ASSERT_EQUAL(APP_RES_SUCCESS, APP_NVM_Submit(&job));
+    }
+    TEST_ASSERT_EQUAL(APP_RES_NO_RESOURCE, APP_NVM_Submit(&job));
+}
+
+int main(void)
+{
+    TEST_RUN(test_Sequence);
+    TEST_RUN(test_RfResumedAtStepEnd);
+    TEST_RUN(test_LostMessage);
+    TEST_RUN(test_MissedInterrupt);
+    TEST_RUN(test_Errors);
+    TEST_RUN(test_RfRefused);
+    TEST_RUN(test_InvalidJob);
+
+    return TEST_RESULT();
+}
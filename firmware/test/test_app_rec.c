@@ -0,0 +1,461 @@
+/*******************************************************************************
+  Application Event Recorder Test Source File
+
+  File Name:
+    test_app_rec.c
+
+  Summary:
+    Checks the record ring of the event recorder and its vendor command.
+
+  Description:
+    The reset controller page is mapped at its device address so that
+    APP_REC_Init() runs unchanged. The tick read of the recorder is wrapped
+    at link time: it stands for the point where an interrupt preempts a
+    record being written, the interrupt records its own event and reads the
+    ring. The records are read back through APP_REC_VendorCmdHandler, in as
+    many replies as the MTU of the link needs.
+ *******************************************************************************/
+
+#include <string.h>
+#include <sys/mman.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "device.h"
+#include "gatt.h"
+#include "ble_util/byte_stream.h"
+#include "app_rec/app_rec.h"
+#include "fake_rtos.h"
+#include "unit_test.h"
+
+#define TEST_RCON_PAGE              (0x44000000UL)
+#define TEST_PAGE_SIZE              (0x1000U)
+#define TEST_CONN_HANDLE            (0x0041U)
+#define TEST_REPLY_MAX              (256U)
+#define TEST_READ_HEADER_LEN        (6U)
+#define TEST_EVENT_NUM              (APP_REC_RECORD_NUM + 37U)
+
+typedef struct TEST_Record_T
+{
+    uint32_t    tick;
+    uint8_t     type;
+    uint8_t     boot;
+    uint16_t    arg16;
+    uint32_t    arg32;
+} TEST_Record_T;
+
+static uint8_t          s_reply[TEST_REPLY_MAX];
+static uint8_t          s_replyLen;
+static uint32_t         s_replyNum;
+static uint16_t         s_mtu;
+static bool             s_isPreempting;     // The next tick read is preempted by an interrupt.
+static uint32_t         s_preemptIdx;       // Index of the record preempted.
+static TEST_Record_T    s_record[APP_REC_RECORD_NUM];
+
+TickType_t __real_xTaskGetTickCount(void);
+
+uint16_t APP_LINK_GetMtu(uint16_t connHandle)
+{
+    TEST_ASSERT_EQUAL(TEST_CONN_HANDLE, connHandle);
+
+    return s_mtu;
+}
+
+uint16_t BLE_TRSPS_SendVendorCommand(uint16_t connHandle, uint8_t commandID, uint8_t commandLength,
+    uint8_t *p_commandPayload)
+{
+    TEST_ASSERT_EQUAL(TEST_CONN_HANDLE, connHandle);
+    TEST_ASSERT_EQUAL(APP_REC_VENDOR_OPCODE, commandID);
+    TEST_ASSERT(commandLength <= TEST_REPLY_MAX);
+    (void)memcpy(s_reply, p_commandPayload, commandLength);
+    s_replyLen = commandLength;
+    s_replyNum++;
+
+    return 0U;
+}
+
+static void test_Command(uint8_t op, const uint8_t *p_param, uint8_t paramLen)
+{
+    uint8_t cmd[8];
+
+    cmd[0] = APP_REC_VENDOR_OPCODE;
+    cmd[1] = op;
+    (void)memcpy(&cmd[2], p_param, paramLen);
+    s_replyLen = 0U;
+    APP_REC_VendorCmdHandler(TEST_CONN_HANDLE, 2U + paramLen, cmd);
+}
+
+static void test_Info(uint32_t *p_first, uint32_t *p_next, uint16_t *p_boot)
+{
+    const uint8_t *p_buf = &s_reply[2];
+
+    test_Command(APP_REC_OP_INFO, NULL, 0U);
+    TEST_ASSERT_EQUAL(13, s_replyLen);
+    TEST_ASSERT_EQUAL(APP_REC_OP_INFO, s_reply[0]);
+    TEST_ASSERT_EQUAL(APP_REC_STATUS_SUCCESS, s_reply[1]);
+    TEST_ASSERT_EQUAL(APP_REC_RECORD_LEN, s_reply[12]);
+    STREAM_LE_TO_U32(p_first, &p_buf);
+    STREAM_LE_TO_U32(p_next, &p_buf);
+    STREAM_LE_TO_U16(p_boot, &p_buf);
+}
+
+// Sends a read and returns the number of records in the reply, *p_idx is set to the index of the first one
+static uint32_t test_Read(uint32_t *p_idx, TEST_Record_T *p_record, uint32_t maxNum)
+{
+    uint8_t param[4];
+    const uint8_t *p_buf;
+    uint32_t num;
+    uint32_t i;
+
+    U32_TO_BUF_LE(param, *p_idx);
+    test_Command(APP_REC_OP_READ, param, sizeof(param));
+    TEST_ASSERT_EQUAL(APP_REC_OP_READ, s_reply[0]);
+    TEST_ASSERT_EQUAL(APP_REC_STATUS_SUCCESS, s_reply[1]);
+    TEST_ASSERT(s_replyLen >= TEST_READ_HEADER_LEN);
+    TEST_ASSERT_EQUAL(0, (s_replyLen - TEST_READ_HEADER_LEN) % APP_REC_RECORD_LEN);
+
+    // The reply fits in a notification
+    TEST_ASSERT((ATT_NOTI_INDI_HEADER_SIZE + 1U + s_replyLen) <= s_mtu);
+
+    p_buf = &s_reply[2];
+    STREAM_LE_TO_U32(p_idx, &p_buf);
+    num = (s_replyLen - TEST_READ_HEADER_LEN) / APP_REC_RECORD_LEN;
+    for (i = 0; (i < num) && (i < maxNum); i++)
+    {
+        STREAM_LE_TO_U32(&p_record[i].tick, &p_buf);
+        STREAM_TO_U8(&p_record[i].type, &p_buf);
+        STREAM_TO_U8(&p_record[i].boot, &p_buf);
+        STREAM_LE_TO_U16(&p_record[i].arg16, &p_buf);
+        STREAM_LE_TO_U32(&p_record[i].arg32, &p_buf);
+    }
+
+    return num;
+}
+
+// Reads from idx until a reply holds no record, as the host does
+static uint32_t test_ReadAll(uint32_t idx, uint32_t *p_first, uint32_t *p_replyNum)
+{
+    uint32_t num = 0U;
+    uint32_t replyNum = 0U;
+    uint32_t readNum;
+    uint32_t at;
+
+    *p_first = idx;
+    for (;;)
+    {
+        at = idx;
+        readNum = test_Read(&at, &s_record[num], APP_REC_RECORD_NUM - num);
+        if (num == 0U)
+        {
+            *p_first = at;
+        }
+        else
+        {
+            // Each reply resumes where the previous one stopped
+            TEST_ASSERT_EQUAL(idx, at);
+        }
+        if (readNum == 0U)
+        {
+            break;
+        }
+        TEST_ASSERT((num + readNum) <= APP_REC_RECORD_NUM);
+        num += readNum;
+        idx = at + readNum;
+        replyNum++;
+    }
+
+    if (p_replyNum != NULL)
+    {
+        *p_replyNum = replyNum;
+    }
+
+    return num;
+}
+
+static void test_Reset(uint32_t resetFlags)
+{
+    RCON_REGS->RCON_RCON = resetFlags;
+    RCON_REGS->RCON_RCONCLR = 0U;
+    APP_REC_Init();
+    TEST_ASSERT_EQUAL(resetFlags, RCON_REGS->RCON_RCONCLR);
+}
+
+static void test_Setup(void)
+{
+    FAKE_RTOS_Reset();
+    s_replyNum = 0U;
+    s_mtu = 247U;
+    s_isPreempting = false;
+    test_Reset(RCON_RCON_POR_Msk);
+}
+
+static void test_PowerOn(void)
+{
+    uint32_t first;
+    uint32_t next;
+    uint16_t boot;
+
+    test_Setup();
+
+    test_Info(&first, &next, &boot);
+    TEST_ASSERT_EQUAL(0, first);
+    TEST_ASSERT_EQUAL(1, next);
+    TEST_ASSERT_EQUAL(1, boot);
+
+    TEST_ASSERT_EQUAL(1, test_ReadAll(0U, &first, NULL));
+    TEST_ASSERT_EQUAL(0, first);
+    TEST_ASSERT_EQUAL(APP_REC_TYPE_RESET, s_record[0].type);
+    TEST_ASSERT_EQUAL(1, s_record[0].boot);
+    TEST_ASSERT_EQUAL(1, s_record[0].arg16);
+    TEST_ASSERT_EQUAL(RCON_RCON_POR_Msk, s_record[0].arg32);
+}
+
+static void test_WarmReset(void)
+{
+    uint32_t first;
+    uint32_t next;
+    uint16_t boot;
+
+    test_Setup();
+    APP_REC_Record(APP_REC_TYPE_CONNECTED, TEST_CONN_HANDLE, 0U);
+
+    // The records are kept over a software reset
+    test_Reset(RCON_RCON_SWR_Msk);
+    test_Info(&first, &next, &boot);
+    TEST_ASSERT_EQUAL(0, first);
+    TEST_ASSERT_EQUAL(3, next);
+    TEST_ASSERT_EQUAL(2, boot);
+    TEST_ASSERT_EQUAL(3, test_ReadAll(0U, &first, NULL));
+    TEST_ASSERT_EQUAL(APP_REC_TYPE_CONNECTED, s_record[1].type);
+    TEST_ASSERT_EQUAL(1, s_record[1].boot);
+    TEST_ASSERT_EQUAL(APP_REC_TYPE_RESET, s_record[2].type);
+    TEST_ASSERT_EQUAL(2, s_record[2].boot);
+    TEST_ASSERT_EQUAL(RCON_RCON_SWR_Msk, s_record[2].arg32);
+
+    // And forgotten after a brown-out
+    test_Reset(RCON_RCON_BOR_Msk);
+    test_Info(&first, &next, &boot);
+    TEST_ASSERT_EQUAL(0, first);
+    TEST_ASSERT_EQUAL(1, next);
+    TEST_ASSERT_EQUAL(1, boot);
+}
+
+TickType_t __wrap_xTaskGetTickCount(void)
+{
+    uint32_t idx;
+    uint32_t first;
+    uint32_t next;
+    uint16_t boot;
+
+    if (s_isPreempting)
+    {
+        s_isPreempting = false;
+
+        // The interrupt claims the next record and completes it first
+        APP_REC_Record(APP_REC_TYPE_QUEUE_FULL, 7U, 2U);
+        test_Info(&first, &next, &boot);
+        TEST_ASSERT_EQUAL(s_preemptIdx + 2U, next);
+
+        // The record being written still holds an older event, it is sent as type 0
+        idx = s_preemptIdx;
+        TEST_ASSERT_EQUAL(2, test_Read(&idx, s_record, APP_REC_RECORD_NUM));
+        TEST_ASSERT_EQUAL(s_preemptIdx, idx);
+        TEST_ASSERT_EQUAL(0, s_record[0].type);
+        TEST_ASSERT_EQUAL(0, s_record[0].arg16);
+        TEST_ASSERT_EQUAL(0, s_record[0].arg32);
+        TEST_ASSERT_EQUAL(APP_REC_TYPE_QUEUE_FULL, s_record[1].type);
+        TEST_ASSERT_EQUAL(7, s_record[1].arg16);
+        TEST_ASSERT_EQUAL(2, s_record[1].arg32);
+    }
+
+    return __real_xTaskGetTickCount();
+}
+
+static void test_Claim(void)
+{
+    uint32_t first;
+    uint32_t i;
+
+    test_Setup();
+
+    // Fill the ring, the next record overwrites the reset event
+    for (i = 1; i < APP_REC_RECORD_NUM; i++)
+    {
+        APP_REC_Record(APP_REC_TYPE_COMMAND, TEST_CONN_HANDLE, i);
+    }
+
+    // A record preempted while it is written
+    FAKE_RTOS_AdvanceUs(5000U);
+    s_preemptIdx = APP_REC_RECORD_NUM;
+    s_isPreempting = true;
+    APP_REC_Record(APP_REC_TYPE_SETPOINT, 1U, 1500U);
+    TEST_ASSERT(!s_isPreempting);
+
+    // Each event has its own record, in the order of the claims
+    TEST_ASSERT_EQUAL(APP_REC_RECORD_NUM, test_ReadAll(0U, &first, NULL));
+    TEST_ASSERT_EQUAL(2, first);
+    for (i = 0; i < (APP_REC_RECORD_NUM - 2U); i++)
+    {
+        TEST_ASSERT_EQUAL(APP_REC_TYPE_COMMAND, s_record[i].type);
+        TEST_ASSERT_EQUAL(first + i, s_record[i].arg32);
+    }
+    TEST_ASSERT_EQUAL(APP_REC_TYPE_SETPOINT, s_record[i].type);
+    TEST_ASSERT_EQUAL(1, s_record[i].arg16);
+    TEST_ASSERT_EQUAL(1500, s_record[i].arg32);
+    TEST_ASSERT_EQUAL(5, s_record[i].tick);
+    TEST_ASSERT_EQUAL(APP_REC_TYPE_QUEUE_FULL, s_record[i + 1U].type);
+}
+
+static void test_Wrap(void)
+{
+    uint32_t first;
+    uint32_t next;
+    uint16_t boot;
+    uint32_t i;
+
+    test_Setup();
+
+    for (i = 1; i < TEST_EVENT_NUM; i++)
+    {
+        APP_REC_Record(APP_REC_TYPE_SETPOINT, 1U, i);
+    }
+
+    // The oldest events are overwritten
+    test_Info(&first, &next, &boot);
+    TEST_ASSERT_EQUAL(TEST_EVENT_NUM, next);
+    TEST_ASSERT_EQUAL(TEST_EVENT_NUM - APP_REC_RECORD_NUM, first);
+
+    // A read of a lost record resumes at the oldest one kept
+    TEST_ASSERT_EQUAL(APP_REC_RECORD_NUM, test_ReadAll(0U, &first, NULL));
+    TEST_ASSERT_EQUAL(TEST_EVENT_NUM - APP_REC_RECORD_NUM, first);
+    for (i = 0; i < APP_REC_RECORD_NUM; i++)
+    {
+        TEST_ASSERT_EQUAL(APP_REC_TYPE_SETPOINT, s_record[i].type);
+        TEST_ASSERT_EQUAL(first + i, s_record[i].arg32);
+    }
+
+    // Nothing after the last record
+    i = next + 5U;
+    TEST_ASSERT_EQUAL(0, test_Read(&i, s_record, APP_REC_RECORD_NUM));
+    TEST_ASSERT_EQUAL(next + 5U, i);
+}
+
+static void test_Clear(void)
+{
+    uint32_t first;
+    uint32_t next;
+    uint16_t boot;
+    uint32_t i;
+
+    test_Setup();
+
+    for (i = 1; i < TEST_EVENT_NUM; i++)
+    {
+        APP_REC_Record(APP_REC_TYPE_SETPOINT, 1U, i);
+    }
+
+    test_Command(APP_REC_OP_CLEAR, NULL, 0U);
+    TEST_ASSERT_EQUAL(2, s_replyLen);
+    TEST_ASSERT_EQUAL(APP_REC_OP_CLEAR, s_reply[0]);
+    TEST_ASSERT_EQUAL(APP_REC_STATUS_SUCCESS, s_reply[1]);
+
+    test_Info(&first, &next, &boot);
+    TEST_ASSERT_EQUAL(TEST_EVENT_NUM, first);
+    TEST_ASSERT_EQUAL(TEST_EVENT_NUM, next);
+    TEST_ASSERT_EQUAL(0, test_ReadAll(0U, &first, NULL));
+
+    // Only the events after the clear are read
+    APP_REC_Record(APP_REC_TYPE_DISCONNECTED, TEST_CONN_HANDLE, 0x13U);
+    TEST_ASSERT_EQUAL(1, test_ReadAll(0U, &first, NULL));
+    TEST_ASSERT_EQUAL(TEST_EVENT_NUM, first);
+    TEST_ASSERT_EQUAL(APP_REC_TYPE_DISCONNECTED, s_record[0].type);
+    TEST_ASSERT_EQUAL(0x13, s_record[0].arg32);
+
+    // The clear is kept over a warm reset
+    test_Reset(RCON_RCON_SWR_Msk);
+    TEST_ASSERT_EQUAL(2, test_ReadAll(0U, &first, NULL));
+    TEST_ASSERT_EQUAL(TEST_EVENT_NUM, first);
+}
+
+static void test_Chunking(void)
+{
+    static const struct
+    {
+        uint16_t    mtu;
+        uint32_t    perReply;
+    } s_case[] =
+    {
+        {23U, 1U},                      // The smallest MTU fits one record
+        {100U, 7U},
+        {247U, 16U},                    // At most 16 records in a reply
+    };
+    uint32_t first;
+    uint32_t replyNum;
+    uint32_t i;
+    uint32_t c;
+
+    test_Setup();
+
+    for (i = 1; i < 40U; i++)
+    {
+        APP_REC_Record(APP_REC_TYPE_SETPOINT, 1U, i);
+    }
+
+    for (c = 0; c < (sizeof(s_case) / sizeof(s_case[0])); c++)
+    {
+        s_mtu = s_case[c].mtu;
+        TEST_ASSERT_EQUAL(40, test_ReadAll(0U, &first, &replyNum));
+        TEST_ASSERT_EQUAL(0, first);
+        TEST_ASSERT_EQUAL((40U + s_case[c].perReply - 1U) / s_case[c].perReply, replyNum);
+        for (i = 1; i < 40U; i++)
+        {
+            TEST_ASSERT_EQUAL(i, s_record[i].arg32);
+        }
+    }
+}
+
+static void test_Invalid(void)
+{
+    uint8_t param[4] = {0};
+
+    test_Setup();
+
+    test_Command(0x7FU, NULL, 0U);
+    TEST_ASSERT_EQUAL(2, s_replyLen);
+    TEST_ASSERT_EQUAL(0x7F, s_reply[0]);
+    TEST_ASSERT_EQUAL(APP_REC_STATUS_INVALID, s_reply[1]);
+
+    test_Command(APP_REC_OP_READ, param, 3U);
+    TEST_ASSERT_EQUAL(2, s_replyLen);
+    TEST_ASSERT_EQUAL(APP_REC_STATUS_INVALID, s_reply[1]);
+
+    test_Command(APP_REC_OP_INFO, param, 1U);
+    TEST_ASSERT_EQUAL(APP_REC_STATUS_INVALID, s_reply[1]);
+
+    // No operation, no reply
+    s_replyNum = 0U;
+    APP_REC_VendorCmdHandler(TEST_CONN_HANDLE, 1U, param);
+    TEST_ASSERT_EQUAL(0, s_replyNum);
+}
+
+int main(void)
+{
+    void *p_page;
+
+    p_page = mmap((void *)TEST_RCON_PAGE, TEST_PAGE_SIZE, PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+    if (p_page != (void *)TEST_RCON_PAGE)
+    {
+        printf("The reset controller page cannot be mapped\n");
+        return 1;
+    }
+
+    TEST_RUN(test_PowerOn);
+    TEST_RUN(test_WarmReset);
+    TEST_RUN(test_Claim);
+    TEST_RUN(test_Wrap);
+    TEST_RUN(test_Clear);
+    TEST_RUN(test_Chunking);
+    TEST_RUN(test_Invalid);
+
+    return TEST_RESULT();
+}
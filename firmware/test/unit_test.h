@@ -0,0 +1,59 @@
+/*******************************************************************************
+  Host Test Helpers Header File
+
+  File Name:
+    unit_test.h
+
+  Summary:
+    Assertions and a runner shared by the host tests.
+
+  Description:
+    A failed assertion prints its location and fails the test case, the test
+    program then exits with a non-zero status for CTest.
+ *******************************************************************************/
+
+#ifndef UNIT_TEST_H
+#define UNIT_TEST_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+static int s_testFailNum;
+static bool s_testFailed;
+
+#define TEST_ASSERT(cond)                                                           \
+    do                                                                              \
+    {                                                                               \
+        if (!(cond))                                                                \
+        {                                                                           \
+            printf("%s:%d: assertion failed: %s\n", __FILE__, __LINE__, #cond);    \
+            s_testFailed = true;                                                    \
+        }                                                                           \
+    } while (0)
+
+#define TEST_ASSERT_EQUAL(expected, actual)                                         \
+    do                                                                              \
+    {                                                                               \
+        long long exp_ = (long long)(expected);                                     \
+        long long act_ = (long long)(actual);                                       \
+        if (exp_ != act_)                                                           \
+        {                                                                           \
+            printf("%s:%d: %s: expected %lld, got %lld\n", __FILE__, __LINE__,      \
+                #actual, exp_, act_);                                               \
+            s_testFailed = true;                                                    \
+        }                                                                           \
+    } while (0)
+
+#define TEST_RUN(test)                                                              \
+    do                                                                              \
+    {                                                                               \
+        s_testFailed = false;                                                       \
+        test();                                                                     \
+        printf("%s %s\n", s_testFailed ? "FAIL" : "ok  ", #test);                   \
+        s_testFailNum += s_testFailed ? 1 : 0;                                      \
+    } while (0)
+
+#define TEST_RESULT()                   ((s_testFailNum == 0) ? 0 : 1)
+
+#endif // UNIT_TEST_H
@@ -0,0 +1,139 @@
+#!/usr/bin/env python3
+"""Decode the binary log of the servo application.
+
+The firmware sends each log record as a frame:
+
+    0x1E | log ID (2, little endian) | size of the arguments (1) | arguments | XOR check (1)
+
+The text of each log ID is taken from APP_LOG_TABLE in src/app_log/app_log_ids.h,
+where the log ID is the position of the message. Bytes outside the frames, such
+as the data bridged from BLE, are passed through as they are.
+
+Usage:
+    app_log_decode.py [capture]              decode a capture file, or stdin
+    app_log_decode.py --table                print the string table
+    cat /dev/ttyACM0 | app_log_decode.py     decode a live UART
+"""
+
+import argparse
+import os
+import re
+import struct
+import sys
+
+FRAME_SYNC = 0x1E
+FRAME_OVERHEAD = 5
+DATA_MAX = 16
+
+DEFAULT_IDS = os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                           "..", "src", "app_log", "app_log_ids.h")
+
+ENTRY_RE = re.compile(r'X\(\s*(\w+)\s*,\s*"((?:[^"\\]|\\.)*)"\s*\)')
+SPEC_RE = re.compile(r"%([udxs%])")
+
+
+def load_table(path):
+    """Return the (name, format) list of APP_LOG_TABLE, indexed by log ID."""
+    with open(path, encoding="utf-8") as f:
+        text = f.read()
+    start = text.index("#define APP_LOG_TABLE(X)")
+    return [(m.group(1), m.group(2).encode().decode("unicode_escape"))
+            for m in ENTRY_RE.finditer(text, start)]
+
+
+def format_record(fmt, data):
+    """Rebuild the text of a record, or return None if the arguments do not fit."""
+    out = []
+    pos = 0
+    last = 0
+    for m in SPEC_RE.finditer(fmt):
+        out.append(fmt[last:m.start()])
+        last = m.end()
+        spec = m.group(1)
+        if spec == "%":
+            out.append("%")
+        elif spec == "s":
+            out.append(data[pos:].decode("latin-1"))
+            pos = len(data)
+        else:
+            if pos + 4 > len(data):
+                return None
+            value, = struct.unpack_from("<I" if spec != "d" else "<i", data, pos)
+            pos += 4
+            out.append(format(value, "x" if spec == "x" else "d"))
+    out.append(fmt[last:])
+    if pos != len(data):
+        return None
+    return "".join(out)
+
+
+def decode(stream, table, out):
+    buf = bytearray()
+    raw = bytearray()
+
+    def flush_raw():
+        if raw:
+            out.write(raw.decode("latin-1"))
+            raw.clear()
+
+    while True:
+        chunk = stream.read1(256) if hasattr(stream, "read1") else stream.read(256)
+        if chunk:
+            buf.extend(chunk)
+        while buf:
+            if buf[0] != FRAME_SYNC:
+                raw.append(buf.pop(0))
+                continue
+            if len(buf) < 4:
+                break
+            log_id = buf[1] | (buf[2] << 8)
+            size = buf[3]
+            if size > DATA_MAX or log_id >= len(table):
+                raw.append(buf.pop(0))
+                continue
+            if len(buf) < FRAME_OVERHEAD + size:
+                break
+            frame = bytes(buf[:FRAME_OVERHEAD + size])
+            check = 0
+            for b in frame[1:-1]:
+                check ^= b
+            text = format_record(table[log_id][1], frame[4:-1]) if check == frame[-1] else None
+            if text is None:
+                # Not a frame, the sync byte was part of the bridged data
+                raw.append(buf.pop(0))
+                continue
+            flush_raw()
+            out.write(text + "\n")
+            del buf[:len(frame)]
+        if not chunk:
+            break
+        out.flush()
+
+    raw.extend(buf)
+    flush_raw()
+    out.flush()
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decode the binary log of the servo application.")
+    parser.add_argument("capture", nargs="?", help="binary capture of the UART, stdin if omitted")
+    parser.add_argument("--ids", default=DEFAULT_IDS, help="path to app_log_ids.h")
+    parser.add_argument("--table", action="store_true", help="print the string table and exit")
+    args = parser.parse_args()
+
+    table = load_table(args.ids)
+
+    if args.table:
+        for log_id, (name, fmt) in enumerate(table):
+            print("%5d  %-32s %s" % (log_id, name, fmt))
+        return
+
+    if args.capture:
+        with open(args.capture, "rb") as stream:
+            decode(stream, table, sys.stdout)
+    else:
+        decode(sys.stdin.buffer, table, sys.stdout)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,134 @@
+#!/usr/bin/env python3
+"""Decode the flight recorder of the servo application.
+
+The recorder is read with the vendor command 0xF0 of the transparent service
+(see src/app_rec/app_rec.h): INFO gives the first and next record index, then
+READ is repeated from the first index, advancing by the number of records of
+each reply, until a reply carries no record.
+
+This script takes the replies as they are notified on the TRS control point,
+one per line in hex, the 0xF0 opcode first. Bytes may be separated by spaces,
+colons or dashes, as copied from a BLE app log.
+
+Usage:
+    app_rec_decode.py [replies.txt]          decode the replies, or stdin
+"""
+
+import argparse
+import re
+import struct
+import sys
+
+VENDOR_OPCODE = 0xF0
+OP_INFO = 0x00
+OP_READ = 0x01
+OP_CLEAR = 0x02
+RECORD_LEN = 12
+
+# APP_REC_Type_T
+TYPES = {
+    1: "RESET",
+    2: "COMMAND",
+    3: "SETPOINT",
+    4: "CONNECTED",
+    5: "DISCONNECTED",
+    6: "QUEUE_FULL",
+    7: "HEAP_FAIL",
+}
+
+# RCON_RCON flags
+RESET_FLAGS = [
+    (0, "POR"), (1, "BOR"), (2, "IDLE"), (3, "SLEEP"), (4, "WDTO"), (5, "DMTO"),
+    (6, "SWR"), (7, "EXTR"), (9, "CMR"), (10, "DPSLP"), (30, "PORCORE"), (31, "PORIO"),
+]
+
+# Lanes of the application queue, in the order of app_queue.h
+LANES = ["urgent", "normal", "bulk"]
+
+# msgId of APP_Msg_T, in the order of app.h
+MESSAGES = [
+    "BLE_STACK_EVT", "BLE_STACK_LOG", "BLE_DATA_EVT", "BLE_SEND_EVT", "ZB_STACK_EVT",
+    "ZB_STACK_CB", "UART_CB", "NVM_CB", "SMP_KEY_GEN", "SERVO_SETPOINT",
+    "TIMER_SEND_UART", "TIMER_CONN_POLICY", "TIMER_LINK_STATUS", "TIMER_L2CAP_DRAIN",
+    "TIMER_ADV_STATUS", "TIMER_GROUP_APPLY", "TIMER_SERVO_RAMP", "TIMER_CAL_SAVE",
+    "TIMER_ADV_ROTATE",
+]
+
+
+def describe(rec_type, arg16, arg32):
+    if rec_type == 1:
+        flags = [name for bit, name in RESET_FLAGS if arg32 & (1 << bit)]
+        return "boot %u, flags %s" % (arg16, "|".join(flags) or "0x%08x" % arg32)
+    if rec_type == 2:
+        text = struct.pack("<I", arg32).rstrip(b"\0").decode("latin-1")
+        return "conn 0x%04x \"%s\"" % (arg16, text)
+    if rec_type == 3:
+        return "channel %u, duty %u" % (arg16, arg32)
+    if rec_type == 4:
+        return "conn 0x%04x" % arg16
+    if rec_type == 5:
+        return "conn 0x%04x, reason 0x%02x" % (arg16, arg32)
+    if rec_type == 6:
+        name = MESSAGES[arg16] if arg16 < len(MESSAGES) else str(arg16)
+        lane = LANES[arg32] if arg32 < len(LANES) else str(arg32)
+        return "message %s lost, %s lane full" % (name, lane)
+    if rec_type == 7:
+        return "size %u, free heap %u" % (arg16, arg32)
+    return "arg16 0x%04x, arg32 0x%08x" % (arg16, arg32)
+
+
+def parse_line(line):
+    digits = re.sub(r"(0x)|[\s:,\-]", "", line.strip(), flags=re.IGNORECASE)
+    if not digits:
+        return None
+    return bytes.fromhex(digits)
+
+
+def decode(lines, out):
+    records = {}
+    for number, line in enumerate(lines, 1):
+        try:
+            reply = parse_line(line)
+        except ValueError:
+            sys.stderr.write("line %d: not hex, skipped\n" % number)
+            continue
+        if not reply or len(reply) < 3 or reply[0] != VENDOR_OPCODE:
+            continue
+        op, status = reply[1], reply[2]
+        if status != 0:
+            sys.stderr.write("line %d: operation 0x%02x failed with status %u\n" % (number, op, status))
+            continue
+        if op == OP_INFO and len(reply) >= 14:
+            first, nxt, boot, size = struct.unpack_from("<IIHB", reply, 3)
+            out.write("# records %u to %u, boot %u, record size %u\n" % (first, nxt - 1, boot, size))
+        elif op == OP_READ and len(reply) >= 7:
+            idx, = struct.unpack_from("<I", reply, 3)
+            body = reply[7:]
+            for pos in range(0, len(body) - RECORD_LEN + 1, RECORD_LEN):
+                records[idx] = body[pos:pos + RECORD_LEN]
+                idx += 1
+
+    for idx in sorted(records):
+        tick, rec_type, boot, arg16, arg32 = struct.unpack("<IBBHI", records[idx])
+        if rec_type == 0:
+            out.write("%8u  (lost)\n" % idx)
+            continue
+        out.write("%8u  boot %3u  %10.3f s  %-12s %s\n" % (
+            idx, boot, tick / 1000.0, TYPES.get(rec_type, "TYPE_%u" % rec_type),
+            describe(rec_type, arg16, arg32)))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decode the flight recorder of the servo application.")
+    parser.add_argument("replies", nargs="?", help="vendor command replies, one per line in hex, stdin if omitted")
+    args = parser.parse_args()
+
+    if args.replies:
+        with open(args.replies, encoding="utf-8") as f:
+            decode(f, sys.stdout)
+    else:
+        decode(sys.stdin, sys.stdout)
+
+
+if __name__ == "__main__":
+    main()